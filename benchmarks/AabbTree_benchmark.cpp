@@ -0,0 +1,219 @@
+/*
+ * ---------------------------------------------------
+ * AabbTree_benchmark.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Compare the ways of keeping the spatial index up to date in a scene of
+ * static entities with a few moving ones: reinserting the leaves leaving
+ * their margin, replacing the boxes and refitting the tree, or rebuilding
+ * it every frame. The refitted tree is cheap to update but its quality
+ * degrades as the moving boxes drift away from their original siblings,
+ * so the cost of a frustum query and a few picking rays is measured too,
+ * after all the frames. Each frame is compared with a linear scan of all
+ * the boxes.
+ *
+ * usage: AabbTree_benchmark [static count] [moving count] [frames]
+ *
+ */
+
+#include "Game-Engine/AabbTree.hpp"
+#include "Game-Engine/Culling.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr float WORLD_SIZE = 2000.0f;
+constexpr int RAY_COUNT = 100;
+
+template<typename F>
+double averageMilliseconds(int iterations, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        f();
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / iterations;
+}
+
+struct Scene
+{
+    std::vector<GE::BoundingBox> boxes; // the moving ones first
+    std::vector<glm::vec3> velocities;
+};
+
+Scene makeScene(uint32_t staticCount, uint32_t movingCount)
+{
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-WORLD_SIZE / 2, WORLD_SIZE / 2);
+    std::uniform_real_distribution<float> height(0.0f, 50.0f);
+    std::uniform_real_distribution<float> size(0.5f, 4.0f);
+    std::uniform_real_distribution<float> speed(-1.0f, 1.0f);
+    Scene scene;
+    for (uint32_t i = 0; i < staticCount + movingCount; i++)
+    {
+        const glm::vec3 center(position(random), height(random), position(random));
+        const glm::vec3 extent(size(random), size(random), size(random));
+        scene.boxes.push_back({ .min = center - extent, .max = center + extent });
+    }
+    for (uint32_t i = 0; i < movingCount; i++)
+        scene.velocities.emplace_back(speed(random), 0.0f, speed(random));
+    return scene;
+}
+
+void step(Scene& scene)
+{
+    for (size_t i = 0; i < scene.velocities.size(); i++)
+    {
+        scene.boxes[i].min += scene.velocities[i];
+        scene.boxes[i].max += scene.velocities[i];
+    }
+}
+
+struct Queries
+{
+    GE::Frustum frustum;
+    std::vector<GE::Ray> rays;
+};
+
+Queries makeQueries()
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> direction(-0.3f, 0.3f);
+    const glm::vec3 eye(0.0f, 20.0f, 0.0f);
+    Queries queries{ .frustum = GE::frustum(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f) * glm::lookAt(eye, glm::vec3(0.0f, 20.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f))), .rays = {} };
+    for (int i = 0; i < RAY_COUNT; i++)
+        queries.rays.push_back(GE::Ray{ .origin = eye, .direction = glm::normalize(glm::vec3(direction(random), direction(random), -1.0f)) });
+    return queries;
+}
+
+// visible count plus the hits, so the work cannot be optimized away
+uint64_t runQueries(const GE::AabbTree& tree, const Queries& queries)
+{
+    uint64_t result = 0;
+    tree.query(queries.frustum, [&](uint64_t) { result++; });
+    for (const GE::Ray& ray : queries.rays)
+        result += tree.closestHit(ray).value_or(0);
+    return result;
+}
+
+uint64_t runLinearQueries(const std::vector<GE::BoundingBox>& boxes, const Queries& queries)
+{
+    uint64_t result = 0;
+    for (const GE::BoundingBox& box : boxes)
+        result += GE::isBoxInFrustum(queries.frustum, box) ? 1 : 0;
+    for (const GE::Ray& ray : queries.rays)
+    {
+        float closestDistance = std::numeric_limits<float>::infinity();
+        uint64_t closest = 0;
+        for (uint64_t i = 0; i < boxes.size(); i++)
+        {
+            if (std::optional<float> distance = GE::rayBoxDistance(ray, boxes[i], closestDistance))
+            {
+                closestDistance = *distance;
+                closest = i;
+            }
+        }
+        result += closest;
+    }
+    return result;
+}
+
+struct Result
+{
+    double updateMilliseconds = 0.0;
+    double queryMilliseconds = 0.0;
+    float surfaceAreaRatio = 0.0f;
+    uint32_t height = 0;
+};
+
+template<typename Update>
+Result run(uint32_t staticCount, uint32_t movingCount, int frames, const Queries& queries, Update&& update)
+{
+    Scene scene = makeScene(staticCount, movingCount);
+    GE::AabbTree tree;
+    std::vector<GE::AabbTree::NodeID> ids;
+    ids.reserve(scene.boxes.size());
+    for (uint64_t i = 0; i < scene.boxes.size(); i++)
+        ids.push_back(tree.insert(scene.boxes[i], i));
+    tree.rebuild();
+
+    Result result;
+    result.updateMilliseconds = averageMilliseconds(frames, [&]() {
+        step(scene);
+        update(tree, ids, scene.boxes, movingCount);
+    });
+    volatile uint64_t sink = 0;
+    result.queryMilliseconds = averageMilliseconds(10, [&]() { sink = sink + runQueries(tree, queries); });
+    result.surfaceAreaRatio = tree.surfaceAreaRatio();
+    result.height = tree.height();
+    return result;
+}
+
+void print(const std::string& name, const Result& result)
+{
+    std::cout << name << result.updateMilliseconds << " ms/frame, queries " << result.queryMilliseconds << " ms, height " << result.height << ", surface ratio " << result.surfaceAreaRatio << '\n';
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const uint32_t staticCount = argc > 1 ? static_cast<uint32_t>(std::max(0, std::atoi(argv[1]))) : 1'000'000;
+    const uint32_t movingCount = argc > 2 ? static_cast<uint32_t>(std::max(1, std::atoi(argv[2]))) : 10'000;
+    const int frames = argc > 3 ? std::max(1, std::atoi(argv[3])) : 100;
+    const Queries queries = makeQueries();
+
+    double insertMilliseconds = 0.0;
+    double rebuildMilliseconds = 0.0;
+    {
+        const Scene scene = makeScene(staticCount, movingCount);
+        GE::AabbTree tree;
+        insertMilliseconds = averageMilliseconds(1, [&]() {
+            for (uint64_t i = 0; i < scene.boxes.size(); i++)
+                tree.insert(scene.boxes[i], i);
+        });
+        rebuildMilliseconds = averageMilliseconds(1, [&]() { tree.rebuild(); });
+    }
+
+    const Result moved = run(staticCount, movingCount, frames, queries, [](GE::AabbTree& tree, const auto& ids, const auto& boxes, uint32_t count) {
+        for (uint32_t i = 0; i < count; i++)
+            tree.move(ids[i], boxes[i]);
+    });
+    const Result refitted = run(staticCount, movingCount, frames, queries, [](GE::AabbTree& tree, const auto& ids, const auto& boxes, uint32_t count) {
+        for (uint32_t i = 0; i < count; i++)
+            tree.setBox(ids[i], boxes[i]);
+        tree.refit();
+    });
+    const Result rebuilt = run(staticCount, movingCount, std::max(1, frames / 10), queries, [](GE::AabbTree& tree, const auto& ids, const auto& boxes, uint32_t count) {
+        for (uint32_t i = 0; i < count; i++)
+            tree.setBox(ids[i], boxes[i]);
+        tree.rebuild();
+    });
+
+    const Scene scene = makeScene(staticCount, movingCount);
+    volatile uint64_t sink = 0;
+    const double linearQueryMilliseconds = averageMilliseconds(1, [&]() { sink = sink + runLinearQueries(scene.boxes, queries); });
+
+    std::cout << "entities:           " << staticCount << " static, " << movingCount << " moving, " << frames << " frames\n";
+    std::cout << "build by insertion: " << insertMilliseconds << " ms\n";
+    std::cout << "build top down:     " << rebuildMilliseconds << " ms\n";
+    print("move:               ", moved);
+    print("refit:              ", refitted);
+    print("rebuild:            ", rebuilt);
+    std::cout << "linear queries:     " << linearQueryMilliseconds << " ms (1 frustum, " << RAY_COUNT << " rays)\n";
+    return 0;
+}
@@ -0,0 +1,208 @@
+/*
+ * ---------------------------------------------------
+ * AssetArchive_benchmark.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Compare the time needed to load every mesh and texture of a resource
+ * directory from the loose files (source + cooked cache, one file each)
+ * with the time needed to load them from a packed asset archive, stored
+ * and LZ4 compressed. The cold numbers drop the files from the page cache
+ * before each iteration (linux only).
+ *
+ * usage: AssetArchive_benchmark [resource directory] [iterations]
+ *
+ */
+
+#include "Game-Engine/AssetArchive.hpp"
+#include "Game-Engine/MeshData.hpp"
+#include "Game-Engine/TextureData.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <variant>
+#include <vector>
+
+#if defined(__linux__)
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+
+template<typename F>
+double averageMilliseconds(int iterations, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        f();
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / iterations;
+}
+
+// return false if the page cache can not be dropped on this platform
+bool evictFromPageCache(const std::filesystem::path& path)
+{
+#if defined(__linux__)
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    ::fdatasync(fd);
+    bool evicted = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    ::close(fd);
+    return evicted;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+bool evictDirectoryFromPageCache(const std::filesystem::path& directory)
+{
+    bool evicted = true;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(directory))
+    {
+        if (entry.is_regular_file())
+            evicted = evictFromPageCache(entry.path()) && evicted;
+    }
+    return evicted;
+}
+
+// touch the data so the mapped pages are actually read
+uint32_t touch(const GE::MeshData& meshData)
+{
+    uint32_t sum = 0;
+    for (const GE::MeshData::Geometry& geometry : meshData.geometries)
+        for (uint32_t index : geometry.indices)
+            sum += index;
+    return sum;
+}
+
+uint32_t touch(const GE::TextureData& textureData)
+{
+    uint32_t sum = 0;
+    for (const GE::TextureData::Mip& mip : textureData.mips)
+    {
+        for (size_t i = 0; i < mip.bytes.size(); i += 64)
+            sum += static_cast<uint32_t>(mip.bytes[i]);
+    }
+    return sum;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path resourceDirectory = argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::path(GE_BENCHMARK_RESOURCE_DIR);
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+    const std::filesystem::path workDirectory = std::filesystem::temp_directory_path() / "GE_AssetArchive_benchmark";
+    const std::filesystem::path cacheDirectory = workDirectory / "cache";
+    const std::filesystem::path storedArchivePath = workDirectory / "stored.gearchive";
+    const std::filesystem::path compressedArchivePath = workDirectory / "compressed.gearchive";
+
+    if (!std::filesystem::is_directory(resourceDirectory))
+    {
+        std::cerr << "resource directory not found: " << resourceDirectory << '\n';
+        return 1;
+    }
+    std::filesystem::remove_all(workDirectory);
+    std::filesystem::create_directories(workDirectory);
+
+    GE::AssetArchiveWriter storedWriter;
+    storedWriter.addDirectory(resourceDirectory, GE::ArchiveCompression::none);
+    storedWriter.write(storedArchivePath);
+
+    GE::AssetArchiveWriter compressedWriter;
+    compressedWriter.addDirectory(resourceDirectory, GE::ArchiveCompression::lz4);
+    compressedWriter.write(compressedArchivePath);
+
+    const GE::AssetArchive storedArchive(storedArchivePath);
+    if (storedArchive.entries().empty())
+    {
+        std::cerr << "no mesh or texture found in " << resourceDirectory << '\n';
+        return 1;
+    }
+
+    volatile uint32_t sum = 0;
+
+    const auto loadLooseFiles = [&]() {
+        for (const GE::AssetArchive::Entry& entry : storedArchive.entries())
+        {
+            const std::filesystem::path sourcePath = resourceDirectory / entry.path;
+            if (entry.type == "Mesh")
+                sum = sum + touch(GE::loadMeshData(sourcePath, cacheDirectory));
+            else
+                sum = sum + touch(GE::loadTextureData(sourcePath, cacheDirectory));
+        }
+    };
+
+    const auto loadArchive = [&](const std::filesystem::path& archivePath) {
+        const GE::AssetArchive archive(archivePath);
+        for (const GE::AssetArchive::Entry& entry : archive.entries())
+        {
+            const GE::AssetArchive::Blob blob = archive.read(entry);
+            if (entry.type == "Mesh")
+            {
+                std::optional<GE::MeshData> meshData = GE::readCookedMesh(blob.bytes, blob.storage, entry.key);
+                if (meshData.has_value())
+                    sum = sum + touch(*meshData);
+            }
+            else
+            {
+                std::optional<GE::TextureData> textureData = GE::readCookedTexture(blob.bytes, blob.storage, entry.key);
+                if (textureData.has_value())
+                    sum = sum + touch(*textureData);
+            }
+        }
+    };
+
+    // fill the cooked cache of the loose files
+    loadLooseFiles();
+
+    bool canEvict = true;
+    double looseCold = averageMilliseconds(iterations, [&]() {
+        canEvict = evictDirectoryFromPageCache(resourceDirectory) && evictDirectoryFromPageCache(cacheDirectory) && canEvict;
+        loadLooseFiles();
+    });
+    double storedCold = averageMilliseconds(iterations, [&]() {
+        canEvict = evictFromPageCache(storedArchivePath) && canEvict;
+        loadArchive(storedArchivePath);
+    });
+    double compressedCold = averageMilliseconds(iterations, [&]() {
+        canEvict = evictFromPageCache(compressedArchivePath) && canEvict;
+        loadArchive(compressedArchivePath);
+    });
+
+    double looseWarm = averageMilliseconds(iterations, loadLooseFiles);
+    double storedWarm = averageMilliseconds(iterations, [&]() { loadArchive(storedArchivePath); });
+    double compressedWarm = averageMilliseconds(iterations, [&]() { loadArchive(compressedArchivePath); });
+
+    const auto storedSize = std::filesystem::file_size(storedArchivePath);
+    const auto compressedSize = std::filesystem::file_size(compressedArchivePath);
+    std::filesystem::remove_all(workDirectory);
+
+    std::cout << "resources:       " << resourceDirectory.string() << " (" << storedArchive.entries().size() << " assets)\n";
+    std::cout << "archive size:    " << storedSize << " bytes stored, " << compressedSize << " bytes lz4\n";
+    if (canEvict)
+    {
+        std::cout << "cold loose:      " << looseCold << " ms (source hash + cooked file per asset)\n";
+        std::cout << "cold stored:     " << storedCold << " ms (mapped archive)\n";
+        std::cout << "cold lz4:        " << compressedCold << " ms (mapped archive + decompression)\n";
+    }
+    else
+        std::cout << "cold:            page cache can not be dropped on this platform\n";
+    std::cout << "warm loose:      " << looseWarm << " ms\n";
+    std::cout << "warm stored:     " << storedWarm << " ms\n";
+    std::cout << "warm lz4:        " << compressedWarm << " ms\n";
+    std::cout << "speedup (warm):  " << looseWarm / storedWarm << "x stored, " << looseWarm / compressedWarm << "x lz4\n";
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * ---------------------------------------------------
+ * AsyncFileReader_benchmark.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Compare the time needed to read every file of a directory of small
+ * assets with one blocking thread per file, like the asset loaders did,
+ * with the AsyncFileReader backends reading them in a single batch. Only
+ * the reads are measured, the decoding costs the same either way. Without
+ * a directory, a few thousand small files are generated. The cold numbers
+ * drop the files from the page cache before each iteration (linux only).
+ *
+ * usage: AsyncFileReader_benchmark [directory] [iterations]
+ *
+ */
+
+#include "Game-Engine/AsyncFileReader.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+
+constexpr int GENERATED_FILE_COUNT = 4000;
+
+template<typename F>
+double averageMilliseconds(int iterations, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        f();
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / iterations;
+}
+
+// return false if the page cache can not be dropped on this platform
+bool evictFromPageCache(const std::vector<std::filesystem::path>& paths)
+{
+#if defined(__linux__)
+    for (const std::filesystem::path& path : paths)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        ::fdatasync(fd);
+        const bool evicted = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        ::close(fd);
+        if (evicted == false)
+            return false;
+    }
+    return true;
+#else
+    (void)paths;
+    return false;
+#endif
+}
+
+std::vector<std::byte> readFileBlocking(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    std::vector<std::byte> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return bytes;
+}
+
+// sizes of small textures and meshes, between 4 and 64 KB
+std::vector<std::filesystem::path> generateFiles(const std::filesystem::path& directory)
+{
+    std::mt19937 random(42);
+    std::uniform_int_distribution<size_t> size(4 * 1024, 64 * 1024);
+    std::vector<std::filesystem::path> paths;
+    std::filesystem::create_directories(directory);
+    for (int i = 0; i < GENERATED_FILE_COUNT; i++)
+    {
+        std::string content(size(random), '\0');
+        std::ranges::generate(content, [&]() { return static_cast<char>(random()); });
+        paths.push_back(directory / ("asset_" + std::to_string(i) + ".bin"));
+        std::ofstream(paths.back(), std::ios::binary) << content;
+    }
+    return paths;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+    const std::filesystem::path generatedDirectory = std::filesystem::temp_directory_path() / "GE_AsyncFileReader_benchmark";
+
+    std::vector<std::filesystem::path> paths;
+    if (argc > 1)
+    {
+        if (!std::filesystem::is_directory(argv[1]))
+        {
+            std::cerr << "directory not found: " << argv[1] << '\n';
+            return 1;
+        }
+        for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(argv[1]))
+        {
+            if (entry.is_regular_file())
+                paths.push_back(entry.path());
+        }
+    }
+    else
+    {
+        std::filesystem::remove_all(generatedDirectory);
+        paths = generateFiles(generatedDirectory);
+    }
+
+    size_t totalBytes = 0;
+    for (const std::filesystem::path& path : paths)
+        totalBytes += std::filesystem::file_size(path);
+
+    volatile size_t readBytes = 0;
+
+    const auto readWithThreads = [&]() {
+        std::vector<std::future<std::vector<std::byte>>> futures;
+        futures.reserve(paths.size());
+        for (const std::filesystem::path& path : paths)
+            futures.push_back(std::async(std::launch::async, readFileBlocking, path));
+        for (auto& future : futures)
+            readBytes = readBytes + future.get().size();
+    };
+
+    const auto readWithReader = [&](GE::AsyncFileReader& reader) {
+        for (auto& future : reader.read(paths))
+            readBytes = readBytes + future.get().size();
+    };
+
+    GE::AsyncFileReader ioUringReader(GE::AsyncFileReader::Backend::ioUring);
+    GE::AsyncFileReader threadPoolReader(GE::AsyncFileReader::Backend::threadPool);
+    const bool hasIoUring = ioUringReader.backend() == GE::AsyncFileReader::Backend::ioUring;
+
+    bool canEvict = true;
+    double threadsCold = averageMilliseconds(iterations, [&]() { canEvict = evictFromPageCache(paths) && canEvict; readWithThreads(); });
+    double threadPoolCold = averageMilliseconds(iterations, [&]() { canEvict = evictFromPageCache(paths) && canEvict; readWithReader(threadPoolReader); });
+    double ioUringCold = averageMilliseconds(iterations, [&]() { canEvict = evictFromPageCache(paths) && canEvict; readWithReader(ioUringReader); });
+
+    double threadsWarm = averageMilliseconds(iterations, readWithThreads);
+    double threadPoolWarm = averageMilliseconds(iterations, [&]() { readWithReader(threadPoolReader); });
+    double ioUringWarm = averageMilliseconds(iterations, [&]() { readWithReader(ioUringReader); });
+
+    if (argc <= 1)
+        std::filesystem::remove_all(generatedDirectory);
+
+    std::cout << "files:              " << paths.size() << " (" << totalBytes << " bytes)\n";
+    if (hasIoUring == false)
+        std::cout << "io_uring:           not available, the reader falls back to the thread pool\n";
+    if (canEvict)
+    {
+        std::cout << "cold thread/file:   " << threadsCold << " ms\n";
+        std::cout << "cold thread pool:   " << threadPoolCold << " ms\n";
+        std::cout << "cold io_uring:      " << ioUringCold << " ms\n";
+    }
+    else
+        std::cout << "cold:               page cache can not be dropped on this platform\n";
+    std::cout << "warm thread/file:   " << threadsWarm << " ms\n";
+    std::cout << "warm thread pool:   " << threadPoolWarm << " ms\n";
+    std::cout << "warm io_uring:      " << ioUringWarm << " ms\n";
+    std::cout << "speedup (warm):     " << threadsWarm / ioUringWarm << "x io_uring, " << threadsWarm / threadPoolWarm << "x thread pool\n";
+    return 0;
+}
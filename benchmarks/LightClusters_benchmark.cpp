@@ -0,0 +1,158 @@
+/*
+ * ---------------------------------------------------
+ * LightClusters_benchmark.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Cost of the clustered point lights from 1k to 10k lights scattered in
+ * front of the camera, with radii derived from their attenuation: the cpu
+ * time to build the cluster grid each frame, the size of the uploaded
+ * light lists, and the lights a fragment evaluates. The fragments are
+ * emulated on the cpu at random positions of the frustum, shading them
+ * with the lights of their cluster is compared with looping over all the
+ * lights like before the clustering.
+ *
+ * usage: LightClusters_benchmark [frames] [fragments]
+ *
+ */
+
+#include "Game-Engine/LightClusters.hpp"
+#include "Game-Engine/MeshLod.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr float NEAR_DEPTH = 0.1f;
+constexpr float FAR_DEPTH = 500.0f;
+constexpr float WORLD_SIZE = 400.0f;
+
+template<typename F>
+double averageMilliseconds(int iterations, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        f();
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / iterations;
+}
+
+const glm::vec3 EYE(0.0f, 20.0f, 0.0f);
+
+glm::mat4 viewProjection()
+{
+    return glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, NEAR_DEPTH, FAR_DEPTH) * glm::lookAt(EYE, EYE + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+std::vector<GE::BoundingSphere> makeLights(uint32_t count)
+{
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-WORLD_SIZE / 2, WORLD_SIZE / 2);
+    std::uniform_real_distribution<float> height(0.0f, 30.0f);
+    std::uniform_real_distribution<float> attenuation(0.5f, 5.0f);
+    std::vector<GE::BoundingSphere> lights;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        lights.push_back({
+            .center = glm::vec3(position(random), height(random), position(random) - WORLD_SIZE / 2),
+            .radius = GE::pointLightRadius(glm::vec3(1.0f), attenuation(random))
+        });
+    }
+    return lights;
+}
+
+// world positions whose normalized device coordinates and depth are uniform, like the fragments of a filled screen
+std::vector<glm::vec3> makeFragments(uint32_t count, const glm::mat4& matrix)
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> ndc(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> depth(1.0f, FAR_DEPTH / 2);
+    const glm::mat4 inverse = glm::inverse(matrix);
+    std::vector<glm::vec3> fragments;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        // along the ray from the camera through a point of the far plane
+        const glm::vec4 far = inverse * glm::vec4(ndc(random), ndc(random), 1.0f, 1.0f);
+        const glm::vec3 direction = glm::normalize(glm::vec3(far) / far.w - EYE);
+        fragments.push_back(EYE + direction * depth(random));
+    }
+    return fragments;
+}
+
+// the number of lights reaching the fragments, so the work cannot be optimized away
+uint64_t shadeAll(const std::vector<glm::vec3>& fragments, const std::vector<GE::BoundingSphere>& lights)
+{
+    uint64_t result = 0;
+    for (const glm::vec3& fragment : fragments)
+    {
+        for (const GE::BoundingSphere& light : lights)
+        {
+            const glm::vec3 offset = light.center - fragment;
+            result += glm::dot(offset, offset) <= light.radius * light.radius ? 1 : 0;
+        }
+    }
+    return result;
+}
+
+uint64_t shadeClustered(const std::vector<glm::vec3>& fragments, const std::vector<GE::BoundingSphere>& lights, const GE::LightClusterGrid& grid, uint64_t& evaluatedCount)
+{
+    uint64_t result = 0;
+    for (const glm::vec3& fragment : fragments)
+    {
+        const GE::LightClusterGrid::Cluster& cluster = grid.clusters()[grid.clusterIndex(grid.clusterOf(fragment))];
+        evaluatedCount += cluster.count;
+        for (uint32_t light : grid.lightIndices().subspan(cluster.offset, cluster.count))
+        {
+            const glm::vec3 offset = lights[light].center - fragment;
+            result += glm::dot(offset, offset) <= lights[light].radius * lights[light].radius ? 1 : 0;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100;
+    const uint32_t fragmentCount = argc > 2 ? static_cast<uint32_t>(std::max(1, std::atoi(argv[2]))) : 100'000;
+    const glm::mat4 matrix = viewProjection();
+    const std::vector<glm::vec3> fragments = makeFragments(fragmentCount, matrix);
+
+    std::cout << "grid: " << GE::LightClusterGrid::DEFAULT_TILE_COUNT_X << "x" << GE::LightClusterGrid::DEFAULT_TILE_COUNT_Y << "x" << GE::LightClusterGrid::DEFAULT_SLICE_COUNT
+              << ", " << frames << " frames, " << fragmentCount << " fragments\n";
+    for (uint32_t lightCount : std::array<uint32_t, 4>{ 1'000, 2'500, 5'000, 10'000 })
+    {
+        const std::vector<GE::BoundingSphere> lights = makeLights(lightCount);
+        GE::LightClusterGrid grid;
+        const double buildMilliseconds = averageMilliseconds(frames, [&]() { grid.build(matrix, NEAR_DEPTH, FAR_DEPTH, lights); });
+
+        uint32_t maxClusterCount = 0;
+        for (const GE::LightClusterGrid::Cluster& cluster : grid.clusters())
+            maxClusterCount = std::max(maxClusterCount, cluster.count);
+
+        volatile uint64_t sink = 0;
+        uint64_t evaluatedCount = 0;
+        const double allMilliseconds = averageMilliseconds(1, [&]() { sink = sink + shadeAll(fragments, lights); });
+        const double clusteredMilliseconds = averageMilliseconds(1, [&]() { sink = sink + shadeClustered(fragments, lights, grid, evaluatedCount); });
+
+        std::cout << lightCount << " lights:\n";
+        std::cout << "  build:     " << buildMilliseconds << " ms/frame, " << grid.lightIndices().size() << " indices (" << grid.lightIndices().size() * sizeof(uint32_t) / 1024 << " KB), "
+                  << "max " << maxClusterCount << " lights in a cluster\n";
+        std::cout << "  all:       " << allMilliseconds << " ms, " << lightCount << " lights/fragment\n";
+        std::cout << "  clustered: " << clusteredMilliseconds << " ms, " << static_cast<double>(evaluatedCount) / fragmentCount << " lights/fragment\n";
+    }
+    return 0;
+}
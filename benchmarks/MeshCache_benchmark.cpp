@@ -0,0 +1,92 @@
+/*
+ * ---------------------------------------------------
+ * MeshCache_benchmark.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Compare the load time of a mesh imported with assimp (cold) with the
+ * load time of its cooked version (warm). The cold time is also split in
+ * its import and cook steps.
+ *
+ * usage: MeshCache_benchmark [mesh path] [iterations]
+ *
+ */
+
+#include "Game-Engine/MeshData.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <variant>
+
+namespace
+{
+
+template<typename F>
+double averageMilliseconds(int iterations, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        f();
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path meshPath = argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::path(GE_BENCHMARK_RESOURCE_DIR) / "chess_set" / "chess_set.gltf";
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+    const std::filesystem::path cacheDirectory = std::filesystem::temp_directory_path() / "GE_MeshCache_benchmark";
+
+    if (!std::filesystem::is_regular_file(meshPath))
+    {
+        std::cerr << "mesh not found: " << meshPath << '\n';
+        return 1;
+    }
+
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+
+    double cold = averageMilliseconds(iterations, [&]() {
+        std::filesystem::remove_all(cacheDirectory);
+        GE::MeshData meshData = GE::loadMeshData(meshPath, cacheDirectory);
+        vertexCount = 0;
+        indexCount = 0;
+        for (const GE::MeshData::Geometry& geometry : meshData.geometries)
+        {
+            vertexCount += geometry.vertexCount();
+            indexCount += geometry.indexCount();
+        }
+    });
+
+    // the two steps of a cold load, without the hashing and the write of the cache
+    GE::MeshData imported;
+    const double import = averageMilliseconds(iterations, [&]() { imported = GE::importMesh(meshPath); });
+    const double cook = averageMilliseconds(iterations, [&]() { GE::MeshData cooked = GE::cookMesh(imported, GE::MeshCookOptions{}); });
+
+    double warm = averageMilliseconds(iterations, [&]() {
+        GE::MeshData meshData = GE::loadMeshData(meshPath, cacheDirectory);
+        // touch the data so the mapped pages are actually read
+        volatile uint32_t sum = 0;
+        for (const GE::MeshData::Geometry& geometry : meshData.geometries)
+            for (uint32_t index : geometry.indices)
+                sum = sum + index;
+    });
+
+    std::filesystem::remove_all(cacheDirectory);
+
+    std::cout << "mesh:     " << meshPath.string() << " (" << vertexCount << " vertices, " << indexCount << " indices)\n";
+    std::cout << "cold:     " << cold << " ms (assimp import + cook)\n";
+    std::cout << "  import: " << import << " ms\n";
+    std::cout << "  cook:   " << cook << " ms\n";
+    std::cout << "warm:     " << warm << " ms (mapped cooked mesh)\n";
+    std::cout << "speedup:  " << cold / warm << "x\n";
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * ---------------------------------------------------
+ * MeshCompression_benchmark.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Size report of a mesh cooked with the full and the packed vertex
+ * formats, with the precision lost by the packed format.
+ *
+ * usage: MeshCompression_benchmark [mesh path]
+ *
+ */
+
+#include "Game-Engine/MeshData.hpp"
+#include "Game-Engine/VertexFormat.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <variant>
+
+namespace
+{
+
+struct SizeReport
+{
+    size_t vertexBytes = 0;
+    size_t indexBytes = 0;
+    size_t uploadedIndexBytes = 0; // indices are always uploaded as uint32
+};
+
+SizeReport sizeReport(const GE::MeshData& meshData)
+{
+    SizeReport report;
+    for (const GE::MeshData::Geometry& geometry : meshData.geometries)
+    {
+        report.vertexBytes += geometry.vertexBytes();
+        report.indexBytes += geometry.indexBytes();
+        report.uploadedIndexBytes += geometry.indexCount() * sizeof(uint32_t);
+    }
+    return report;
+}
+
+void print(const char* name, const SizeReport& report)
+{
+    std::cout << name << ": vertices " << report.vertexBytes << " B, indices " << report.indexBytes << " B (cooked) "
+              << report.uploadedIndexBytes << " B (uploaded), total uploaded " << report.vertexBytes + report.uploadedIndexBytes << " B\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path meshPath = argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::path(GE_BENCHMARK_RESOURCE_DIR) / "chess_set" / "chess_set.gltf";
+    if (!std::filesystem::is_regular_file(meshPath))
+    {
+        std::cerr << "mesh not found: " << meshPath << '\n';
+        return 1;
+    }
+
+    const GE::MeshData imported = GE::importMesh(meshPath);
+    const GE::MeshData full = GE::cookMesh(imported, GE::MeshCookOptions{ .vertexFormat = GE::VertexFormat::full });
+    const GE::MeshData packed = GE::cookMesh(imported, GE::MeshCookOptions{ .vertexFormat = GE::VertexFormat::packed });
+
+    const SizeReport fullReport = sizeReport(full);
+    const SizeReport packedReport = sizeReport(packed);
+
+    std::cout << "mesh: " << meshPath.string() << '\n';
+    print("full  ", fullReport);
+    print("packed", packedReport);
+    std::cout << "vertex bytes ratio: " << static_cast<double>(packedReport.vertexBytes) / static_cast<double>(fullReport.vertexBytes) << '\n';
+    std::cout << "cooked bytes ratio: " << static_cast<double>(packedReport.vertexBytes + packedReport.indexBytes) / static_cast<double>(fullReport.vertexBytes + fullReport.indexBytes) << '\n';
+
+    float maxPositionError = 0.0f;
+    float maxNormalAngle = 0.0f;
+    float maxUvError = 0.0f;
+    for (size_t i = 0; i < full.geometries.size(); i++)
+    {
+        const auto fullVertices = std::get<std::span<const GE::Vertex>>(full.geometries[i].vertices);
+        const auto packedVertices = std::get<std::span<const GE::PackedVertex>>(packed.geometries[i].vertices);
+        for (size_t v = 0; v < fullVertices.size(); v++)
+        {
+            const GE::Vertex decoded = GE::unpackVertex(packedVertices[v], packed.geometries[i].positionQuantization);
+            maxPositionError = std::max(maxPositionError, glm::length(decoded.pos - fullVertices[v].pos));
+            if (glm::length(fullVertices[v].normal) > 0.0f)
+                maxNormalAngle = std::max(maxNormalAngle, std::atan2(glm::length(glm::cross(decoded.normal, fullVertices[v].normal)), glm::dot(decoded.normal, fullVertices[v].normal)));
+            maxUvError = std::max(maxUvError, glm::length(decoded.uv - fullVertices[v].uv));
+        }
+    }
+    std::cout << "max position error: " << maxPositionError << '\n';
+    std::cout << "max normal error:   " << maxNormalAngle * 180.0f / 3.14159265f << " deg\n";
+    std::cout << "max uv error:       " << maxUvError << '\n';
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * ---------------------------------------------------
+ * MeshOptimization_benchmark.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Post transform cache efficiency of a mesh cooked with and without
+ * the mesh optimizer, and the time spent optimizing it.
+ *
+ * usage: MeshOptimization_benchmark [mesh path]
+ *
+ */
+
+#include "Game-Engine/MeshData.hpp"
+#include "Game-Engine/MeshOptimizer.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace
+{
+
+struct CacheReport
+{
+    uint64_t triangleCount = 0;
+    uint64_t usedVertexCount = 0;
+    uint64_t transformedVertexCount = 0;
+};
+
+CacheReport cacheReport(const GE::MeshData& meshData, uint32_t cacheSize)
+{
+    CacheReport report;
+    for (const GE::MeshData::Geometry& geometry : meshData.geometries)
+    {
+        const std::vector<uint32_t> indices(geometry.indices.begin(), geometry.indices.end());
+        const GE::VertexCacheStatistics statistics = GE::analyzeVertexCache(indices, static_cast<uint32_t>(geometry.vertexCount()), cacheSize);
+        report.triangleCount += indices.size() / 3;
+        report.transformedVertexCount += statistics.transformedVertexCount;
+        if (statistics.atvr > 0.0f)
+            report.usedVertexCount += static_cast<uint64_t>(static_cast<float>(statistics.transformedVertexCount) / statistics.atvr + 0.5f);
+    }
+    return report;
+}
+
+void print(const char* name, const CacheReport& report)
+{
+    const double acmr = report.triangleCount > 0 ? static_cast<double>(report.transformedVertexCount) / static_cast<double>(report.triangleCount) : 0.0;
+    const double atvr = report.usedVertexCount > 0 ? static_cast<double>(report.transformedVertexCount) / static_cast<double>(report.usedVertexCount) : 0.0;
+    std::cout << name << ": ACMR " << std::fixed << std::setprecision(3) << acmr << ", ATVR " << atvr << '\n';
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path meshPath = argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::path(GE_BENCHMARK_RESOURCE_DIR) / "chess_set" / "chess_set.gltf";
+    if (!std::filesystem::is_regular_file(meshPath))
+    {
+        std::cerr << "mesh not found: " << meshPath << '\n';
+        return 1;
+    }
+
+    const GE::MeshData imported = GE::importMesh(meshPath);
+
+    const auto start = std::chrono::steady_clock::now();
+    const GE::MeshData optimized = GE::cookMesh(imported, GE::MeshCookOptions{ .vertexFormat = GE::VertexFormat::full, .optimize = true });
+    const auto optimizedEnd = std::chrono::steady_clock::now();
+    const GE::MeshData unoptimized = GE::cookMesh(imported, GE::MeshCookOptions{ .vertexFormat = GE::VertexFormat::full, .optimize = false });
+    const auto unoptimizedEnd = std::chrono::steady_clock::now();
+
+    std::cout << "mesh: " << meshPath.string() << '\n';
+    for (uint32_t cacheSize : { 16u, 32u })
+    {
+        std::cout << "FIFO cache of " << cacheSize << " vertices\n";
+        print("  imported ", cacheReport(unoptimized, cacheSize));
+        print("  optimized", cacheReport(optimized, cacheSize));
+    }
+    const auto milliseconds = [](auto duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+    std::cout << "optimization time: " << milliseconds((optimizedEnd - start) - (unoptimizedEnd - optimizedEnd)) << " ms\n";
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * ---------------------------------------------------
+ * TextureCook_benchmark.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Compare the load time of a texture decoded with stb_image with the load
+ * time of its cooked version for each format, and report the size of the
+ * cooked mip chain and the PSNR of its full resolution mip over the 4
+ * channels, BC1 and BC5 drop the alpha and blue channels.
+ *
+ * usage: TextureCook_benchmark [texture path] [iterations]
+ *
+ */
+
+#include "Game-Engine/TextureData.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+template<typename F>
+double averageMilliseconds(int iterations, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        f();
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / iterations;
+}
+
+double psnr(std::span<const std::byte> reference, std::span<const std::byte> decoded)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < reference.size(); i++)
+    {
+        const double difference = static_cast<double>(reference[i]) - static_cast<double>(decoded[i]);
+        sum += difference * difference;
+    }
+    const double mse = sum / static_cast<double>(reference.size());
+    return mse == 0.0 ? INFINITY : 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path texturePath = argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::path(GE_BENCHMARK_RESOURCE_DIR) / "chess_set" / "textures" / "chess_set_board_diff_1k.jpg";
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+    const std::filesystem::path cacheDirectory = std::filesystem::temp_directory_path() / "GE_TextureCook_benchmark";
+
+    if (!std::filesystem::is_regular_file(texturePath))
+    {
+        std::cerr << "texture not found: " << texturePath << '\n';
+        return 1;
+    }
+
+    GE::TextureData source;
+    double decode = averageMilliseconds(iterations, [&]() { source = GE::importTexture(texturePath); });
+
+    std::cout << "texture:  " << texturePath.string() << " (" << source.width() << "x" << source.height() << ")\n";
+    std::cout << "decode:   " << decode << " ms (stb_image, single mip)\n";
+
+    const std::vector<std::pair<GE::TextureFormat, std::string>> formats = {
+        { GE::TextureFormat::rgba8, "rgba8" },
+        { GE::TextureFormat::bc1, "bc1" },
+        { GE::TextureFormat::bc3, "bc3" },
+        { GE::TextureFormat::bc5, "bc5" },
+        { GE::TextureFormat::bc7, "bc7" },
+    };
+    for (const auto& [format, name] : formats)
+    {
+        const GE::TextureCookOptions options = { .format = format };
+        std::filesystem::remove_all(cacheDirectory);
+
+        double cook = averageMilliseconds(1, [&]() { GE::loadTextureData(texturePath, cacheDirectory, options); });
+
+        size_t bytes = 0;
+        GE::TextureData cooked;
+        double warm = averageMilliseconds(iterations, [&]() {
+            cooked = GE::loadTextureData(texturePath, cacheDirectory, options);
+            // touch the data so the mapped pages are actually read
+            volatile uint8_t sum = 0;
+            bytes = 0;
+            for (const GE::TextureData::Mip& mip : cooked.mips)
+            {
+                for (std::byte byte : mip.bytes)
+                    sum = sum + static_cast<uint8_t>(byte);
+                bytes += mip.bytes.size();
+            }
+        });
+
+        std::cout << name << ":\t cook " << cook << " ms, warm " << warm << " ms, "
+                  << cooked.mips.size() << " mips " << bytes / 1024 << " KiB, "
+                  << "psnr " << psnr(source.mips.front().bytes, GE::decodeMip(cooked, 0)) << " dB\n";
+    }
+
+    std::filesystem::remove_all(cacheDirectory);
+    return 0;
+}
@@ -100,6 +100,8 @@ Editor::Editor(int argc, char* argv[])
 
     if (std::filesystem::exists(m_project.scriptLib()))
         reloadScriptLib();
+
+    watchResourceDir();
 }
 
 void Editor::onUpdate()
@@ -117,6 +119,9 @@ void Editor::onUpdate()
         }
     }
 
+    // used by the picking in the viewport
+    (m_game.has_value() ? m_game->activeScene() : m_editedScene.second).updateSpatialIndex();
+
     renderImgui();
 
     if (ImGui::GetIO().WantSaveIniSettings)
@@ -148,10 +153,20 @@ void Editor::loadProject(const std::filesystem::path& path)
     if (std::filesystem::exists(m_project.scriptLib()))
         reloadScriptLib();
 
+    watchResourceDir();
+
     m_selectedEntity = {};
     m_editorCamera = {};
 }
 
+void Editor::watchResourceDir()
+{
+    if (std::filesystem::is_directory(m_project.resourceDir()))
+        assetManager().enableHotReload(m_project.resourceDir());
+    else
+        assetManager().disableHotReload();
+}
+
 void Editor::saveEditedScene()
 {
     m_project.setScene(m_editedScene.first, m_editedScene.second.makeDescriptor());
@@ -52,6 +52,7 @@ private:
     void saveEditedScene();
     void saveProject();
     void reloadScriptLib();
+    void watchResourceDir();
     void startGame();
     void stopGame();
 
@@ -8,6 +8,9 @@
 
 #include "Editor.hpp"
 
+#include "Game-Engine/AssetManager.hpp"
+#include "Game-Engine/AssetStatistics.hpp"
+#include "Game-Engine/Culling.hpp"
 #include "Game-Engine/ECSView.hpp"
 #include "Game-Engine/Entity.hpp"
 #include "Game-Engine/InputFwd.hpp"
@@ -16,17 +19,24 @@
 
 #include "imgui.h"
 
+#include <glm/glm.hpp>
+
 #include <algorithm>
 #include <array>
 #include <concepts>
 #include <cstddef>
 #include <filesystem>
+#include <format>
+#include <fstream>
 #include <functional>
 #include <numbers>
+#include <optional>
 #include <ranges>
+#include <string>
 #include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 constexpr float TILE_SIZE = 60.0f;
 
@@ -35,6 +45,16 @@ namespace
 
 using MenuItem = std::pair<std::string_view, std::function<void()>>;
 
+// from the near plane to the far plane, through a point of the viewport in normalized device coordinates
+GE::Ray viewportRay(const glm::mat4& viewProjectionMatrix, const glm::vec2& ndc)
+{
+    const glm::mat4 inverseViewProjection = glm::inverse(viewProjectionMatrix);
+    const glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndc, -1.0f, 1.0f);
+    const glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndc, 1.0f, 1.0f);
+    const glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+    return GE::Ray{ .origin = origin, .direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin) };
+}
+
 template<typename T>
 concept MenuItemRange = std::ranges::range<T> && std::same_as<std::ranges::range_value_t<T>, MenuItem>;
 
@@ -406,6 +426,126 @@ void sceneGrapRow(GE::Entity& entity, GE::Entity& selectedEntity)
         }
 }
 
+template<typename T>
+void statisticRow(const char* label, const T& value)
+{
+    propertyRow(label, [&] { ImGui::TextUnformatted(std::format("{}", value).c_str()); });
+}
+
+void durationHistogramRow(const char* label, const GE::DurationHistogram& histogram)
+{
+    propertyRow(label, [&] {
+        ImGui::TextUnformatted(std::format("mean {} us, p50 {} us, p90 {} us, p99 {} us, max {} us", histogram.mean().count(), histogram.percentile(0.5).count(),
+                                           histogram.percentile(0.9).count(), histogram.percentile(0.99).count(), histogram.max().count()).c_str());
+    });
+}
+
+void assetStatisticsWindow(GE::AssetManager& assetManager)
+{
+    static std::filesystem::path savedJsonPath;
+
+    const GE::AssetStatistics statistics = assetManager.statistics();
+
+    if (ImGui::Button("Reset"))
+        assetManager.resetStatistics();
+    ImGui::SameLine();
+    if (ImGui::Button("Save JSON"))
+    {
+        savedJsonPath = std::filesystem::temp_directory_path() / "asset_statistics.json";
+        std::ofstream(savedJsonPath) << statistics.toJson();
+    }
+    if (!savedJsonPath.empty())
+    {
+        ImGui::SameLine();
+        ImGui::TextDisabled("%s", savedJsonPath.string().c_str());
+    }
+
+    if (ImGui::CollapsingHeader("Counters", ImGuiTreeNodeFlags_DefaultOpen) && beginPropertyTable("asset_counters_table"))
+    {
+        statisticRow("Loads", statistics.loadCount);
+        statisticRow("Reloads", statistics.reloadCount);
+        statisticRow("Failed loads", statistics.failedLoadCount);
+        statisticRow("Unloads", statistics.unloadCount);
+        statisticRow("Evictions", statistics.evictionCount);
+        statisticRow("Read bytes", statistics.readBytes);
+        statisticRow("Resident bytes", statistics.residencyBudget > 0 ? std::format("{} / {}", statistics.residentBytes, statistics.residencyBudget)
+                                                                      : std::format("{}", statistics.residentBytes));
+        statisticRow("Pending reads", statistics.pendingReadCount);
+        statisticRow("Reloading", statistics.reloadingCount);
+        statisticRow("Unreferenced", statistics.unreferencedCount);
+        statisticRow("Deferred streaming", statistics.deferredStreamingRequestCount);
+        ImGui::EndTable();
+    }
+
+    if (ImGui::CollapsingHeader("Types", ImGuiTreeNodeFlags_DefaultOpen) && ImGui::BeginTable("asset_types_table", 5, ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_RowBg))
+    {
+        for (const char* column : { "Type", "Registered", "Loading", "Loaded", "Resident bytes" })
+            ImGui::TableSetupColumn(column);
+        ImGui::TableHeadersRow();
+        for (const auto& [type, typeStatistics] : statistics.types)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::TextUnformatted(type.c_str());
+            ImGui::TableSetColumnIndex(1);
+            ImGui::Text("%u", typeStatistics.assetCount);
+            ImGui::TableSetColumnIndex(2);
+            ImGui::Text("%u", typeStatistics.loadingCount);
+            ImGui::TableSetColumnIndex(3);
+            ImGui::Text("%u", typeStatistics.loadedCount);
+            ImGui::TableSetColumnIndex(4);
+            ImGui::TextUnformatted(std::to_string(typeStatistics.residentBytes).c_str());
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::CollapsingHeader("Timings", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        if (beginPropertyTable("asset_timings_table"))
+        {
+            durationHistogramRow("Read", statistics.readTimes);
+            durationHistogramRow("Decode", statistics.decodeTimes);
+            durationHistogramRow("Upload", statistics.uploadTimes);
+            durationHistogramRow("Load", statistics.loadTimes);
+            ImGui::EndTable();
+        }
+        // one bar per power of two microseconds
+        std::vector<float> buckets(statistics.loadTimes.buckets().begin(), statistics.loadTimes.buckets().end());
+        ImGui::PlotHistogram("##load_times", buckets.data(), static_cast<int>(buckets.size()), 0, "load times (log2 us)", 0.0f, FLT_MAX, ImVec2(-FLT_MIN, 80.0f));
+    }
+
+    if (ImGui::CollapsingHeader("Last loads") && ImGui::BeginTable("asset_records_table", 6, ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0.0f, 300.0f)))
+    {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        for (const char* column : { "Path", "Type", "Read us", "Decode us", "Upload us", "Source bytes" })
+            ImGui::TableSetupColumn(column);
+        ImGui::TableHeadersRow();
+        // most recent first
+        for (auto it = statistics.records.rbegin(); it != statistics.records.rend(); ++it)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            if (it->failed)
+                ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s (failed)", it->path.filename().string().c_str());
+            else
+                ImGui::Text("%s%s", it->path.filename().string().c_str(), it->reload ? " (reload)" : "");
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("%s", it->path.string().c_str());
+            ImGui::TableSetColumnIndex(1);
+            ImGui::TextUnformatted(it->type.data(), it->type.data() + it->type.size());
+            ImGui::TableSetColumnIndex(2);
+            ImGui::TextUnformatted(std::to_string(it->readTime.count()).c_str());
+            ImGui::TableSetColumnIndex(3);
+            ImGui::TextUnformatted(std::to_string(it->decodeTime.count()).c_str());
+            ImGui::TableSetColumnIndex(4);
+            ImGui::TextUnformatted(std::to_string(it->uploadTime.count()).c_str());
+            ImGui::TableSetColumnIndex(5);
+            ImGui::TextUnformatted(std::to_string(it->sourceBytes).c_str());
+        }
+        ImGui::EndTable();
+    }
+}
+
 }
 
 namespace GE_Editor
@@ -455,6 +595,18 @@ void Editor::renderImgui()
 
         ImGui::Image(&textureIdPlaceholder, contentRegionAvai);
 
+        // a click selects the closest entity under the cursor
+        const ImVec2 imageSize = ImGui::GetItemRectSize();
+        if (m_game.has_value() == false && ImGui::IsItemClicked(ImGuiMouseButton_Left) && imageSize.x > 0 && imageSize.y > 0)
+        {
+            const ImVec2 imagePos = ImGui::GetItemRectMin();
+            const ImVec2 mousePos = ImGui::GetMousePos();
+            const glm::vec2 ndc(2.0f * (mousePos.x - imagePos.x) / imageSize.x - 1.0f, 1.0f - 2.0f * (mousePos.y - imagePos.y) / imageSize.y);
+            GE::Scene& scene = m_editedScene.second;
+            if (std::optional<uint64_t> entityId = scene.spatialIndex().closestHit(viewportRay(m_editorCamera.viewProjectionMatrix(imageSize.x / imageSize.y), ndc)))
+                m_selectedEntity = GE::Entity{ &scene.ecsWorld(), *entityId };
+        }
+
         if (newWidth != m_viewportSize.first || newHeight != m_viewportSize.second) {
             m_viewportSize = {newWidth, newHeight};
             rebuildFrameGraph();
@@ -622,6 +774,10 @@ void Editor::renderImgui()
     }
     ImGui::End();
 
+    if (ImGui::Begin("Assets"))
+        assetStatisticsWindow(assetManager());
+    ImGui::End();
+
     if (projectPropertiesOpen)
     {
         ImGuiViewport* viewport = ImGui::GetMainViewport();
@@ -0,0 +1,206 @@
+/*
+ * ---------------------------------------------------
+ * AabbTree.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Dynamic bounding volume hierarchy of axis aligned boxes. The leaves are
+ * inserted where they increase the surface of the tree the least and the
+ * tree is kept balanced by rotations, so the leaves can move one by one.
+ * The leaf boxes are fattened by a margin, small moves stay inside of it
+ * and do not touch the tree. When most of the leaves move every frame the
+ * boxes can also be replaced in place and the tree refitted, or the whole
+ * tree rebuilt.
+ *
+ */
+
+#ifndef AABBTREE_HPP
+#define AABBTREE_HPP
+
+#include "Game-Engine/Culling.hpp"
+#include "Game-Engine/Export.hpp"
+#include "Game-Engine/MeshLod.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace GE
+{
+
+class GE_API AabbTree
+{
+public:
+    using NodeID = uint32_t;
+    static constexpr NodeID INVALID_NODE_ID = UINT32_MAX;
+    static constexpr float DEFAULT_MARGIN = 0.1f;
+
+    AabbTree(const AabbTree&) = default;
+    AabbTree(AabbTree&&) = default;
+
+    explicit AabbTree(float margin = DEFAULT_MARGIN);
+
+    // the box must not be empty, the returned id is kept until the leaf is removed, rebuilds included
+    NodeID insert(const BoundingBox&, uint64_t userData);
+    void remove(NodeID);
+
+    // the leaf is only reinserted if the box leaves its fattened box, true if it was
+    bool move(NodeID, const BoundingBox&);
+
+    // replace the box without changing the tree, the ancestors are updated by `refit`
+    // which must be called before the next query
+    void setBox(NodeID, const BoundingBox&);
+    void refit();
+
+    // rebuild the internal nodes from the leaves, top down
+    void rebuild();
+
+    void clear();
+
+    inline const BoundingBox& box(NodeID id) const { return m_nodes[id].leafBox; }
+    inline uint64_t userData(NodeID id) const { return m_nodes[id].userData; }
+
+    inline uint32_t size() const { return m_leafCount; }
+    inline uint32_t height() const { return m_root == INVALID_NODE_ID ? 0 : static_cast<uint32_t>(m_nodes[m_root].height); }
+
+    // sum of the surfaces of the internal nodes over the surface of the root, lower gives faster queries
+    float surfaceAreaRatio() const;
+
+    // `fn(userData)` for each leaf overlapping the shape, in no particular order
+    template<typename Fn> void query(const BoundingBox&, Fn&& fn) const;
+    template<typename Fn> void query(const BoundingSphere&, Fn&& fn) const;
+    template<typename Fn> void query(const Frustum&, Fn&& fn) const;
+
+    // `fn(userData, distance)` for each leaf the ray enters before `maxDistance`, in no particular order
+    template<typename Fn> void query(const Ray&, float maxDistance, Fn&& fn) const;
+
+    // user data of the leaf the ray enters first
+    std::optional<uint64_t> closestHit(const Ray&, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+    ~AabbTree() = default;
+
+private:
+    struct Node
+    {
+        BoundingBox box;     // fattened for a leaf, containing the children otherwise
+        BoundingBox leafBox; // the box of the leaf, not fattened
+        NodeID parent = INVALID_NODE_ID; // next free node when the node is free
+        std::array<NodeID, 2> children = { INVALID_NODE_ID, INVALID_NODE_ID };
+        int32_t height = 0; // 0 for a leaf, -1 for a free node
+        uint64_t userData = 0;
+
+        inline bool isLeaf() const { return children[0] == INVALID_NODE_ID; }
+    };
+
+    // nodes still to visit during a query, on the stack unless the tree is very unbalanced
+    class NodeStack
+    {
+    public:
+        inline bool empty() const { return m_size == 0; }
+        inline NodeID pop() { return m_nodes[--m_size]; }
+        inline void push(NodeID id)
+        {
+            if (m_size == m_capacity)
+                grow();
+            m_nodes[m_size++] = id;
+        }
+
+    private:
+        void grow();
+
+        std::array<NodeID, 64> m_inlineNodes;
+        std::vector<NodeID> m_heapNodes;
+        NodeID* m_nodes = m_inlineNodes.data();
+        uint32_t m_size = 0;
+        uint32_t m_capacity = 64;
+    };
+
+    template<typename NodeTest, typename LeafFn>
+    void traverse(NodeTest&& nodeTest, LeafFn&& onLeaf) const;
+
+    NodeID allocateNode();
+    void freeNode(NodeID);
+
+    void insertLeaf(NodeID);
+    void removeLeaf(NodeID);
+    NodeID balance(NodeID);
+    void updateFromChildren(NodeID);
+    struct BuildLeaf
+    {
+        uint32_t mortonCode;
+        NodeID id;
+    };
+    NodeID buildTopDown(std::vector<BuildLeaf>::const_iterator first, std::vector<BuildLeaf>::const_iterator last);
+
+    float m_margin;
+    std::vector<Node> m_nodes;
+    NodeID m_root = INVALID_NODE_ID;
+    NodeID m_freeList = INVALID_NODE_ID;
+    uint32_t m_leafCount = 0;
+    std::vector<NodeID> m_refitLeaves;
+
+public:
+    AabbTree& operator=(const AabbTree&) = default;
+    AabbTree& operator=(AabbTree&&) = default;
+};
+
+template<typename NodeTest, typename LeafFn>
+void AabbTree::traverse(NodeTest&& nodeTest, LeafFn&& onLeaf) const
+{
+    assert(m_refitLeaves.empty()); // `refit` must be called after `setBox`
+    if (m_root == INVALID_NODE_ID)
+        return;
+    NodeStack stack;
+    stack.push(m_root);
+    while (stack.empty() == false)
+    {
+        const Node& node = m_nodes[stack.pop()];
+        if (node.isLeaf())
+        {
+            if (nodeTest(node.leafBox))
+                onLeaf(node);
+        }
+        else if (nodeTest(node.box))
+        {
+            stack.push(node.children[0]);
+            stack.push(node.children[1]);
+        }
+    }
+}
+
+template<typename Fn>
+void AabbTree::query(const BoundingBox& box, Fn&& fn) const
+{
+    traverse([&](const BoundingBox& nodeBox) { return overlaps(nodeBox, box); },
+             [&](const Node& leaf) { fn(leaf.userData); });
+}
+
+template<typename Fn>
+void AabbTree::query(const BoundingSphere& sphere, Fn&& fn) const
+{
+    traverse([&](const BoundingBox& nodeBox) { return overlaps(nodeBox, sphere); },
+             [&](const Node& leaf) { fn(leaf.userData); });
+}
+
+template<typename Fn>
+void AabbTree::query(const Frustum& frustum, Fn&& fn) const
+{
+    traverse([&](const BoundingBox& nodeBox) { return isBoxInFrustum(frustum, nodeBox); },
+             [&](const Node& leaf) { fn(leaf.userData); });
+}
+
+template<typename Fn>
+void AabbTree::query(const Ray& ray, float maxDistance, Fn&& fn) const
+{
+    std::optional<float> leafDistance;
+    traverse([&](const BoundingBox& nodeBox) { return (leafDistance = rayBoxDistance(ray, nodeBox, maxDistance)).has_value(); },
+             [&](const Node& leaf) { fn(leaf.userData, *leafDistance); });
+}
+
+} // namespace GE
+
+#endif // AABBTREE_HPP
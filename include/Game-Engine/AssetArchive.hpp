@@ -0,0 +1,129 @@
+/*
+ * ---------------------------------------------------
+ * AssetArchive.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Single file holding the cooked assets of a project, to ship it without
+ * the thousands of source files. The archive starts with a table of
+ * contents sorted by asset type and path, followed by the cooked files
+ * aligned on pages. It is memory mapped and the uncompressed entries are
+ * read in place, the LZ4 compressed ones are decompressed on read.
+ *
+ */
+
+#ifndef ASSETARCHIVE_HPP
+#define ASSETARCHIVE_HPP
+
+#include "Game-Engine/Export.hpp"
+#include "Game-Engine/MappedFile.hpp"
+#include "Game-Engine/MeshData.hpp"
+#include "Game-Engine/TextureData.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace GE
+{
+
+constexpr size_t ASSET_ARCHIVE_BLOB_ALIGNMENT = 4096;
+
+enum class ArchiveCompression : uint8_t
+{
+    none,
+    lz4
+};
+
+class GE_API AssetArchive
+{
+public:
+    struct Entry
+    {
+        std::string_view type; // AssetPathYamlTraits name of the asset type
+        std::string_view path; // generic path, relative to the archived directory
+        uint64_t key;          // of the cooked file
+        uint64_t offset;
+        uint64_t size;
+        uint64_t uncompressedSize;
+        ArchiveCompression compression;
+    };
+
+    // the bytes of an entry and their owner
+    struct Blob
+    {
+        std::shared_ptr<const void> storage;
+        std::span<const std::byte> bytes;
+    };
+
+public:
+    AssetArchive() = delete;
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive(AssetArchive&&) = delete;
+
+    explicit AssetArchive(const std::filesystem::path&); // throw std::runtime_error if the file is not a valid archive
+
+    // nullptr if the archive has no such asset
+    const Entry* find(std::string_view type, const std::filesystem::path& path) const;
+
+    // a view of the mapping for an uncompressed entry, throw std::runtime_error if a compressed entry is corrupted
+    Blob read(const Entry&) const;
+
+    inline std::span<const Entry> entries() const { return m_entries; }
+    inline const std::filesystem::path& path() const { return m_path; }
+
+    ~AssetArchive() = default;
+
+private:
+    std::filesystem::path m_path;
+    std::shared_ptr<MappedFile> m_file;
+    std::vector<Entry> m_entries; // sorted by type and path
+
+public:
+    AssetArchive& operator=(const AssetArchive&) = delete;
+    AssetArchive& operator=(AssetArchive&&) = delete;
+};
+
+class GE_API AssetArchiveWriter
+{
+public:
+    // a compressed entry is stored uncompressed if the compression does not make it smaller
+    void add(std::string_view type, const std::filesystem::path& path, uint64_t key, std::span<const std::byte> cookedFile, ArchiveCompression = ArchiveCompression::none);
+
+    // Cook and add the meshes and textures found in the directory tree, recognized by their extension,
+    // with their path relative to `directory`. The files are cooked in parallel, the ones failing to
+    // cook are skipped and returned.
+    std::vector<std::filesystem::path> addDirectory(const std::filesystem::path& directory, ArchiveCompression = ArchiveCompression::lz4,
+                                                    const MeshCookOptions& = MeshCookOptions{}, const TextureCookOptions& = TextureCookOptions{});
+
+    inline size_t entryCount() const { return m_entries.size(); }
+
+    // the file is written next to its destination then renamed, throw std::runtime_error on failure
+    void write(const std::filesystem::path&) const;
+
+private:
+    struct Entry
+    {
+        std::string type;
+        std::string path;
+        uint64_t key;
+        uint64_t uncompressedSize;
+        ArchiveCompression compression;
+        std::vector<std::byte> bytes;
+    };
+
+    static Entry makeEntry(std::string_view type, const std::filesystem::path&, uint64_t key, std::span<const std::byte> cookedFile, ArchiveCompression);
+    void insert(Entry);
+
+    std::vector<Entry> m_entries;
+};
+
+} // namespace GE
+
+#endif // ASSETARCHIVE_HPP
@@ -10,8 +10,18 @@
 #ifndef ASSETMANAGER_HPP
 #define ASSETMANAGER_HPP
 
+#include "Game-Engine/AssetArchive.hpp"
+#include "Game-Engine/AssetStatistics.hpp"
+#include "Game-Engine/AssetStreamer.hpp"
+#include "Game-Engine/AsyncFileReader.hpp"
 #include "Game-Engine/Export.hpp"
+#include "Game-Engine/FileWatcher.hpp"
+#include "Game-Engine/GeometryPool.hpp"
+#include "Game-Engine/Hash.hpp"
 #include "Game-Engine/Mesh.hpp"
+#include "Game-Engine/MeshData.hpp"
+#include "Game-Engine/ShardedMap.hpp"
+#include "Game-Engine/TextureData.hpp"
 #include "Game-Engine/TypeList.hpp"
 
 #include <Graphics/Device.hpp>
@@ -22,14 +32,22 @@
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <future>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <ranges>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <string_view>
 #include <type_traits>
 #include <utility>
@@ -79,24 +97,133 @@ using AssetPathType = AssetPath<AssetT>;
 using AssetPathTypes = ManagableAssetTypes::wrapped<AssetPathType>;
 using VAssetPath = AssetPathTypes::into<std::variant>;
 
+struct VAssetPathHash
+{
+    inline size_t operator()(const VAssetPath& vAssetPath) const {
+        return std::visit([&](const auto& assetPath) {
+            return static_cast<size_t>(hashCombine(vAssetPath.index(), std::filesystem::hash_value(assetPath.path)));
+        },
+        vAssetPath);
+    }
+};
+
+// The loading of an asset, get() waits for it and rethrows its error like a shared_future,
+// but returns a copy of the asset current at the call, the hot reload and the streaming
+// replace it while other threads hold the previous one.
+template<ManagableAsset T>
+class AssetFuture
+{
+public:
+    AssetFuture() = default;
+    AssetFuture(std::shared_future<void> loaded, const std::shared_ptr<T>* asset, std::mutex* mutex)
+        : m_loaded(std::move(loaded)), m_asset(asset), m_mutex(mutex)
+    {
+    }
+
+    inline bool valid() const { return m_loaded.valid(); }
+    inline void wait() const { m_loaded.wait(); }
+
+    template<typename Rep, typename Period>
+    inline std::future_status wait_for(const std::chrono::duration<Rep, Period>& duration) const { return m_loaded.wait_for(duration); }
+
+    inline std::shared_ptr<T> get() const {
+        m_loaded.get();
+        std::scoped_lock lock(*m_mutex);
+        return *m_asset;
+    }
+
+private:
+    std::shared_future<void> m_loaded;
+    const std::shared_ptr<T>* m_asset = nullptr;
+    std::mutex* m_mutex = nullptr; // guards the asset
+};
+
 template<typename T>
 concept VAssetPathRange = std::ranges::range<T> && std::is_same_v<std::ranges::range_value_t<T>, VAssetPath>;
 
+// Registration, lookups and loads can be done from any thread, to deserialize a
+// scene or register assets from scripts on worker threads. Retaining, releasing and
+// unloading are thread safe too. The hot reload, the streaming requests and endFrame
+// are for the thread rendering the frames, the assets they replace stay alive in the
+// other threads, which are handed copies of the shared pointers.
 class GE_API AssetManager
 {
+public:
+    struct LoadProgress
+    {
+        uint32_t assetCount = 0;
+        uint32_t loadedAssetCount = 0;
+        size_t sourceBytes = 0;       // size of the source files, a rough estimate of the loading work
+        size_t loadedSourceBytes = 0;
+        size_t residentBytes = 0;     // of the loaded assets
+
+        inline bool isComplete() const { return loadedAssetCount == assetCount; }
+        inline float ratio() const {
+            if (sourceBytes > 0)
+                return static_cast<float>(loadedSourceBytes) / static_cast<float>(sourceBytes);
+            return assetCount > 0 ? static_cast<float>(loadedAssetCount) / static_cast<float>(assetCount) : 1.0f;
+        }
+    };
+
+    struct DeduplicationStatistics
+    {
+        uint32_t registeredPathCount = 0;
+        uint32_t uniqueAssetCount = 0;
+        size_t savedBytes = 0; // by the loaded assets registered with several paths, each would have been loaded once per path
+    };
+
 public:
     AssetManager() = delete;
     AssetManager(const AssetManager&) = delete;
     AssetManager(AssetManager&&) = delete;
 
-    AssetManager(gfx::Device*);
+    // cooked meshes and textures are stored in the cache directories, an empty path disable the cache
+    AssetManager(gfx::Device*,
+                 std::filesystem::path meshCacheDirectory = defaultMeshCacheDirectory(), MeshCookOptions = MeshCookOptions{},
+                 std::filesystem::path textureCacheDirectory = defaultTextureCacheDirectory(), TextureCookOptions = TextureCookOptions{});
 
+    // Paths resolving to the same file, relative or absolute or through symlinks, share
+    // one asset. With the content deduplication, identical texture files share one too.
     void registerAsset(const VAssetPath&);
 
+    // only affects the assets registered after the call, each texture source is read to be hashed
+    inline void setContentDeduplication(bool enabled) { m_contentDeduplication.store(enabled); }
+    inline bool contentDeduplication() const { return m_contentDeduplication.load(); }
+
+    DeduplicationStatistics deduplicationStatistics() const;
+
+    // The assets registered after the call and found in the archive are loaded from it instead of
+    // their source. They are looked up by their path relative to `root`, the directory the archive
+    // was packed from. The archives mounted last take precedence. Throw std::runtime_error if the
+    // archive is invalid.
+    void mountArchive(const std::filesystem::path& archive, const std::filesystem::path& root);
+
+    // `asset` uses `dependency`, like a material its textures. Loading or retaining an asset
+    // loads or retains its dependencies too. Both must be registered, a cycle throws std::runtime_error.
+    void addAssetDependency(const VAssetPath& asset, const VAssetPath& dependency);
+
+    // a copy, an other thread can add dependencies meanwhile
+    std::vector<VAssetPath> assetDependencies(const VAssetPath&) const;
+
+    // the assets and their transitive dependencies, each once, the dependencies before the assets using them
+    std::vector<VAssetPath> dependencyClosure(VAssetPathRange auto&& vAssetPaths) const {
+        std::vector<VAssetPath> closure;
+        std::set<const VAssetHandle*> visited;
+        for (const VAssetPath& vAssetPath : vAssetPaths)
+            appendDependencyClosure(vAssetPath, visited, closure);
+        return closure;
+    }
+
     template<ManagableAsset T>
-    inline const std::shared_future<const std::shared_ptr<T>&>& loadAsset(const VAssetPath& vAssetPath) { return loadAssetHandle<T>(m_handles.at(vAssetPath)); }
+    inline AssetFuture<T> loadAsset(const VAssetPath& vAssetPath) {
+        loadAssetDependencies(vAssetPath);
+        return loadAssetHandle<T>(assetHandle(vAssetPath));
+    }
 
+    // the sources of the assets and of their dependencies are read in a single batch
     std::future<void> loadAssets(VAssetPathRange auto&& vAssetPaths) {
+        readAssetSources(dependencyClosure(vAssetPaths));
+
         std::vector<std::future<void>> futures;
         if constexpr (std::ranges::sized_range<std::remove_cvref_t<decltype(vAssetPaths)>>)
             futures.reserve(std::ranges::size(vAssetPaths));
@@ -105,8 +232,7 @@ public:
         {
             std::visit([&](const auto& assetPath) {
                 using AssetType = typename std::remove_cvref_t<decltype(assetPath)>::AssetType;
-                const auto& future = loadAsset<AssetType>(vAssetPath);
-                futures.push_back(std::async(std::launch::deferred, [future = future]() { future.get(); }));
+                futures.push_back(std::async(std::launch::deferred, [future = loadAsset<AssetType>(vAssetPath)]() { future.get(); }));
             },
             vAssetPath);
         }
@@ -116,9 +242,9 @@ public:
         });
     }
 
-    inline const std::shared_future<const std::shared_ptr<Mesh>&>& loadBuiltInCube() { return loadAssetHandle<Mesh>(m_builtInCubeHandle); }
+    inline AssetFuture<Mesh> loadBuiltInCube() { return loadAssetHandle<Mesh>(m_builtInCubeHandle); }
 
-    inline bool isAssetLoaded(const VAssetPath& vAssetPath) const { return isAssetHandleLoaded(m_handles.at(vAssetPath)); }
+    inline bool isAssetLoaded(const VAssetPath& vAssetPath) const { return isAssetHandleLoaded(assetHandle(vAssetPath)); }
 
     bool areAssetsLoaded(VAssetPathRange auto&& vAssetPaths) const {
         return std::ranges::all_of(vAssetPaths, [this](const VAssetPath& vAssetPath) {
@@ -128,7 +254,27 @@ public:
 
     inline bool isBuiltInCubeLoaded() const { return isAssetHandleLoaded(m_builtInCubeHandle); }
 
-    inline void unloadAsset(const VAssetPath& vAssetPath) { unloadAssetHandle(m_handles.at(vAssetPath)); }
+    // progress of the loading of the assets and their dependencies, to be polled while they are loading
+    LoadProgress loadProgress(VAssetPathRange auto&& vAssetPaths) const {
+        LoadProgress progress;
+        for (const VAssetPath& vAssetPath : dependencyClosure(vAssetPaths))
+        {
+            std::visit([&](const auto& handle) {
+                progress.assetCount++;
+                progress.sourceBytes += handle.sourceByteSize;
+                if (handle.status.load() == AssetHandleLoadingStatus::loaded)
+                {
+                    progress.loadedAssetCount++;
+                    progress.loadedSourceBytes += handle.sourceByteSize;
+                    progress.residentBytes += handle.streamable ? handle.streamable->residentBytes() : handle.byteSize;
+                }
+            },
+            assetHandle(vAssetPath));
+        }
+        return progress;
+    }
+
+    inline void unloadAsset(const VAssetPath& vAssetPath) { unloadAssetHandle(assetHandle(vAssetPath)); }
 
     void unloadAssets(VAssetPathRange auto&& vAssetPaths) {
         for (const VAssetPath& vAssetPath : vAssetPaths)
@@ -138,7 +284,78 @@ public:
     inline void unloadBuiltInCube() { unloadAssetHandle(m_builtInCubeHandle); }
 
     template<ManagableAsset T>
-    inline const std::shared_ptr<T>& getAsset(VAssetPath& vAssetPath) { return loadAsset<T>(vAssetPath).get(); }
+    inline std::shared_ptr<T> getAsset(VAssetPath& vAssetPath) { return loadAsset<T>(vAssetPath).get(); }
+
+    // References held by the AssetManagerViews, an asset left without reference
+    // stays loaded in a least recently released list, and is only unloaded when the
+    // resident assets exceed the residency budget. Unlike unloadAsset, releasing an
+    // asset never unloads it while an other view still uses it.
+    void retainAsset(const VAssetPath&);
+    void releaseAsset(const VAssetPath&);
+    inline void retainBuiltInCube() { retainAssetHandle(m_builtInCubeHandle); }
+    inline void releaseBuiltInCube() { releaseAssetHandle(m_builtInCubeHandle); }
+
+    inline uint32_t assetReferenceCount(const VAssetPath& vAssetPath) const {
+        std::scoped_lock lock(m_residencyMutex);
+        return std::visit([](const auto& handle) { return handle.referenceCount; }, assetHandle(vAssetPath));
+    }
+
+    // 0 unloads the unreferenced assets as soon as their loading is done
+    inline void setResidencyBudget(size_t bytes) {
+        std::scoped_lock lock(m_residencyMutex);
+        m_residencyBudget = bytes;
+        evictUnreferencedAssets();
+    }
+
+    inline size_t residencyBudget() const {
+        std::scoped_lock lock(m_residencyMutex);
+        return m_residencyBudget;
+    }
+
+    // approximate GPU memory used by the loaded assets, referenced or not
+    inline size_t residentBytes() const { return m_residentBytes.load(); }
+
+    // Per frame upload budget of the streamed assets, 0 disables the streaming. Only the
+    // assets loaded after the call are affected, a streamed asset is loaded with its
+    // coarsest level and refined by the endFrame calls following the requests.
+    inline void setStreamingBudget(size_t bytesPerFrame) { m_streamer.setFrameByteBudget(bytesPerFrame); }
+    inline size_t streamingBudget() const { return m_streamer.frameByteBudget(); }
+
+    // level of detail (mesh) or mip (texture) needed this frame, the most important
+    // requests, with the highest priority, are streamed first
+    void requestStreaming(const VAssetPath&, uint32_t level, float priority = 0.0f);
+
+    inline const AssetStreamer::Statistics& streamingStatistics() const { return m_streamer.statistics(); }
+
+    // Watch the source files of the assets in `directory` and reload the loaded assets whose
+    // source is written. The reloads are cooked in the background and swapped in endFrame,
+    // the previous assets stay valid for the frames still using them.
+    void enableHotReload(const std::filesystem::path& directory);
+    inline void disableHotReload() { m_fileWatcher.reset(); }
+    inline bool isHotReloadEnabled() const { return m_fileWatcher != nullptr; }
+
+    // reload the asset from its source if it is loaded, the reloaded asset is swapped in a later endFrame
+    void reloadAsset(const VAssetPath&);
+
+    // to be called once per rendered frame, swaps the reloaded assets, streams the requested levels
+    // and releases the geometry of the meshes unloaded since then
+    void endFrame();
+
+    inline GeometryPool::Statistics geometryPoolStatistics() const { return m_geometryPool.statistics(); }
+
+    // counters, queue depths and timings of the loads, a snapshot of the assets still loading
+    AssetStatistics statistics() const;
+
+    // the totals, the histograms and the load records start over, to measure a level load alone
+    inline void resetStatistics() { m_loadRecorder.reset(); }
+
+    inline const std::filesystem::path& meshCacheDirectory() const { return m_meshCacheDirectory; }
+
+    static inline std::filesystem::path defaultMeshCacheDirectory() { return std::filesystem::temp_directory_path() / "Game-Engine" / "mesh_cache"; }
+
+    inline const std::filesystem::path& textureCacheDirectory() const { return m_textureCacheDirectory; }
+
+    static inline std::filesystem::path defaultTextureCacheDirectory() { return std::filesystem::temp_directory_path() / "Game-Engine" / "texture_cache"; }
 
     ~AssetManager();
 
@@ -150,41 +367,92 @@ private:
         loaded
     };
 
+    template<ManagableAsset T>
+    struct AssetHandle;
+
+    template<typename AssetT>
+    using AssetHandleType = AssetHandle<AssetT>;
+
+    using AssetHandleTypes = ManagableAssetTypes::wrapped<AssetHandleType>;
+    using VAssetHandle = AssetHandleTypes::into<std::variant>;
+
+    using UnreferencedList = std::list<VAssetHandle*>; // least recently released first
+
+    // set the decode and upload times of the record, and `owner` to the streamable asset
+    // keeping the asset, streamed by the AssetStreamer when `streamed`, compacted by it if it can
+    template<ManagableAsset T>
+    using AssetLoader = std::function<std::shared_ptr<T>(gfx::CommandBuffer&, bool streamed, std::span<const std::byte> sourceContent, AssetLoadRecord&, std::shared_ptr<StreamableAsset>& owner)>;
+
     template<ManagableAsset T>
     struct AssetHandle
     {
         using AssetType = T;
 
-        std::function<std::shared_ptr<T>(gfx::CommandBuffer&)> loader;
+        // set at the registration, then read only
+        AssetPath<T> path; // canonical
+        AssetLoader<T> loader;
+        bool readsSource = false; // the loader decodes the content of the source file, read by the AsyncFileReader
+        size_t sourceByteSize = 0;
+
+        mutable std::mutex mutex; // guards the start of the loading, `source`, `future`, `asset` and `dependencies`
+        std::shared_future<std::vector<std::byte>> source; // read ahead by loadAssets
         std::atomic<AssetHandleLoadingStatus> status = AssetHandleLoadingStatus::unloaded;
-        std::shared_future<const std::shared_ptr<T>&> future;
-        std::shared_ptr<T> asset;
+        std::shared_future<void> future;
+        std::shared_ptr<T> asset; // replaced by the hot reload and the streaming, read from any thread
+        std::shared_ptr<StreamableAsset> streamable;
+        size_t byteSize = 0; // set before the status is loaded, of the coarsest level for a streamed asset
+        uint32_t registrationCount = 0; // registered paths sharing the handle, guarded by the registration mutex
+        std::vector<VAssetPath> dependencies;
+        uint32_t referenceCount = 0; // guarded by the residency mutex, like `unreferencedPosition`
+        std::optional<UnreferencedList::iterator> unreferencedPosition;
+        std::future<std::shared_ptr<T>> reloadedAsset;
+        bool reloadAgain = false; // the source changed again during the reload
     };
 
-    template<typename AssetT>
-    using AssetHandleType = AssetHandle<AssetT>;
+    // a registered path, or the canonical path of a handle, throw std::out_of_range if unregistered
+    VAssetHandle& assetHandle(const VAssetPath& vAssetPath) {
+        if (VAssetHandle* const* vHandle = m_registeredPaths.find(vAssetPath))
+            return **vHandle;
+        // a handle is inserted before its fields are set, the registration lock waits for them
+        std::scoped_lock lock(m_registrationMutex);
+        if (VAssetHandle* vHandle = m_handles.find(vAssetPath))
+            return *vHandle;
+        throw std::out_of_range("unregistered asset");
+    }
 
-    using AssetHandleTypes = ManagableAssetTypes::wrapped<AssetHandleType>;
-    using VAssetHandle = AssetHandleTypes::into<std::variant>;
+    const VAssetHandle& assetHandle(const VAssetPath& vAssetPath) const { return const_cast<AssetManager*>(this)->assetHandle(vAssetPath); }
 
     template<ManagableAsset T>
-    const std::shared_future<const std::shared_ptr<T>&>& loadAssetHandle(VAssetHandle& vHandle) {
+    AssetFuture<T> loadAssetHandle(VAssetHandle& vHandle) {
         auto& handle = std::get<AssetHandle<T>>(vHandle);
+        std::scoped_lock lock(handle.mutex);
         auto expected = AssetHandleLoadingStatus::unloaded;
         if (handle.status.compare_exchange_strong(expected, AssetHandleLoadingStatus::loading))
         {
-            handle.future = std::async(std::launch::async, [device = m_device, handle = &handle]() -> const std::shared_ptr<T>& {
-                std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = device->newCommandBufferPool();
-                assert(commandBufferPool);
-                std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
-                assert(commandBuffer);
-                handle->asset = handle->loader(*commandBuffer);
-                device->submitCommandBuffers(commandBuffer);
+            const bool streamed = m_streamer.frameByteBudget() > 0;
+            std::shared_future<std::vector<std::byte>> source = std::exchange(handle.source, {});
+            if (handle.readsSource && source.valid() == false)
+                source = m_fileReader.read(handle.path.path).share();
+            handle.future = std::async(std::launch::async, [device = m_device, streamer = &m_streamer, residentBytes = &m_residentBytes, recorder = &m_loadRecorder, handle = &handle, streamed, source]() {
+                AssetLoadRecord record = { .type = AssetPathYamlTraits<AssetPath<T>>::name, .path = handle->path.path, .start = recorder->now(), .sourceBytes = handle->sourceByteSize };
+                std::shared_ptr<StreamableAsset> owner;
+                std::shared_ptr<T> asset = runLoader<T>(*device, handle->loader, streamed, source, record, *recorder, owner);
+                if (streamed)
+                    handle->streamable = owner;
+                handle->byteSize = handle->streamable ? handle->streamable->residentBytes() : assetByteSize(*asset);
+                // the compaction moves the data of the asset from the main thread, this one is done reading it
+                if (owner)
+                    streamer->addCompactable(owner);
+                std::unique_lock lock(handle->mutex);
+                handle->asset = std::move(asset);
+                lock.unlock();
+                residentBytes->fetch_add(handle->byteSize);
+                record.residentBytes = handle->byteSize;
+                recorder->record(std::move(record));
                 handle->status.store(AssetHandleLoadingStatus::loaded);
-                return handle->asset;
             });
         }
-        return handle.future;
+        return AssetFuture<T>(handle.future, &handle.asset, &handle.mutex);
     }
 
     bool isAssetHandleLoaded(const VAssetHandle& vHandle) const {
@@ -196,34 +464,82 @@ private:
 
     void unloadAssetHandle(VAssetHandle&);
 
-    static std::shared_ptr<gfx::Buffer> newDeviceLocalBuffer(gfx::Device& device, gfx::CommandBuffer& commandBuffer, gfx::BufferUsage usage, const std::ranges::sized_range auto& data) {
-        std::shared_ptr<gfx::Buffer> indexBuffer = device.newBuffer(gfx::Buffer::Descriptor{
-            .size = sizeof(std::ranges::range_value_t<decltype(data)>) * data.size(),
-            .usages = usage | gfx::BufferUsage::copyDestination,
-            .storageMode = gfx::ResourceStorageMode::deviceLocal });
-        assert(indexBuffer);
+    void readAssetSources(const std::vector<VAssetPath>&);
+
+    // empty for the loaders not reading a source, throw the read error
+    static inline std::span<const std::byte> sourceContent(const std::shared_future<std::vector<std::byte>>& source) {
+        return source.valid() ? std::span<const std::byte>(source.get()) : std::span<const std::byte>();
+    }
+
+    // run by the loading threads, the record is completed with the read and upload times,
+    // or recorded as failed before the error is rethrown
+    template<ManagableAsset T>
+    static std::shared_ptr<T> runLoader(gfx::Device& device, const AssetLoader<T>& loader, bool streamed, const std::shared_future<std::vector<std::byte>>& source,
+                                        AssetLoadRecord& record, AssetLoadRecorder& recorder, std::shared_ptr<StreamableAsset>& owner) {
+        try {
+            auto start = std::chrono::steady_clock::now();
+            const std::span<const std::byte> content = sourceContent(source);
+            record.readTime = elapsedMicroseconds(start);
+            if (source.valid())
+                record.sourceBytes = content.size();
+            std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = device.newCommandBufferPool();
+            assert(commandBufferPool);
+            std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
+            assert(commandBuffer);
+            std::shared_ptr<T> asset = loader(*commandBuffer, streamed, content, record, owner);
+            start = std::chrono::steady_clock::now();
+            device.submitCommandBuffers(commandBuffer);
+            record.uploadTime += elapsedMicroseconds(start);
+            return asset;
+        }
+        catch (...) {
+            record.failed = true;
+            recorder.record(record);
+            throw;
+        }
+    }
+
+    void reloadAssetHandle(VAssetHandle&);
+    void reloadChangedAssets();
+    void swapReloadedAssets();
 
-        std::shared_ptr<gfx::Buffer> stagingBuffer = device.newBuffer(gfx::Buffer::Descriptor{
-            .size = indexBuffer->size(),
-            .usages = gfx::BufferUsage::copySource,
-            .storageMode = gfx::ResourceStorageMode::hostVisible });
-        assert(stagingBuffer);
+    void loadAssetDependencies(const VAssetPath&);
+    void appendDependencyClosure(const VAssetPath&, std::set<const VAssetHandle*>& visited, std::vector<VAssetPath>& closure) const;
 
-        std::ranges::copy(data, stagingBuffer->content<std::ranges::range_value_t<decltype(data)>>());
+    void retainAssetHandle(VAssetHandle&);
+    void releaseAssetHandle(VAssetHandle&);
+    void evictUnreferencedAssets();
 
-        commandBuffer.copyBufferToBuffer(stagingBuffer, indexBuffer, indexBuffer->size());
+    static size_t assetByteSize(const Mesh&);
+    static size_t assetByteSize(const gfx::Texture&);
 
-        return indexBuffer;
-    }
+    std::pair<std::shared_ptr<const AssetArchive>, const AssetArchive::Entry*> findArchivedAsset(const VAssetPath& canonicalPath) const;
 
-    static Mesh loadMesh(gfx::Device&, const std::filesystem::path&, gfx::CommandBuffer&);
-    static std::shared_ptr<gfx::Texture> loadTexture(gfx::Device&, const std::filesystem::path&, gfx::CommandBuffer&);
-    static std::shared_ptr<gfx::Texture> loadTexture(gfx::Device&, const std::byte* bytes, uint32_t width, uint32_t height, gfx::CommandBuffer&);
-    static Mesh loadBuiltInCube(gfx::Device&, gfx::CommandBuffer&);
+    static std::shared_ptr<gfx::Texture> loadTexture(gfx::Device&, const TextureData&, gfx::CommandBuffer&);
+    static MeshData builtInCubeData();
 
     gfx::Device* m_device = nullptr;
-    std::map<VAssetPath, VAssetHandle> m_handles;
+    AsyncFileReader m_fileReader;
+    GeometryPool m_geometryPool;
+    std::filesystem::path m_meshCacheDirectory;
+    MeshCookOptions m_meshCookOptions;
+    std::filesystem::path m_textureCacheDirectory;
+    TextureCookOptions m_textureCookOptions;
+    ShardedMap<VAssetPath, VAssetHandle, VAssetPathHash> m_handles; // by canonical path
+    ShardedMap<VAssetPath, VAssetHandle*, VAssetPathHash> m_registeredPaths;
+    std::atomic<bool> m_contentDeduplication = false;
+    mutable std::mutex m_registrationMutex; // serializes the creation of the handles, guards the content handles and the archives
+    std::map<std::pair<size_t, uint64_t>, VAssetHandle*> m_contentHandles; // by asset type index and source content hash
+    std::vector<std::pair<std::shared_ptr<const AssetArchive>, std::filesystem::path>> m_archives; // with their canonical root
     VAssetHandle m_builtInCubeHandle;
+    mutable std::recursive_mutex m_residencyMutex; // releasing an asset evicts and unloads others
+    UnreferencedList m_unreferencedHandles;
+    size_t m_residencyBudget = 0;
+    std::atomic<size_t> m_residentBytes = 0;
+    std::vector<VAssetHandle*> m_reloadingHandles;
+    std::unique_ptr<FileWatcher> m_fileWatcher;
+    AssetStreamer m_streamer;
+    AssetLoadRecorder m_loadRecorder;
 
 public:
     AssetManager& operator=(const AssetManager&) = delete;
@@ -14,11 +14,14 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <concepts>
 #include <future>
 #include <map>
 #include <ranges>
+#include <set>
+#include <type_traits>
 #include <utility>
 
 namespace GE
@@ -30,12 +33,14 @@ constexpr AssetID BUILT_IN_CUBE_ASSET_ID = 0;
 template<typename T>
 concept AssetIdRange = std::ranges::range<T> && std::convertible_to<std::ranges::range_value_t<T>, AssetID>;
 
+// Unlike the AssetManager, a view is used by one thread at a time, the views
+// of the scenes deserialized on different threads share the asset manager.
 class GE_API AssetManagerView
 {
 public:
     AssetManagerView() = delete;
     AssetManagerView(const AssetManagerView&) = delete;
-    AssetManagerView(AssetManagerView&&) = default;
+    AssetManagerView(AssetManagerView&&) noexcept;
 
     AssetManagerView(AssetManager*);
     AssetManagerView(AssetManager*, const std::map<VAssetPath, AssetID>& registredAssets);
@@ -44,25 +49,28 @@ public:
     AssetID registerAsset(const std::filesystem::path& path)
     {
         assert(m_assetManager);
-        const AssetID assetId = s_nextAssetId++;
-        auto [it, inserted] = m_registredAssets.insert(std::make_pair(AssetPath<T>(path), assetId));
+        auto [it, inserted] = m_registredAssets.try_emplace(AssetPath<T>(path), BUILT_IN_CUBE_ASSET_ID);
         if (inserted)
         {
+            it->second = s_nextAssetId.fetch_add(1);
             m_assetManager->registerAsset(AssetPath<T>(path));
-            auto [_, inserted] = m_assets.insert(std::make_pair(assetId, AssetPath<T>(path)));
+            auto [_, inserted] = m_assets.insert(std::make_pair(it->second, AssetPath<T>(path)));
             assert(inserted);
         }
         return it->second;
     }
 
     template<ManagableAsset T>
-    const std::shared_future<const std::shared_ptr<T>&>& loadAsset(AssetID assetId) const
+    AssetFuture<T> loadAsset(AssetID assetId) const
     {
         assert(m_assetManager);
-        if (assetId == BUILT_IN_CUBE_ASSET_ID)
-            return m_assetManager->loadBuiltInCube();
-        else
-            return m_assetManager->loadAsset<T>(m_assets.at(assetId));
+        retainAsset(assetId);
+        if constexpr (std::is_same_v<T, Mesh>)
+        {
+            if (assetId == BUILT_IN_CUBE_ASSET_ID)
+                return m_assetManager->loadBuiltInCube();
+        }
+        return m_assetManager->loadAsset<T>(m_assets.at(assetId));
     }
 
     std::future<void> loadAssets(AssetIdRange auto&& assetIds) const
@@ -72,10 +80,16 @@ public:
         futures[1] = m_assetManager->loadAssets(assetIds
                                                 | std::views::filter([&](const auto& id) {
                                                       if (id == BUILT_IN_CUBE_ASSET_ID)
+                                                      {
+                                                          retainAsset(id);
                                                           futures[0] = std::async(std::launch::deferred, [future = m_assetManager->loadBuiltInCube()] { future.get(); });
+                                                      }
                                                       return id != BUILT_IN_CUBE_ASSET_ID;
                                                   })
-                                                | std::ranges::views::transform([&](const auto& assetId) { return m_assets.at(assetId); }));
+                                                | std::ranges::views::transform([&](const auto& assetId) {
+                                                      retainAsset(assetId);
+                                                      return m_assets.at(assetId);
+                                                  }));
 
         return std::async(std::launch::deferred, [futures = std::move(futures)]() mutable {
             for (auto& f : futures)
@@ -103,38 +117,69 @@ public:
 
     inline bool areAllAssetsLoaded() const { return areAssetsLoaded(m_assets | std::views::transform([](const auto& asset) { return asset.first; })); }
 
+    // include the dependencies of the assets
+    AssetManager::LoadProgress loadProgress(AssetIdRange auto&& assetIds) const
+    {
+        assert(m_assetManager);
+        bool hasBuiltInCube = false;
+        AssetManager::LoadProgress progress = m_assetManager->loadProgress(assetIds
+                                                                           | std::views::filter([&](const auto& id) {
+                                                                                 hasBuiltInCube |= id == BUILT_IN_CUBE_ASSET_ID;
+                                                                                 return id != BUILT_IN_CUBE_ASSET_ID;
+                                                                             })
+                                                                           | std::views::transform([&](const auto& assetId) -> const VAssetPath& {
+                                                                                 return m_assets.at(assetId);
+                                                                             }));
+        if (hasBuiltInCube)
+        {
+            progress.assetCount++;
+            if (m_assetManager->isBuiltInCubeLoaded())
+                progress.loadedAssetCount++;
+        }
+        return progress;
+    }
+
+    inline AssetManager::LoadProgress allAssetsLoadProgress() const { return loadProgress(m_assets | std::views::transform([](const auto& asset) { return asset.first; })); }
+
+    // ignored for the built in cube and the assets that are not streamed
+    inline void requestStreaming(AssetID assetId, uint32_t level, float priority = 0.0f) const
+    {
+        assert(m_assetManager);
+        if (assetId != BUILT_IN_CUBE_ASSET_ID)
+            m_assetManager->requestStreaming(m_assets.at(assetId), level, priority);
+    }
+
     inline const std::map<VAssetPath, AssetID>& registredAssets() const { return m_registredAssets; }
 
+    // the assets are released, they stay loaded while an other view uses them
     void unloadAssets(AssetIdRange auto&& assetIds)
     {
-        assert(m_assetManager);
-        m_assetManager->unloadAssets(assetIds
-                                     | std::views::filter([&](const auto& id) {
-                                           if (id == BUILT_IN_CUBE_ASSET_ID)
-                                               m_assetManager->unloadBuiltInCube();
-                                           return id != BUILT_IN_CUBE_ASSET_ID;
-                                       })
-                                     | std::views::transform([&](const auto& assetId) { return m_assets.at(assetId); }));
+        for (AssetID assetId : assetIds)
+            unloadAsset(assetId);
     }
 
     void unloadAsset(AssetID);
     void unloadAllAssets();
 
     template<ManagableAsset T>
-    inline const std::shared_ptr<T>& getAsset(AssetID assetId) { return loadAsset<T>(assetId).get(); }
+    inline std::shared_ptr<T> getAsset(AssetID assetId) { return loadAsset<T>(assetId).get(); }
 
     ~AssetManagerView();
 
 private:
+    // a reference is held on the assets loaded through the view, until they are unloaded
+    void retainAsset(AssetID) const;
+
     AssetManager* m_assetManager = nullptr;
-    inline static AssetID s_nextAssetId = 1; // 0 is builtin cube
+    inline static std::atomic<AssetID> s_nextAssetId = 1; // 0 is builtin cube, shared by the views of every thread
 
     std::map<VAssetPath, AssetID> m_registredAssets;
     std::map<AssetID, VAssetPath> m_assets;
+    mutable std::set<AssetID> m_retainedAssets;
 
 public:
     AssetManagerView& operator=(const AssetManagerView&) = delete;
-    AssetManagerView& operator=(AssetManagerView&&) = default;
+    AssetManagerView& operator=(AssetManagerView&&) noexcept;
 };
 
 } // namespace GE
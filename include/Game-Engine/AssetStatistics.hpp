@@ -0,0 +1,159 @@
+/*
+ * ---------------------------------------------------
+ * AssetStatistics.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Instrumentation of the AssetManager: counters, queue depths, histograms
+ * of the load phases and a timing record per asset load, to find what a
+ * slow level load is waiting on. A snapshot can be dumped as JSON.
+ *
+ */
+
+#ifndef ASSETSTATISTICS_HPP
+#define ASSETSTATISTICS_HPP
+
+#include "Game-Engine/Export.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace GE
+{
+
+inline std::chrono::microseconds elapsedMicroseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+// durations in power of two buckets of microseconds, bucket i counts [2^i, 2^(i+1)) and the first one everything below 2
+class GE_API DurationHistogram
+{
+public:
+    static constexpr uint32_t BUCKET_COUNT = 32;
+
+    void record(std::chrono::microseconds);
+
+    inline uint64_t count() const { return m_count; }
+    inline std::chrono::microseconds total() const { return m_total; }
+    inline std::chrono::microseconds min() const { return m_count > 0 ? m_min : std::chrono::microseconds(0); }
+    inline std::chrono::microseconds max() const { return m_max; }
+    inline std::chrono::microseconds mean() const { return m_count > 0 ? m_total / static_cast<int64_t>(m_count) : std::chrono::microseconds(0); }
+
+    // upper bound of the bucket holding the percentile, clamped to the maximum, `percentile` in [0, 1]
+    std::chrono::microseconds percentile(double percentile) const;
+
+    inline const std::array<uint64_t, BUCKET_COUNT>& buckets() const { return m_buckets; }
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> m_buckets = {};
+    uint64_t m_count = 0;
+    std::chrono::microseconds m_total{0};
+    std::chrono::microseconds m_min = std::chrono::microseconds::max();
+    std::chrono::microseconds m_max{0};
+};
+
+struct AssetLoadRecord
+{
+    std::string_view type; // name of the asset type, "Mesh" or "Texture"
+    std::filesystem::path path;
+    bool reload = false;
+    bool failed = false;
+    std::chrono::microseconds start{0};      // since the creation of the asset manager
+    std::chrono::microseconds readTime{0};   // waited by the loading thread for the source read
+    std::chrono::microseconds decodeTime{0}; // import and cook, or read of the cooked version
+    std::chrono::microseconds uploadTime{0}; // recording and submission of the uploads, the GPU copies are not waited for
+    size_t sourceBytes = 0;
+    size_t residentBytes = 0;
+
+    inline std::chrono::microseconds totalTime() const { return readTime + decodeTime + uploadTime; }
+};
+
+struct AssetStatistics
+{
+    struct TypeStatistics
+    {
+        uint32_t assetCount = 0; // registered
+        uint32_t loadingCount = 0;
+        uint32_t loadedCount = 0;
+        size_t residentBytes = 0;
+    };
+
+    // since the creation of the asset manager, or the last reset
+    uint64_t loadCount = 0;
+    uint64_t reloadCount = 0;
+    uint64_t failedLoadCount = 0; // loads and reloads
+    uint64_t unloadCount = 0;
+    uint64_t evictionCount = 0; // unloads of unreferenced assets to fit the residency budget
+    size_t readBytes = 0;
+
+    // at the time of the snapshot
+    std::map<std::string, TypeStatistics, std::less<>> types;
+    size_t residentBytes = 0;
+    size_t residencyBudget = 0;
+    uint32_t pendingReadCount = 0; // queued or in flight in the file reader
+    uint32_t reloadingCount = 0;
+    uint32_t unreferencedCount = 0; // loaded assets waiting for an eviction
+    uint32_t deferredStreamingRequestCount = 0;
+
+    // of the successful loads and reloads
+    DurationHistogram readTimes;
+    DurationHistogram decodeTimes;
+    DurationHistogram uploadTimes;
+    DurationHistogram loadTimes;
+
+    std::vector<AssetLoadRecord> records; // the last loads, oldest first
+
+    std::string toJson() const;
+};
+
+// Collects the load records sent by the loading threads, and the counters the
+// AssetManager cannot derive from its handles. Thread safe.
+class GE_API AssetLoadRecorder
+{
+public:
+    static constexpr size_t RECORD_CAPACITY = 1024;
+
+    AssetLoadRecorder() = default;
+    AssetLoadRecorder(const AssetLoadRecorder&) = delete;
+    AssetLoadRecorder(AssetLoadRecorder&&) = delete;
+
+    // since the creation of the recorder
+    inline std::chrono::microseconds now() const { return elapsedMicroseconds(m_origin); }
+
+    void record(AssetLoadRecord);
+    void countUnload();
+    void countEviction();
+
+    // the totals, histograms and records
+    void fill(AssetStatistics&) const;
+
+    void reset();
+
+    ~AssetLoadRecorder() = default;
+
+private:
+    const std::chrono::steady_clock::time_point m_origin = std::chrono::steady_clock::now();
+    mutable std::mutex m_mutex;
+    AssetStatistics m_statistics; // only the fields filled by the recorder are used
+    std::deque<AssetLoadRecord> m_records;
+
+public:
+    AssetLoadRecorder& operator=(const AssetLoadRecorder&) = delete;
+    AssetLoadRecorder& operator=(AssetLoadRecorder&&) = delete;
+};
+
+} // namespace GE
+
+#endif // ASSETSTATISTICS_HPP
@@ -0,0 +1,255 @@
+/*
+ * ---------------------------------------------------
+ * AssetStreamer.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Partial residency of the large assets. A streamable asset is a chain of
+ * levels, from the full detail (0) to a coarsest level that is uploaded
+ * with the asset and stays resident until it is unloaded. The renderer
+ * requests the level it needs every frame and the AssetStreamer uploads
+ * the finer levels within a per frame byte budget, the most important
+ * requests first.
+ *
+ * It also compacts the assets registered with addCompactable(), streamed
+ * or not, within an other per frame budget so the GeometryPool is compacted
+ * even when nothing is streamed.
+ *
+ */
+
+#ifndef ASSETSTREAMER_HPP
+#define ASSETSTREAMER_HPP
+
+#include "Game-Engine/Export.hpp"
+#include "Game-Engine/GeometryPool.hpp"
+#include "Game-Engine/Mesh.hpp"
+#include "Game-Engine/MeshData.hpp"
+#include "Game-Engine/Renderer.hpp"
+#include "Game-Engine/TextureData.hpp"
+
+#include <Graphics/CommandBuffer.hpp>
+#include <Graphics/CommandBufferPool.hpp>
+#include <Graphics/Device.hpp>
+#include <Graphics/Texture.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace GE
+{
+
+class GE_API StreamableAsset
+{
+public:
+    virtual uint32_t levelCount() const = 0;
+    virtual uint32_t residentLevel() const = 0;
+
+    // bytes uploaded by makeResident(level), 0 for a level not finer than the resident one
+    virtual size_t uploadSize(uint32_t level) const = 0;
+
+    virtual size_t residentBytes() const = 0;
+
+    // upload a level finer than the resident one, the copies are recorded in the command buffer
+    virtual void makeResident(uint32_t level, gfx::Device&, gfx::CommandBuffer&) = 0;
+
+    // release the levels finer than `level`, without any upload, so the resident
+    // level can end up coarser than `level`
+    virtual void evict(uint32_t level) = 0;
+
+    // true when compact() may move the resident data
+    virtual bool canCompact() const { return false; }
+
+    // move the resident data into the room released by the assets unloaded since the last
+    // call, the copies are recorded in the command buffer, return the bytes copied
+    virtual size_t compact(gfx::Device&, gfx::CommandBuffer&) { return 0; }
+
+    inline uint32_t coarsestLevel() const { return levelCount() - 1; }
+
+    virtual ~StreamableAsset() = default;
+};
+
+// The levels are the mips down to the mip tail, the first mip no larger than
+// MIP_TAIL_SIZE, which is uploaded on construction. The Graphics textures have
+// a single level so each level change replaces the texture, the mip tail is
+// kept so an eviction falls back to it without uploading anything.
+class GE_API StreamedTexture : public StreamableAsset
+{
+public:
+    static constexpr uint32_t MIP_TAIL_SIZE = 64;
+
+    StreamedTexture() = delete;
+    StreamedTexture(const StreamedTexture&) = delete;
+    StreamedTexture(StreamedTexture&&) = delete;
+
+    // `onTextureChange` is called with the new texture each time it is replaced, but not on construction
+    StreamedTexture(gfx::Device&, gfx::CommandBuffer&, TextureData, std::function<void(const std::shared_ptr<gfx::Texture>&)> onTextureChange = nullptr);
+
+    inline uint32_t levelCount() const override { return m_tailMip + 1; }
+    inline uint32_t residentLevel() const override { return m_residentMip; }
+    size_t uploadSize(uint32_t level) const override;
+    size_t residentBytes() const override;
+    void makeResident(uint32_t level, gfx::Device&, gfx::CommandBuffer&) override;
+    void evict(uint32_t level) override;
+
+    inline const std::shared_ptr<gfx::Texture>& texture() const { return m_texture; }
+    inline const TextureData& textureData() const { return m_textureData; }
+
+    ~StreamedTexture() override = default;
+
+private:
+    TextureData m_textureData;
+    uint32_t m_tailMip = 0;
+    uint32_t m_residentMip = 0;
+    std::shared_ptr<gfx::Texture> m_tailTexture;
+    std::shared_ptr<gfx::Texture> m_texture;
+    std::function<void(const std::shared_ptr<gfx::Texture>&)> m_onTextureChange;
+
+public:
+    StreamedTexture& operator=(const StreamedTexture&) = delete;
+    StreamedTexture& operator=(StreamedTexture&&) = delete;
+};
+
+// The levels are the levels of detail of the geometries, a geometry with fewer
+// levels uses its coarsest one for the others. A resident level keeps the index
+// buffers of all the coarser levels so the renderer can fall back to any of them.
+// The vertices are always resident since every level is simplified from the full
+// detail geometry and uses its vertices. They are relocated into the holes of the
+// GeometryPool by compact(), which rebuilds the resident index buffers with the new
+// vertex offset, so the pool must outlive the calls to compact(). The meshes which
+// are not streamed are loaded with every level resident, only to be compacted.
+class GE_API StreamedMesh : public StreamableAsset
+{
+public:
+    StreamedMesh() = delete;
+    StreamedMesh(const StreamedMesh&) = delete;
+    StreamedMesh(StreamedMesh&&) = delete;
+
+    StreamedMesh(gfx::Device&, GeometryPool&, gfx::CommandBuffer&, MeshData, bool allLevelsResident = false);
+
+    inline uint32_t levelCount() const override { return m_levelCount; }
+    inline uint32_t residentLevel() const override { return m_residentLevel; }
+    size_t uploadSize(uint32_t level) const override;
+    size_t residentBytes() const override;
+    void makeResident(uint32_t level, gfx::Device&, gfx::CommandBuffer&) override;
+    void evict(uint32_t level) override;
+    bool canCompact() const override;
+    size_t compact(gfx::Device&, gfx::CommandBuffer&) override;
+
+    // the index buffers of the levels not resident are null
+    inline const std::shared_ptr<Mesh>& mesh() const { return m_mesh; }
+
+    ~StreamedMesh() override = default;
+
+private:
+    uint32_t geometryLevel(uint32_t geometry, uint32_t level) const;
+    void setIndexBuffer(uint32_t geometry, uint32_t level, const std::shared_ptr<gfx::Buffer>&);
+
+    MeshData m_meshData;
+    GeometryPool* m_geometryPool = nullptr;
+    uint64_t m_compactedFreeCount = 0; // the retired free count of the pool at the last compaction
+    std::shared_ptr<Mesh> m_mesh;
+    std::vector<std::vector<SubMesh*>> m_geometrySubMeshes; // the nodes sharing each geometry
+    uint32_t m_levelCount = 1;
+    uint32_t m_residentLevel = 0;
+
+public:
+    StreamedMesh& operator=(const StreamedMesh&) = delete;
+    StreamedMesh& operator=(StreamedMesh&&) = delete;
+};
+
+// level of a texture displayed on `projectedSize` pixels, the finest mip not smaller than it
+GE_API uint32_t selectMip(uint32_t textureWidth, uint32_t textureHeight, float projectedSize);
+
+class GE_API AssetStreamer
+{
+public:
+    struct Statistics
+    {
+        uint64_t frameCount = 0;
+        size_t streamedBytes = 0;          // since the creation of the streamer
+        size_t frameStreamedBytes = 0;     // by the last update
+        size_t frameCompactedBytes = 0;    // by the last update
+        uint32_t frameUploadCount = 0;     // by the last update
+        uint32_t deferredRequestCount = 0; // requests of the last update left for the next frames by the budget
+        size_t residentBytes = 0;
+        uint32_t assetCount = 0;
+    };
+
+    static constexpr uint32_t DEFAULT_EVICTION_DELAY = 120;
+    static constexpr size_t DEFAULT_FRAME_COMPACTION_BUDGET = 4 * 1024 * 1024;
+
+public:
+    AssetStreamer() = delete;
+    AssetStreamer(const AssetStreamer&) = delete;
+    AssetStreamer(AssetStreamer&&) = delete;
+
+    // a level not requested for `evictionDelay` frames is released, so an asset
+    // at the edge of two levels does not stream the finer one every other frame
+    AssetStreamer(gfx::Device*, size_t frameByteBudget, uint32_t evictionDelay = DEFAULT_EVICTION_DELAY);
+
+    // can be called several times per frame for the same asset, the finest level and the
+    // highest priority are kept, the assets are only referenced weakly by the streamer
+    void request(const std::shared_ptr<StreamableAsset>&, uint32_t level, float priority = 0.0f);
+
+    // the asset is compacted by the updates until it is destroyed, it is only referenced weakly,
+    // can be called from any thread once the asset is not accessed by it anymore
+    void addCompactable(const std::shared_ptr<StreamableAsset>&);
+
+    // to be called once per frame, one upload is always done even if it is larger than the
+    // budget so the assets keep refining, then the compactable assets are compacted within
+    // the compaction budget, return the change of the resident bytes
+    ptrdiff_t update();
+
+    inline void setFrameByteBudget(size_t bytes) { m_frameByteBudget = bytes; }
+    inline size_t frameByteBudget() const { return m_frameByteBudget; }
+
+    // 0 disables the compaction, a compaction larger than the budget is still done if it is the first of the frame
+    inline void setFrameCompactionBudget(size_t bytes) { m_frameCompactionBudget = bytes; }
+    inline size_t frameCompactionBudget() const { return m_frameCompactionBudget; }
+
+    inline const Statistics& statistics() const { return m_statistics; }
+
+    ~AssetStreamer();
+
+private:
+    struct Entry
+    {
+        std::weak_ptr<StreamableAsset> asset;
+        uint32_t targetLevel = 0;
+        uint64_t targetFrame = 0; // last frame the target level, or a finer one, was requested
+        uint32_t requestedLevel = 0;
+        uint64_t requestFrame = 0;
+        float priority = 0.0f;
+    };
+
+    struct InFlightData
+    {
+        std::unique_ptr<gfx::CommandBufferPool> commandBufferPool;
+        std::shared_ptr<gfx::CommandBuffer> waitedCommandBuffer;
+    };
+
+    gfx::Device* m_device = nullptr;
+    size_t m_frameByteBudget = 0;
+    uint32_t m_evictionDelay = DEFAULT_EVICTION_DELAY;
+    size_t m_frameCompactionBudget = DEFAULT_FRAME_COMPACTION_BUDGET;
+    std::map<const StreamableAsset*, Entry> m_entries;
+    std::mutex m_compactablesMutex;
+    std::vector<std::weak_ptr<StreamableAsset>> m_compactables;
+    std::array<InFlightData, maxFrameInFlight> m_inFlightDatas;
+    Statistics m_statistics;
+
+public:
+    AssetStreamer& operator=(const AssetStreamer&) = delete;
+    AssetStreamer& operator=(AssetStreamer&&) = delete;
+};
+
+} // namespace GE
+
+#endif // ASSETSTREAMER_HPP
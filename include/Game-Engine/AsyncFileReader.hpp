@@ -0,0 +1,103 @@
+/*
+ * ---------------------------------------------------
+ * AsyncFileReader.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Reads whole files in memory without blocking the caller. On linux the
+ * reads are submitted to an io_uring, a batch of reads in a single system
+ * call, and completed by one thread. Where io_uring is not available (other
+ * platforms, old kernels, sandboxes forbidding it) a small pool of threads
+ * does blocking reads instead.
+ *
+ */
+
+#ifndef ASYNCFILEREADER_HPP
+#define ASYNCFILEREADER_HPP
+
+#include "Game-Engine/Export.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace GE
+{
+
+class GE_API AsyncFileReader
+{
+public:
+    enum class Backend : uint8_t
+    {
+        ioUring,
+        threadPool
+    };
+
+    static constexpr uint32_t DEFAULT_THREAD_COUNT = 4;
+    static constexpr uint32_t IO_URING_QUEUE_DEPTH = 256; // reads in flight, the others wait in a queue
+
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader(AsyncFileReader&&) = delete;
+
+    // io_uring is used when available unless the thread pool is requested,
+    // `threadCount` is the size of the pool when it is used
+    explicit AsyncFileReader(Backend = Backend::ioUring, uint32_t threadCount = DEFAULT_THREAD_COUNT);
+
+    // the future throws std::runtime_error if the file cannot be read
+    std::future<std::vector<std::byte>> read(const std::filesystem::path&);
+
+    // the reads of the batch are submitted together, the futures are in the order of the paths
+    std::vector<std::future<std::vector<std::byte>>> read(std::span<const std::filesystem::path>);
+
+    inline Backend backend() const { return m_backend; }
+
+    // reads queued or in progress
+    inline uint32_t pendingReadCount() const { return m_pendingReadCount.load(std::memory_order_relaxed); }
+
+    ~AsyncFileReader(); // complete the pending reads
+
+private:
+    struct Request
+    {
+        std::filesystem::path path;
+        std::promise<std::vector<std::byte>> promise;
+        std::vector<std::byte> bytes;
+        size_t readSize = 0;
+        int fileDescriptor = -1;
+    };
+
+    struct IoUring; // defined on linux only
+
+    void threadPoolLoop();
+
+    void submitToIoUring(std::vector<std::unique_ptr<Request>>&&);
+    void completeIoUringReads();
+    void flushIoUringQueue(); // with the mutex locked
+
+    Backend m_backend;
+    std::mutex m_mutex;
+    std::deque<std::unique_ptr<Request>> m_queuedRequests; // not yet submitted to the io_uring, or not yet read by the pool
+    std::condition_variable m_queueCondition;
+    bool m_stopping = false;
+    std::atomic<uint32_t> m_pendingReadCount = 0;
+    std::unique_ptr<IoUring> m_ioUring;
+    std::vector<std::thread> m_threads; // the pool or the io_uring completion thread
+
+public:
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(AsyncFileReader&&) = delete;
+};
+
+} // namespace GE
+
+#endif // ASYNCFILEREADER_HPP
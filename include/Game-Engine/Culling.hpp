@@ -0,0 +1,140 @@
+/*
+ * ---------------------------------------------------
+ * Culling.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Bounding boxes computed at import and the frustum culling of the
+ * geometry pass. The culler keeps the world space boxes of a frame as
+ * structure of arrays and tests them against the frustum planes 8 at a
+ * time, with AVX, SSE or NEON when available.
+ *
+ */
+
+#ifndef CULLING_HPP
+#define CULLING_HPP
+
+#include "Game-Engine/Export.hpp"
+#include "Game-Engine/MeshLod.hpp"
+#include "Game-Engine/VertexFormat.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace GE
+{
+
+// axis aligned, empty by default
+struct BoundingBox
+{
+    glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+
+    inline bool isEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+    inline glm::vec3 center() const { return (min + max) * 0.5f; }
+    inline glm::vec3 extent() const { return (max - min) * 0.5f; }
+
+    inline void expand(const glm::vec3& point) { min = glm::min(min, point); max = glm::max(max, point); }
+    inline void expand(const BoundingBox& box) { min = glm::min(min, box.min); max = glm::max(max, box.max); }
+
+    friend bool operator==(const BoundingBox&, const BoundingBox&) = default;
+};
+
+GE_API BoundingBox boundingBox(std::span<const Vertex>);
+
+// box containing the transformed box, an empty box stays empty
+GE_API BoundingBox transformBoundingBox(const BoundingBox&, const glm::mat4x4&);
+
+inline bool overlaps(const BoundingBox& a, const BoundingBox& b)
+{
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y && a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+inline bool overlaps(const BoundingBox& box, const BoundingSphere& sphere)
+{
+    const glm::vec3 offset = sphere.center - glm::clamp(sphere.center, box.min, box.max);
+    return glm::dot(offset, offset) <= sphere.radius * sphere.radius;
+}
+
+inline bool contains(const BoundingBox& outer, const BoundingBox& inner)
+{
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z
+        && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+struct Ray
+{
+    glm::vec3 origin = glm::vec3(0.0f);
+    glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f); // not required to be normalized, the distances are in its length unit
+};
+
+// distance along the ray where it enters the box, 0 if the origin is inside, nullopt if it misses the box before `maxDistance`
+GE_API std::optional<float> rayBoxDistance(const Ray&, const BoundingBox&, float maxDistance = std::numeric_limits<float>::infinity());
+
+// planes with normals pointing inside, a point is inside a plane when dot(plane.xyz, point) + plane.w >= 0
+struct Frustum
+{
+    std::array<glm::vec4, 6> planes; // left, right, bottom, top, near, far
+};
+
+// in the space the view projection matrix transforms from, usually the world space
+GE_API Frustum frustum(const glm::mat4x4& viewProjectionMatrix);
+
+// conservative, a box near a corner of the frustum can be reported inside
+GE_API bool isBoxInFrustum(const Frustum&, const BoundingBox&);
+
+struct CullingStatistics
+{
+    uint32_t testedCount = 0;
+    uint32_t visibleCount = 0;
+    uint32_t culledCount = 0;
+};
+
+class GE_API FrustumCuller
+{
+public:
+    static constexpr uint32_t LANE_COUNT = 8;
+
+    FrustumCuller() = default;
+    FrustumCuller(const FrustumCuller&) = delete;
+    FrustumCuller(FrustumCuller&&) = default;
+
+    // the boxes are cleared, the memory is kept for the next frame
+    void clear();
+
+    // world space box, return its index
+    uint32_t add(const BoundingBox&);
+
+    inline uint32_t size() const { return m_count; }
+
+    // indices of the boxes intersecting the frustum, in increasing order, valid until the next call
+    const std::vector<uint32_t>& cull(const Frustum&);
+
+    // of the last call to cull
+    inline const CullingStatistics& statistics() const { return m_statistics; }
+
+    ~FrustumCuller() = default;
+
+private:
+    // padded to a multiple of LANE_COUNT, the padding is never reported visible
+    std::vector<float> m_minX, m_minY, m_minZ;
+    std::vector<float> m_maxX, m_maxY, m_maxZ;
+    uint32_t m_count = 0;
+    std::vector<uint32_t> m_visibleIndices;
+    CullingStatistics m_statistics;
+
+public:
+    FrustumCuller& operator=(const FrustumCuller&) = delete;
+    FrustumCuller& operator=(FrustumCuller&&) = default;
+};
+
+} // namespace GE
+
+#endif // CULLING_HPP
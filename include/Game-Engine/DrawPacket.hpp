@@ -0,0 +1,70 @@
+/*
+ * ---------------------------------------------------
+ * DrawPacket.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Everything needed to record a draw, so the draws of a pass can be split
+ * into lists built and recorded by different threads, each in its own
+ * command buffer. A list does not rely on the state bound by the previous
+ * one, its first packet binds everything.
+ *
+ */
+
+#ifndef DRAWPACKET_HPP
+#define DRAWPACKET_HPP
+
+#include <Graphics/Buffer.hpp>
+#include <Graphics/CommandBuffer.hpp>
+#include <Graphics/GraphicsPipeline.hpp>
+#include <Graphics/ParameterBlock.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace GE
+{
+
+// the resources are owned by the caller until the packet is recorded
+template<typename PushConstants>
+struct DrawPacket
+{
+    const std::shared_ptr<gfx::GraphicsPipeline>* pipeline;
+    const std::shared_ptr<gfx::Buffer>* vertexBuffer;
+    const std::shared_ptr<gfx::Buffer>* indexBuffer;
+    PushConstants pushConstants;
+};
+
+// the pipeline and the vertex buffer are only bound when they change, the
+// parameter blocks are bound at the indices of the span after each pipeline
+template<typename PushConstants>
+void recordDrawPackets(gfx::CommandBuffer& commandBuffer, std::span<const DrawPacket<PushConstants>> packets, std::span<const std::shared_ptr<gfx::ParameterBlock>> parameterBlocks)
+{
+    const std::shared_ptr<gfx::GraphicsPipeline>* boundPipeline = nullptr;
+    const gfx::Buffer* boundVertexBuffer = nullptr;
+    for (const DrawPacket<PushConstants>& packet : packets)
+    {
+        assert(packet.pipeline != nullptr && packet.vertexBuffer != nullptr && packet.indexBuffer != nullptr);
+        if (boundPipeline == nullptr || *packet.pipeline != *boundPipeline)
+        {
+            commandBuffer.usePipeline(*packet.pipeline);
+            for (uint32_t i = 0; i < parameterBlocks.size(); i++)
+                commandBuffer.setParameterBlock(parameterBlocks[i], i);
+            boundPipeline = packet.pipeline;
+        }
+        if (packet.vertexBuffer->get() != boundVertexBuffer)
+        {
+            commandBuffer.useVertexBuffer(*packet.vertexBuffer);
+            boundVertexBuffer = packet.vertexBuffer->get();
+        }
+        commandBuffer.setPushConstants(&packet.pushConstants);
+        commandBuffer.drawIndexedVertices(*packet.indexBuffer);
+    }
+}
+
+} // namespace GE
+
+#endif // DRAWPACKET_HPP
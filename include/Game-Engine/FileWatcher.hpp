@@ -0,0 +1,60 @@
+/*
+ * ---------------------------------------------------
+ * FileWatcher.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Reports the files written in a directory tree, using inotify on linux
+ * and by comparing the last write times of the files on the other
+ * platforms. Polled from the main loop, it never blocks.
+ *
+ */
+
+#ifndef FILEWATCHER_HPP
+#define FILEWATCHER_HPP
+
+#include "Game-Engine/Export.hpp"
+
+#include <filesystem>
+#include <map>
+#include <vector>
+
+namespace GE
+{
+
+class GE_API FileWatcher
+{
+public:
+    FileWatcher() = delete;
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher(FileWatcher&&) = delete;
+
+    explicit FileWatcher(const std::filesystem::path& directory); // throw std::runtime_error if the directory cannot be watched
+
+    // canonical paths of the files written, or moved in the directory tree, since the last call, each once
+    std::vector<std::filesystem::path> poll();
+
+    inline const std::filesystem::path& directory() const { return m_directory; }
+
+    ~FileWatcher();
+
+private:
+    std::filesystem::path m_directory;
+#if defined(__linux__)
+    void addWatch(const std::filesystem::path& directory, std::vector<std::filesystem::path>* existingFiles);
+
+    int m_fileDescriptor = -1;
+    std::map<int, std::filesystem::path> m_watchedDirectories; // watch descriptor -> directory
+#else
+    std::map<std::filesystem::path, std::filesystem::file_time_type> m_writeTimes;
+#endif
+
+public:
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    FileWatcher& operator=(FileWatcher&&) = delete;
+};
+
+} // namespace GE
+
+#endif // FILEWATCHER_HPP
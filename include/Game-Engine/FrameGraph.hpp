@@ -10,8 +10,11 @@
 #define FRAMEGRAPH_HPP
 
 #include "Game-Engine/Export.hpp"
+#include "Game-Engine/FunctionRef.hpp"
+#include "Game-Engine/VertexFormat.hpp"
 
 #include <Graphics/CommandBuffer.hpp>
+#include <Graphics/GraphicsPipeline.hpp>
 #include <Graphics/ParameterBlockPool.hpp>
 #include <Graphics/Enums.hpp>
 #include <Graphics/Texture.hpp>
@@ -23,6 +26,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 #include <memory>
@@ -67,23 +71,50 @@ struct AttachmentDescriptor
     };
 };
 
+// position of a resource in the compiled frame graph, given by the graph once it is built so the passes
+// can reach their resources through flat arrays instead of looking their names up each frame
+struct TextureHandle
+{
+    uint32_t index = UINT32_MAX;
+
+    inline bool isValid() const { return index != UINT32_MAX; }
+    bool operator==(const TextureHandle&) const = default;
+};
+
+struct BufferHandle
+{
+    uint32_t index = UINT32_MAX;
+
+    inline bool isValid() const { return index != UINT32_MAX; }
+    bool operator==(const BufferHandle&) const = default;
+};
+
+class FrameGraph;
+class FrameResources;
+class LinearAllocator;
+
 struct FramePassSetupContext
 {
-    std::map<std::string, std::shared_ptr<gfx::Texture>>& textureMap;
-    std::map<std::string, std::shared_ptr<gfx::Buffer>>& constantBuffers;
-    std::function<void(const std::string& name, const void* data, uint32_t size)> setStructuredBufferContent;
+    FrameResources& resources;
+    LinearAllocator& frameAllocator; // released when the frame in flight is reused
 };
 
 struct FramePassExecuteContext
 {
     gfx::CommandBuffer& commandBuffer;
     gfx::ParameterBlockPool& parameterBlockPool;
-    std::map<std::string, std::shared_ptr<gfx::Texture>>& textureMap;
-    std::map<std::string, std::shared_ptr<gfx::Buffer>>& bufferMap;
+    const FrameResources& resources;
 
     std::shared_ptr<gfx::ParameterBlockLayout> frameDataBlockLayout;
     std::shared_ptr<gfx::ParameterBlockLayout> materialBlockLayout;
-    std::shared_ptr<gfx::GraphicsPipeline> gfxPipeline; // only one for now
+    const std::map<VertexFormat, std::shared_ptr<gfx::GraphicsPipeline>>& gfxPipelines; // one per vertex format
+
+    // `job(index, jobContext)` for each index in [0, jobCount) on the worker threads, each job recording in its own
+    // command buffer which continues the render pass. The jobs are executed by the gpu in their index order, after
+    // what was recorded in `commandBuffer`, which must not be used afterward. At most once per pass, empty in the
+    // context of a job
+    std::function<void(uint32_t jobCount, FunctionRef<void(uint32_t index, FramePassExecuteContext&)> job)> recordParallel;
+    uint32_t threadCount = 1; // running the jobs
 };
 
 struct FramePass
@@ -95,6 +126,7 @@ struct FramePass
     std::vector<TextureDescriptor> textureDeclarations;
     std::vector<ConstantBufferDescriptor> constantBufferDeclarations;
     std::vector<StructuredBufferDescriptor> structuredBufferDeclarations;
+    std::function<void(const FrameGraph&)> resolveHandles; // called once by the graph, after it is compiled
     std::function<void(FramePassSetupContext&)> setup;
     std::function<void(FramePassExecuteContext&)> execute;
 
@@ -106,6 +138,58 @@ struct FramePass
     FramePass& operator=(FramePass&&) = default;
 };
 
+// how a pass uses a texture, gfx derives its barriers from the attachments and the sampled textures
+enum class ResourceState : uint8_t
+{
+    undefined,
+    colorAttachment,
+    depthStencilAttachment,
+    shaderRead,
+    present
+};
+
+struct ResourceTransition
+{
+    std::string resource;
+    ResourceState before;
+    ResourceState after;
+    bool operator==(const ResourceTransition&) const = default;
+};
+
+// positions in the compiled passes, both included
+struct ResourceLifetime
+{
+    uint32_t firstPass;
+    uint32_t lastPass;
+};
+
+enum class ResourceKind : uint8_t
+{
+    texture,
+    constantBuffer,
+    structuredBuffer
+};
+
+struct CompiledResource
+{
+    static constexpr uint32_t NO_ALIAS_SLOT = UINT32_MAX;
+
+    std::string name;
+    ResourceKind kind;
+    bool isUsed = false;                 // by a compiled pass, the others are not allocated
+    uint32_t aliasSlot = NO_ALIAS_SLOT;  // of the transient textures
+};
+
+// of the transient textures, all but the back buffer, for one frame in flight
+struct TransientMemoryStatistics
+{
+    uint64_t naiveBytes = 0;   // one texture each
+    uint64_t aliasedBytes = 0; // one texture per alias slot
+    uint64_t peakBytes = 0;    // most bytes used by the textures of a pass, the least any aliasing can reach
+    uint32_t textureCount = 0;
+    uint32_t slotCount = 0;
+};
+
 class GE_API FrameGraph
 {
 public:
@@ -118,6 +202,16 @@ public:
         std::vector<FramePass> passes;
     };
 
+    struct CompiledPass
+    {
+        uint32_t passIndex; // in `passes()`
+        std::vector<ResourceTransition> transitions; // of the textures, before the pass
+        bool acquiresDrawable = false; // first pass using the back buffer
+        std::vector<TextureHandle> colorAttachments;
+        std::optional<TextureHandle> depthAttachment;
+        std::vector<TextureHandle> sampledTextures;
+    };
+
 public:
     FrameGraph() = default;
     FrameGraph(const FrameGraph&) = default;
@@ -131,10 +225,46 @@ public:
     const std::set<std::string>& structuredBufferNames() const { return m_structuredBufferNames; }
     const std::vector<FramePass>& passes() const { return m_passes; }
 
+    // the passes in an order where each one runs after the passes writing what it reads, without
+    // the passes whose outputs do not reach the back buffer
+    const std::vector<CompiledPass>& compiledPasses() const { return m_compiledPasses; }
+    // the back buffer to present, after the last pass
+    const std::vector<ResourceTransition>& finalTransitions() const { return m_finalTransitions; }
+    // of the textures and buffers used by the compiled passes, the others are not allocated
+    const std::map<std::string, ResourceLifetime>& lifetimes() const { return m_lifetimes; }
+
+    // the transient textures with the same slot share a gfx texture, their lifetimes do not overlap
+    const std::map<std::string, uint32_t>& aliasSlots() const { return m_aliasSlots; }
+    const std::vector<gfx::Texture::Descriptor>& aliasSlotDescriptors() const { return m_aliasSlotDescriptors; }
+    const TransientMemoryStatistics& transientMemory() const { return m_transientMemory; }
+
+    // the declared textures then the constant and the structured buffers, each in name order, so
+    // the resources of a frame can be kept in arrays indexed by their position
+    const std::vector<CompiledResource>& resources() const { return m_resources; }
+    // throws std::out_of_range if nothing is declared with this name, does not allocate
+    uint32_t resourceIndex(std::string_view name) const;
+    // same, also throws if the resource is not of the kind of the handle
+    TextureHandle textureHandle(std::string_view name) const;
+    BufferHandle bufferHandle(std::string_view name) const;
+
     ~FrameGraph() = default;
 
 private:
+    // throws std::runtime_error if the passes depend on each other
+    void compile();
+    // the buffers are written by the cpu during the setups, before the gpu reads the previous ones, so only the textures are aliased
+    void allocateAliasSlots();
+    void indexResources();
+
     std::vector<FramePass> m_passes;
+    std::vector<CompiledPass> m_compiledPasses;
+    std::vector<ResourceTransition> m_finalTransitions;
+    std::map<std::string, ResourceLifetime> m_lifetimes;
+    std::map<std::string, uint32_t> m_aliasSlots;
+    std::vector<gfx::Texture::Descriptor> m_aliasSlotDescriptors;
+    TransientMemoryStatistics m_transientMemory;
+    std::vector<CompiledResource> m_resources;
+    std::map<std::string, uint32_t, std::less<>> m_resourceIndices;
     std::string m_backBufferName;
     std::map<std::string, gfx::Texture::Descriptor> m_textureDescriptors;
     std::map<std::string, gfx::Buffer::Descriptor> m_constantBufferDescriptors;
@@ -9,8 +9,10 @@
 #ifndef FRAMEPASSBUILDER_HPP
 #define FRAMEPASSBUILDER_HPP
 
+#include "Game-Engine/Culling.hpp"
 #include "Game-Engine/Export.hpp"
 #include "Game-Engine/FrameGraph.hpp"
+#include "Game-Engine/FrameResources.hpp"
 #include "Game-Engine/ICamera.hpp"
 #include "Game-Engine/Scene.hpp"
 
@@ -20,6 +22,7 @@
 #include <imgui.h>
 #include <glm/glm.hpp>
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
@@ -91,9 +94,10 @@ public:
                     assert(cmd.TexRef._TexData == nullptr);
                     auto vistor = [&](auto& v) {
                         if constexpr (std::is_same_v<std::remove_cvref_t<decltype(v)>, std::string>) {
-                            if (ctx.textureMap[v]->imTextureId().has_value() == false)
-                                ctx.textureMap[v]->initImTextureId();
-                            cmd.TexRef._TexID = *ctx.textureMap[v]->imTextureId();
+                            const std::shared_ptr<gfx::Texture>& texture = ctx.resources.texture(v);
+                            if (texture->imTextureId().has_value() == false)
+                                texture->initImTextureId();
+                            cmd.TexRef._TexID = *texture->imTextureId();
                         }
                         else if constexpr (std::is_same_v<std::remove_cvref_t<decltype(v)>, uint64_t>)
                             cmd.TexRef._TexID = v;
@@ -115,11 +119,19 @@ public:
     FlatGeometryPassBuilder(const Scene*, const ICamera*);
     FlatGeometryPassBuilder(std::function<const Scene*()>, std::function<const ICamera*()>);
 
+    // the submeshes outside of the camera frustum are not drawn, enabled by default
+    inline FlatGeometryPassBuilder& setFrustumCulling(bool enabled) { m_frustumCulling = enabled; return *this; }
+
+    // of the last frame drawn by a pass built by this builder, shared by its copies
+    inline std::shared_ptr<const CullingStatistics> cullingStatistics() const { return m_cullingStatistics; }
+
     FramePass build() const;
 
 private:
     std::function<const Scene*()> m_sceneProvider;
     std::function<const ICamera*()> m_cameraProvider;
+    bool m_frustumCulling = true;
+    std::shared_ptr<CullingStatistics> m_cullingStatistics = std::make_shared<CullingStatistics>();
 };
 
 }
@@ -0,0 +1,102 @@
+/*
+ * ---------------------------------------------------
+ * FrameResources.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * The textures and buffers of a frame graph for one frame in flight, kept
+ * from frame to frame in arrays indexed like the compiled resources of the
+ * graph. They are only created when the graph changes, a frame with the
+ * same graph as the previous one reuses everything without allocating.
+ * The structured buffers are ranges of an upload arena, whatever their
+ * sizes they do not need buffers of their own.
+ *
+ */
+
+#ifndef FRAMERESOURCES_HPP
+#define FRAMERESOURCES_HPP
+
+#include "Game-Engine/Export.hpp"
+#include "Game-Engine/FrameGraph.hpp"
+#include "Game-Engine/UploadArena.hpp"
+
+#include <Graphics/Buffer.hpp>
+#include <Graphics/Device.hpp>
+#include <Graphics/Texture.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace GE
+{
+
+class GE_API FrameResources
+{
+public:
+    FrameResources(const FrameResources&) = delete;
+    FrameResources(FrameResources&&) = default;
+
+    explicit FrameResources(gfx::Device*);
+
+    // creates what the graph uses and the previous frames did not, the graph must outlive the frame
+    void prepare(const FrameGraph&);
+
+    // the texture of the drawable, until the next `prepare`
+    void setBackBuffer(std::shared_ptr<gfx::Texture>);
+
+    // the handles given by the graph are array indices, the names are looked up in the graph first.
+    // Throws std::out_of_range if the graph has no such texture
+    const std::shared_ptr<gfx::Texture>& texture(TextureHandle) const;
+    const std::shared_ptr<gfx::Texture>& texture(std::string_view name) const;
+    // the buffer of a structured buffer is the arena buffer holding its last content, null before any
+    const std::shared_ptr<gfx::Buffer>& buffer(BufferHandle) const;
+    const std::shared_ptr<gfx::Buffer>& buffer(std::string_view name) const;
+
+    // copied in the upload arena of the frame, returns the index of the first element in the buffer, to be
+    // added by the shaders to theirs. Nothing is uploaded for an empty content and 0 is returned
+    uint32_t setStructuredBufferContent(BufferHandle, const void* data, uint32_t elementSize, uint32_t elementCount);
+    uint32_t setStructuredBufferContent(std::string_view name, const void* data, uint32_t elementSize, uint32_t elementCount);
+
+    template<typename T>
+    uint32_t setStructuredBufferContent(BufferHandle handle, std::span<T> elements)
+    {
+        assert(elements.size() <= UINT32_MAX);
+        return setStructuredBufferContent(handle, elements.data(), sizeof(T), static_cast<uint32_t>(elements.size()));
+    }
+
+    ~FrameResources() = default;
+
+private:
+    struct SlotTexture
+    {
+        gfx::Texture::Descriptor descriptor;
+        std::shared_ptr<gfx::Texture> texture;
+    };
+
+    struct ResourceBuffer
+    {
+        ResourceKind kind = ResourceKind::texture; // the buffer of another kind is not reused when the graph changes
+        std::shared_ptr<gfx::Buffer> buffer;
+    };
+
+    gfx::Device* m_device;
+    const FrameGraph* m_frameGraph = nullptr;
+
+    std::vector<SlotTexture> m_slotTextures; // by alias slot
+    std::vector<ResourceBuffer> m_buffers; // by resource index
+    std::shared_ptr<gfx::Texture> m_backBuffer;
+    UploadArena m_structuredBufferArena;
+
+public:
+    FrameResources& operator=(const FrameResources&) = delete;
+    FrameResources& operator=(FrameResources&&) = default;
+};
+
+} // namespace GE
+
+#endif // FRAMERESOURCES_HPP
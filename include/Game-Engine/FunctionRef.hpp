@@ -0,0 +1,62 @@
+/*
+ * ---------------------------------------------------
+ * FunctionRef.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Non owning reference to a callable, for the callbacks invoked before the
+ * call taking them returns. Unlike a std::function it never allocates, so
+ * the per frame code can pass lambdas capturing what they need.
+ *
+ */
+
+#ifndef FUNCTIONREF_HPP
+#define FUNCTIONREF_HPP
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace GE
+{
+
+template<typename Signature>
+class FunctionRef;
+
+template<typename R, typename... Args>
+class FunctionRef<R(Args...)>
+{
+public:
+    FunctionRef() = delete;
+    FunctionRef(const FunctionRef&) = default;
+    FunctionRef(FunctionRef&&) = default;
+
+    // the callable must outlive the reference
+    template<typename F>
+        requires(std::is_same_v<std::remove_cvref_t<F>, FunctionRef> == false && std::is_invocable_r_v<R, F&, Args...>)
+    FunctionRef(F&& callable)
+        : m_callable(const_cast<void*>(static_cast<const void*>(std::addressof(callable))))
+        , m_invoke([](void* callable, Args... args) -> R {
+            return std::invoke(*static_cast<std::remove_reference_t<F>*>(callable), std::forward<Args>(args)...);
+        })
+    {
+    }
+
+    inline R operator()(Args... args) const { return m_invoke(m_callable, std::forward<Args>(args)...); }
+
+    ~FunctionRef() = default;
+
+private:
+    void* m_callable;
+    R (*m_invoke)(void*, Args...);
+
+public:
+    FunctionRef& operator=(const FunctionRef&) = default;
+    FunctionRef& operator=(FunctionRef&&) = default;
+};
+
+} // namespace GE
+
+#endif // FUNCTIONREF_HPP
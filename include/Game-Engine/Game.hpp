@@ -39,8 +39,17 @@ public:
     Game(AssetManager* assetManager, const ScriptLibrary* scriptLibrary, const Descriptor& descriptor);
 
     auto& activeScene(this auto&& self) { return *self.m_activeScene; }
+    // the scripts of the scene are setup immediately, its assets may still be loading
+    // unless the scene was preloaded, the assets shared with the previous scene stay loaded
     void setActiveScene(const std::string& name);
 
+    // start loading the assets of a scene, and their dependencies, while an other one is active
+    void preloadScene(const std::string& name);
+    inline AssetManager::LoadProgress sceneLoadProgress(const std::string& name) const { return m_scenes.at(name).loadProgress(); }
+
+    // release the assets of a preloaded scene that will not be activated
+    void cancelScenePreload(const std::string& name);
+
     auto& inputContext(this auto&& self) { return self.m_inputContext; }
 
     ~Game();
@@ -0,0 +1,185 @@
+/*
+ * ---------------------------------------------------
+ * GeometryPool.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Packs the vertex data of every loaded mesh into a few large shared
+ * vertex buffers (pages) so a model with hundreds of submeshes does not
+ * need hundreds of GPU allocations, and the geometry pass can keep the
+ * same vertex buffer bound across submeshes.
+ *
+ * The pages are device local. Each one has a host visible staging buffer of
+ * the same size the vertices are written to, copied to the page by upload().
+ * The Graphics copies have no offsets, so a page is copied from its start:
+ * the ranges below the uploaded ones are rewritten with the content they
+ * already have, or are not used yet and rewritten by their own upload later.
+ *
+ * The holes left by the unloaded meshes are filled by relocating the live
+ * ranges above them: the vertices are copied into the lowest free room of
+ * the pool and the owner switches to the copy, the original range is then
+ * released like any other, after the frames in flight. The owners rebuild
+ * their offset indices from the mesh data they keep, see StreamedMesh.
+ *
+ * Only the vertices are pooled, drawIndexedVertices draws a whole index
+ * buffer, without a first index nor a count, so the index buffers of the
+ * submeshes and of their levels of detail stay separate.
+ *
+ */
+
+#ifndef GEOMETRYPOOL_HPP
+#define GEOMETRYPOOL_HPP
+
+#include "Game-Engine/Export.hpp"
+
+#include <Graphics/Buffer.hpp>
+#include <Graphics/CommandBuffer.hpp>
+#include <Graphics/Device.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace GE
+{
+
+// first fit free-list allocator over a range of elements, adjacent free ranges are merged on free
+class GE_API RangeAllocator
+{
+public:
+    RangeAllocator() = default;
+    RangeAllocator(const RangeAllocator&) = default;
+    RangeAllocator(RangeAllocator&&) = default;
+
+    explicit RangeAllocator(uint32_t capacity);
+
+    std::optional<uint32_t> allocate(uint32_t count);
+    void free(uint32_t offset, uint32_t count);
+
+    inline uint32_t capacity() const { return m_capacity; }
+    inline uint32_t freeCount() const { return m_freeCount; }
+    inline uint32_t usedCount() const { return m_capacity - m_freeCount; }
+    inline size_t freeRangeCount() const { return m_freeRanges.size(); }
+    uint32_t largestFreeRange() const;
+    inline bool isEmpty() const { return m_freeCount == m_capacity; }
+
+    ~RangeAllocator() = default;
+
+private:
+    uint32_t m_capacity = 0;
+    uint32_t m_freeCount = 0;
+    std::map<uint32_t, uint32_t> m_freeRanges; // offset -> count
+
+public:
+    RangeAllocator& operator=(const RangeAllocator&) = default;
+    RangeAllocator& operator=(RangeAllocator&&) = default;
+};
+
+class GE_API GeometryPool
+{
+public:
+    struct Allocation
+    {
+        std::shared_ptr<gfx::Buffer> buffer;
+        std::shared_ptr<gfx::Buffer> stagingBuffer; // of the page, where the vertices are written
+        uint32_t offset = 0; // in vertices
+        uint32_t count = 0;
+        uint32_t stride = 0;
+    };
+
+    struct Statistics
+    {
+        uint32_t pageCount = 0;
+        size_t reservedBytes = 0;
+        size_t usedBytes = 0;
+        size_t freeRangeCount = 0;
+        uint32_t pendingFreeCount = 0;
+    };
+
+    static constexpr uint32_t DEFAULT_PAGE_VERTEX_COUNT = 1u << 18;
+
+public:
+    GeometryPool() = delete;
+    GeometryPool(const GeometryPool&) = delete;
+    GeometryPool(GeometryPool&&) = delete;
+
+    GeometryPool(gfx::Device*, uint32_t pageVertexCount = DEFAULT_PAGE_VERTEX_COUNT);
+
+    // the returned allocation keeps the range reserved, when the last copy is
+    // released the range is given back to its page after the frames in flight are done with it,
+    // the vertices are written to the staging buffer of the page, not uploaded
+    template<typename V>
+    std::shared_ptr<const Allocation> allocateVertices(std::span<const V> vertices)
+    {
+        static_assert(std::is_trivially_copyable_v<V>);
+        assert(vertices.size() <= UINT32_MAX);
+        return allocate(sizeof(V), static_cast<uint32_t>(vertices.size()), std::as_bytes(vertices));
+    }
+
+    // a copy of the allocation lower in the pool, in an earlier page or at a lower offset of its page, null if
+    // there is no such room, the vertices are copied in the staging buffers and the original is kept until it is released
+    std::shared_ptr<const Allocation> relocate(const Allocation&);
+
+    // record the copies of the pages of the allocations, once per page up to its highest allocation, in
+    // a blit pass the caller begins and ends, return the bytes copied
+    size_t upload(gfx::CommandBuffer&, std::span<const std::shared_ptr<const Allocation>>) const;
+
+    // ranges given back to the pages since the creation of the pool, nothing can be relocated until it changes
+    uint64_t retiredFreeCount() const;
+
+    // to be called once per rendered frame
+    void endFrame();
+
+    Statistics statistics() const;
+
+    ~GeometryPool() = default;
+
+private:
+    struct Page
+    {
+        std::shared_ptr<gfx::Buffer> buffer;
+        std::shared_ptr<gfx::Buffer> stagingBuffer;
+        RangeAllocator allocator;
+    };
+
+    struct PendingFree
+    {
+        std::shared_ptr<Page> page;
+        uint32_t offset;
+        uint32_t count;
+        uint64_t frame;
+    };
+
+    struct State
+    {
+        std::mutex mutex;
+        uint64_t frame = 0;
+        std::map<uint32_t, std::vector<std::shared_ptr<Page>>> pages; // stride -> pages
+        std::vector<PendingFree> pendingFrees;
+        uint64_t retiredFreeCount = 0;
+    };
+
+    std::shared_ptr<const Allocation> allocate(uint32_t stride, uint32_t count, std::span<const std::byte> data);
+    std::shared_ptr<const Allocation> newAllocation(const std::shared_ptr<Page>&, uint32_t offset, uint32_t count, uint32_t stride) const;
+
+    gfx::Device* m_device = nullptr;
+    uint32_t m_pageVertexCount = DEFAULT_PAGE_VERTEX_COUNT;
+    std::shared_ptr<State> m_state; // shared with the allocations so they can outlive the pool
+
+public:
+    GeometryPool& operator=(const GeometryPool&) = delete;
+    GeometryPool& operator=(GeometryPool&&) = delete;
+};
+
+} // namespace GE
+
+#endif // GEOMETRYPOOL_HPP
@@ -0,0 +1,33 @@
+/*
+ * ---------------------------------------------------
+ * Hash.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Non cryptographic 64 bit hash used to key the content of cached assets.
+ *
+ */
+
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include "Game-Engine/Export.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace GE
+{
+
+GE_API uint64_t hashBytes(std::span<const std::byte> bytes, uint64_t seed = 0);
+
+constexpr uint64_t hashCombine(uint64_t lhs, uint64_t rhs)
+{
+    return lhs ^ (rhs + 0x9e3779b97f4a7c15ULL + (lhs << 6) + (lhs >> 2));
+}
+
+} // namespace GE
+
+#endif // HASH_HPP
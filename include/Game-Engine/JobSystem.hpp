@@ -0,0 +1,80 @@
+/*
+ * ---------------------------------------------------
+ * JobSystem.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Fixed pool of worker threads running the iterations of a parallel loop.
+ * The calling thread takes part in the loop, so a system without workers
+ * runs it inline. Each iteration is given the index of the thread running
+ * it, 0 for the calling thread, so the callers can keep per thread data
+ * such as the command buffer pools without locking.
+ *
+ */
+
+#ifndef JOBSYSTEM_HPP
+#define JOBSYSTEM_HPP
+
+#include "Game-Engine/Export.hpp"
+#include "Game-Engine/FunctionRef.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GE
+{
+
+class GE_API JobSystem
+{
+public:
+    // one thread per core, the calling one included, with at most 7 workers
+    static uint32_t defaultWorkerCount();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem(JobSystem&&) = delete;
+
+    explicit JobSystem(uint32_t workerCount = defaultWorkerCount());
+
+    // the workers plus the calling thread
+    inline uint32_t threadCount() const { return static_cast<uint32_t>(m_workers.size()) + 1; }
+
+    // `job(index, threadIndex)` for each index in [0, count), returns when they are all done,
+    // the first exception thrown by a job is rethrown once the others are done.
+    // Not reentrant, the jobs must not call `parallelFor`. Nothing is allocated
+    void parallelFor(uint32_t count, FunctionRef<void(uint32_t index, uint32_t threadIndex)> job);
+
+    ~JobSystem();
+
+private:
+    void workerLoop(uint32_t threadIndex);
+    void runJobs(uint32_t threadIndex);
+
+    std::mutex m_submitMutex; // one loop at a time
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_doneCondition;
+    uint64_t m_generation = 0; // incremented by each loop, wakes the workers
+    uint32_t m_doneWorkerCount = 0;
+    bool m_stop = false;
+
+    const FunctionRef<void(uint32_t, uint32_t)>* m_job = nullptr;
+    uint32_t m_jobCount = 0;
+    std::atomic<uint32_t> m_nextJob = 0;
+    std::exception_ptr m_exception;
+
+    std::vector<std::thread> m_workers;
+
+public:
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+};
+
+} // namespace GE
+
+#endif // JOBSYSTEM_HPP
@@ -0,0 +1,110 @@
+/*
+ * ---------------------------------------------------
+ * LightClusters.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Clustered forward shading of the point lights. The view frustum is split
+ * in clusters, tiles of the normalized device coordinates by slices of
+ * depth growing exponentially, and each cluster lists the lights whose
+ * sphere of influence may reach it, so a fragment only evaluates the
+ * lights of its cluster. The grid is built on the cpu every frame: the
+ * sphere of a light is tested against the planes bounding the columns,
+ * rows and slices of the grid, then the light is added to the clusters of
+ * the ranges it overlaps.
+ *
+ */
+
+#ifndef LIGHTCLUSTERS_HPP
+#define LIGHTCLUSTERS_HPP
+
+#include "Game-Engine/Export.hpp"
+#include "Game-Engine/MeshLod.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace GE
+{
+
+// fraction of its brightest channel under which a point light does not light anymore
+constexpr float POINT_LIGHT_CUTOFF = 1.0f / 256.0f;
+
+// distance at which a light of falloff 1 / (1 + attenuation * distance^2) gets under the cutoff, infinite without attenuation
+GE_API float pointLightRadius(const glm::vec3& color, float attenuation);
+
+class GE_API LightClusterGrid
+{
+public:
+    static constexpr uint32_t DEFAULT_TILE_COUNT_X = 16;
+    static constexpr uint32_t DEFAULT_TILE_COUNT_Y = 9;
+    static constexpr uint32_t DEFAULT_SLICE_COUNT = 24;
+
+    // range of the light indices
+    struct Cluster
+    {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    LightClusterGrid(const LightClusterGrid&) = default;
+    LightClusterGrid(LightClusterGrid&&) = default;
+
+    LightClusterGrid(uint32_t tileCountX = DEFAULT_TILE_COUNT_X, uint32_t tileCountY = DEFAULT_TILE_COUNT_Y, uint32_t sliceCount = DEFAULT_SLICE_COUNT);
+
+    // the depths are the w clip coordinate, the distance along the view direction for a rigid view matrix,
+    // the lights with an infinite radius are not assigned, they light every fragment
+    // the memory is kept for the next frame
+    void build(const glm::mat4x4& viewProjectionMatrix, float nearDepth, float farDepth, std::span<const BoundingSphere> lights);
+
+    inline const glm::uvec3& size() const { return m_size; }
+    inline uint32_t clusterIndex(const glm::uvec3& cluster) const { return (cluster.z * m_size.y + cluster.y) * m_size.x + cluster.x; }
+
+    // the cluster of a world space position in front of the camera, with the mapping of the shader
+    // which clamps the positions outside of the frustum to the border clusters
+    glm::uvec3 clusterOf(const glm::vec3& position) const;
+
+    // x first, then y, then z
+    inline std::span<const Cluster> clusters() const { return m_clusters; }
+    // indices in the lights of the last build
+    inline std::span<const uint32_t> lightIndices() const { return m_lightIndices; }
+
+    // the slice of a depth is floor(log2(depth) * depthScale + depthBias)
+    inline float depthScale() const { return m_depthScale; }
+    inline float depthBias() const { return m_depthBias; }
+
+    ~LightClusterGrid() = default;
+
+private:
+    struct LightRange
+    {
+        uint32_t light;
+        glm::uvec3 min;
+        glm::uvec3 max; // included
+    };
+
+    uint32_t sliceOf(float depth) const;
+
+    glm::uvec3 m_size;
+    glm::mat4x4 m_viewProjectionMatrix = glm::mat4x4(1.0f);
+    float m_depthScale = 0.0f;
+    float m_depthBias = 0.0f;
+
+    std::vector<glm::vec4> m_columnPlanes; // normalized, positive on the side of the greater coordinate
+    std::vector<glm::vec4> m_rowPlanes;
+    std::vector<LightRange> m_lightRanges;
+    std::vector<Cluster> m_clusters;
+    std::vector<uint32_t> m_lightIndices;
+
+public:
+    LightClusterGrid& operator=(const LightClusterGrid&) = default;
+    LightClusterGrid& operator=(LightClusterGrid&&) = default;
+};
+
+} // namespace GE
+
+#endif // LIGHTCLUSTERS_HPP
@@ -0,0 +1,80 @@
+/*
+ * ---------------------------------------------------
+ * LinearAllocator.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Bump allocator for the scratch data of a frame, released all at once by
+ * the reset at the start of the next frame using it. The memory grows by
+ * blocks during the first frames, a reset after a frame which needed more
+ * than one block replaces them by a single block big enough, so the frames
+ * after it do not allocate anymore.
+ *
+ */
+
+#ifndef LINEARALLOCATOR_HPP
+#define LINEARALLOCATOR_HPP
+
+#include "Game-Engine/Export.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace GE
+{
+
+class GE_API LinearAllocator
+{
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    LinearAllocator(const LinearAllocator&) = delete;
+    LinearAllocator(LinearAllocator&&) = default;
+
+    explicit LinearAllocator(size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    // valid until the next reset, `alignment` must be a power of two
+    void* allocate(size_t size, size_t alignment);
+
+    // default initialized, nothing is destroyed by the reset
+    template<typename T>
+        requires std::is_trivially_destructible_v<T>
+    std::span<T> allocate(size_t count)
+    {
+        T* elements = static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+        std::uninitialized_default_construct_n(elements, count);
+        return std::span<T>(elements, count);
+    }
+
+    void reset();
+
+    inline size_t usedBytes() const { return m_usedBytes; }
+    size_t capacity() const;
+
+    ~LinearAllocator() = default;
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> memory;
+        size_t size;
+    };
+
+    size_t m_blockSize;
+    std::vector<Block> m_blocks;
+    size_t m_currentBlock = 0;
+    size_t m_offset = 0; // in the current block
+    size_t m_usedBytes = 0;
+
+public:
+    LinearAllocator& operator=(const LinearAllocator&) = delete;
+    LinearAllocator& operator=(LinearAllocator&&) = default;
+};
+
+} // namespace GE
+
+#endif // LINEARALLOCATOR_HPP
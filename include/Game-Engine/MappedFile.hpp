@@ -0,0 +1,51 @@
+/*
+ * ---------------------------------------------------
+ * MappedFile.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include "Game-Engine/Export.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace GE
+{
+
+// read only memory mapping of a whole file
+class GE_API MappedFile
+{
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) noexcept;
+
+    explicit MappedFile(const std::filesystem::path&); // throw std::runtime_error if the file cannot be mapped
+
+    inline std::span<const std::byte> bytes() const { return std::span(m_data, m_size); }
+    inline size_t size() const { return m_size; }
+
+    ~MappedFile();
+
+private:
+    const std::byte* m_data = nullptr;
+    size_t m_size = 0;
+#if defined(_WIN32)
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+
+public:
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) noexcept;
+};
+
+} // namespace GE
+
+#endif // MAPPEDFILE_HPP
@@ -10,10 +10,16 @@
 #ifndef MESH_HPP
 #define MESH_HPP
 
+#include "Game-Engine/Culling.hpp"
+#include "Game-Engine/GeometryPool.hpp"
+#include "Game-Engine/MeshLod.hpp"
+#include "Game-Engine/VertexFormat.hpp"
+
 #include <Graphics/Buffer.hpp>
 
 #include <glm/glm.hpp>
 
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <vector>
@@ -21,20 +27,28 @@
 namespace GE
 {
 
-struct Vertex
-{
-    glm::vec3 pos;
-    glm::vec2 uv;
-    glm::vec3 normal;
-    glm::vec3 tangent;
-};
-
 struct SubMesh
 {
+    struct Lod
+    {
+        std::shared_ptr<gfx::Buffer> indexBuffer;
+        uint32_t indexCount = 0;
+        float error = 0.0f; // in object space units
+    };
+
     std::string name;
     glm::mat4x4 transform;
-    std::shared_ptr<gfx::Buffer> vertexBuffer;
-    std::shared_ptr<gfx::Buffer> indexBuffer;
+    std::shared_ptr<gfx::Buffer> vertexBuffer; // geometry pool page, shared with other submeshes
+    std::shared_ptr<gfx::Buffer> indexBuffer;  // indices are already offset by `vertexOffset`
+    uint32_t vertexOffset = 0;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    VertexFormat vertexFormat = VertexFormat::full;
+    PositionQuantization positionQuantization; // VertexFormat::packed only
+    std::vector<Lod> lods;                     // coarser levels of detail, `indexBuffer` is the level 0
+    BoundingSphere boundingSphere;             // in the submesh space, without `transform`
+    BoundingBox boundingBox;                   // in the submesh space too, of this submesh only, not of its children
+    std::shared_ptr<const GeometryPool::Allocation> vertexAllocation;
     // std::shared_ptr<Material> material;
     std::vector<SubMesh> subMeshes;
 };
@@ -43,6 +57,7 @@ struct Mesh
 {
     std::string name;
     std::vector<SubMesh> subMeshes;
+    BoundingBox boundingBox; // of all the submeshes with their transforms, in the mesh space
 };
 
 }
@@ -0,0 +1,130 @@
+/*
+ * ---------------------------------------------------
+ * MeshData.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * CPU side representation of a mesh, produced either by importing the
+ * source file with assimp or by mapping its cooked version from the mesh
+ * cache. The cooked file is keyed by the hash of the source file content
+ * and of the import settings, so a modified source is cooked again, the
+ * files read alongside the source (gltf buffers, obj materials, ...) are
+ * recorded with their own hash and also checked.
+ *
+ */
+
+#ifndef MESHDATA_HPP
+#define MESHDATA_HPP
+
+#include "Game-Engine/Culling.hpp"
+#include "Game-Engine/Export.hpp"
+#include "Game-Engine/Mesh.hpp"
+#include "Game-Engine/MeshLod.hpp"
+#include "Game-Engine/VertexFormat.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace GE
+{
+
+struct MeshData
+{
+    // simplified version of a geometry, using the same vertices
+    struct Lod
+    {
+        std::span<const uint32_t> indices;
+        float error; // in object space units
+    };
+
+    struct Geometry
+    {
+        std::string name;
+        std::variant<std::span<const Vertex>, std::span<const PackedVertex>> vertices; // alternative index is the VertexFormat
+        std::span<const uint32_t> indices;
+        PositionQuantization positionQuantization; // VertexFormat::packed only
+        std::vector<Lod> lods;                     // coarser levels of detail, ordered by increasing error
+        BoundingSphere boundingSphere;
+        BoundingBox boundingBox;
+
+        inline VertexFormat vertexFormat() const { return static_cast<VertexFormat>(vertices.index()); }
+        inline size_t vertexCount() const { return std::visit([](auto span) { return span.size(); }, vertices); }
+        inline size_t indexCount() const { return indices.size(); }
+        inline size_t vertexBytes() const { return std::visit([](auto span) { return span.size_bytes(); }, vertices); }
+        inline size_t indexBytes() const { return indices.size_bytes(); }
+    };
+
+    // flattened SubMesh tree, a node always comes after its parent
+    struct Node
+    {
+        uint32_t geometry;
+        int32_t parent; // -1 for the Mesh::subMeshes
+        glm::mat4x4 transform;
+    };
+
+    // other files read by the import, like the .bin of a .gltf
+    struct Dependency
+    {
+        std::string path; // relative to the directory of the source
+        uint64_t hash;
+    };
+
+    std::string name;
+    std::vector<Geometry> geometries;
+    std::vector<Node> nodes;
+    std::vector<Dependency> dependencies;
+    std::shared_ptr<const void> storage; // owns the memory viewed by the geometries
+};
+
+struct MeshCookOptions
+{
+    VertexFormat vertexFormat = VertexFormat::packed;
+    bool optimize = true;     // reorder the triangles and vertices for the post transform cache, overdraw and vertex fetch
+    uint32_t lodCount = 3;    // levels of detail generated in addition to the full detail geometry
+    float lodReduction = 0.5f; // triangle count of a level relative to the previous one
+    float lodMaxError = 0.05f; // relative to the bounding sphere radius, no more levels are generated past it
+};
+
+// import the source file using assimp, throw std::runtime_error on failure
+GE_API MeshData importMesh(const std::filesystem::path&);
+
+// same from the content of the source file already read in memory, the files it references are read next to `path`
+GE_API MeshData importMesh(const std::filesystem::path&, std::span<const std::byte> sourceContent);
+
+// convert the geometries to the vertex format and index width of the options
+GE_API MeshData cookMesh(const MeshData&, const MeshCookOptions&);
+
+// key of the cooked version of a source file content
+GE_API uint64_t cookedMeshKey(std::span<const std::byte> sourceContent, const MeshCookOptions&);
+
+// return std::nullopt if the file is missing, invalid or was cooked from an other source
+GE_API std::optional<MeshData> readCookedMesh(const std::filesystem::path&, uint64_t key);
+
+// same from the content of a cooked file, read in place, `storage` owns the memory viewed by `file`
+GE_API std::optional<MeshData> readCookedMesh(std::span<const std::byte> file, std::shared_ptr<const void> storage, uint64_t key);
+
+// the file is written next to its destination then renamed so readers never see a partial file
+GE_API void writeCookedMesh(const std::filesystem::path&, const MeshData&, uint64_t key);
+
+// content of the cooked file
+GE_API std::vector<std::byte> serializeCookedMesh(const MeshData&, uint64_t key);
+
+// use the cooked mesh from the cache directory if up to date, otherwise import and cook it
+// an empty cache directory disable the cache
+GE_API MeshData loadMeshData(const std::filesystem::path&, const std::filesystem::path& cacheDirectory, const MeshCookOptions& = MeshCookOptions{});
+
+// same with the content of the source file already read in memory
+GE_API MeshData loadMeshData(const std::filesystem::path&, std::span<const std::byte> sourceContent, const std::filesystem::path& cacheDirectory, const MeshCookOptions& = MeshCookOptions{});
+
+} // namespace GE
+
+#endif // MESHDATA_HPP
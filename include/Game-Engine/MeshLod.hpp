@@ -0,0 +1,66 @@
+/*
+ * ---------------------------------------------------
+ * MeshLod.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Level of detail selection. Each level stores the geometric error of its
+ * simplification in object space units, the selected level is the coarsest
+ * one whose error projects to less than a given number of pixels on screen.
+ *
+ */
+
+#ifndef MESHLOD_HPP
+#define MESHLOD_HPP
+
+#include "Game-Engine/Export.hpp"
+#include "Game-Engine/VertexFormat.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+
+namespace GE
+{
+
+constexpr float DEFAULT_LOD_PIXEL_ERROR = 1.0f;
+
+struct BoundingSphere
+{
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+};
+
+GE_API BoundingSphere boundingSphere(std::span<const Vertex>);
+
+// cotangent of the half vertical field of view, from a perspective view projection matrix with a rigid view matrix
+GE_API float projectionScale(const glm::mat4x4& viewProjectionMatrix);
+
+// radius in pixels of the sphere once projected, infinity when the camera is inside of it
+GE_API float projectedSphereRadius(const BoundingSphere& sphere, const glm::mat4x4& modelMatrix, const glm::vec3& cameraPosition, float projectionScale, float viewportHeight);
+
+// `lodErrors` are the errors of the levels after the full detail one, in increasing order
+// return 0 for the full detail geometry or the index in `lodErrors` plus one
+template<std::ranges::random_access_range R>
+uint32_t selectLod(R&& lodErrors, float sphereRadius, float projectedRadius, float maxPixelError = DEFAULT_LOD_PIXEL_ERROR)
+{
+    if (sphereRadius <= 0.0f || projectedRadius == std::numeric_limits<float>::infinity())
+        return 0;
+    const float pixelsPerUnit = projectedRadius / sphereRadius;
+    uint32_t lod = 0;
+    for (float error : lodErrors)
+    {
+        if (error * pixelsPerUnit > maxPixelError)
+            break;
+        lod++;
+    }
+    return lod;
+}
+
+} // namespace GE
+
+#endif // MESHLOD_HPP
@@ -0,0 +1,61 @@
+/*
+ * ---------------------------------------------------
+ * MeshOptimizer.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Triangle and vertex reordering run when a mesh is cooked:
+ *  - vertex cache optimization using Tipsify (Sander, Nehab, Barczak 2007)
+ *  - overdraw optimization by sorting the clusters found by Tipsify so
+ *    the outward facing ones are drawn first
+ *  - vertex fetch optimization, vertices ordered by first use
+ *  - simplification by edge collapses ordered with quadric error metrics
+ *    (Garland, Heckbert 1997) used to build the levels of detail
+ *
+ */
+
+#ifndef MESHOPTIMIZER_HPP
+#define MESHOPTIMIZER_HPP
+
+#include "Game-Engine/Export.hpp"
+#include "Game-Engine/VertexFormat.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace GE
+{
+
+constexpr uint32_t DEFAULT_VERTEX_CACHE_SIZE = 16;
+
+struct VertexCacheStatistics
+{
+    uint32_t transformedVertexCount = 0;
+    float acmr = 0.0f; // average cache miss ratio, transformed vertices per triangle (0.5 best, 3 worst)
+    float atvr = 0.0f; // average transformed vertex ratio, transformed vertices per used vertex (1 best)
+};
+
+// simulate a FIFO post transform cache of `cacheSize` vertices
+GE_API VertexCacheStatistics analyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+// return the reordered triangles, `clusters` receives the first triangle of each
+// cache coherent run of triangles, to be used by optimizeOverdraw
+GE_API std::vector<uint32_t> optimizeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, std::vector<uint32_t>* clusters = nullptr, uint32_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+// reorder the clusters so the outer ones are drawn first, clusters are split further as long
+// as their ACMR stays under `threshold` times the ACMR of the input
+GE_API std::vector<uint32_t> optimizeOverdraw(std::span<const uint32_t> indices, std::span<const Vertex> vertices, std::span<const uint32_t> clusters, float threshold = 1.05f, uint32_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+// reorder the vertices by first use and drop the unused ones, indices are remapped in place
+GE_API std::vector<Vertex> optimizeVertexFetch(std::span<const Vertex> vertices, std::span<uint32_t> indices);
+
+// collapse edges until the triangle count reaches `targetIndexCount` / 3 or until the next collapse
+// would move the surface further than `targetError`, the vertices of the border and of the attribute
+// seams are kept in place, `resultError` receives the error of the simplified mesh
+GE_API std::vector<uint32_t> simplifyMesh(std::span<const uint32_t> indices, std::span<const Vertex> vertices, size_t targetIndexCount, float targetError, float* resultError = nullptr);
+
+} // namespace GE
+
+#endif // MESHOPTIMIZER_HPP
@@ -0,0 +1,87 @@
+/*
+ * ---------------------------------------------------
+ * RenderQueue.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Draws of a frame ordered by a 64 bits key: pipeline, then material, then
+ * geometry, then depth. Sorting the keys groups the state changes and puts
+ * the draws of the same geometry next to each other, front to back, so the
+ * recording only binds a state when it changes. The keys are sorted by a
+ * radix sort which skips the bytes shared by all of them.
+ *
+ */
+
+#ifndef RENDERQUEUE_HPP
+#define RENDERQUEUE_HPP
+
+#include "Game-Engine/Export.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace GE
+{
+
+// most significant first
+constexpr uint32_t SORT_KEY_PIPELINE_BITS = 8;
+constexpr uint32_t SORT_KEY_MATERIAL_BITS = 16;
+constexpr uint32_t SORT_KEY_GEOMETRY_BITS = 24;
+constexpr uint32_t SORT_KEY_DEPTH_BITS = 16;
+
+// `depth` is the distance to the camera, the negative ones are clamped to 0
+GE_API uint64_t makeSortKey(uint32_t pipeline, uint32_t material, uint32_t geometry, float depth);
+
+// the draws with the same batch key only differ by their depth
+inline uint64_t sortKeyBatch(uint64_t sortKey) { return sortKey >> SORT_KEY_DEPTH_BITS; }
+
+class GE_API RenderQueue
+{
+public:
+    struct Item
+    {
+        uint64_t sortKey;
+        uint32_t draw; // index in the draws of the caller
+    };
+
+    // consecutive sorted items with the same batch key, each could be one instanced
+    // draw, but the draws of gfx have no instance count yet and are recorded one by one
+    struct Batch
+    {
+        uint32_t firstItem;
+        uint32_t itemCount;
+    };
+
+    RenderQueue() = default;
+    RenderQueue(const RenderQueue&) = default;
+    RenderQueue(RenderQueue&&) = default;
+
+    // the memory is kept for the next frame
+    void clear();
+
+    inline void push(uint64_t sortKey, uint32_t draw) { m_items.push_back({ .sortKey = sortKey, .draw = draw }); }
+
+    // stable, the items with equal keys keep their push order, then find the batches
+    void sort();
+
+    inline std::span<const Item> items() const { return m_items; }
+    inline std::span<const Batch> batches() const { return m_batches; }
+    inline uint32_t size() const { return static_cast<uint32_t>(m_items.size()); }
+
+    ~RenderQueue() = default;
+
+private:
+    std::vector<Item> m_items;
+    std::vector<Item> m_scratchItems;
+    std::vector<Batch> m_batches;
+
+public:
+    RenderQueue& operator=(const RenderQueue&) = default;
+    RenderQueue& operator=(RenderQueue&&) = default;
+};
+
+} // namespace GE
+
+#endif // RENDERQUEUE_HPP
@@ -12,8 +12,15 @@
 
 #include "Game-Engine/Export.hpp"
 #include "Game-Engine/FrameGraph.hpp"
+#include "Game-Engine/FrameResources.hpp"
+#include "Game-Engine/FunctionRef.hpp"
+#include "Game-Engine/JobSystem.hpp"
+#include "Game-Engine/LinearAllocator.hpp"
+#include "Game-Engine/VertexFormat.hpp"
 
+#include <Graphics/CommandBuffer.hpp>
 #include <Graphics/Device.hpp>
+#include <Graphics/Framebuffer.hpp>
 #include <Graphics/Surface.hpp>
 #include <Graphics/Swapchain.hpp>
 #include <Graphics/Texture.hpp>
@@ -24,7 +31,7 @@
 #include <array>
 #include <map>
 #include <memory>
-#include <set>
+#include <vector>
 
 #define cfd m_inFlightDatas.at(m_frameIdx)
 
@@ -42,30 +49,58 @@ public:
 
     Renderer(gfx::Device*, gfx::Surface*);
 
+    // once the frame in flight it reuses has recorded the same graph, nothing is allocated by the renderer
     void renderFrame(const FrameGraph&);
 
     ~Renderer();
 
 private:
+    // the pools are not thread safe, each thread recording the jobs of a pass has its owns
+    struct ThreadPools
+    {
+        std::unique_ptr<gfx::CommandBufferPool> commandBufferPool;
+        std::unique_ptr<gfx::ParameterBlockPool> parameterBlockPool;
+    };
+
     struct InFlightData
     {
         std::unique_ptr<gfx::CommandBufferPool> commandBufferPool;
         std::unique_ptr<gfx::ParameterBlockPool> parameterBlockPool;
-        gfx::CommandBuffer* waitedCmdBuffer = nullptr;
+        std::vector<ThreadPools> jobPools; // by thread index of the job system
+
+        std::unique_ptr<FrameResources> resources;
+        LinearAllocator frameAllocator;
 
-        std::map<gfx::Texture::Descriptor, std::set<std::shared_ptr<gfx::Texture>>> textureCache;
-        std::map<gfx::Buffer::Descriptor, std::set<std::shared_ptr<gfx::Buffer>>> bufferCache;
+        // cleared when the frame in flight is reused, the vectors keep their memory
+        std::vector<std::shared_ptr<gfx::CommandBuffer>> commandBuffers; // submitted in this order
+        std::vector<std::shared_ptr<gfx::CommandBuffer>> jobCommandBuffers;
+        std::vector<gfx::Framebuffer> framebuffers; // by compiled pass
+        std::vector<gfx::Framebuffer> continuedFramebuffers; // loading what was recorded before the jobs of the pass
     };
 
+    // the pass being executed, for its jobs
+    struct PassRecording
+    {
+        const FrameGraph::CompiledPass* compiledPass = nullptr;
+        gfx::CommandBuffer* commandBuffer = nullptr;
+        const gfx::Framebuffer* continuedFramebuffer = nullptr;
+        bool recordedJobs = false;
+    };
+
+    void recordParallel(uint32_t jobCount, FunctionRef<void(uint32_t, FramePassExecuteContext&)> job);
+
     gfx::Device* m_device;
     gfx::Surface* m_surface;
 
     std::shared_ptr<gfx::ParameterBlockLayout> m_frameDataBlockLayout;
     std::shared_ptr<gfx::ParameterBlockLayout> m_materialBlockLayout;
-    std::shared_ptr<gfx::GraphicsPipeline> m_gfxPipeline; // only one for now
+    std::map<VertexFormat, std::shared_ptr<gfx::GraphicsPipeline>> m_gfxPipelines; // one per vertex format
 
     std::unique_ptr<gfx::Swapchain> m_swapchain;
 
+    JobSystem m_jobSystem;
+    PassRecording m_passRecording;
+
     uint8_t m_frameIdx = 0;
     std::array<InFlightData, maxFrameInFlight> m_inFlightDatas;
 
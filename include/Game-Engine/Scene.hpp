@@ -10,6 +10,7 @@
 #ifndef SCENE_HPP
 #define SCENE_HPP
 
+#include "Game-Engine/AabbTree.hpp"
 #include "Game-Engine/AssetManager.hpp"
 #include "Game-Engine/AssetManagerView.hpp"
 #include "Game-Engine/Components.hpp"
@@ -58,19 +59,37 @@ public:
 
     inline bool isLoaded() const { return m_assetManagerView.areAllAssetsLoaded(); }
     inline std::future<void> load() const { return m_assetManagerView.loadAllAssets(); }
+    inline AssetManager::LoadProgress loadProgress() const { return m_assetManagerView.allAssetsLoadProgress(); }
     inline void unload() { m_assetManagerView.unloadAllAssets(); }
 
     Descriptor makeDescriptor() const;
 
+    // world space boxes of the entities with a transform and a loaded mesh, the user data is the entity id
+    inline const AabbTree& spatialIndex() const { return m_spatialIndex; }
+
+    // recompute the boxes of the entities, the tree only changes for the boxes leaving their margin,
+    // the new entities and the ones removed, or whose mesh is not loaded anymore
+    void updateSpatialIndex();
+
     ~Scene() = default;
 
 private:
+    struct SpatialIndexEntry
+    {
+        AabbTree::NodeID node;
+        uint64_t updateCount; // of the last update that found the entity
+    };
+
     ECSWorld m_ecsWorld;
     AssetManagerView m_assetManagerView;
 
     std::string m_name;
     ECSWorld::EntityID m_activeCamera = INVALID_ENTITY_ID;
 
+    AabbTree m_spatialIndex;
+    std::map<ECSWorld::EntityID, SpatialIndexEntry> m_spatialIndexEntries;
+    uint64_t m_spatialIndexUpdateCount = 0;
+
 public:
     Scene& operator=(const Scene&) = delete;
     Scene& operator=(Scene&&) = default;
@@ -0,0 +1,117 @@
+/*
+ * ---------------------------------------------------
+ * ShardedMap.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Map shared by several threads. The keys are spread by hash over shards
+ * each guarded by a reader writer lock, so lookups only contend with the
+ * insertions in the same shard. Nothing is ever erased, the values stay at
+ * the same address for the lifetime of the map and the pointers returned
+ * by the lookups can be kept. Guarding the values themselves is left to
+ * the caller.
+ *
+ */
+
+#ifndef SHARDEDMAP_HPP
+#define SHARDEDMAP_HPP
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+namespace GE
+{
+
+template<typename Key, typename Value, typename Hash = std::hash<Key>, size_t SHARD_COUNT = 16>
+class ShardedMap
+{
+public:
+    ShardedMap() = default;
+    ShardedMap(const ShardedMap&) = delete;
+    ShardedMap(ShardedMap&&) = delete;
+
+    // nullptr if the key is not in the map
+    Value* find(const Key& key) {
+        Shard& shard = shardOf(key);
+        std::shared_lock lock(shard.mutex);
+        auto it = shard.map.find(key);
+        return it != shard.map.end() ? &it->second : nullptr;
+    }
+
+    const Value* find(const Key& key) const {
+        const Shard& shard = shardOf(key);
+        std::shared_lock lock(shard.mutex);
+        auto it = shard.map.find(key);
+        return it != shard.map.end() ? &it->second : nullptr;
+    }
+
+    inline bool contains(const Key& key) const { return find(key) != nullptr; }
+
+    // the value is constructed from `args` if the key is not in the map yet, true if it was inserted
+    template<typename... Args>
+    std::pair<Value*, bool> tryEmplace(const Key& key, Args&&... args) {
+        Shard& shard = shardOf(key);
+        std::scoped_lock lock(shard.mutex);
+        auto [it, inserted] = shard.map.try_emplace(key, std::forward<Args>(args)...);
+        return { &it->second, inserted };
+    }
+
+    size_t size() const {
+        size_t size = 0;
+        for (const Shard& shard : m_shards)
+        {
+            std::shared_lock lock(shard.mutex);
+            size += shard.map.size();
+        }
+        return size;
+    }
+
+    // shard by shard, the insertions in the shard being visited wait, `fn` must not insert
+    template<typename Fn>
+    void forEach(Fn&& fn) {
+        for (Shard& shard : m_shards)
+        {
+            std::shared_lock lock(shard.mutex);
+            for (auto& [key, value] : shard.map)
+                fn(key, value);
+        }
+    }
+
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Shard& shard : m_shards)
+        {
+            std::shared_lock lock(shard.mutex);
+            for (const auto& [key, value] : shard.map)
+                fn(key, value);
+        }
+    }
+
+    ~ShardedMap() = default;
+
+private:
+    struct alignas(64) Shard // one cache line per lock
+    {
+        mutable std::shared_mutex mutex;
+        std::map<Key, Value> map;
+    };
+
+    inline Shard& shardOf(const Key& key) { return m_shards[Hash{}(key) % SHARD_COUNT]; }
+    inline const Shard& shardOf(const Key& key) const { return m_shards[Hash{}(key) % SHARD_COUNT]; }
+
+    std::array<Shard, SHARD_COUNT> m_shards;
+
+public:
+    ShardedMap& operator=(const ShardedMap&) = delete;
+    ShardedMap& operator=(ShardedMap&&) = delete;
+};
+
+} // namespace GE
+
+#endif // SHARDEDMAP_HPP
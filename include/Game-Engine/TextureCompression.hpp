@@ -0,0 +1,79 @@
+/*
+ * ---------------------------------------------------
+ * TextureCompression.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * CPU encoders and decoders of the BC block compressed formats, an image
+ * is split in 4x4 pixel blocks, the blocks on the right and bottom edges
+ * are padded by repeating the last row and column.
+ *
+ *  - BC1: RGB, 8 bytes per block
+ *  - BC3: RGBA, 16 bytes per block, BC1 color and an interpolated alpha
+ *  - BC5: RG, 16 bytes per block, two interpolated channels (normal maps)
+ *  - BC7: RGBA, 16 bytes per block, only the mode 6 is used by the encoder
+ *
+ */
+
+#ifndef TEXTURECOMPRESSION_HPP
+#define TEXTURECOMPRESSION_HPP
+
+#include "Game-Engine/Export.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace GE
+{
+
+enum class TextureFormat : uint8_t
+{
+    rgba8,
+    bc1,
+    bc3,
+    bc5,
+    bc7
+};
+
+constexpr bool isBlockCompressed(TextureFormat format)
+{
+    return format != TextureFormat::rgba8;
+}
+
+// bytes per pixel for rgba8, bytes per 4x4 block for the compressed formats
+constexpr size_t textureFormatBlockSize(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::rgba8:
+        return 4;
+    case TextureFormat::bc1:
+        return 8;
+    case TextureFormat::bc3:
+    case TextureFormat::bc5:
+    case TextureFormat::bc7:
+        return 16;
+    }
+    return 0;
+}
+
+constexpr size_t textureByteSize(TextureFormat format, uint32_t width, uint32_t height)
+{
+    if (isBlockCompressed(format))
+        return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * textureFormatBlockSize(format);
+    return static_cast<size_t>(width) * height * textureFormatBlockSize(format);
+}
+
+// `pixels` are tightly packed RGBA8
+GE_API std::vector<std::byte> encodeTexture(TextureFormat, std::span<const std::byte> pixels, uint32_t width, uint32_t height);
+
+// return tightly packed RGBA8, BC5 decodes to (R, G, 0, 255), only the BC7 mode written by
+// encodeTexture is supported, throw std::runtime_error for the other modes
+GE_API std::vector<std::byte> decodeTexture(TextureFormat, std::span<const std::byte> bytes, uint32_t width, uint32_t height);
+
+} // namespace GE
+
+#endif // TEXTURECOMPRESSION_HPP
@@ -0,0 +1,110 @@
+/*
+ * ---------------------------------------------------
+ * TextureData.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * CPU side representation of a texture and its mip chain, produced either
+ * by decoding the source image with stb_image or by mapping its cooked
+ * version from the texture cache. Like the meshes, the cooked file is
+ * keyed by the hash of the source file content and of the cook settings.
+ *
+ */
+
+#ifndef TEXTUREDATA_HPP
+#define TEXTUREDATA_HPP
+
+#include "Game-Engine/Export.hpp"
+#include "Game-Engine/TextureCompression.hpp"
+
+#include <Graphics/CommandBuffer.hpp>
+#include <Graphics/Device.hpp>
+#include <Graphics/Texture.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace GE
+{
+
+constexpr uint32_t mipLevelCount(uint32_t width, uint32_t height)
+{
+    return static_cast<uint32_t>(std::bit_width(std::max({ width, height, 1u })));
+}
+
+struct TextureData
+{
+    struct Mip
+    {
+        uint32_t width;
+        uint32_t height;
+        std::span<const std::byte> bytes; // in the format of the texture
+    };
+
+    TextureFormat format = TextureFormat::rgba8;
+    std::vector<Mip> mips; // full resolution first, down to 1x1
+    std::shared_ptr<const void> storage; // owns the memory viewed by the mips
+
+    inline uint32_t width() const { return mips.empty() ? 0 : mips.front().width; }
+    inline uint32_t height() const { return mips.empty() ? 0 : mips.front().height; }
+};
+
+struct TextureCookOptions
+{
+    // The block compressed formats are opt-in, they only save disk space for now: the Graphics
+    // textures have no BC pixel format, so their mips are decoded back to RGBA8 at the upload.
+    TextureFormat format = TextureFormat::rgba8;
+    bool mipmaps = true;
+    bool srgb = true; // the mips of color textures are filtered in linear space
+};
+
+// half resolution version of a RGBA8 image using a box filter, odd rows and columns are folded into the last pixel
+GE_API std::vector<std::byte> downsampleImage(std::span<const std::byte> pixels, uint32_t width, uint32_t height, bool srgb);
+
+// decode the source image to a single RGBA8 mip, throw std::runtime_error on failure
+GE_API TextureData importTexture(const std::filesystem::path&);
+
+// same from the content of the source file already read in memory, `path` only names it in the errors
+GE_API TextureData importTexture(const std::filesystem::path&, std::span<const std::byte> sourceContent);
+
+// generate the mip chain and encode it in the format of the options, the texture must be a single RGBA8 mip
+GE_API TextureData cookTexture(const TextureData&, const TextureCookOptions&);
+
+// RGBA8 pixels of a mip, decoded if the texture is block compressed
+GE_API std::vector<std::byte> decodeMip(const TextureData&, size_t mipIndex);
+
+// key of the cooked version of a source file content
+GE_API uint64_t cookedTextureKey(std::span<const std::byte> sourceContent, const TextureCookOptions&);
+
+// return std::nullopt if the file is missing, invalid or was cooked from an other source
+GE_API std::optional<TextureData> readCookedTexture(const std::filesystem::path&, uint64_t key);
+
+// same from the content of a cooked file, read in place, `storage` owns the memory viewed by `file`
+GE_API std::optional<TextureData> readCookedTexture(std::span<const std::byte> file, std::shared_ptr<const void> storage, uint64_t key);
+
+GE_API void writeCookedTexture(const std::filesystem::path&, const TextureData&, uint64_t key);
+
+// content of the cooked file
+GE_API std::vector<std::byte> serializeCookedTexture(const TextureData&, uint64_t key);
+
+// use the cooked texture from the cache directory if up to date, otherwise import and cook it
+// an empty cache directory disable the cache
+GE_API TextureData loadTextureData(const std::filesystem::path&, const std::filesystem::path& cacheDirectory, const TextureCookOptions& = TextureCookOptions{});
+
+// same with the content of the source file already read in memory
+GE_API TextureData loadTextureData(const std::filesystem::path&, std::span<const std::byte> sourceContent, const std::filesystem::path& cacheDirectory, const TextureCookOptions& = TextureCookOptions{});
+
+// upload the RGBA8 pixels of an image to a new device local texture
+GE_API std::shared_ptr<gfx::Texture> uploadTexture(gfx::Device&, gfx::CommandBuffer&, std::span<const std::byte> pixels, uint32_t width, uint32_t height);
+
+} // namespace GE
+
+#endif // TEXTUREDATA_HPP
@@ -0,0 +1,77 @@
+/*
+ * ---------------------------------------------------
+ * UploadArena.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Linear sub-allocator over one host visible buffer, written in place by
+ * the cpu, for the data uploaded each frame. There is one per frame in
+ * flight, reset once the gpu is done with the frame. When a frame needs
+ * more than the buffer holds it is replaced by one at least twice as big,
+ * with what was already written copied, so after the first frames the
+ * uploads do not create any buffer.
+ *
+ */
+
+#ifndef UPLOADARENA_HPP
+#define UPLOADARENA_HPP
+
+#include "Game-Engine/Export.hpp"
+
+#include <Graphics/Buffer.hpp>
+#include <Graphics/Device.hpp>
+#include <Graphics/Enums.hpp>
+
+#include <cstddef>
+#include <memory>
+
+namespace GE
+{
+
+class GE_API UploadArena
+{
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+    static constexpr size_t MIN_ALIGNMENT = 256; // of the offsets of buffer bindings on every backend
+
+    struct Allocation
+    {
+        std::shared_ptr<gfx::Buffer> buffer; // the one holding the data at the time of the allocation
+        size_t offset;
+        std::byte* data;
+    };
+
+    UploadArena(const UploadArena&) = delete;
+    UploadArena(UploadArena&&) = default;
+
+    UploadArena(gfx::Device*, gfx::BufferUsages, size_t initialCapacity = DEFAULT_CAPACITY);
+
+    // the offset is a multiple of `alignment` and of MIN_ALIGNMENT, the data is valid until the next reset
+    Allocation allocate(size_t size, size_t alignment = 1);
+
+    // the gpu must be done with the buffer
+    void reset();
+
+    // null before the first allocation
+    inline const std::shared_ptr<gfx::Buffer>& buffer() const { return m_buffer; }
+    inline size_t usedBytes() const { return m_usedBytes; }
+
+    ~UploadArena() = default;
+
+private:
+    gfx::Device* m_device;
+    gfx::BufferUsages m_usages;
+    size_t m_initialCapacity;
+
+    std::shared_ptr<gfx::Buffer> m_buffer;
+    size_t m_usedBytes = 0;
+
+public:
+    UploadArena& operator=(const UploadArena&) = delete;
+    UploadArena& operator=(UploadArena&&) = default;
+};
+
+} // namespace GE
+
+#endif // UPLOADARENA_HPP
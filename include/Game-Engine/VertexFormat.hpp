@@ -0,0 +1,84 @@
+/*
+ * ---------------------------------------------------
+ * VertexFormat.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Compressed vertex format produced when a mesh is cooked.
+ *
+ * PackedVertex is 20 bytes instead of the 44 bytes of Vertex:
+ *  - position quantized to 16 bits per axis in the bounding box of its geometry
+ *  - normal octahedral encoded in 2 x snorm12, tangent in 2 x snorm16
+ *  - uv as 2 x half
+ *
+ * The shader reads the position and the normal through one float3 attribute
+ * and decode the raw bits (see vertexMainPacked in flat_color.slang). So the
+ * fetch cannot flush a denormal or canonicalize a NaN, the high byte of the
+ * three words is always 0x3F, their exponent is 126 or 127 whatever the
+ * encoded values.
+ *
+ */
+
+#ifndef VERTEXFORMAT_HPP
+#define VERTEXFORMAT_HPP
+
+#include "Game-Engine/Export.hpp"
+
+#include <Graphics/GraphicsPipeline.hpp>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+
+namespace GE
+{
+
+struct Vertex
+{
+    glm::vec3 pos;
+    glm::vec2 uv;
+    glm::vec3 normal;
+    glm::vec3 tangent;
+};
+
+struct PackedVertex
+{
+    uint32_t posNormal[3]; // quantized position axis in the bits 0-15, 8 bits of the octahedral normal in the bits 16-23
+    uint32_t tangent;      // octahedral snorm16x2
+    uint32_t uv;           // half2
+};
+static_assert(sizeof(PackedVertex) == 20);
+
+enum class VertexFormat : uint8_t
+{
+    full,  // Vertex
+    packed // PackedVertex
+};
+
+// pos = quantized * scale + offset
+struct PositionQuantization
+{
+    glm::vec3 scale = glm::vec3(1.0f);
+    glm::vec3 offset = glm::vec3(0.0f);
+};
+
+GE_API uint32_t vertexSize(VertexFormat);
+GE_API gfx::VertexLayout vertexLayout(VertexFormat);
+
+GE_API uint32_t packOctahedral(const glm::vec3& direction);
+GE_API glm::vec3 unpackOctahedral(uint32_t);
+
+// snorm12x2 in the 24 low bits
+GE_API uint32_t packOctahedral24(const glm::vec3& direction);
+GE_API glm::vec3 unpackOctahedral24(uint32_t);
+
+GE_API PositionQuantization positionQuantization(std::span<const Vertex>);
+
+GE_API PackedVertex packVertex(const Vertex&, const PositionQuantization&);
+GE_API Vertex unpackVertex(const PackedVertex&, const PositionQuantization&);
+
+} // namespace GE
+
+#endif // VERTEXFORMAT_HPP
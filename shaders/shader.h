@@ -21,6 +21,7 @@ namespace shader
     using float3 = glm::vec3;
     using float4 = glm::vec4;
     using float4x4 = glm::mat4;
+    using uint = unsigned int;
     #define SLANG_PUBLIC
     #define SLANG_MODULE_DEF(name)
     #define SLANG_MODULE_IMP(name)
@@ -28,6 +29,7 @@ namespace shader
     #define CBUFFER_END
     #define FLOAT3_PADDING(n) float _padding3##n
     #define FLOAT1_PADDING(n) float _padding1a##n, _padding1b##n, _padding1c##n
+    #define FLOAT2_PADDING(n) float _padding2a##n, _padding2b##n
 #else
     #define SLANG_PUBLIC public
     #define SLANG_MODULE_DEF(name) module name
@@ -38,9 +40,11 @@ namespace shader
     #ifdef __SPIRV__
         #define FLOAT3_PADDING(n) float _padding3##n
         #define FLOAT1_PADDING(n) float _padding1a##n, _padding1b##n, _padding1c##n
+        #define FLOAT2_PADDING(n) float _padding2a##n, _padding2b##n
     #else
         #define FLOAT3_PADDING(n)
         #define FLOAT1_PADDING(n)
+        #define FLOAT2_PADDING(n)
     #endif
     #ifdef __METAL__
         #define PUSH_CONSTANT [[vk::push_constant]] cbuffer PushConstant : register(b6)
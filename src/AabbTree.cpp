@@ -0,0 +1,378 @@
+/*
+ * ---------------------------------------------------
+ * AabbTree.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/AabbTree.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace
+{
+
+inline GE::BoundingBox merged(GE::BoundingBox a, const GE::BoundingBox& b)
+{
+    a.expand(b);
+    return a;
+}
+
+inline float surfaceArea(const GE::BoundingBox& box)
+{
+    const glm::vec3 size = box.max - box.min;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+// 10 bits of each coordinate in [0, 1] interleaved, the close points have close codes
+uint32_t mortonCode(const glm::vec3& position)
+{
+    const auto spreadBits = [](uint32_t value) {
+        value = (value | (value << 16)) & 0x030000FFu;
+        value = (value | (value << 8)) & 0x0300F00Fu;
+        value = (value | (value << 4)) & 0x030C30C3u;
+        value = (value | (value << 2)) & 0x09249249u;
+        return value;
+    };
+    const glm::vec3 quantized = glm::clamp(position * 1024.0f, 0.0f, 1023.0f);
+    return (spreadBits(static_cast<uint32_t>(quantized.x)) << 2) | (spreadBits(static_cast<uint32_t>(quantized.y)) << 1) | spreadBits(static_cast<uint32_t>(quantized.z));
+}
+
+} // namespace
+
+namespace GE
+{
+
+AabbTree::AabbTree(float margin)
+    : m_margin(margin)
+{
+    assert(margin >= 0.0f);
+}
+
+AabbTree::NodeID AabbTree::insert(const BoundingBox& box, uint64_t userData)
+{
+    assert(box.isEmpty() == false);
+    const NodeID id = allocateNode();
+    Node& node = m_nodes[id];
+    node.leafBox = box;
+    node.box = BoundingBox{ .min = box.min - glm::vec3(m_margin), .max = box.max + glm::vec3(m_margin) };
+    node.userData = userData;
+    node.height = 0;
+    insertLeaf(id);
+    m_leafCount++;
+    return id;
+}
+
+void AabbTree::remove(NodeID id)
+{
+    assert(id < m_nodes.size() && m_nodes[id].isLeaf() && m_nodes[id].height == 0);
+    removeLeaf(id);
+    freeNode(id);
+    m_leafCount--;
+}
+
+bool AabbTree::move(NodeID id, const BoundingBox& box)
+{
+    assert(id < m_nodes.size() && m_nodes[id].isLeaf() && m_nodes[id].height == 0);
+    assert(box.isEmpty() == false);
+    m_nodes[id].leafBox = box;
+    if (contains(m_nodes[id].box, box))
+        return false;
+    removeLeaf(id);
+    m_nodes[id].box = BoundingBox{ .min = box.min - glm::vec3(m_margin), .max = box.max + glm::vec3(m_margin) };
+    insertLeaf(id);
+    return true;
+}
+
+void AabbTree::setBox(NodeID id, const BoundingBox& box)
+{
+    assert(id < m_nodes.size() && m_nodes[id].isLeaf() && m_nodes[id].height == 0);
+    assert(box.isEmpty() == false);
+    m_nodes[id].leafBox = box;
+    m_nodes[id].box = BoundingBox{ .min = box.min - glm::vec3(m_margin), .max = box.max + glm::vec3(m_margin) };
+    m_refitLeaves.push_back(id);
+}
+
+void AabbTree::refit()
+{
+    // each path up from a changed leaf, a path stops where an other one already left the boxes correct
+    for (NodeID leaf : m_refitLeaves)
+    {
+        if (m_nodes[leaf].height < 0) // removed since
+            continue;
+        for (NodeID id = m_nodes[leaf].parent; id != INVALID_NODE_ID; id = m_nodes[id].parent)
+        {
+            const BoundingBox box = merged(m_nodes[m_nodes[id].children[0]].box, m_nodes[m_nodes[id].children[1]].box);
+            if (box == m_nodes[id].box)
+                break;
+            m_nodes[id].box = box;
+        }
+    }
+    m_refitLeaves.clear();
+}
+
+void AabbTree::rebuild()
+{
+    m_refitLeaves.clear();
+    BoundingBox centers;
+    for (NodeID id = 0; id < m_nodes.size(); id++)
+    {
+        if (m_nodes[id].height == 0)
+            centers.expand(m_nodes[id].box.center());
+    }
+
+    // the leaves sorted along a morton curve, so each half of a range is a compact region
+    const glm::vec3 size = glm::max(centers.max - centers.min, glm::vec3(std::numeric_limits<float>::min()));
+    std::vector<BuildLeaf> leaves;
+    leaves.reserve(m_leafCount);
+    for (NodeID id = 0; id < m_nodes.size(); id++)
+    {
+        if (m_nodes[id].height < 0)
+            continue;
+        if (m_nodes[id].isLeaf())
+            leaves.push_back({ .mortonCode = mortonCode((m_nodes[id].box.center() - centers.min) / size), .id = id });
+        else
+            freeNode(id);
+    }
+    assert(leaves.size() == m_leafCount);
+    std::ranges::sort(leaves, {}, &BuildLeaf::mortonCode);
+    m_root = leaves.empty() ? INVALID_NODE_ID : buildTopDown(leaves.cbegin(), leaves.cend());
+    if (m_root != INVALID_NODE_ID)
+        m_nodes[m_root].parent = INVALID_NODE_ID;
+}
+
+void AabbTree::clear()
+{
+    m_nodes.clear();
+    m_root = INVALID_NODE_ID;
+    m_freeList = INVALID_NODE_ID;
+    m_leafCount = 0;
+    m_refitLeaves.clear();
+}
+
+float AabbTree::surfaceAreaRatio() const
+{
+    if (m_root == INVALID_NODE_ID)
+        return 0.0f;
+    const float rootArea = surfaceArea(m_nodes[m_root].box);
+    if (rootArea <= 0.0f)
+        return 0.0f;
+    float internalArea = 0.0f;
+    for (const Node& node : m_nodes)
+    {
+        if (node.height > 0)
+            internalArea += surfaceArea(node.box);
+    }
+    return internalArea / rootArea;
+}
+
+std::optional<uint64_t> AabbTree::closestHit(const Ray& ray, float maxDistance) const
+{
+    // the hits shorten the ray, the nodes further than the closest hit are not visited
+    std::optional<uint64_t> closest;
+    std::optional<float> distance;
+    traverse([&](const BoundingBox& nodeBox) { return (distance = rayBoxDistance(ray, nodeBox, maxDistance)).has_value(); },
+             [&](const Node& leaf) {
+                 closest = leaf.userData;
+                 maxDistance = *distance;
+             });
+    return closest;
+}
+
+void AabbTree::NodeStack::grow()
+{
+    if (m_heapNodes.empty())
+        m_heapNodes.assign(m_inlineNodes.begin(), m_inlineNodes.end());
+    m_heapNodes.resize(m_capacity * 2);
+    m_nodes = m_heapNodes.data();
+    m_capacity *= 2;
+}
+
+AabbTree::NodeID AabbTree::allocateNode()
+{
+    if (m_freeList == INVALID_NODE_ID)
+    {
+        assert(m_nodes.size() < INVALID_NODE_ID);
+        m_nodes.emplace_back();
+        return static_cast<NodeID>(m_nodes.size() - 1);
+    }
+    const NodeID id = m_freeList;
+    m_freeList = m_nodes[id].parent;
+    m_nodes[id] = Node{};
+    return id;
+}
+
+void AabbTree::freeNode(NodeID id)
+{
+    m_nodes[id].parent = m_freeList;
+    m_nodes[id].children = { INVALID_NODE_ID, INVALID_NODE_ID };
+    m_nodes[id].height = -1;
+    m_freeList = id;
+}
+
+void AabbTree::insertLeaf(NodeID leaf)
+{
+    if (m_root == INVALID_NODE_ID)
+    {
+        m_root = leaf;
+        m_nodes[leaf].parent = INVALID_NODE_ID;
+        return;
+    }
+
+    // descend to the sibling giving the smallest surface increase, the cost of going down a
+    // child is the growth of the current node, inherited by all the nodes below it
+    const BoundingBox leafBox = m_nodes[leaf].box;
+    NodeID sibling = m_root;
+    while (m_nodes[sibling].isLeaf() == false)
+    {
+        const Node& node = m_nodes[sibling];
+        const float area = surfaceArea(node.box);
+        const float combinedArea = surfaceArea(merged(node.box, leafBox));
+        const float siblingCost = 2.0f * combinedArea; // new parent of this node and the leaf
+        const float inheritedCost = 2.0f * (combinedArea - area);
+
+        const auto childCost = [&](NodeID child) {
+            const float mergedArea = surfaceArea(merged(m_nodes[child].box, leafBox));
+            return (m_nodes[child].isLeaf() ? mergedArea : mergedArea - surfaceArea(m_nodes[child].box)) + inheritedCost;
+        };
+        const float cost0 = childCost(node.children[0]);
+        const float cost1 = childCost(node.children[1]);
+        if (siblingCost < cost0 && siblingCost < cost1)
+            break;
+        sibling = cost0 < cost1 ? node.children[0] : node.children[1];
+    }
+
+    const NodeID oldParent = m_nodes[sibling].parent;
+    const NodeID newParent = allocateNode();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].box = merged(leafBox, m_nodes[sibling].box);
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+    m_nodes[newParent].children = { sibling, leaf };
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    if (oldParent == INVALID_NODE_ID)
+        m_root = newParent;
+    else
+    {
+        std::array<NodeID, 2>& children = m_nodes[oldParent].children;
+        children[children[0] == sibling ? 0 : 1] = newParent;
+    }
+
+    for (NodeID id = m_nodes[leaf].parent; id != INVALID_NODE_ID; id = m_nodes[id].parent)
+    {
+        id = balance(id);
+        updateFromChildren(id);
+    }
+}
+
+void AabbTree::removeLeaf(NodeID leaf)
+{
+    if (leaf == m_root)
+    {
+        m_root = INVALID_NODE_ID;
+        return;
+    }
+
+    const NodeID parent = m_nodes[leaf].parent;
+    const NodeID grandParent = m_nodes[parent].parent;
+    const NodeID sibling = m_nodes[parent].children[m_nodes[parent].children[0] == leaf ? 1 : 0];
+    freeNode(parent);
+    m_nodes[leaf].parent = INVALID_NODE_ID;
+
+    if (grandParent == INVALID_NODE_ID)
+    {
+        m_root = sibling;
+        m_nodes[sibling].parent = INVALID_NODE_ID;
+        return;
+    }
+
+    std::array<NodeID, 2>& children = m_nodes[grandParent].children;
+    children[children[0] == parent ? 0 : 1] = sibling;
+    m_nodes[sibling].parent = grandParent;
+    for (NodeID id = grandParent; id != INVALID_NODE_ID; id = m_nodes[id].parent)
+    {
+        id = balance(id);
+        updateFromChildren(id);
+    }
+}
+
+AabbTree::NodeID AabbTree::balance(NodeID a)
+{
+    // if a child is 2 levels higher than the other one, it is rotated up in place of `a`,
+    // and `a` takes the lowest of its children
+    if (m_nodes[a].isLeaf() || m_nodes[a].height < 2)
+        return a;
+
+    const int32_t heightDifference = m_nodes[m_nodes[a].children[1]].height - m_nodes[m_nodes[a].children[0]].height;
+    if (heightDifference >= -1 && heightDifference <= 1)
+        return a;
+
+    const int upSide = heightDifference > 1 ? 1 : 0;
+    const NodeID up = m_nodes[a].children[upSide];
+    const NodeID upChild0 = m_nodes[up].children[0];
+    const NodeID upChild1 = m_nodes[up].children[1];
+
+    m_nodes[up].children[0] = a;
+    m_nodes[up].parent = m_nodes[a].parent;
+    m_nodes[a].parent = up;
+    if (m_nodes[up].parent == INVALID_NODE_ID)
+        m_root = up;
+    else
+    {
+        std::array<NodeID, 2>& children = m_nodes[m_nodes[up].parent].children;
+        children[children[0] == a ? 0 : 1] = up;
+    }
+
+    const bool keepChild0 = m_nodes[upChild0].height > m_nodes[upChild1].height;
+    const NodeID kept = keepChild0 ? upChild0 : upChild1;
+    const NodeID given = keepChild0 ? upChild1 : upChild0;
+    m_nodes[up].children[1] = kept;
+    m_nodes[a].children[upSide] = given;
+    m_nodes[given].parent = a;
+
+    updateFromChildren(a);
+    updateFromChildren(up);
+    return up;
+}
+
+void AabbTree::updateFromChildren(NodeID id)
+{
+    Node& node = m_nodes[id];
+    const Node& child0 = m_nodes[node.children[0]];
+    const Node& child1 = m_nodes[node.children[1]];
+    node.box = merged(child0.box, child1.box);
+    node.height = 1 + std::max(child0.height, child1.height);
+}
+
+AabbTree::NodeID AabbTree::buildTopDown(std::vector<BuildLeaf>::const_iterator first, std::vector<BuildLeaf>::const_iterator last)
+{
+    if (last - first == 1)
+        return first->id;
+
+    // split where the highest bit differing in the range changes, in the middle if all the codes are equal
+    auto middle = first + (last - first) / 2;
+    const uint32_t differentBits = first->mortonCode ^ (last - 1)->mortonCode;
+    if (differentBits != 0)
+    {
+        const uint32_t highestBit = 1u << (31 - std::countl_zero(differentBits));
+        middle = std::ranges::partition_point(first, last, [&](const BuildLeaf& leaf) { return (leaf.mortonCode & highestBit) == 0; });
+    }
+
+    const NodeID child0 = buildTopDown(first, middle);
+    const NodeID child1 = buildTopDown(middle, last);
+    const NodeID id = allocateNode();
+    m_nodes[id].children = { child0, child1 };
+    m_nodes[child0].parent = id;
+    m_nodes[child1].parent = id;
+    updateFromChildren(id);
+    return id;
+}
+
+} // namespace GE
@@ -115,6 +115,7 @@ void Application::run()
         onUpdate();
 
         m_renderer->renderFrame(frameGraph());
+        m_assetManager->endFrame();
     }
 }
 
@@ -0,0 +1,289 @@
+/*
+ * ---------------------------------------------------
+ * AssetArchive.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/AssetArchive.hpp"
+#include "Game-Engine/AssetManager.hpp"
+#include "Game-Engine/MappedFile.hpp"
+
+#include "CookedFile.hpp"
+#include "Lz4.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+
+constexpr uint32_t ASSET_ARCHIVE_MAGIC = 0x52414547; // "GEAR"
+constexpr uint32_t ASSET_ARCHIVE_VERSION = 1;        // to be incremented on any change of the layout
+
+struct ArchiveHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t fileSize;
+    uint64_t entryCount;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+struct ArchiveEntry
+{
+    uint64_t key;
+    uint64_t offset;
+    uint64_t size;
+    uint64_t uncompressedSize;
+    uint32_t typeOffset; // in the strings
+    uint32_t typeLength;
+    uint32_t pathOffset;
+    uint32_t pathLength;
+    uint8_t compression;
+    uint8_t padding[7];
+};
+
+static_assert(std::is_trivially_copyable_v<ArchiveHeader>);
+static_assert(std::is_trivially_copyable_v<ArchiveEntry>);
+
+// the formats decoded by stb_image and the most common ones imported by assimp
+constexpr auto TEXTURE_EXTENSIONS = std::to_array<std::string_view>({ ".png", ".jpg", ".jpeg", ".tga", ".bmp", ".psd", ".gif", ".hdr", ".pic", ".pnm", ".pgm", ".ppm" });
+constexpr auto MESH_EXTENSIONS = std::to_array<std::string_view>({ ".obj", ".fbx", ".gltf", ".glb", ".dae", ".3ds", ".blend", ".ply", ".stl" });
+
+} // namespace
+
+namespace GE
+{
+
+AssetArchive::AssetArchive(const std::filesystem::path& path)
+    : m_path(path)
+    , m_file(std::make_shared<MappedFile>(path))
+{
+    const std::span<const std::byte> file = m_file->bytes();
+
+    const auto* header = readRecords<ArchiveHeader>(file, 0, 1);
+    if (header == nullptr
+        || header->magic != ASSET_ARCHIVE_MAGIC
+        || header->version != ASSET_ARCHIVE_VERSION
+        || header->fileSize != file.size()
+        || !isValidBlob<char>(file, header->stringsOffset, header->stringsSize))
+        throw std::runtime_error("invalid asset archive: " + path.string());
+
+    const auto* entries = readRecords<ArchiveEntry>(file, sizeof(ArchiveHeader), header->entryCount);
+    if (entries == nullptr)
+        throw std::runtime_error("invalid asset archive: " + path.string());
+
+    const auto strings = std::string_view(reinterpret_cast<const char*>(file.data() + header->stringsOffset), header->stringsSize);
+    const auto validString = [&](uint32_t offset, uint32_t length) { return offset <= strings.size() && length <= strings.size() - offset; };
+
+    m_entries.reserve(header->entryCount);
+    for (const ArchiveEntry& entry : std::span(entries, header->entryCount))
+    {
+        if (!validString(entry.typeOffset, entry.typeLength)
+            || !validString(entry.pathOffset, entry.pathLength)
+            || entry.compression > static_cast<uint8_t>(ArchiveCompression::lz4)
+            || !isValidBlob<std::byte>(file, entry.offset, entry.size)
+            || (entry.compression == static_cast<uint8_t>(ArchiveCompression::none) && entry.size != entry.uncompressedSize))
+            throw std::runtime_error("invalid asset archive: " + path.string());
+        m_entries.push_back(Entry{
+            .type = strings.substr(entry.typeOffset, entry.typeLength),
+            .path = strings.substr(entry.pathOffset, entry.pathLength),
+            .key = entry.key,
+            .offset = entry.offset,
+            .size = entry.size,
+            .uncompressedSize = entry.uncompressedSize,
+            .compression = static_cast<ArchiveCompression>(entry.compression)
+        });
+    }
+    if (!std::ranges::is_sorted(m_entries, {}, [](const Entry& entry) { return std::tie(entry.type, entry.path); }))
+        throw std::runtime_error("invalid asset archive: " + path.string());
+}
+
+const AssetArchive::Entry* AssetArchive::find(std::string_view type, const std::filesystem::path& path) const
+{
+    const std::string genericPath = path.generic_string();
+    auto it = std::ranges::lower_bound(m_entries, std::make_tuple(type, std::string_view(genericPath)), {}, [](const Entry& entry) { return std::make_tuple(entry.type, entry.path); });
+    if (it == m_entries.end() || it->type != type || it->path != genericPath)
+        return nullptr;
+    return &*it;
+}
+
+AssetArchive::Blob AssetArchive::read(const Entry& entry) const
+{
+    const std::span<const std::byte> bytes = m_file->bytes().subspan(entry.offset, entry.size);
+    if (entry.compression == ArchiveCompression::none)
+        return Blob{ .storage = m_file, .bytes = bytes };
+
+    auto decompressed = std::make_shared<std::vector<std::byte>>(entry.uncompressedSize);
+    if (!lz4Decompress(bytes, *decompressed))
+        throw std::runtime_error("corrupted asset archive entry: " + std::string(entry.path));
+    const std::span<const std::byte> decompressedBytes = *decompressed;
+    return Blob{ .storage = std::move(decompressed), .bytes = decompressedBytes };
+}
+
+void AssetArchiveWriter::add(std::string_view type, const std::filesystem::path& path, uint64_t key, std::span<const std::byte> cookedFile, ArchiveCompression compression)
+{
+    insert(makeEntry(type, path, key, cookedFile, compression));
+}
+
+std::vector<std::filesystem::path> AssetArchiveWriter::addDirectory(const std::filesystem::path& directory, ArchiveCompression compression,
+                                                                    const MeshCookOptions& meshCookOptions, const TextureCookOptions& textureCookOptions)
+{
+    std::vector<std::filesystem::path> files;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(directory))
+    {
+        if (entry.is_regular_file())
+            files.push_back(entry.path());
+    }
+
+    std::atomic<size_t> nextFile = 0;
+    std::mutex mutex;
+    std::vector<std::filesystem::path> failedFiles;
+    const auto cookFiles = [&]() {
+        for (size_t i = nextFile++; i < files.size(); i = nextFile++)
+        {
+            std::string extension = files[i].extension().string();
+            std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            const std::filesystem::path relativePath = files[i].lexically_relative(directory);
+            try {
+                if (std::ranges::find(MESH_EXTENSIONS, extension) != MESH_EXTENSIONS.end())
+                {
+                    const MappedFile source(files[i]);
+                    const uint64_t key = cookedMeshKey(source.bytes(), meshCookOptions);
+                    Entry entry = makeEntry(AssetPathYamlTraits<AssetPath<Mesh>>::name, relativePath, key, serializeCookedMesh(cookMesh(importMesh(files[i], source.bytes()), meshCookOptions), key), compression);
+                    std::scoped_lock lock(mutex);
+                    insert(std::move(entry));
+                }
+                else if (std::ranges::find(TEXTURE_EXTENSIONS, extension) != TEXTURE_EXTENSIONS.end())
+                {
+                    const MappedFile source(files[i]);
+                    const uint64_t key = cookedTextureKey(source.bytes(), textureCookOptions);
+                    Entry entry = makeEntry(AssetPathYamlTraits<AssetPath<gfx::Texture>>::name, relativePath, key, serializeCookedTexture(cookTexture(importTexture(files[i], source.bytes()), textureCookOptions), key), compression);
+                    std::scoped_lock lock(mutex);
+                    insert(std::move(entry));
+                }
+            }
+            catch (const std::exception&) {
+                std::scoped_lock lock(mutex);
+                failedFiles.push_back(files[i]);
+            }
+        }
+    };
+
+    std::vector<std::future<void>> workers;
+    for (unsigned int i = 1; i < std::max(1u, std::thread::hardware_concurrency()); i++)
+        workers.push_back(std::async(std::launch::async, cookFiles));
+    cookFiles();
+    for (std::future<void>& worker : workers)
+        worker.get();
+
+    std::ranges::sort(failedFiles);
+    return failedFiles;
+}
+
+AssetArchiveWriter::Entry AssetArchiveWriter::makeEntry(std::string_view type, const std::filesystem::path& path, uint64_t key, std::span<const std::byte> cookedFile, ArchiveCompression compression)
+{
+    Entry entry = {
+        .type = std::string(type),
+        .path = path.generic_string(),
+        .key = key,
+        .uncompressedSize = cookedFile.size(),
+        .compression = ArchiveCompression::none,
+        .bytes = {}
+    };
+    if (compression == ArchiveCompression::lz4)
+    {
+        std::vector<std::byte> compressed = lz4Compress(cookedFile);
+        if (compressed.size() < cookedFile.size())
+        {
+            entry.compression = ArchiveCompression::lz4;
+            entry.bytes = std::move(compressed);
+        }
+    }
+    if (entry.compression == ArchiveCompression::none)
+        entry.bytes.assign(cookedFile.begin(), cookedFile.end());
+    return entry;
+}
+
+void AssetArchiveWriter::insert(Entry entry)
+{
+    auto it = std::ranges::find_if(m_entries, [&](const Entry& added) { return added.type == entry.type && added.path == entry.path; });
+    if (it != m_entries.end())
+        *it = std::move(entry);
+    else
+        m_entries.push_back(std::move(entry));
+}
+
+void AssetArchiveWriter::write(const std::filesystem::path& path) const
+{
+    std::vector<const Entry*> entries;
+    entries.reserve(m_entries.size());
+    for (const Entry& entry : m_entries)
+        entries.push_back(&entry);
+    std::ranges::sort(entries, {}, [](const Entry* entry) { return std::tie(entry->type, entry->path); });
+
+    std::string strings;
+    std::vector<ArchiveEntry> archiveEntries;
+    archiveEntries.reserve(entries.size());
+    for (const Entry* entry : entries)
+    {
+        archiveEntries.push_back(ArchiveEntry{
+            .key = entry->key,
+            .offset = 0,
+            .size = entry->bytes.size(),
+            .uncompressedSize = entry->uncompressedSize,
+            .typeOffset = static_cast<uint32_t>(strings.size()),
+            .typeLength = static_cast<uint32_t>(entry->type.size()),
+            .pathOffset = static_cast<uint32_t>(strings.size() + entry->type.size()),
+            .pathLength = static_cast<uint32_t>(entry->path.size()),
+            .compression = static_cast<uint8_t>(entry->compression),
+            .padding = {}
+        });
+        strings += entry->type;
+        strings += entry->path;
+    }
+
+    ArchiveHeader header = {
+        .magic = ASSET_ARCHIVE_MAGIC,
+        .version = ASSET_ARCHIVE_VERSION,
+        .fileSize = 0,
+        .entryCount = archiveEntries.size(),
+        .stringsOffset = sizeof(ArchiveHeader) + sizeof(ArchiveEntry) * archiveEntries.size(),
+        .stringsSize = strings.size()
+    };
+
+    size_t fileSize = header.stringsOffset + header.stringsSize;
+    for (ArchiveEntry& archiveEntry : archiveEntries)
+    {
+        archiveEntry.offset = alignUp(fileSize, ASSET_ARCHIVE_BLOB_ALIGNMENT);
+        fileSize = archiveEntry.offset + archiveEntry.size;
+    }
+    header.fileSize = fileSize;
+
+    std::vector<std::byte> bytes(fileSize);
+    std::memcpy(bytes.data(), &header, sizeof(ArchiveHeader));
+    std::memcpy(bytes.data() + sizeof(ArchiveHeader), archiveEntries.data(), sizeof(ArchiveEntry) * archiveEntries.size());
+    std::memcpy(bytes.data() + header.stringsOffset, strings.data(), strings.size());
+    for (size_t i = 0; i < entries.size(); i++)
+        std::ranges::copy(entries[i]->bytes, bytes.begin() + static_cast<std::ptrdiff_t>(archiveEntries[i].offset));
+
+    writeFileAtomically(path, bytes);
+}
+
+} // namespace GE
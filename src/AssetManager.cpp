@@ -8,228 +8,597 @@
  */
 
 #include "Game-Engine/AssetManager.hpp"
+#include "Game-Engine/Hash.hpp"
+#include "Game-Engine/MappedFile.hpp"
 #include "Game-Engine/Mesh.hpp"
+#include "Game-Engine/MeshData.hpp"
+#include "Game-Engine/TextureData.hpp"
 
 #include <Graphics/Device.hpp>
 #include <Graphics/Enums.hpp>
 
+#include <algorithm>
 #include <array>
-#include <stb_image/stb_image.h>
-#include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
-#include <assimp/scene.h>
-#include <assimp/types.h>
 
 #include <cassert>
+#include <chrono>
 #include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
 #include <ranges>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <bit>
 #include <cstddef>
 #include <type_traits>
 #include <utility>
+#include <variant>
 #include <vector>
 
-#ifdef __cpp_lib_containers_ranges
-    #define APPEND_RANGE(self, range) self.append_range(range)
-#else
-    #define APPEND_RANGE(self, range) self.insert(self.end(), range.cbegin(), range.cend())
-#endif
-
-constexpr unsigned int POST_PROCESSING_FLAGS = aiProcess_CalcTangentSpace
-                                               | aiProcess_JoinIdenticalVertices
-                                               | aiProcess_Triangulate
-                                               | aiProcess_GenNormals
-                                               | aiProcess_OptimizeMeshes
-                                               | aiProcess_FlipUVs;
-
-namespace
-{
-
-static inline glm::mat4x4 toGlmMat4(const aiMatrix4x4& from)
-{
-    glm::mat4x4 to;
-    to[0][0] = from.a1; to[1][0] = from.a2; to[2][0] = from.a3; to[3][0] = from.a4;
-    to[0][1] = from.b1; to[1][1] = from.b2; to[2][1] = from.b3; to[3][1] = from.b4;
-    to[0][2] = from.c1; to[1][2] = from.c2; to[2][2] = from.c3; to[3][2] = from.c4;
-    to[0][3] = from.d1; to[1][3] = from.d2; to[2][3] = from.d3; to[3][3] = from.d4;
-    return to;
-}
-
-} // namespace
-
 namespace GE
 {
 
-AssetManager::AssetManager(gfx::Device* device)
+AssetManager::AssetManager(gfx::Device* device,
+                           std::filesystem::path meshCacheDirectory, MeshCookOptions meshCookOptions,
+                           std::filesystem::path textureCacheDirectory, TextureCookOptions textureCookOptions)
     : m_device(device)
+    , m_geometryPool(device)
+    , m_meshCacheDirectory(std::move(meshCacheDirectory))
+    , m_meshCookOptions(meshCookOptions)
+    , m_textureCacheDirectory(std::move(textureCacheDirectory))
+    , m_textureCookOptions(textureCookOptions)
     , m_builtInCubeHandle(std::in_place_type<AssetHandle<Mesh>>)
+    , m_streamer(device, 0)
 {
-    std::get<AssetHandle<Mesh>>(m_builtInCubeHandle).loader = [device=m_device](gfx::CommandBuffer& commandBuffer) -> std::shared_ptr<Mesh> {
-        return std::make_shared<Mesh>(loadBuiltInCube(*device, commandBuffer));
+    std::get<AssetHandle<Mesh>>(m_builtInCubeHandle).loader = [device=m_device, geometryPool=&m_geometryPool](gfx::CommandBuffer& commandBuffer, bool, std::span<const std::byte>, AssetLoadRecord&, std::shared_ptr<StreamableAsset>& owner) -> std::shared_ptr<Mesh> {
+        auto cube = std::make_shared<StreamedMesh>(*device, *geometryPool, commandBuffer, builtInCubeData(), true);
+        owner = cube;
+        return std::shared_ptr<Mesh>(cube, cube->mesh().get());
     };
 }
 
 void AssetManager::registerAsset(const VAssetPath& vAssetPath)
 {
+    if (m_registeredPaths.contains(vAssetPath))
+        return;
     std::visit([&](const auto& assetPath) {
         using AssetType = typename std::remove_cvref_t<decltype(assetPath)>::AssetType;
-        auto [it, inserted] = m_handles.try_emplace(vAssetPath, std::in_place_type<AssetHandle<AssetType>>);
-        if (inserted)
+        std::error_code error;
+        std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(assetPath.path, error);
+        if (error)
+            canonicalPath = assetPath.path;
+
+        // a mesh source can reference the files next to it, so only textures are deduplicated by content,
+        // the source is hashed before locking, the other registrations do not wait for the read
+        std::optional<std::pair<size_t, uint64_t>> contentKey;
+        if constexpr (std::is_same_v<AssetType, gfx::Texture>) {
+            if (m_contentDeduplication.load() && m_handles.contains(AssetPath<AssetType>(canonicalPath)) == false && std::filesystem::is_regular_file(canonicalPath, error))
+                contentKey = std::make_pair(vAssetPath.index(), hashBytes(MappedFile(canonicalPath).bytes()));
+        }
+
+        std::scoped_lock lock(m_registrationMutex);
+        if (m_registeredPaths.contains(vAssetPath)) // by an other thread meanwhile
+            return;
+
+        VAssetHandle* vHandle = m_handles.find(AssetPath<AssetType>(canonicalPath));
+        if (vHandle == nullptr && contentKey)
+        {
+            if (auto it = m_contentHandles.find(*contentKey); it != m_contentHandles.end())
+                vHandle = it->second;
+        }
+
+        if (vHandle == nullptr)
         {
-            AssetHandle<AssetType>& handle = std::get<AssetHandle<AssetType>>(it->second);
+            vHandle = m_handles.tryEmplace(AssetPath<AssetType>(canonicalPath), std::in_place_type<AssetHandle<AssetType>>).first;
+            AssetHandle<AssetType>& handle = std::get<AssetHandle<AssetType>>(*vHandle);
+            handle.path = canonicalPath;
+            const auto [archive, archiveEntry] = findArchivedAsset(handle.path);
+            handle.readsSource = archiveEntry == nullptr;
+            if (archiveEntry != nullptr)
+                handle.sourceByteSize = archiveEntry->size;
+            else
+                handle.sourceByteSize = std::filesystem::is_regular_file(canonicalPath, error) ? std::filesystem::file_size(canonicalPath, error) : 0;
             if constexpr (std::is_same_v<AssetType, Mesh>) {
-                handle.loader = [device=m_device, path=assetPath](gfx::CommandBuffer& commandBuffer) {
-                    return std::make_shared<Mesh>(loadMesh(*device, path, commandBuffer));
+                std::function<MeshData(std::span<const std::byte>)> loadData = [path=handle.path, cacheDirectory=m_meshCacheDirectory, cookOptions=m_meshCookOptions](std::span<const std::byte> sourceContent) {
+                    return loadMeshData(path, sourceContent, cacheDirectory, cookOptions);
+                };
+                if (archiveEntry != nullptr) {
+                    loadData = [archive, archiveEntry, path=handle.path](std::span<const std::byte>) {
+                        const AssetArchive::Blob blob = archive->read(*archiveEntry);
+                        std::optional<MeshData> meshData = readCookedMesh(blob.bytes, blob.storage, archiveEntry->key);
+                        if (!meshData)
+                            throw std::runtime_error("invalid archived mesh: " + path.path.string());
+                        return *std::move(meshData);
+                    };
+                }
+                handle.loader = [device=m_device, geometryPool=&m_geometryPool, loadData](gfx::CommandBuffer& commandBuffer, bool streamed, std::span<const std::byte> sourceContent, AssetLoadRecord& record, std::shared_ptr<StreamableAsset>& owner) -> std::shared_ptr<Mesh> {
+                    auto start = std::chrono::steady_clock::now();
+                    MeshData meshData = loadData(sourceContent);
+                    record.decodeTime = elapsedMicroseconds(start);
+                    start = std::chrono::steady_clock::now();
+                    // streamed or not, the mesh keeps its data to rebuild its index buffers when its vertices are relocated
+                    auto streamedMesh = std::make_shared<StreamedMesh>(*device, *geometryPool, commandBuffer, std::move(meshData), streamed == false);
+                    owner = streamedMesh;
+                    record.uploadTime = elapsedMicroseconds(start);
+                    return std::shared_ptr<Mesh>(streamedMesh, streamedMesh->mesh().get());
                 };
             }
             else if constexpr (std::is_same_v<AssetType, gfx::Texture>) {
-                handle.loader = [device=m_device, path=assetPath](gfx::CommandBuffer& commandBuffer) {
-                    return loadTexture(*device, path, commandBuffer);
+                std::function<TextureData(std::span<const std::byte>)> loadData = [path=handle.path, cacheDirectory=m_textureCacheDirectory, cookOptions=m_textureCookOptions](std::span<const std::byte> sourceContent) {
+                    return loadTextureData(path, sourceContent, cacheDirectory, cookOptions);
+                };
+                if (archiveEntry != nullptr) {
+                    loadData = [archive, archiveEntry, path=handle.path](std::span<const std::byte>) {
+                        const AssetArchive::Blob blob = archive->read(*archiveEntry);
+                        std::optional<TextureData> textureData = readCookedTexture(blob.bytes, blob.storage, archiveEntry->key);
+                        if (!textureData)
+                            throw std::runtime_error("invalid archived texture: " + path.path.string());
+                        return *std::move(textureData);
+                    };
+                }
+                handle.loader = [device=m_device, handle=&handle, loadData](gfx::CommandBuffer& commandBuffer, bool streamed, std::span<const std::byte> sourceContent, AssetLoadRecord& record, std::shared_ptr<StreamableAsset>& owner) -> std::shared_ptr<gfx::Texture> {
+                    auto start = std::chrono::steady_clock::now();
+                    TextureData textureData = loadData(sourceContent);
+                    record.decodeTime = elapsedMicroseconds(start);
+                    start = std::chrono::steady_clock::now();
+                    std::shared_ptr<gfx::Texture> texture;
+                    if (streamed == false)
+                        texture = loadTexture(*device, textureData, commandBuffer);
+                    else
+                    {
+                        // the streamer replaces the texture from the main thread, in endFrame
+                        auto streamedTexture = std::make_shared<StreamedTexture>(*device, commandBuffer, std::move(textureData), [handle](const std::shared_ptr<gfx::Texture>& texture) {
+                            std::scoped_lock lock(handle->mutex);
+                            handle->asset = texture;
+                        });
+                        owner = streamedTexture;
+                        texture = streamedTexture->texture();
+                    }
+                    record.uploadTime = elapsedMicroseconds(start);
+                    return texture;
                 };
             }
             else std::unreachable();
+            if (contentKey)
+                m_contentHandles.emplace(*contentKey, vHandle);
         }
+        std::get<AssetHandle<AssetType>>(*vHandle).registrationCount++;
+        m_registeredPaths.tryEmplace(vAssetPath, vHandle);
     },
     vAssetPath);
 }
 
+void AssetManager::mountArchive(const std::filesystem::path& archive, const std::filesystem::path& root)
+{
+    std::error_code error;
+    std::filesystem::path canonicalRoot = std::filesystem::weakly_canonical(root, error);
+    if (error)
+        canonicalRoot = root;
+    auto mountedArchive = std::make_shared<const AssetArchive>(archive);
+    std::scoped_lock lock(m_registrationMutex);
+    m_archives.emplace_back(std::move(mountedArchive), std::move(canonicalRoot));
+}
+
+std::pair<std::shared_ptr<const AssetArchive>, const AssetArchive::Entry*> AssetManager::findArchivedAsset(const VAssetPath& canonicalPath) const
+{
+    return std::visit([&](const auto& assetPath) -> std::pair<std::shared_ptr<const AssetArchive>, const AssetArchive::Entry*> {
+        using AssetPathT = std::remove_cvref_t<decltype(assetPath)>;
+        for (const auto& [archive, root] : m_archives | std::views::reverse)
+        {
+            const std::filesystem::path relativePath = assetPath.path.lexically_relative(root);
+            if (relativePath.empty() || *relativePath.begin() == "..")
+                continue;
+            if (const AssetArchive::Entry* entry = archive->find(AssetPathYamlTraits<AssetPathT>::name, relativePath))
+                return { archive, entry };
+        }
+        return { nullptr, nullptr };
+    },
+    canonicalPath);
+}
+
+AssetManager::DeduplicationStatistics AssetManager::deduplicationStatistics() const
+{
+    DeduplicationStatistics statistics;
+    std::scoped_lock lock(m_registrationMutex);
+    statistics.registeredPathCount = static_cast<uint32_t>(m_registeredPaths.size());
+    statistics.uniqueAssetCount = static_cast<uint32_t>(m_handles.size());
+    m_handles.forEach([&](const VAssetPath&, const VAssetHandle& vHandle) {
+        std::visit([&](const auto& handle) {
+            if (handle.status.load() == AssetHandleLoadingStatus::loaded && handle.registrationCount > 1)
+                statistics.savedBytes += (handle.registrationCount - 1) * (handle.streamable ? handle.streamable->residentBytes() : handle.byteSize);
+        },
+        vHandle);
+    });
+    return statistics;
+}
+
+void AssetManager::addAssetDependency(const VAssetPath& asset, const VAssetPath& dependency)
+{
+    // the residency lock keeps the references of the asset unchanged until they are held on the dependency too
+    std::scoped_lock residencyLock(m_residencyMutex);
+    std::set<const VAssetHandle*> dependencyHandles;
+    std::vector<VAssetPath> dependencyDependencies;
+    appendDependencyClosure(dependency, dependencyHandles, dependencyDependencies);
+    if (dependencyHandles.contains(&assetHandle(asset)))
+        throw std::runtime_error("asset dependency cycle");
+    const bool added = std::visit([&](auto& handle) {
+        std::scoped_lock lock(handle.mutex);
+        if (std::ranges::find(handle.dependencies, dependency) != handle.dependencies.end())
+            return false;
+        handle.dependencies.push_back(dependency);
+        return true;
+    },
+    assetHandle(asset));
+    if (added == false)
+        return;
+
+    // the references already held on the asset are held on its new dependency too
+    const uint32_t referenceCount = assetReferenceCount(asset);
+    for (uint32_t i = 0; i < referenceCount; i++)
+        retainAsset(dependency);
+    if (std::visit([](const auto& handle) { return handle.status.load() != AssetHandleLoadingStatus::unloaded; }, assetHandle(asset)))
+        loadAssetDependencies(asset);
+}
+
+std::vector<VAssetPath> AssetManager::assetDependencies(const VAssetPath& vAssetPath) const
+{
+    return std::visit([](const auto& handle) {
+        std::scoped_lock lock(handle.mutex);
+        return handle.dependencies;
+    },
+    assetHandle(vAssetPath));
+}
+
+void AssetManager::loadAssetDependencies(const VAssetPath& vAssetPath)
+{
+    for (const VAssetPath& dependency : assetDependencies(vAssetPath))
+    {
+        std::visit([&](const auto& assetPath) {
+            using AssetType = typename std::remove_cvref_t<decltype(assetPath)>::AssetType;
+            loadAsset<AssetType>(dependency);
+        },
+        dependency);
+    }
+}
+
+void AssetManager::appendDependencyClosure(const VAssetPath& vAssetPath, std::set<const VAssetHandle*>& visited, std::vector<VAssetPath>& closure) const
+{
+    if (visited.insert(&assetHandle(vAssetPath)).second == false)
+        return;
+    for (const VAssetPath& dependency : assetDependencies(vAssetPath))
+        appendDependencyClosure(dependency, visited, closure);
+    closure.push_back(vAssetPath);
+}
+
+void AssetManager::retainAsset(const VAssetPath& vAssetPath)
+{
+    std::scoped_lock lock(m_residencyMutex);
+    retainAssetHandle(assetHandle(vAssetPath));
+    for (const VAssetPath& dependency : assetDependencies(vAssetPath))
+        retainAsset(dependency);
+}
+
+void AssetManager::releaseAsset(const VAssetPath& vAssetPath)
+{
+    std::scoped_lock lock(m_residencyMutex);
+    releaseAssetHandle(assetHandle(vAssetPath));
+    for (const VAssetPath& dependency : assetDependencies(vAssetPath))
+        releaseAsset(dependency);
+}
+
 void AssetManager::unloadAssetHandle(VAssetHandle& vHandle)
 {
-    std::visit([](auto& handle) {
-        if (handle.future.valid())
-            handle.future.wait(); // dont need to propagate errors
+    std::scoped_lock residencyLock(m_residencyMutex);
+    std::visit([&](auto& handle) {
+        if (handle.reloadedAsset.valid())
+        {
+            handle.reloadedAsset.wait();
+            handle.reloadedAsset = {};
+            handle.reloadAgain = false;
+            std::erase(m_reloadingHandles, &vHandle);
+        }
+        std::unique_lock lock(handle.mutex);
+        const auto future = handle.future;
+        lock.unlock();
+        if (future.valid())
+            future.wait(); // dont need to propagate errors
+        // a loading requested by an other thread starts once the asset is reset
+        lock.lock();
         auto expected = AssetHandleLoadingStatus::loaded;
         if (handle.status.compare_exchange_strong(expected, AssetHandleLoadingStatus::unloaded))
+        {
+            m_loadRecorder.countUnload();
+            m_residentBytes.fetch_sub(handle.streamable ? handle.streamable->residentBytes() : handle.byteSize);
             handle.asset.reset();
+            handle.streamable.reset();
+            handle.byteSize = 0;
+        }
+        lock.unlock();
+        if (handle.unreferencedPosition)
+        {
+            m_unreferencedHandles.erase(*handle.unreferencedPosition);
+            handle.unreferencedPosition.reset();
+        }
     },
     vHandle);
 }
 
-AssetManager::~AssetManager()
+void AssetManager::readAssetSources(const std::vector<VAssetPath>& vAssetPaths)
 {
-    for (auto& [_, handle] : m_handles)
-        unloadAssetHandle(handle);
+    std::vector<std::filesystem::path> paths;
+    std::vector<VAssetHandle*> vHandles;
+    for (const VAssetPath& vAssetPath : vAssetPaths)
+    {
+        VAssetHandle& vHandle = assetHandle(vAssetPath);
+        std::visit([&](const auto& handle) {
+            std::scoped_lock lock(handle.mutex);
+            if (handle.readsSource && handle.status.load() == AssetHandleLoadingStatus::unloaded && handle.source.valid() == false)
+            {
+                paths.push_back(handle.path.path);
+                vHandles.push_back(&vHandle);
+            }
+        },
+        vHandle);
+    }
+    if (paths.empty())
+        return;
+    std::vector<std::future<std::vector<std::byte>>> sources = m_fileReader.read(paths);
+    for (size_t i = 0; i < vHandles.size(); i++)
+    {
+        std::visit([&](auto& handle) {
+            // a loading started meanwhile by an other thread has read the source itself
+            std::scoped_lock lock(handle.mutex);
+            if (handle.status.load() == AssetHandleLoadingStatus::unloaded)
+                handle.source = sources[i].share();
+        },
+        *vHandles[i]);
+    }
 }
 
-Mesh AssetManager::loadMesh(gfx::Device& device, const std::filesystem::path& path, gfx::CommandBuffer& commandBuffer)
+void AssetManager::retainAssetHandle(VAssetHandle& vHandle)
 {
-    assert(std::filesystem::is_regular_file(path));
-
-    Assimp::Importer importer;
-
-    const aiScene* scene = importer.ReadFile(path.string(), POST_PROCESSING_FLAGS);
-    if (scene == nullptr)
-        throw std::runtime_error("fail to load the model using assimp");
-
-    const auto aiMeshToSubMesh = [&](aiMesh* aiMesh) {
-        const auto aiVtxToVtx = [aiMesh](uint32_t i) -> Vertex {
-            return Vertex{
-                .pos = glm::vec3(aiMesh->mVertices[i].x, aiMesh->mVertices[i].y, aiMesh->mVertices[i].z),
-                .uv = aiMesh->mTextureCoords[0] != nullptr ? glm::vec2(aiMesh->mTextureCoords[0][i].x, aiMesh->mTextureCoords[0][i].y) : glm::vec2(0.0f),
-                .normal = aiMesh->mNormals != nullptr ? glm::vec3(aiMesh->mNormals[i].x, aiMesh->mNormals[i].y, aiMesh->mNormals[i].z) : glm::vec3(0.0f),
-                .tangent = aiMesh->mTangents != nullptr ? glm::vec3(aiMesh->mTangents[i].x, aiMesh->mTangents[i].y, aiMesh->mTangents[i].z) : glm::vec3(0.0f)
-            };
-        };
-        const auto aiVtxToIdx = [aiMesh](uint32_t i) -> uint32_t {
-            return aiMesh->mFaces[i / 3].mIndices[i % 3];
-        };
-        return SubMesh{
-            .name = aiMesh->mName.C_Str(),
-            .transform = glm::mat4x4(1.0f),
-            .vertexBuffer = newDeviceLocalBuffer(device, commandBuffer, gfx::BufferUsage::vertexBuffer, std::views::iota(0u, aiMesh->mNumVertices) | std::views::transform(std::move(aiVtxToVtx))),
-            .indexBuffer = newDeviceLocalBuffer(device, commandBuffer, gfx::BufferUsage::indexBuffer, std::views::iota(0u, aiMesh->mNumFaces * 3) | std::views::transform(std::move(aiVtxToIdx))),
-            // .material = materials[aiMesh->mMaterialIndex],
-            .subMeshes = {}
-        };
-    };
+    std::scoped_lock lock(m_residencyMutex);
+    std::visit([&](auto& handle) {
+        if (handle.referenceCount++ == 0 && handle.unreferencedPosition)
+        {
+            m_unreferencedHandles.erase(*handle.unreferencedPosition);
+            handle.unreferencedPosition.reset();
+        }
+    },
+    vHandle);
+}
 
-    commandBuffer.beginBlitPass();
-    auto flatSubMeshes = std::span(scene->mMeshes, scene->mNumMeshes) | std::views::transform(std::move(aiMeshToSubMesh)) | std::ranges::to<std::vector>();
-    commandBuffer.endBlitPass();
+void AssetManager::releaseAssetHandle(VAssetHandle& vHandle)
+{
+    std::scoped_lock lock(m_residencyMutex);
+    std::visit([&](auto& handle) {
+        assert(handle.referenceCount > 0);
+        if (--handle.referenceCount == 0 && handle.status.load() != AssetHandleLoadingStatus::unloaded)
+        {
+            assert(handle.unreferencedPosition.has_value() == false);
+            handle.unreferencedPosition = m_unreferencedHandles.insert(m_unreferencedHandles.end(), &vHandle);
+        }
+    },
+    vHandle);
+    evictUnreferencedAssets();
+}
 
-    std::function<void(std::vector<SubMesh>&, aiNode*, glm::mat4x4)> addNode = [&](std::vector<SubMesh>& dest, aiNode* aiNode, glm::mat4x4 additionalTransform) {
-        glm::mat4x4 transform = additionalTransform * toGlmMat4(aiNode->mTransformation);
+void AssetManager::evictUnreferencedAssets()
+{
+    std::scoped_lock lock(m_residencyMutex);
+    auto it = m_unreferencedHandles.begin();
+    while (it != m_unreferencedHandles.end() && (m_residencyBudget == 0 || m_residentBytes.load() > m_residencyBudget))
+    {
+        VAssetHandle* vHandle = *it++;
+        // the assets still loading are evicted by a later call, unloading them now would wait for the loading
+        if (isAssetHandleLoaded(*vHandle))
+        {
+            m_loadRecorder.countEviction();
+            unloadAssetHandle(*vHandle);
+        }
+    }
+}
 
-        const auto nodeMeshToSubmesh = [&](uint32_t i) -> SubMesh {
-            SubMesh submesh = flatSubMeshes[i];
-            submesh.transform = transform;
-            return submesh;
-        };
-        auto subMeshes = std::span(aiNode->mMeshes, aiNode->mNumMeshes) | std::views::transform(std::move(nodeMeshToSubmesh));
+void AssetManager::requestStreaming(const VAssetPath& vAssetPath, uint32_t level, float priority)
+{
+    std::visit([&](auto& handle) {
+        if (handle.status.load() == AssetHandleLoadingStatus::loaded && handle.streamable)
+            m_streamer.request(handle.streamable, level, priority);
+    },
+    assetHandle(vAssetPath));
+}
 
-        for (auto* node : std::span(aiNode->mChildren, aiNode->mNumChildren))
+void AssetManager::enableHotReload(const std::filesystem::path& directory)
+{
+    m_fileWatcher = std::make_unique<FileWatcher>(directory);
+}
+
+void AssetManager::reloadAsset(const VAssetPath& vAssetPath)
+{
+    reloadAssetHandle(assetHandle(vAssetPath));
+}
+
+void AssetManager::reloadAssetHandle(VAssetHandle& vHandle)
+{
+    std::scoped_lock lock(m_residencyMutex); // an eviction from an other thread would cancel the reload
+    std::visit([&](auto& handle) {
+        using AssetType = typename std::remove_cvref_t<decltype(handle)>::AssetType;
+        if (handle.status.load() != AssetHandleLoadingStatus::loaded)
+            return;
+        if (handle.reloadedAsset.valid())
         {
-            if (subMeshes.empty())
-                addNode(dest, node, transform);
-            else
+            handle.reloadAgain = true;
+            return;
+        }
+        std::shared_future<std::vector<std::byte>> source;
+        if (handle.readsSource)
+            source = m_fileReader.read(handle.path.path).share();
+        // reloaded assets are not streamed, the streamable asset of the handle is replaced from the main thread
+        AssetLoadRecord record = { .type = AssetPathYamlTraits<AssetPath<AssetType>>::name, .path = handle.path.path, .reload = true, .start = m_loadRecorder.now(), .sourceBytes = handle.sourceByteSize };
+        handle.reloadedAsset = std::async(std::launch::async, [device = m_device, streamer = &m_streamer, recorder = &m_loadRecorder, loader = handle.loader, source, record]() mutable -> std::shared_ptr<AssetType> {
+            std::shared_ptr<StreamableAsset> owner;
+            std::shared_ptr<AssetType> asset = runLoader<AssetType>(*device, loader, false, source, record, *recorder, owner);
+            record.residentBytes = assetByteSize(*asset);
+            if (owner)
+                streamer->addCompactable(owner);
+            recorder->record(std::move(record));
+            return asset;
+        });
+        m_reloadingHandles.push_back(&vHandle);
+    },
+    vHandle);
+}
+
+void AssetManager::reloadChangedAssets()
+{
+    if (m_fileWatcher == nullptr)
+        return;
+    const std::vector<std::filesystem::path> changedFiles = m_fileWatcher->poll();
+    if (changedFiles.empty())
+        return;
+    for (const std::filesystem::path& changedFile : changedFiles)
+    {
+        // the handles are keyed by canonical path, like the changed files
+        forEachType<AssetPathTypes>([&]<typename AssetPathT>() {
+            if (VAssetHandle* vHandle = m_handles.find(AssetPathT(changedFile)))
+                reloadAssetHandle(*vHandle);
+        });
+    }
+}
+
+void AssetManager::swapReloadedAssets()
+{
+    std::scoped_lock lock(m_residencyMutex);
+    std::vector<VAssetHandle*> reloadAgainHandles;
+    std::erase_if(m_reloadingHandles, [&](VAssetHandle* vHandle) {
+        return std::visit([&](auto& handle) {
+            using AssetType = typename std::remove_cvref_t<decltype(handle)>::AssetType;
+            if (handle.reloadedAsset.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return false;
+            std::shared_ptr<AssetType> asset;
+            try {
+                asset = handle.reloadedAsset.get();
+            }
+            catch (const std::exception&) {
+                // most likely a source file read while it was being saved, the previous
+                // asset is kept and the end of the save triggers an other reload
+            }
+            if (asset)
             {
-                std::vector<SubMesh> subDest;
-                addNode(subDest, node, glm::mat4x4(1.0F));
-                APPEND_RANGE(subMeshes.front().subMeshes, subDest);
+                m_residentBytes.fetch_sub(handle.streamable ? handle.streamable->residentBytes() : handle.byteSize);
+                handle.streamable.reset();
+                handle.byteSize = assetByteSize(*asset);
+                std::scoped_lock assetLock(handle.mutex);
+                handle.asset = std::move(asset);
+                m_residentBytes.fetch_add(handle.byteSize);
             }
-        }
-        APPEND_RANGE(dest, subMeshes);
-    };
+            if (handle.reloadAgain)
+            {
+                handle.reloadAgain = false;
+                reloadAgainHandles.push_back(vHandle);
+            }
+            return true;
+        },
+        *vHandle);
+    });
+    for (VAssetHandle* vHandle : reloadAgainHandles)
+        reloadAssetHandle(*vHandle);
+}
 
-    Mesh mesh = {
-        .name = scene->mRootNode->mName.C_Str(),
-        .subMeshes = std::span(scene->mRootNode->mMeshes, scene->mRootNode->mNumMeshes)
-                     | std::views::transform([&](uint32_t i) -> SubMesh {
-                           SubMesh submesh = flatSubMeshes[i];
-                           submesh.transform = glm::mat4x4(1.0F);
-                           return submesh;
-                       })
-                     | std::ranges::to<std::vector>()
-    };
+AssetStatistics AssetManager::statistics() const
+{
+    AssetStatistics statistics;
+    m_loadRecorder.fill(statistics);
 
-    for (auto* node : std::span(scene->mRootNode->mChildren, scene->mRootNode->mNumChildren))
-        addNode(mesh.subMeshes, node, glm::mat4x4(1.0F));
+    forEachType<AssetPathTypes>([&]<typename AssetPathT>() {
+        statistics.types.try_emplace(std::string(AssetPathYamlTraits<AssetPathT>::name));
+    });
+    m_handles.forEach([&](const VAssetPath&, const VAssetHandle& vHandle) {
+        std::visit([&](const auto& handle) {
+            using AssetType = typename std::remove_cvref_t<decltype(handle)>::AssetType;
+            AssetStatistics::TypeStatistics& typeStatistics = statistics.types.find(AssetPathYamlTraits<AssetPath<AssetType>>::name)->second;
+            typeStatistics.assetCount++;
+            const AssetHandleLoadingStatus status = handle.status.load();
+            if (status == AssetHandleLoadingStatus::loading)
+                typeStatistics.loadingCount++;
+            else if (status == AssetHandleLoadingStatus::loaded)
+            {
+                typeStatistics.loadedCount++;
+                typeStatistics.residentBytes += handle.streamable ? handle.streamable->residentBytes() : handle.byteSize;
+            }
+        },
+        vHandle);
+    });
 
-    return mesh;
+    std::scoped_lock lock(m_residencyMutex);
+    statistics.residentBytes = m_residentBytes.load();
+    statistics.residencyBudget = m_residencyBudget;
+    statistics.pendingReadCount = m_fileReader.pendingReadCount();
+    statistics.reloadingCount = static_cast<uint32_t>(m_reloadingHandles.size());
+    statistics.unreferencedCount = static_cast<uint32_t>(m_unreferencedHandles.size());
+    statistics.deferredStreamingRequestCount = m_streamer.statistics().deferredRequestCount;
+    return statistics;
 }
 
-std::shared_ptr<gfx::Texture> AssetManager::loadTexture(gfx::Device& device, const std::filesystem::path& path, gfx::CommandBuffer& commandBuffer)
+void AssetManager::endFrame()
 {
-    using UniqueStbiUc = std::unique_ptr<stbi_uc, decltype(&stbi_image_free)>;
-
-    int width = 0;
-    int height = 0;
-    UniqueStbiUc bytes = UniqueStbiUc(stbi_load(path.string().c_str(), &width, &height, nullptr, STBI_rgb_alpha), stbi_image_free);
-    if (!bytes)
-        throw std::runtime_error("failed to load texture: " + path.string());
-    return loadTexture(device, std::bit_cast<const std::byte*>(bytes.get()), static_cast<uint32_t>(width), static_cast<uint32_t>(height), commandBuffer);
+    reloadChangedAssets();
+    swapReloadedAssets();
+    const ptrdiff_t streamedBytes = m_streamer.update();
+    m_residentBytes.fetch_add(static_cast<size_t>(streamedBytes)); // wraps around for a negative change
+    m_geometryPool.endFrame();
+    evictUnreferencedAssets();
 }
 
-std::shared_ptr<gfx::Texture> AssetManager::loadTexture(gfx::Device& device, const std::byte* bytes, uint32_t width, uint32_t height, gfx::CommandBuffer& commandBuffer)
+AssetManager::~AssetManager()
+{
+    m_handles.forEach([&](const VAssetPath&, VAssetHandle& vHandle) {
+        unloadAssetHandle(vHandle);
+    });
+    unloadAssetHandle(m_builtInCubeHandle);
+}
+
+size_t AssetManager::assetByteSize(const Mesh& mesh)
 {
-    assert(bytes);
-    std::shared_ptr<gfx::Texture> texture = device.newTexture(gfx::Texture::Descriptor{
-        .type = gfx::TextureType::texture2d,
-        .width = width,
-        .height = height,
-        .pixelFormat = gfx::PixelFormat::RGBA8Unorm,
-        .usages = gfx::TextureUsage::copyDestination | gfx::TextureUsage::shaderRead,
-        .storageMode = gfx::ResourceStorageMode::deviceLocal });
-    assert(texture);
-
-    std::shared_ptr<gfx::Buffer> stagingBuffer = device.newBuffer(gfx::Buffer::Descriptor{
-        .size = static_cast<size_t>(width) * static_cast<size_t>(height) * pixelFormatSize(gfx::PixelFormat::RGBA8Unorm),
-        .usages = gfx::BufferUsage::copySource,
-        .storageMode = gfx::ResourceStorageMode::hostVisible });
-    assert(stagingBuffer);
-
-    std::memcpy(stagingBuffer->content<uint32_t>(), bytes, stagingBuffer->size());
-
-    commandBuffer.beginBlitPass();
-    commandBuffer.copyBufferToTexture(stagingBuffer, texture);
-    commandBuffer.endBlitPass();
-
-    return texture;
+    std::function<size_t(const SubMesh&)> subMeshByteSize = [&](const SubMesh& subMesh) {
+        size_t byteSize = subMesh.indexBuffer ? subMesh.indexBuffer->size() : 0;
+        if (subMesh.vertexAllocation)
+            byteSize += static_cast<size_t>(subMesh.vertexAllocation->count) * subMesh.vertexAllocation->stride;
+        for (const SubMesh::Lod& lod : subMesh.lods)
+            byteSize += lod.indexBuffer ? lod.indexBuffer->size() : 0;
+        for (const SubMesh& child : subMesh.subMeshes)
+            byteSize += subMeshByteSize(child);
+        return byteSize;
+    };
+
+    size_t byteSize = 0;
+    for (const SubMesh& subMesh : mesh.subMeshes)
+        byteSize += subMeshByteSize(subMesh);
+    return byteSize;
 }
 
-Mesh AssetManager::loadBuiltInCube(gfx::Device& device, gfx::CommandBuffer& commandBuffer)
+size_t AssetManager::assetByteSize(const gfx::Texture& texture)
 {
-    constexpr auto vertices = std::to_array<Vertex>({
+    return static_cast<size_t>(texture.width()) * texture.height() * pixelFormatSize(texture.pixelFormat());
+}
+
+std::shared_ptr<gfx::Texture> AssetManager::loadTexture(gfx::Device& device, const TextureData& textureData, gfx::CommandBuffer& commandBuffer)
+{
+    // the Graphics textures have a single level and no block compressed pixel format, so only the
+    // full resolution mip is uploaded, decoded if a compressed format was opted in the cook options
+    if (isBlockCompressed(textureData.format))
+        return uploadTexture(device, commandBuffer, decodeMip(textureData, 0), textureData.width(), textureData.height());
+    return uploadTexture(device, commandBuffer, textureData.mips.front().bytes, textureData.width(), textureData.height());
+}
+
+MeshData AssetManager::builtInCubeData()
+{
+    // viewed by the mesh data, which is kept by the loaded cube
+    static constexpr auto vertices = std::to_array<Vertex>({
         { {-1, -1, -1}, {0, 1}, {-1,  0,  0}, { 0,  1,  0} },
         { {-1,  1, -1}, {1, 1}, {-1,  0,  0}, { 0,  1,  0} },
         { {-1,  1,  1}, {1, 0}, {-1,  0,  0}, { 0,  1,  0} },
@@ -256,7 +625,7 @@ Mesh AssetManager::loadBuiltInCube(gfx::Device& device, gfx::CommandBuffer& comm
         { { 1,  1, -1}, {0, 0}, { 0,  1,  0}, {-1,  0,  0} },
     });
 
-    constexpr auto indices = std::to_array<uint32_t>({
+    static constexpr auto indices = std::to_array<uint32_t>({
          2,  1,  0,  3,  2,  0,
          6,  5,  4,  7,  6,  4,
         10,  9,  8, 11, 10,  8,
@@ -265,21 +634,19 @@ Mesh AssetManager::loadBuiltInCube(gfx::Device& device, gfx::CommandBuffer& comm
         22, 21, 20, 23, 22, 20
     });
 
-    commandBuffer.beginBlitPass();
-    auto mesh = Mesh {
+    return MeshData{
         .name = "built_in_cube",
-        .subMeshes = std::vector<SubMesh> {
-            {
+        .geometries = {
+            MeshData::Geometry{
                 .name = "built_in_cube_submesh",
-                .transform = glm::mat4(1.0f),
-                .vertexBuffer = newDeviceLocalBuffer(device, commandBuffer, gfx::BufferUsage::vertexBuffer, vertices),
-                .indexBuffer = newDeviceLocalBuffer(device, commandBuffer, gfx::BufferUsage::indexBuffer, indices),
-                .subMeshes = {}
+                .vertices = std::span<const Vertex>(vertices),
+                .indices = std::span<const uint32_t>(indices),
+                .boundingSphere = boundingSphere(vertices),
+                .boundingBox = boundingBox(vertices)
             }
-        }
+        },
+        .nodes = { MeshData::Node{ .geometry = 0, .parent = -1, .transform = glm::mat4x4(1.0f) } }
     };
-    commandBuffer.endBlitPass();
-    return mesh;
 }
 
 } // namespace GE
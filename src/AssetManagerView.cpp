@@ -8,7 +8,7 @@
 
 #include "Game-Engine/AssetManagerView.hpp"
 
-#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <utility>
 
@@ -32,27 +32,68 @@ AssetManagerView::AssetManagerView(AssetManager* assetManager, const std::map<VA
             m_assetManager->registerAsset(vAssetPath);
         auto [it, inserted] = m_assets.insert(std::make_pair(assetID, vAssetPath));
         assert(inserted);
-        s_nextAssetId = std::max(s_nextAssetId, assetID + 1);
+        AssetID nextAssetId = s_nextAssetId.load();
+        while (nextAssetId <= assetID && s_nextAssetId.compare_exchange_weak(nextAssetId, assetID + 1) == false) {}
     }
 }
 
+AssetManagerView::AssetManagerView(AssetManagerView&& other) noexcept
+    : m_assetManager(std::exchange(other.m_assetManager, nullptr))
+    , m_registredAssets(std::move(other.m_registredAssets))
+    , m_assets(std::move(other.m_assets))
+    , m_retainedAssets(std::move(other.m_retainedAssets))
+{
+    other.m_retainedAssets.clear();
+}
+
 void AssetManagerView::unloadAsset(AssetID assetId)
 {
     assert(m_assetManager);
+    if (m_retainedAssets.erase(assetId) == 0)
+        return;
     if (assetId == BUILT_IN_CUBE_ASSET_ID)
-        return m_assetManager->unloadBuiltInCube();
-    return m_assetManager->unloadAsset(m_assets.at(assetId));
+        return m_assetManager->releaseBuiltInCube();
+    return m_assetManager->releaseAsset(m_assets.at(assetId));
 }
 
 void AssetManagerView::unloadAllAssets()
 {
     assert(m_assetManager);
-    unloadAssets(m_assets | std::views::transform([](const auto& asset) { return asset.first; }));
+    while (m_retainedAssets.empty() == false)
+        unloadAsset(*m_retainedAssets.begin());
 }
 
 AssetManagerView::~AssetManagerView()
 {
-    unloadAllAssets();
+    if (m_assetManager != nullptr)
+        unloadAllAssets();
+}
+
+void AssetManagerView::retainAsset(AssetID assetId) const
+{
+    assert(m_assetManager);
+    if (m_retainedAssets.contains(assetId))
+        return;
+    if (assetId == BUILT_IN_CUBE_ASSET_ID)
+        m_assetManager->retainBuiltInCube();
+    else
+        m_assetManager->retainAsset(m_assets.at(assetId));
+    m_retainedAssets.insert(assetId);
+}
+
+AssetManagerView& AssetManagerView::operator=(AssetManagerView&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_assetManager != nullptr)
+            unloadAllAssets();
+        m_assetManager = std::exchange(other.m_assetManager, nullptr);
+        m_registredAssets = std::move(other.m_registredAssets);
+        m_assets = std::move(other.m_assets);
+        m_retainedAssets = std::move(other.m_retainedAssets);
+        other.m_retainedAssets.clear();
+    }
+    return *this;
 }
 
 }
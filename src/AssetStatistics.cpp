@@ -0,0 +1,188 @@
+/*
+ * ---------------------------------------------------
+ * AssetStatistics.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/AssetStatistics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <iterator>
+#include <utility>
+
+namespace
+{
+
+void appendJsonString(std::string& json, std::string_view string)
+{
+    json += '"';
+    for (char c : string)
+    {
+        switch (c)
+        {
+        case '"':  json += "\\\""; break;
+        case '\\': json += "\\\\"; break;
+        case '\n': json += "\\n"; break;
+        case '\r': json += "\\r"; break;
+        case '\t': json += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+                std::format_to(std::back_inserter(json), "\\u{:04x}", static_cast<unsigned char>(c));
+            else
+                json += c;
+        }
+    }
+    json += '"';
+}
+
+void appendJsonHistogram(std::string& json, const GE::DurationHistogram& histogram)
+{
+    std::format_to(std::back_inserter(json), "{{\"count\":{},\"totalUs\":{},\"minUs\":{},\"maxUs\":{},\"meanUs\":{},\"p50Us\":{},\"p90Us\":{},\"p99Us\":{},\"buckets\":[",
+                   histogram.count(), histogram.total().count(), histogram.min().count(), histogram.max().count(), histogram.mean().count(),
+                   histogram.percentile(0.5).count(), histogram.percentile(0.9).count(), histogram.percentile(0.99).count());
+    // the empty buckets past the last used one are omitted
+    const auto& buckets = histogram.buckets();
+    size_t usedBucketCount = buckets.size();
+    while (usedBucketCount > 0 && buckets[usedBucketCount - 1] == 0)
+        usedBucketCount--;
+    for (size_t i = 0; i < usedBucketCount; i++)
+        std::format_to(std::back_inserter(json), "{}{}", i == 0 ? "" : ",", buckets[i]);
+    json += "]}";
+}
+
+} // namespace
+
+namespace GE
+{
+
+void DurationHistogram::record(std::chrono::microseconds duration)
+{
+    const auto microseconds = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+    const uint32_t bucket = std::min<uint32_t>(microseconds < 2 ? 0 : static_cast<uint32_t>(std::bit_width(microseconds)) - 1, BUCKET_COUNT - 1);
+    m_buckets[bucket]++;
+    m_count++;
+    m_total += duration;
+    m_min = std::min(m_min, duration);
+    m_max = std::max(m_max, duration);
+}
+
+std::chrono::microseconds DurationHistogram::percentile(double percentile) const
+{
+    if (m_count == 0)
+        return std::chrono::microseconds(0);
+    const auto rank = static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 1.0) * static_cast<double>(m_count)));
+    uint64_t cumulated = 0;
+    for (uint32_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        cumulated += m_buckets[i];
+        if (cumulated >= std::max<uint64_t>(rank, 1))
+            return std::min(std::chrono::microseconds(int64_t(2) << i), m_max);
+    }
+    return m_max;
+}
+
+std::string AssetStatistics::toJson() const
+{
+    std::string json = "{";
+    std::format_to(std::back_inserter(json), "\"loadCount\":{},\"reloadCount\":{},\"failedLoadCount\":{},\"unloadCount\":{},\"evictionCount\":{},\"readBytes\":{},",
+                   loadCount, reloadCount, failedLoadCount, unloadCount, evictionCount, readBytes);
+    std::format_to(std::back_inserter(json), "\"residentBytes\":{},\"residencyBudget\":{},\"pendingReadCount\":{},\"reloadingCount\":{},\"unreferencedCount\":{},\"deferredStreamingRequestCount\":{},",
+                   residentBytes, residencyBudget, pendingReadCount, reloadingCount, unreferencedCount, deferredStreamingRequestCount);
+
+    json += "\"types\":{";
+    for (auto it = types.begin(); it != types.end(); ++it)
+    {
+        if (it != types.begin())
+            json += ',';
+        appendJsonString(json, it->first);
+        std::format_to(std::back_inserter(json), ":{{\"assetCount\":{},\"loadingCount\":{},\"loadedCount\":{},\"residentBytes\":{}}}",
+                       it->second.assetCount, it->second.loadingCount, it->second.loadedCount, it->second.residentBytes);
+    }
+    json += "},";
+
+    json += "\"histograms\":{\"read\":";
+    appendJsonHistogram(json, readTimes);
+    json += ",\"decode\":";
+    appendJsonHistogram(json, decodeTimes);
+    json += ",\"upload\":";
+    appendJsonHistogram(json, uploadTimes);
+    json += ",\"load\":";
+    appendJsonHistogram(json, loadTimes);
+    json += "},";
+
+    json += "\"records\":[";
+    for (auto it = records.begin(); it != records.end(); ++it)
+    {
+        if (it != records.begin())
+            json += ',';
+        json += "{\"type\":";
+        appendJsonString(json, it->type);
+        json += ",\"path\":";
+        appendJsonString(json, it->path.generic_string());
+        std::format_to(std::back_inserter(json), ",\"reload\":{},\"failed\":{},\"startUs\":{},\"readUs\":{},\"decodeUs\":{},\"uploadUs\":{},\"sourceBytes\":{},\"residentBytes\":{}}}",
+                       it->reload, it->failed, it->start.count(), it->readTime.count(), it->decodeTime.count(), it->uploadTime.count(), it->sourceBytes, it->residentBytes);
+    }
+    json += "]}";
+    return json;
+}
+
+void AssetLoadRecorder::record(AssetLoadRecord record)
+{
+    std::scoped_lock lock(m_mutex);
+    (record.reload ? m_statistics.reloadCount : m_statistics.loadCount)++;
+    m_statistics.readBytes += record.sourceBytes;
+    if (record.failed)
+        m_statistics.failedLoadCount++;
+    else
+    {
+        m_statistics.readTimes.record(record.readTime);
+        m_statistics.decodeTimes.record(record.decodeTime);
+        m_statistics.uploadTimes.record(record.uploadTime);
+        m_statistics.loadTimes.record(record.totalTime());
+    }
+    if (m_records.size() == RECORD_CAPACITY)
+        m_records.pop_front();
+    m_records.push_back(std::move(record));
+}
+
+void AssetLoadRecorder::countUnload()
+{
+    std::scoped_lock lock(m_mutex);
+    m_statistics.unloadCount++;
+}
+
+void AssetLoadRecorder::countEviction()
+{
+    std::scoped_lock lock(m_mutex);
+    m_statistics.evictionCount++;
+}
+
+void AssetLoadRecorder::fill(AssetStatistics& statistics) const
+{
+    std::scoped_lock lock(m_mutex);
+    statistics.loadCount = m_statistics.loadCount;
+    statistics.reloadCount = m_statistics.reloadCount;
+    statistics.failedLoadCount = m_statistics.failedLoadCount;
+    statistics.unloadCount = m_statistics.unloadCount;
+    statistics.evictionCount = m_statistics.evictionCount;
+    statistics.readBytes = m_statistics.readBytes;
+    statistics.readTimes = m_statistics.readTimes;
+    statistics.decodeTimes = m_statistics.decodeTimes;
+    statistics.uploadTimes = m_statistics.uploadTimes;
+    statistics.loadTimes = m_statistics.loadTimes;
+    statistics.records.assign(m_records.begin(), m_records.end());
+}
+
+void AssetLoadRecorder::reset()
+{
+    std::scoped_lock lock(m_mutex);
+    m_statistics = AssetStatistics();
+    m_records.clear();
+}
+
+} // namespace GE
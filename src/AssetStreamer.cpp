@@ -0,0 +1,436 @@
+/*
+ * ---------------------------------------------------
+ * AssetStreamer.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/AssetStreamer.hpp"
+
+#include "MeshUpload.hpp"
+
+#include <Graphics/Buffer.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <variant>
+
+namespace GE
+{
+
+namespace
+{
+
+// the Graphics textures have no block compressed pixel format, the mips are uploaded decoded
+std::shared_ptr<gfx::Texture> uploadMip(gfx::Device& device, gfx::CommandBuffer& commandBuffer, const TextureData& textureData, uint32_t mipIndex)
+{
+    const TextureData::Mip& mip = textureData.mips[mipIndex];
+    if (isBlockCompressed(textureData.format))
+        return uploadTexture(device, commandBuffer, decodeMip(textureData, mipIndex), mip.width, mip.height);
+    return uploadTexture(device, commandBuffer, mip.bytes, mip.width, mip.height);
+}
+
+size_t decodedMipSize(const TextureData::Mip& mip)
+{
+    return static_cast<size_t>(mip.width) * mip.height * 4;
+}
+
+size_t textureByteSize(const std::shared_ptr<gfx::Texture>& texture)
+{
+    return texture ? static_cast<size_t>(texture->width()) * texture->height() * pixelFormatSize(texture->pixelFormat()) : 0;
+}
+
+} // namespace
+
+StreamedTexture::StreamedTexture(gfx::Device& device, gfx::CommandBuffer& commandBuffer, TextureData textureData, std::function<void(const std::shared_ptr<gfx::Texture>&)> onTextureChange)
+    : m_textureData(std::move(textureData))
+    , m_onTextureChange(std::move(onTextureChange))
+{
+    assert(m_textureData.mips.empty() == false);
+    while (m_tailMip + 1 < m_textureData.mips.size() && std::max(m_textureData.mips[m_tailMip].width, m_textureData.mips[m_tailMip].height) > MIP_TAIL_SIZE)
+        m_tailMip++;
+    m_residentMip = m_tailMip;
+    m_tailTexture = uploadMip(device, commandBuffer, m_textureData, m_tailMip);
+    m_texture = m_tailTexture;
+}
+
+size_t StreamedTexture::uploadSize(uint32_t level) const
+{
+    return level < m_residentMip ? decodedMipSize(m_textureData.mips[level]) : 0;
+}
+
+size_t StreamedTexture::residentBytes() const
+{
+    return textureByteSize(m_tailTexture) + (m_texture != m_tailTexture ? textureByteSize(m_texture) : 0);
+}
+
+void StreamedTexture::makeResident(uint32_t level, gfx::Device& device, gfx::CommandBuffer& commandBuffer)
+{
+    assert(level < m_residentMip);
+    m_texture = uploadMip(device, commandBuffer, m_textureData, level);
+    m_residentMip = level;
+    if (m_onTextureChange)
+        m_onTextureChange(m_texture);
+}
+
+void StreamedTexture::evict(uint32_t level)
+{
+    assert(level < levelCount());
+    if (level <= m_residentMip)
+        return;
+    m_texture = m_tailTexture;
+    m_residentMip = m_tailMip;
+    if (m_onTextureChange)
+        m_onTextureChange(m_texture);
+}
+
+StreamedMesh::StreamedMesh(gfx::Device& device, GeometryPool& geometryPool, gfx::CommandBuffer& commandBuffer, MeshData meshData, bool allLevelsResident)
+    : m_meshData(std::move(meshData))
+    , m_geometryPool(&geometryPool)
+    , m_geometrySubMeshes(m_meshData.geometries.size())
+{
+    std::vector<uint32_t> subMeshGeometries;
+    m_mesh = std::make_shared<Mesh>(newMesh(device, geometryPool, commandBuffer, m_meshData, allLevelsResident == false, &subMeshGeometries));
+
+    auto geometry = subMeshGeometries.begin();
+    std::function<void(SubMesh&)> collectSubMeshes = [&](SubMesh& subMesh) {
+        assert(geometry != subMeshGeometries.end());
+        m_geometrySubMeshes[*geometry++].push_back(&subMesh);
+        for (SubMesh& child : subMesh.subMeshes)
+            collectSubMeshes(child);
+    };
+    for (SubMesh& subMesh : m_mesh->subMeshes)
+        collectSubMeshes(subMesh);
+
+    for (const MeshData::Geometry& geometry : m_meshData.geometries)
+        m_levelCount = std::max(m_levelCount, static_cast<uint32_t>(geometry.lods.size()) + 1);
+    m_residentLevel = allLevelsResident ? 0 : m_levelCount - 1;
+    m_compactedFreeCount = m_geometryPool->retiredFreeCount();
+}
+
+size_t StreamedMesh::uploadSize(uint32_t level) const
+{
+    size_t size = 0;
+    for (uint32_t geometry = 0; geometry < m_meshData.geometries.size(); geometry++)
+    {
+        if (m_geometrySubMeshes[geometry].empty())
+            continue;
+        for (uint32_t i = geometryLevel(geometry, level); i < geometryLevel(geometry, m_residentLevel); i++)
+        {
+            const MeshData::Geometry& data = m_meshData.geometries[geometry];
+            const std::span<const uint32_t> indices = i == 0 ? data.indices : data.lods[i - 1].indices;
+            size += indices.size_bytes();
+        }
+    }
+    return size;
+}
+
+size_t StreamedMesh::residentBytes() const
+{
+    size_t byteSize = 0;
+    for (const std::vector<SubMesh*>& subMeshes : m_geometrySubMeshes)
+    {
+        if (subMeshes.empty())
+            continue;
+        const SubMesh& subMesh = *subMeshes.front();
+        byteSize += static_cast<size_t>(subMesh.vertexAllocation->count) * subMesh.vertexAllocation->stride;
+        byteSize += subMesh.indexBuffer ? subMesh.indexBuffer->size() : 0;
+        for (const SubMesh::Lod& lod : subMesh.lods)
+            byteSize += lod.indexBuffer ? lod.indexBuffer->size() : 0;
+    }
+    return byteSize;
+}
+
+void StreamedMesh::makeResident(uint32_t level, gfx::Device& device, gfx::CommandBuffer& commandBuffer)
+{
+    assert(level < m_residentLevel);
+    commandBuffer.beginBlitPass();
+    for (uint32_t geometry = 0; geometry < m_meshData.geometries.size(); geometry++)
+    {
+        if (m_geometrySubMeshes[geometry].empty())
+            continue;
+        const MeshData::Geometry& data = m_meshData.geometries[geometry];
+        const uint32_t vertexOffset = m_geometrySubMeshes[geometry].front()->vertexOffset;
+        for (uint32_t i = geometryLevel(geometry, level); i < geometryLevel(geometry, m_residentLevel); i++)
+            setIndexBuffer(geometry, i, newIndexBuffer(device, commandBuffer, i == 0 ? data.indices : data.lods[i - 1].indices, vertexOffset));
+    }
+    commandBuffer.endBlitPass();
+    m_residentLevel = level;
+}
+
+void StreamedMesh::evict(uint32_t level)
+{
+    assert(level < m_levelCount);
+    if (level <= m_residentLevel)
+        return;
+    for (uint32_t geometry = 0; geometry < m_meshData.geometries.size(); geometry++)
+    {
+        for (uint32_t i = geometryLevel(geometry, m_residentLevel); i < geometryLevel(geometry, level); i++)
+            setIndexBuffer(geometry, i, nullptr);
+    }
+    m_residentLevel = level;
+}
+
+bool StreamedMesh::canCompact() const
+{
+    return m_geometryPool->retiredFreeCount() != m_compactedFreeCount;
+}
+
+size_t StreamedMesh::compact(gfx::Device& device, gfx::CommandBuffer& commandBuffer)
+{
+    m_compactedFreeCount = m_geometryPool->retiredFreeCount();
+    size_t copiedBytes = 0;
+    bool isBlitPassBegun = false;
+    std::vector<std::shared_ptr<const GeometryPool::Allocation>> allocations;
+    for (uint32_t geometry = 0; geometry < m_meshData.geometries.size(); geometry++)
+    {
+        if (m_geometrySubMeshes[geometry].empty())
+            continue;
+        std::shared_ptr<const GeometryPool::Allocation> allocation = m_geometryPool->relocate(*m_geometrySubMeshes[geometry].front()->vertexAllocation);
+        if (allocation == nullptr)
+            continue;
+        allocations.push_back(allocation);
+
+        if (isBlitPassBegun == false)
+        {
+            commandBuffer.beginBlitPass();
+            isBlitPassBegun = true;
+        }
+        // the indices are offset by the position of the vertices in the pool
+        const MeshData::Geometry& data = m_meshData.geometries[geometry];
+        for (uint32_t i = geometryLevel(geometry, m_residentLevel); i <= data.lods.size(); i++)
+        {
+            std::shared_ptr<gfx::Buffer> indexBuffer = newIndexBuffer(device, commandBuffer, i == 0 ? data.indices : data.lods[i - 1].indices, allocation->offset);
+            copiedBytes += indexBuffer->size();
+            setIndexBuffer(geometry, i, indexBuffer);
+        }
+        // the original range is released with the last submesh referencing it
+        for (SubMesh* subMesh : m_geometrySubMeshes[geometry])
+        {
+            subMesh->vertexBuffer = allocation->buffer;
+            subMesh->vertexOffset = allocation->offset;
+            subMesh->vertexAllocation = allocation;
+        }
+    }
+    if (isBlitPassBegun)
+    {
+        copiedBytes += m_geometryPool->upload(commandBuffer, allocations);
+        commandBuffer.endBlitPass();
+    }
+    return copiedBytes;
+}
+
+uint32_t StreamedMesh::geometryLevel(uint32_t geometry, uint32_t level) const
+{
+    return std::min(level, static_cast<uint32_t>(m_meshData.geometries[geometry].lods.size()));
+}
+
+void StreamedMesh::setIndexBuffer(uint32_t geometry, uint32_t level, const std::shared_ptr<gfx::Buffer>& buffer)
+{
+    for (SubMesh* subMesh : m_geometrySubMeshes[geometry])
+        (level == 0 ? subMesh->indexBuffer : subMesh->lods[level - 1].indexBuffer) = buffer;
+}
+
+uint32_t selectMip(uint32_t textureWidth, uint32_t textureHeight, float projectedSize)
+{
+    const uint32_t coarsestMip = mipLevelCount(textureWidth, textureHeight) - 1;
+    if (projectedSize <= 1.0f)
+        return coarsestMip;
+    const float mip = std::floor(std::log2(static_cast<float>(std::max(textureWidth, textureHeight)) / projectedSize));
+    return mip <= 0.0f ? 0 : std::min(static_cast<uint32_t>(mip), coarsestMip);
+}
+
+AssetStreamer::AssetStreamer(gfx::Device* device, size_t frameByteBudget, uint32_t evictionDelay)
+    : m_device(device)
+    , m_frameByteBudget(frameByteBudget)
+    , m_evictionDelay(evictionDelay)
+{
+    assert(m_device);
+    for (InFlightData& inFlightData : m_inFlightDatas)
+    {
+        inFlightData.commandBufferPool = m_device->newCommandBufferPool();
+        assert(inFlightData.commandBufferPool);
+    }
+}
+
+void AssetStreamer::addCompactable(const std::shared_ptr<StreamableAsset>& asset)
+{
+    assert(asset);
+    std::scoped_lock lock(m_compactablesMutex);
+    m_compactables.push_back(asset);
+}
+
+void AssetStreamer::request(const std::shared_ptr<StreamableAsset>& asset, uint32_t level, float priority)
+{
+    assert(asset);
+    level = std::min(level, asset->coarsestLevel());
+
+    Entry& entry = m_entries[asset.get()];
+    if (entry.asset.lock() != asset)
+    {
+        // new asset, or an other one allocated where an expired asset was
+        entry = Entry{
+            .asset = asset,
+            .targetLevel = asset->residentLevel(),
+            .targetFrame = m_statistics.frameCount
+        };
+    }
+
+    if (entry.requestFrame != m_statistics.frameCount + 1)
+    {
+        entry.requestedLevel = level;
+        entry.requestFrame = m_statistics.frameCount + 1;
+        entry.priority = priority;
+    }
+    else
+    {
+        entry.requestedLevel = std::min(entry.requestedLevel, level);
+        entry.priority = std::max(entry.priority, priority);
+    }
+}
+
+ptrdiff_t AssetStreamer::update()
+{
+    const uint64_t frame = ++m_statistics.frameCount;
+    m_statistics.frameStreamedBytes = 0;
+    m_statistics.frameCompactedBytes = 0;
+    m_statistics.frameUploadCount = 0;
+    m_statistics.deferredRequestCount = 0;
+
+    InFlightData& inFlightData = m_inFlightDatas[frame % maxFrameInFlight];
+    if (inFlightData.waitedCommandBuffer != nullptr)
+    {
+        m_device->waitCommandBuffer(*inFlightData.waitedCommandBuffer);
+        inFlightData.waitedCommandBuffer = nullptr;
+        inFlightData.commandBufferPool->reset();
+    }
+    std::shared_ptr<gfx::CommandBuffer> commandBuffer;
+
+    ptrdiff_t residentBytesDelta = 0;
+    const auto changeLevel = [&](StreamableAsset& asset, auto&& change) {
+        const size_t residentBytes = asset.residentBytes();
+        change();
+        residentBytesDelta += static_cast<ptrdiff_t>(asset.residentBytes()) - static_cast<ptrdiff_t>(residentBytes);
+    };
+
+    struct Refinement
+    {
+        std::shared_ptr<StreamableAsset> asset;
+        uint32_t targetLevel;
+        float priority;
+    };
+    std::vector<Refinement> refinements;
+
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        Entry& entry = it->second;
+        std::shared_ptr<StreamableAsset> asset = entry.asset.lock();
+        if (asset == nullptr)
+        {
+            it = m_entries.erase(it);
+            continue;
+        }
+        ++it;
+
+        // finer levels are streamed as soon as they are requested, but only released
+        // once they have not been needed for the eviction delay
+        const bool requested = entry.requestFrame == frame;
+        if (requested && entry.requestedLevel <= entry.targetLevel)
+        {
+            entry.targetLevel = entry.requestedLevel;
+            entry.targetFrame = frame;
+        }
+        else if (frame - entry.targetFrame >= m_evictionDelay)
+        {
+            entry.targetLevel = requested ? entry.requestedLevel : asset->coarsestLevel();
+            entry.targetFrame = frame;
+        }
+
+        if (entry.targetLevel > asset->residentLevel())
+            changeLevel(*asset, [&] { asset->evict(entry.targetLevel); });
+        if (entry.targetLevel < asset->residentLevel())
+            refinements.push_back(Refinement{ .asset = std::move(asset), .targetLevel = entry.targetLevel, .priority = entry.priority });
+    }
+
+    std::ranges::stable_sort(refinements, std::ranges::greater(), &Refinement::priority);
+
+    for (Refinement& refinement : refinements)
+    {
+        StreamableAsset& asset = *refinement.asset;
+        const size_t remainingBudget = m_frameByteBudget - std::min(m_frameByteBudget, m_statistics.frameStreamedBytes);
+
+        // the finest level fitting in the remaining budget, the intermediate levels are skipped
+        uint32_t level = asset.residentLevel();
+        while (level > refinement.targetLevel && asset.uploadSize(level - 1) <= remainingBudget)
+            level--;
+        if (level == asset.residentLevel() && m_statistics.frameUploadCount == 0)
+            level--;
+
+        if (level != asset.residentLevel())
+        {
+            if (commandBuffer == nullptr)
+            {
+                commandBuffer = inFlightData.commandBufferPool->get();
+                assert(commandBuffer);
+            }
+            m_statistics.frameStreamedBytes += asset.uploadSize(level);
+            m_statistics.frameUploadCount++;
+            changeLevel(asset, [&] { asset.makeResident(level, *m_device, *commandBuffer); });
+        }
+        if (level != refinement.targetLevel)
+            m_statistics.deferredRequestCount++;
+    }
+
+    // the room released by the unloaded assets is filled with a budget of its own, the
+    // streaming one is 0 when nothing is streamed
+    {
+        std::scoped_lock lock(m_compactablesMutex);
+        std::erase_if(m_compactables, [](const std::weak_ptr<StreamableAsset>& asset) { return asset.expired(); });
+        for (const std::weak_ptr<StreamableAsset>& weakAsset : m_compactables)
+        {
+            if (m_frameCompactionBudget == 0 || m_statistics.frameCompactedBytes >= m_frameCompactionBudget)
+                break;
+            std::shared_ptr<StreamableAsset> asset = weakAsset.lock();
+            if (asset == nullptr || asset->canCompact() == false)
+                continue;
+            if (commandBuffer == nullptr)
+            {
+                commandBuffer = inFlightData.commandBufferPool->get();
+                assert(commandBuffer);
+            }
+            m_statistics.frameCompactedBytes += asset->compact(*m_device, *commandBuffer);
+        }
+    }
+
+    if (commandBuffer != nullptr)
+    {
+        m_device->submitCommandBuffers(commandBuffer);
+        inFlightData.waitedCommandBuffer = commandBuffer;
+    }
+
+    m_statistics.streamedBytes += m_statistics.frameStreamedBytes;
+    m_statistics.residentBytes = 0;
+    for (const auto& [_, entry] : m_entries)
+    {
+        if (std::shared_ptr<StreamableAsset> asset = entry.asset.lock())
+            m_statistics.residentBytes += asset->residentBytes();
+    }
+    m_statistics.assetCount = static_cast<uint32_t>(m_entries.size());
+    return residentBytesDelta;
+}
+
+AssetStreamer::~AssetStreamer()
+{
+    for (InFlightData& inFlightData : m_inFlightDatas)
+    {
+        if (inFlightData.waitedCommandBuffer != nullptr)
+            m_device->waitCommandBuffer(*inFlightData.waitedCommandBuffer);
+    }
+}
+
+} // namespace GE
@@ -0,0 +1,397 @@
+/*
+ * ---------------------------------------------------
+ * AsyncFileReader.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/AsyncFileReader.hpp"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+    #define GE_IO_URING
+    #include <linux/io_uring.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace
+{
+
+std::vector<std::byte> readFileBlocking(const std::filesystem::path& path)
+{
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error))
+        throw std::runtime_error("failed to read file: " + path.string() + ": not a regular file");
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    const std::streamoff size = file ? static_cast<std::streamoff>(file.tellg()) : -1;
+    if (size < 0)
+        throw std::runtime_error("failed to open file: " + path.string());
+    std::vector<std::byte> bytes(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+        throw std::runtime_error("failed to read file: " + path.string());
+    return bytes;
+}
+
+} // namespace
+
+namespace GE
+{
+
+#if defined(GE_IO_URING)
+
+namespace
+{
+
+constexpr size_t IO_URING_MAX_READ_SIZE = size_t(1) << 30; // the length of a read is 32 bits
+constexpr uint64_t IO_URING_WAKE_UP = 0;                  // user data of the no-op waking up the completion thread
+
+template<typename T>
+T& ringField(std::byte* ring, uint32_t offset)
+{
+    return *reinterpret_cast<T*>(ring + offset);
+}
+
+} // namespace
+
+// The rings are used through the raw system calls, the few operations needed here
+// do not justify a dependency on liburing. The submission queue is only written
+// with the mutex of the reader locked and the completion queue is only read by
+// the completion thread.
+struct AsyncFileReader::IoUring
+{
+    int fileDescriptor = -1;
+    io_uring_params params = {};
+    std::byte* submissionRing = nullptr;
+    size_t submissionRingSize = 0;
+    std::byte* completionRing = nullptr;
+    size_t completionRingSize = 0;
+    io_uring_sqe* submissionEntries = nullptr;
+    uint32_t inFlightCount = 0; // bounded by the completion queue size so it never overflows
+
+    // nullptr if the kernel does not support io_uring, or forbids it, or is older than linux 5.6
+    static std::unique_ptr<IoUring> create(uint32_t queueDepth)
+    {
+        auto ioUring = std::make_unique<IoUring>();
+        ioUring->fileDescriptor = static_cast<int>(::syscall(__NR_io_uring_setup, queueDepth, &ioUring->params));
+        if (ioUring->fileDescriptor < 0 || (ioUring->params.features & IORING_FEAT_RW_CUR_POS) == 0) // IORING_OP_READ came with it
+            return nullptr;
+
+        const io_uring_params& params = ioUring->params;
+        ioUring->submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        ioUring->completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            ioUring->submissionRingSize = ioUring->completionRingSize = std::max(ioUring->submissionRingSize, ioUring->completionRingSize);
+
+        void* submissionRing = ::mmap(nullptr, ioUring->submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ioUring->fileDescriptor, IORING_OFF_SQ_RING);
+        if (submissionRing == MAP_FAILED)
+            return nullptr;
+        ioUring->submissionRing = static_cast<std::byte*>(submissionRing);
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            ioUring->completionRing = ioUring->submissionRing;
+        else
+        {
+            void* completionRing = ::mmap(nullptr, ioUring->completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ioUring->fileDescriptor, IORING_OFF_CQ_RING);
+            if (completionRing == MAP_FAILED)
+                return nullptr;
+            ioUring->completionRing = static_cast<std::byte*>(completionRing);
+        }
+
+        void* submissionEntries = ::mmap(nullptr, params.sq_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ioUring->fileDescriptor, IORING_OFF_SQES);
+        if (submissionEntries == MAP_FAILED)
+            return nullptr;
+        ioUring->submissionEntries = static_cast<io_uring_sqe*>(submissionEntries);
+        return ioUring;
+    }
+
+    inline bool isSubmissionQueueFull() const
+    {
+        const uint32_t head = std::atomic_ref(ringField<uint32_t>(submissionRing, params.sq_off.head)).load(std::memory_order_acquire);
+        return ringField<uint32_t>(submissionRing, params.sq_off.tail) - head >= params.sq_entries;
+    }
+
+    // the entry is only seen by the kernel after the next submit
+    void push(const io_uring_sqe& entry)
+    {
+        uint32_t& tail = ringField<uint32_t>(submissionRing, params.sq_off.tail);
+        const uint32_t index = tail & ringField<uint32_t>(submissionRing, params.sq_off.ring_mask);
+        submissionEntries[index] = entry;
+        (&ringField<uint32_t>(submissionRing, params.sq_off.array))[index] = index;
+        std::atomic_ref(tail).store(tail + 1, std::memory_order_release);
+        inFlightCount++;
+    }
+
+    void submit()
+    {
+        const uint32_t head = std::atomic_ref(ringField<uint32_t>(submissionRing, params.sq_off.head)).load(std::memory_order_acquire);
+        const uint32_t pendingCount = ringField<uint32_t>(submissionRing, params.sq_off.tail) - head;
+        // without SQPOLL the kernel consumes the entries in the call, the ones left by an interruption are submitted by the next call
+        if (pendingCount > 0)
+            ::syscall(__NR_io_uring_enter, fileDescriptor, pendingCount, 0, 0, nullptr, 0);
+    }
+
+    void waitForCompletion() const
+    {
+        ::syscall(__NR_io_uring_enter, fileDescriptor, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+    }
+
+    ~IoUring()
+    {
+        if (submissionEntries != nullptr)
+            ::munmap(submissionEntries, params.sq_entries * sizeof(io_uring_sqe));
+        if (completionRing != nullptr && completionRing != submissionRing)
+            ::munmap(completionRing, completionRingSize);
+        if (submissionRing != nullptr)
+            ::munmap(submissionRing, submissionRingSize);
+        if (fileDescriptor >= 0)
+            ::close(fileDescriptor);
+    }
+};
+
+#else
+
+struct AsyncFileReader::IoUring
+{
+};
+
+#endif
+
+AsyncFileReader::AsyncFileReader(Backend backend, uint32_t threadCount)
+    : m_backend(Backend::threadPool)
+{
+#if defined(GE_IO_URING)
+    if (backend == Backend::ioUring)
+        m_ioUring = IoUring::create(IO_URING_QUEUE_DEPTH);
+    if (m_ioUring)
+    {
+        m_backend = Backend::ioUring;
+        m_threads.emplace_back(&AsyncFileReader::completeIoUringReads, this);
+        return;
+    }
+#else
+    (void)backend;
+#endif
+    for (uint32_t i = 0; i < std::max(threadCount, 1u); i++)
+        m_threads.emplace_back(&AsyncFileReader::threadPoolLoop, this);
+}
+
+std::future<std::vector<std::byte>> AsyncFileReader::read(const std::filesystem::path& path)
+{
+    return std::move(read(std::span(&path, 1)).front());
+}
+
+std::vector<std::future<std::vector<std::byte>>> AsyncFileReader::read(std::span<const std::filesystem::path> paths)
+{
+    std::vector<std::future<std::vector<std::byte>>> futures;
+    futures.reserve(paths.size());
+    std::vector<std::unique_ptr<Request>> requests;
+    requests.reserve(paths.size());
+    for (const std::filesystem::path& path : paths)
+    {
+        auto& request = requests.emplace_back(std::make_unique<Request>());
+        request->path = path;
+        futures.push_back(request->promise.get_future());
+    }
+    m_pendingReadCount.fetch_add(static_cast<uint32_t>(requests.size()), std::memory_order_relaxed);
+
+#if defined(GE_IO_URING)
+    if (m_ioUring)
+    {
+        submitToIoUring(std::move(requests));
+        return futures;
+    }
+#endif
+    {
+        std::scoped_lock lock(m_mutex);
+        std::ranges::move(requests, std::back_inserter(m_queuedRequests));
+    }
+    m_queueCondition.notify_all();
+    return futures;
+}
+
+void AsyncFileReader::threadPoolLoop()
+{
+    while (true)
+    {
+        std::unique_ptr<Request> request;
+        {
+            std::unique_lock lock(m_mutex);
+            m_queueCondition.wait(lock, [&]() { return m_stopping || m_queuedRequests.empty() == false; });
+            if (m_queuedRequests.empty())
+                return;
+            request = std::move(m_queuedRequests.front());
+            m_queuedRequests.pop_front();
+        }
+        try {
+            request->promise.set_value(readFileBlocking(request->path));
+        }
+        catch (...) {
+            request->promise.set_exception(std::current_exception());
+        }
+        m_pendingReadCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+#if defined(GE_IO_URING)
+
+void AsyncFileReader::submitToIoUring(std::vector<std::unique_ptr<Request>>&& requests)
+{
+    // the files are opened by the caller, only the reads go through the ring
+    std::vector<std::unique_ptr<Request>> openedRequests;
+    openedRequests.reserve(requests.size());
+    for (std::unique_ptr<Request>& request : requests)
+    {
+        request->fileDescriptor = ::open(request->path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st = {};
+        std::string reason;
+        if (request->fileDescriptor < 0 || ::fstat(request->fileDescriptor, &st) != 0)
+            reason = std::strerror(errno);
+        else if (S_ISREG(st.st_mode) == false)
+            reason = "not a regular file";
+        if (reason.empty() == false)
+        {
+            if (request->fileDescriptor >= 0)
+                ::close(request->fileDescriptor);
+            request->promise.set_exception(std::make_exception_ptr(std::runtime_error("failed to read file: " + request->path.string() + ": " + reason)));
+            m_pendingReadCount.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (st.st_size == 0)
+        {
+            ::close(request->fileDescriptor);
+            request->promise.set_value({});
+            m_pendingReadCount.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+        request->bytes.resize(static_cast<size_t>(st.st_size));
+        openedRequests.push_back(std::move(request));
+    }
+
+    std::scoped_lock lock(m_mutex);
+    std::ranges::move(openedRequests, std::back_inserter(m_queuedRequests));
+    flushIoUringQueue();
+}
+
+void AsyncFileReader::flushIoUringQueue()
+{
+    IoUring& ioUring = *m_ioUring;
+    bool pushed = false;
+    while (m_queuedRequests.empty() == false && ioUring.inFlightCount < ioUring.params.cq_entries && ioUring.isSubmissionQueueFull() == false)
+    {
+        Request* request = m_queuedRequests.front().release();
+        m_queuedRequests.pop_front();
+        io_uring_sqe entry = {};
+        entry.opcode = IORING_OP_READ;
+        entry.fd = request->fileDescriptor;
+        entry.off = request->readSize;
+        entry.addr = reinterpret_cast<uint64_t>(request->bytes.data() + request->readSize);
+        entry.len = static_cast<uint32_t>(std::min(request->bytes.size() - request->readSize, IO_URING_MAX_READ_SIZE));
+        entry.user_data = reinterpret_cast<uint64_t>(request);
+        ioUring.push(entry);
+        pushed = true;
+    }
+    if (pushed)
+        ioUring.submit();
+}
+
+void AsyncFileReader::completeIoUringReads()
+{
+    IoUring& ioUring = *m_ioUring;
+    uint32_t& completionHead = ringField<uint32_t>(ioUring.completionRing, ioUring.params.cq_off.head);
+    const uint32_t& completionTail = ringField<uint32_t>(ioUring.completionRing, ioUring.params.cq_off.tail);
+    const uint32_t completionMask = ringField<uint32_t>(ioUring.completionRing, ioUring.params.cq_off.ring_mask);
+    const auto* completionEntries = &ringField<io_uring_cqe>(ioUring.completionRing, ioUring.params.cq_off.cqes);
+
+    bool stopped = false;
+    while (stopped == false)
+    {
+        ioUring.waitForCompletion();
+
+        std::vector<std::unique_ptr<Request>> completedRequests;
+        std::vector<std::pair<std::unique_ptr<Request>, int>> failedRequests;
+        {
+            std::scoped_lock lock(m_mutex);
+            const uint32_t tail = std::atomic_ref(completionTail).load(std::memory_order_acquire);
+            for (uint32_t head = completionHead; head != tail; head++)
+            {
+                const io_uring_cqe& completion = completionEntries[head & completionMask];
+                ioUring.inFlightCount--;
+                if (completion.user_data == IO_URING_WAKE_UP)
+                    continue;
+                std::unique_ptr<Request> request(reinterpret_cast<Request*>(completion.user_data));
+                if (completion.res == -EINTR || completion.res == -EAGAIN)
+                    m_queuedRequests.push_front(std::move(request));
+                else if (completion.res < 0)
+                    failedRequests.emplace_back(std::move(request), -completion.res);
+                else
+                {
+                    request->readSize += static_cast<size_t>(completion.res);
+                    if (completion.res == 0) // truncated since it was opened
+                        request->bytes.resize(request->readSize);
+                    if (request->readSize < request->bytes.size())
+                        m_queuedRequests.push_front(std::move(request)); // short read, the rest is read by an other submission
+                    else
+                        completedRequests.push_back(std::move(request));
+                }
+            }
+            std::atomic_ref(completionHead).store(tail, std::memory_order_release);
+            flushIoUringQueue();
+            stopped = m_stopping && ioUring.inFlightCount == 0 && m_queuedRequests.empty();
+        }
+
+        // the promises are fulfilled without the lock, the continuations of the futures may read other files
+        for (std::unique_ptr<Request>& request : completedRequests)
+        {
+            ::close(request->fileDescriptor);
+            request->promise.set_value(std::move(request->bytes));
+        }
+        for (auto& [request, error] : failedRequests)
+        {
+            ::close(request->fileDescriptor);
+            request->promise.set_exception(std::make_exception_ptr(std::runtime_error("failed to read file: " + request->path.string() + ": " + std::strerror(error))));
+        }
+        m_pendingReadCount.fetch_sub(static_cast<uint32_t>(completedRequests.size() + failedRequests.size()), std::memory_order_relaxed);
+    }
+}
+
+#endif
+
+AsyncFileReader::~AsyncFileReader()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stopping = true;
+#if defined(GE_IO_URING)
+        // the completion thread waits for a completion, an idle ring needs one to wake it up
+        if (m_ioUring && m_ioUring->inFlightCount == 0)
+        {
+            io_uring_sqe entry = {};
+            entry.opcode = IORING_OP_NOP;
+            entry.user_data = IO_URING_WAKE_UP;
+            m_ioUring->push(entry);
+            m_ioUring->submit();
+        }
+#endif
+    }
+    m_queueCondition.notify_all();
+    for (std::thread& thread : m_threads)
+        thread.join();
+}
+
+} // namespace GE
@@ -0,0 +1,39 @@
+/*
+ * ---------------------------------------------------
+ * CookedFile.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "CookedFile.hpp"
+
+#include <format>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+namespace GE
+{
+
+void writeFileAtomically(const std::filesystem::path& path, std::span<const std::byte> bytes)
+{
+    std::filesystem::path tmpPath = path;
+    tmpPath += std::format(".{:x}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream stream(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+            throw std::runtime_error("failed to write: " + tmpPath.string());
+    }
+    std::error_code error;
+    std::filesystem::rename(tmpPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(tmpPath, error);
+        throw std::runtime_error("failed to write: " + path.string());
+    }
+}
+
+} // namespace GE
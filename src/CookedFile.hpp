@@ -0,0 +1,51 @@
+/*
+ * ---------------------------------------------------
+ * CookedFile.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Helpers shared by the readers and writers of the cooked asset files,
+ * which are read in place from a memory mapping.
+ *
+ */
+
+#ifndef COOKEDFILE_HPP
+#define COOKEDFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace GE
+{
+
+constexpr size_t COOKED_FILE_BLOB_ALIGNMENT = 16;
+
+constexpr size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+template<typename T>
+bool isValidBlob(std::span<const std::byte> file, uint64_t offset, uint64_t count)
+{
+    return offset % alignof(T) == 0 && offset <= file.size() && count <= (file.size() - offset) / sizeof(T);
+}
+
+template<typename T>
+const T* readRecords(std::span<const std::byte> file, uint64_t offset, uint64_t count)
+{
+    if (!isValidBlob<T>(file, offset, count))
+        return nullptr;
+    return reinterpret_cast<const T*>(file.data() + offset);
+}
+
+// write to a temporary file renamed once complete, so concurrent readers never see a partial file
+// throw std::runtime_error on failure
+void writeFileAtomically(const std::filesystem::path&, std::span<const std::byte>);
+
+} // namespace GE
+
+#endif // COOKEDFILE_HPP
@@ -0,0 +1,228 @@
+/*
+ * ---------------------------------------------------
+ * Culling.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/Culling.hpp"
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+#endif
+
+namespace
+{
+
+// for each plane, the corner of the box the furthest along its normal, the box is outside if that corner is
+struct PositiveVertexArrays
+{
+    const float* x;
+    const float* y;
+    const float* z;
+};
+
+inline PositiveVertexArrays positiveVertexArrays(const glm::vec4& plane, const float* const minArrays[3], const float* const maxArrays[3])
+{
+    return {
+        plane.x >= 0.0f ? maxArrays[0] : minArrays[0],
+        plane.y >= 0.0f ? maxArrays[1] : minArrays[1],
+        plane.z >= 0.0f ? maxArrays[2] : minArrays[2]
+    };
+}
+
+// one bit per box of the 8 starting at the pointers, set if the box is outside one of the planes
+uint32_t outsideMask(const GE::Frustum& frustum, const float* const minArrays[3], const float* const maxArrays[3])
+{
+#if defined(__AVX__)
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 outside = zero;
+    for (const glm::vec4& plane : frustum.planes)
+    {
+        const PositiveVertexArrays p = positiveVertexArrays(plane, minArrays, maxArrays);
+        const __m256 xy = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), _mm256_loadu_ps(p.x)), _mm256_mul_ps(_mm256_set1_ps(plane.y), _mm256_loadu_ps(p.y)));
+        const __m256 zw = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z), _mm256_loadu_ps(p.z)), _mm256_set1_ps(plane.w));
+        outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(xy, zw), zero, _CMP_LT_OQ));
+    }
+    return static_cast<uint32_t>(_mm256_movemask_ps(outside));
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128 zero = _mm_setzero_ps();
+    __m128 outside[2] = { zero, zero };
+    for (const glm::vec4& plane : frustum.planes)
+    {
+        const PositiveVertexArrays p = positiveVertexArrays(plane, minArrays, maxArrays);
+        const __m128 nx = _mm_set1_ps(plane.x), ny = _mm_set1_ps(plane.y), nz = _mm_set1_ps(plane.z), nw = _mm_set1_ps(plane.w);
+        for (int half = 0; half < 2; half++)
+        {
+            const __m128 xy = _mm_add_ps(_mm_mul_ps(nx, _mm_loadu_ps(p.x + half * 4)), _mm_mul_ps(ny, _mm_loadu_ps(p.y + half * 4)));
+            const __m128 zw = _mm_add_ps(_mm_mul_ps(nz, _mm_loadu_ps(p.z + half * 4)), nw);
+            outside[half] = _mm_or_ps(outside[half], _mm_cmplt_ps(_mm_add_ps(xy, zw), zero));
+        }
+    }
+    return static_cast<uint32_t>(_mm_movemask_ps(outside[0])) | (static_cast<uint32_t>(_mm_movemask_ps(outside[1])) << 4);
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    uint32x4_t outside[2] = { vdupq_n_u32(0), vdupq_n_u32(0) };
+    for (const glm::vec4& plane : frustum.planes)
+    {
+        const PositiveVertexArrays p = positiveVertexArrays(plane, minArrays, maxArrays);
+        const float32x4_t nx = vdupq_n_f32(plane.x), ny = vdupq_n_f32(plane.y), nz = vdupq_n_f32(plane.z), nw = vdupq_n_f32(plane.w);
+        for (int half = 0; half < 2; half++)
+        {
+            const float32x4_t xy = vaddq_f32(vmulq_f32(nx, vld1q_f32(p.x + half * 4)), vmulq_f32(ny, vld1q_f32(p.y + half * 4)));
+            const float32x4_t zw = vaddq_f32(vmulq_f32(nz, vld1q_f32(p.z + half * 4)), nw);
+            outside[half] = vorrq_u32(outside[half], vcltq_f32(vaddq_f32(xy, zw), zero));
+        }
+    }
+    const uint32_t laneBitsValues[4] = { 1, 2, 4, 8 };
+    const uint32x4_t laneBits = vld1q_u32(laneBitsValues);
+    return vaddvq_u32(vandq_u32(outside[0], laneBits)) | (vaddvq_u32(vandq_u32(outside[1], laneBits)) << 4);
+#else
+    uint32_t mask = 0;
+    for (const glm::vec4& plane : frustum.planes)
+    {
+        const PositiveVertexArrays p = positiveVertexArrays(plane, minArrays, maxArrays);
+        for (uint32_t i = 0; i < GE::FrustumCuller::LANE_COUNT; i++)
+        {
+            if ((plane.x * p.x[i] + plane.y * p.y[i]) + (plane.z * p.z[i] + plane.w) < 0.0f)
+                mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+} // namespace
+
+namespace GE
+{
+
+BoundingBox boundingBox(std::span<const Vertex> vertices)
+{
+    BoundingBox box;
+    for (const Vertex& vertex : vertices)
+        box.expand(vertex.pos);
+    return box;
+}
+
+BoundingBox transformBoundingBox(const BoundingBox& box, const glm::mat4x4& transform)
+{
+    if (box.isEmpty())
+        return box;
+    // the extent along each axis is the sum of the projections of the box axes, scaled by the extents
+    const glm::vec3 center = glm::vec3(transform * glm::vec4(box.center(), 1.0f));
+    const glm::mat3 absoluteRotationScale(glm::abs(glm::vec3(transform[0])), glm::abs(glm::vec3(transform[1])), glm::abs(glm::vec3(transform[2])));
+    const glm::vec3 extent = absoluteRotationScale * box.extent();
+    return BoundingBox{ .min = center - extent, .max = center + extent };
+}
+
+std::optional<float> rayBoxDistance(const Ray& ray, const BoundingBox& box, float maxDistance)
+{
+    // slabs method, a zero direction component gives infinite distances of the right sign
+    float entry = 0.0f;
+    float exit = maxDistance;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const float inverseDirection = 1.0f / ray.direction[axis];
+        float slabEntry = (box.min[axis] - ray.origin[axis]) * inverseDirection;
+        float slabExit = (box.max[axis] - ray.origin[axis]) * inverseDirection;
+        if (slabEntry > slabExit)
+            std::swap(slabEntry, slabExit);
+        // the origin on a slab boundary with a zero direction gives a nan, the comparisons then keep the slab unrestricting
+        entry = slabEntry > entry ? slabEntry : entry;
+        exit = slabExit < exit ? slabExit : exit;
+        if (entry > exit)
+            return std::nullopt;
+    }
+    return entry;
+}
+
+Frustum frustum(const glm::mat4x4& viewProjectionMatrix)
+{
+    // Gribb and Hartmann, the planes are combinations of the rows of the matrix
+    const auto row = [&](int i) { return glm::vec4(viewProjectionMatrix[0][i], viewProjectionMatrix[1][i], viewProjectionMatrix[2][i], viewProjectionMatrix[3][i]); };
+    // the near plane is the one of a [-1, 1] depth range, a [0, 1] projection only gets a looser near plane
+    Frustum frustum = {
+        .planes = {
+            row(3) + row(0), row(3) - row(0),
+            row(3) + row(1), row(3) - row(1),
+            row(3) + row(2), row(3) - row(2)
+        }
+    };
+    for (glm::vec4& plane : frustum.planes)
+    {
+        const float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f)
+            plane /= length;
+    }
+    return frustum;
+}
+
+bool isBoxInFrustum(const Frustum& frustum, const BoundingBox& box)
+{
+    for (const glm::vec4& plane : frustum.planes)
+    {
+        const glm::vec3 positiveVertex = glm::vec3(plane.x >= 0.0f ? box.max.x : box.min.x,
+                                                   plane.y >= 0.0f ? box.max.y : box.min.y,
+                                                   plane.z >= 0.0f ? box.max.z : box.min.z);
+        if ((plane.x * positiveVertex.x + plane.y * positiveVertex.y) + (plane.z * positiveVertex.z + plane.w) < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+void FrustumCuller::clear()
+{
+    for (std::vector<float>* array : { &m_minX, &m_minY, &m_minZ, &m_maxX, &m_maxY, &m_maxZ })
+        array->clear();
+    m_count = 0;
+}
+
+uint32_t FrustumCuller::add(const BoundingBox& box)
+{
+    if (m_count % LANE_COUNT == 0)
+    {
+        for (std::vector<float>* array : { &m_minX, &m_minY, &m_minZ, &m_maxX, &m_maxY, &m_maxZ })
+            array->resize(m_count + LANE_COUNT, 0.0f);
+    }
+    m_minX[m_count] = box.min.x;
+    m_minY[m_count] = box.min.y;
+    m_minZ[m_count] = box.min.z;
+    m_maxX[m_count] = box.max.x;
+    m_maxY[m_count] = box.max.y;
+    m_maxZ[m_count] = box.max.z;
+    return m_count++;
+}
+
+const std::vector<uint32_t>& FrustumCuller::cull(const Frustum& frustum)
+{
+    m_visibleIndices.clear();
+    for (uint32_t first = 0; first < m_count; first += LANE_COUNT)
+    {
+        const float* const minArrays[3] = { m_minX.data() + first, m_minY.data() + first, m_minZ.data() + first };
+        const float* const maxArrays[3] = { m_maxX.data() + first, m_maxY.data() + first, m_maxZ.data() + first };
+        uint32_t visibleMask = ~outsideMask(frustum, minArrays, maxArrays) & ((1u << LANE_COUNT) - 1);
+        if (m_count - first < LANE_COUNT)
+            visibleMask &= (1u << (m_count - first)) - 1; // padding
+        for (; visibleMask != 0; visibleMask &= visibleMask - 1)
+            m_visibleIndices.push_back(first + static_cast<uint32_t>(std::countr_zero(visibleMask)));
+    }
+    m_statistics = CullingStatistics{
+        .testedCount = m_count,
+        .visibleCount = static_cast<uint32_t>(m_visibleIndices.size()),
+        .culledCount = m_count - static_cast<uint32_t>(m_visibleIndices.size())
+    };
+    return m_visibleIndices;
+}
+
+} // namespace GE
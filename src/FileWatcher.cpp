@@ -0,0 +1,161 @@
+/*
+ * ---------------------------------------------------
+ * FileWatcher.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/FileWatcher.hpp"
+
+#if defined(__linux__)
+    #include <sys/inotify.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace GE
+{
+
+#if defined(__linux__)
+
+namespace
+{
+
+constexpr uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+
+} // namespace
+
+FileWatcher::FileWatcher(const std::filesystem::path& directory)
+    : m_directory(std::filesystem::canonical(directory))
+{
+    m_fileDescriptor = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fileDescriptor < 0)
+        throw std::runtime_error("failed to initialize inotify: " + std::string(std::strerror(errno)));
+    try {
+        addWatch(m_directory, nullptr);
+    }
+    catch (...) {
+        ::close(m_fileDescriptor);
+        throw;
+    }
+}
+
+std::vector<std::filesystem::path> FileWatcher::poll()
+{
+    std::set<std::filesystem::path> changedFiles;
+    std::vector<std::filesystem::path> newFiles;
+
+    alignas(inotify_event) std::byte buffer[4096];
+    while (true)
+    {
+        const ssize_t size = ::read(m_fileDescriptor, buffer, sizeof(buffer));
+        if (size <= 0)
+            break; // EAGAIN, no more events
+        for (ssize_t offset = 0; offset < size;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            if (event->mask & IN_IGNORED)
+            {
+                m_watchedDirectories.erase(event->wd);
+                continue;
+            }
+            auto it = m_watchedDirectories.find(event->wd);
+            if (it == m_watchedDirectories.end() || event->len == 0)
+                continue;
+            const std::filesystem::path path = it->second / event->name;
+
+            if (event->mask & IN_ISDIR)
+            {
+                // the files written before the watch of the new directory is added are reported too
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                    addWatch(path, &newFiles);
+            }
+            else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+            {
+                changedFiles.insert(path);
+            }
+        }
+    }
+    changedFiles.insert(newFiles.begin(), newFiles.end());
+    return std::vector<std::filesystem::path>(changedFiles.begin(), changedFiles.end());
+}
+
+void FileWatcher::addWatch(const std::filesystem::path& directory, std::vector<std::filesystem::path>* existingFiles)
+{
+    const int watchDescriptor = ::inotify_add_watch(m_fileDescriptor, directory.c_str(), WATCH_MASK);
+    if (watchDescriptor < 0)
+    {
+        // a sub directory removed since it was reported is not an error
+        if (existingFiles != nullptr)
+            return;
+        throw std::runtime_error("failed to watch directory: " + directory.string() + ": " + std::strerror(errno));
+    }
+    m_watchedDirectories[watchDescriptor] = directory;
+
+    std::error_code error;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        if (entry.is_directory(error))
+            addWatch(entry.path(), existingFiles);
+        else if (existingFiles != nullptr)
+            existingFiles->push_back(entry.path());
+    }
+}
+
+FileWatcher::~FileWatcher()
+{
+    if (m_fileDescriptor >= 0)
+        ::close(m_fileDescriptor);
+}
+
+#else
+
+FileWatcher::FileWatcher(const std::filesystem::path& directory)
+    : m_directory(std::filesystem::canonical(directory))
+{
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(m_directory))
+    {
+        if (entry.is_regular_file())
+            m_writeTimes[entry.path()] = entry.last_write_time();
+    }
+}
+
+std::vector<std::filesystem::path> FileWatcher::poll()
+{
+    std::vector<std::filesystem::path> changedFiles;
+    std::map<std::filesystem::path, std::filesystem::file_time_type> writeTimes;
+
+    std::error_code error;
+    for (auto it = std::filesystem::recursive_directory_iterator(m_directory, error); it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+    {
+        if (error)
+            break;
+        if (it->is_regular_file(error) == false)
+            continue;
+        const std::filesystem::file_time_type writeTime = it->last_write_time(error);
+        auto previous = m_writeTimes.find(it->path());
+        if (previous == m_writeTimes.end() || previous->second != writeTime)
+            changedFiles.push_back(it->path());
+        writeTimes.emplace(it->path(), writeTime);
+    }
+    m_writeTimes = std::move(writeTimes);
+    std::ranges::sort(changedFiles);
+    return changedFiles;
+}
+
+FileWatcher::~FileWatcher() = default;
+
+#endif
+
+} // namespace GE
@@ -12,7 +12,16 @@
 #include <Graphics/Texture.hpp>
 #include <Graphics/Buffer.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace GE
 {
@@ -123,6 +132,282 @@ FrameGraph::FrameGraph(const Descriptor& desc)
                 throw std::runtime_error("Buffer \"" + bufferName + "\" is used but not declared");
         }
     }
+
+    compile();
+
+    for (const FramePass& pass : m_passes)
+    {
+        if (pass.resolveHandles)
+            pass.resolveHandles(*this);
+    }
+}
+
+void FrameGraph::compile()
+{
+    const auto passCount = static_cast<uint32_t>(m_passes.size());
+
+    // the passes writing each resource in declaration order, the buffers are written by the setup of the passes declaring them
+    std::map<std::string, std::vector<uint32_t>> writers;
+    for (uint32_t i = 0; i < passCount; i++)
+    {
+        const FramePass& pass = m_passes[i];
+        for (const AttachmentDescriptor& colorAttachment : pass.colorAttachments)
+            writers[colorAttachment.texture].push_back(i);
+        if (pass.depthAttachment)
+            writers[pass.depthAttachment->texture].push_back(i);
+        for (const ConstantBufferDescriptor& cbDesc : pass.constantBufferDeclarations)
+            writers[cbDesc.name].push_back(i);
+        for (const StructuredBufferDescriptor& sbDesc : pass.structuredBufferDeclarations)
+            writers[sbDesc.name].push_back(i);
+    }
+
+    // a writer runs after the previous writers of the resource, a reader after all of them
+    std::vector<std::set<uint32_t>> dependencies(passCount);
+    for (auto& [resource, resourceWriters] : writers)
+    {
+        for (size_t i = 1; i < resourceWriters.size(); i++)
+        {
+            if (resourceWriters[i] != resourceWriters[i - 1])
+                dependencies[resourceWriters[i]].insert(resourceWriters[i - 1]);
+        }
+    }
+    for (uint32_t i = 0; i < passCount; i++)
+    {
+        const auto addReadDependencies = [&](const std::string& resource) {
+            auto it = writers.find(resource);
+            if (it == writers.end())
+                return;
+            for (uint32_t writer : it->second)
+            {
+                if (writer != i)
+                    dependencies[i].insert(writer);
+            }
+        };
+        for (const std::string& sampledTexture : m_passes[i].sampledTextures)
+            addReadDependencies(sampledTexture);
+        for (const std::string& bufferName : m_passes[i].usedBuffers)
+            addReadDependencies(bufferName);
+    }
+
+    // the passes writing the back buffer are kept, then the ones they depend on
+    std::vector<bool> isKept(passCount, false);
+    std::vector<uint32_t> keptPasses;
+    if (auto it = writers.find(m_backBufferName); it != writers.end())
+    {
+        for (uint32_t writer : it->second)
+        {
+            if (isKept[writer] == false)
+            {
+                isKept[writer] = true;
+                keptPasses.push_back(writer);
+            }
+        }
+    }
+    for (size_t i = 0; i < keptPasses.size(); i++)
+    {
+        for (uint32_t dependency : dependencies[keptPasses[i]])
+        {
+            if (isKept[dependency] == false)
+            {
+                isKept[dependency] = true;
+                keptPasses.push_back(dependency);
+            }
+        }
+    }
+
+    // topological order, the first declared of the ready passes runs first so independent passes keep their order
+    std::vector<uint32_t> remainingDependencyCounts(passCount, 0);
+    std::vector<std::vector<uint32_t>> dependents(passCount);
+    for (uint32_t pass : keptPasses)
+    {
+        remainingDependencyCounts[pass] = static_cast<uint32_t>(dependencies[pass].size());
+        for (uint32_t dependency : dependencies[pass])
+            dependents[dependency].push_back(pass);
+    }
+    std::set<uint32_t> readyPasses;
+    for (uint32_t pass : keptPasses)
+    {
+        if (remainingDependencyCounts[pass] == 0)
+            readyPasses.insert(pass);
+    }
+    m_compiledPasses.clear();
+    while (readyPasses.empty() == false)
+    {
+        const uint32_t pass = readyPasses.extract(readyPasses.begin()).value();
+        m_compiledPasses.push_back(CompiledPass{ .passIndex = pass, .transitions = {} });
+        for (uint32_t dependent : dependents[pass])
+        {
+            if (--remainingDependencyCounts[dependent] == 0)
+                readyPasses.insert(dependent);
+        }
+    }
+    if (m_compiledPasses.size() != keptPasses.size())
+        throw std::runtime_error("Frame graph passes depend on each other through their resources");
+
+    // lifetimes and texture states along the compiled passes
+    std::map<std::string, ResourceState> textureStates;
+    m_lifetimes.clear();
+    m_finalTransitions.clear();
+    for (uint32_t position = 0; position < m_compiledPasses.size(); position++)
+    {
+        CompiledPass& compiledPass = m_compiledPasses[position];
+        const FramePass& pass = m_passes[compiledPass.passIndex];
+
+        const auto useResource = [&](const std::string& name) {
+            auto [it, inserted] = m_lifetimes.try_emplace(name, ResourceLifetime{ .firstPass = position, .lastPass = position });
+            it->second.lastPass = position;
+        };
+        const auto useTexture = [&](const std::string& name, ResourceState state) {
+            useResource(name);
+            if (name == m_backBufferName && textureStates.contains(name) == false)
+                compiledPass.acquiresDrawable = true;
+            ResourceState& currentState = textureStates.try_emplace(name, ResourceState::undefined).first->second;
+            if (currentState != state)
+                compiledPass.transitions.push_back({ .resource = name, .before = currentState, .after = state });
+            currentState = state;
+        };
+
+        for (const std::string& sampledTexture : pass.sampledTextures)
+            useTexture(sampledTexture, ResourceState::shaderRead);
+        for (const AttachmentDescriptor& colorAttachment : pass.colorAttachments)
+            useTexture(colorAttachment.texture, ResourceState::colorAttachment);
+        if (pass.depthAttachment)
+            useTexture(pass.depthAttachment->texture, ResourceState::depthStencilAttachment);
+        for (const ConstantBufferDescriptor& cbDesc : pass.constantBufferDeclarations)
+            useResource(cbDesc.name);
+        for (const StructuredBufferDescriptor& sbDesc : pass.structuredBufferDeclarations)
+            useResource(sbDesc.name);
+        for (const std::string& bufferName : pass.usedBuffers)
+            useResource(bufferName);
+    }
+    if (auto it = textureStates.find(m_backBufferName); it != textureStates.end())
+        m_finalTransitions.push_back({ .resource = m_backBufferName, .before = it->second, .after = ResourceState::present });
+
+    allocateAliasSlots();
+    indexResources();
+
+    for (CompiledPass& compiledPass : m_compiledPasses)
+    {
+        const FramePass& pass = m_passes[compiledPass.passIndex];
+        for (const AttachmentDescriptor& colorAttachment : pass.colorAttachments)
+            compiledPass.colorAttachments.push_back(textureHandle(colorAttachment.texture));
+        if (pass.depthAttachment)
+            compiledPass.depthAttachment = textureHandle(pass.depthAttachment->texture);
+        for (const std::string& sampledTexture : pass.sampledTextures)
+            compiledPass.sampledTextures.push_back(textureHandle(sampledTexture));
+    }
+}
+
+uint32_t FrameGraph::resourceIndex(std::string_view name) const
+{
+    auto it = m_resourceIndices.find(name);
+    if (it == m_resourceIndices.end())
+        throw std::out_of_range("No frame graph resource named \"" + std::string(name) + "\"");
+    return it->second;
+}
+
+TextureHandle FrameGraph::textureHandle(std::string_view name) const
+{
+    const uint32_t index = resourceIndex(name);
+    if (m_resources[index].kind != ResourceKind::texture)
+        throw std::out_of_range("Frame graph resource \"" + std::string(name) + "\" is not a texture");
+    return TextureHandle{ .index = index };
+}
+
+BufferHandle FrameGraph::bufferHandle(std::string_view name) const
+{
+    const uint32_t index = resourceIndex(name);
+    if (m_resources[index].kind == ResourceKind::texture)
+        throw std::out_of_range("Frame graph resource \"" + std::string(name) + "\" is not a buffer");
+    return BufferHandle{ .index = index };
+}
+
+void FrameGraph::allocateAliasSlots()
+{
+    struct TransientTexture
+    {
+        const std::string* name;
+        const gfx::Texture::Descriptor* descriptor;
+        ResourceLifetime lifetime;
+        uint64_t bytes;
+    };
+    std::vector<TransientTexture> textures;
+    for (auto& [name, descriptor] : m_textureDescriptors)
+    {
+        auto it = m_lifetimes.find(name);
+        if (name == m_backBufferName || it == m_lifetimes.end())
+            continue;
+        textures.push_back({
+            .name = &name,
+            .descriptor = &descriptor,
+            .lifetime = it->second,
+            .bytes = static_cast<uint64_t>(descriptor.width) * descriptor.height * pixelFormatSize(descriptor.pixelFormat)
+        });
+    }
+    std::ranges::stable_sort(textures, {}, [](const TransientTexture& texture) { return texture.lifetime.firstPass; });
+
+    // interval allocation, a texture takes the compatible slot released the latest before its first pass,
+    // the usages of the textures sharing a slot are merged
+    const auto isCompatible = [](const gfx::Texture::Descriptor& a, const gfx::Texture::Descriptor& b) {
+        return a.type == b.type && a.width == b.width && a.height == b.height && a.pixelFormat == b.pixelFormat && a.storageMode == b.storageMode;
+    };
+    std::vector<uint32_t> slotLastPasses;
+    m_aliasSlots.clear();
+    m_aliasSlotDescriptors.clear();
+    m_transientMemory = TransientMemoryStatistics{ .textureCount = static_cast<uint32_t>(textures.size()) };
+    for (const TransientTexture& texture : textures)
+    {
+        std::optional<uint32_t> bestSlot;
+        for (uint32_t slot = 0; slot < m_aliasSlotDescriptors.size(); slot++)
+        {
+            if (isCompatible(m_aliasSlotDescriptors[slot], *texture.descriptor) && slotLastPasses[slot] < texture.lifetime.firstPass
+                && (bestSlot.has_value() == false || slotLastPasses[slot] > slotLastPasses[*bestSlot]))
+                bestSlot = slot;
+        }
+        if (bestSlot.has_value() == false)
+        {
+            bestSlot = static_cast<uint32_t>(m_aliasSlotDescriptors.size());
+            m_aliasSlotDescriptors.push_back(*texture.descriptor);
+            slotLastPasses.push_back(0);
+            m_transientMemory.aliasedBytes += texture.bytes;
+        }
+        m_aliasSlotDescriptors[*bestSlot].usages |= texture.descriptor->usages;
+        slotLastPasses[*bestSlot] = texture.lifetime.lastPass;
+        m_aliasSlots.emplace(*texture.name, *bestSlot);
+        m_transientMemory.naiveBytes += texture.bytes;
+    }
+    m_transientMemory.slotCount = static_cast<uint32_t>(m_aliasSlotDescriptors.size());
+
+    for (uint32_t position = 0; position < m_compiledPasses.size(); position++)
+    {
+        uint64_t liveBytes = 0;
+        for (const TransientTexture& texture : textures)
+        {
+            if (texture.lifetime.firstPass <= position && position <= texture.lifetime.lastPass)
+                liveBytes += texture.bytes;
+        }
+        m_transientMemory.peakBytes = std::max(m_transientMemory.peakBytes, liveBytes);
+    }
+}
+
+void FrameGraph::indexResources()
+{
+    m_resources.clear();
+    m_resourceIndices.clear();
+    const auto addResource = [&](const std::string& name, ResourceKind kind) {
+        m_resourceIndices.emplace(name, static_cast<uint32_t>(m_resources.size()));
+        m_resources.push_back(CompiledResource{ .name = name, .kind = kind, .isUsed = m_lifetimes.contains(name) });
+    };
+    for (auto& [name, descriptor] : m_textureDescriptors)
+    {
+        addResource(name, ResourceKind::texture);
+        if (auto it = m_aliasSlots.find(name); it != m_aliasSlots.end())
+            m_resources.back().aliasSlot = it->second;
+    }
+    for (auto& [name, descriptor] : m_constantBufferDescriptors)
+        addResource(name, ResourceKind::constantBuffer);
+    for (const std::string& name : m_structuredBufferNames)
+        addResource(name, ResourceKind::structuredBuffer);
 }
 
 }
@@ -7,11 +7,19 @@
  */
 
 #include "Game-Engine/FramePassBuilder.hpp"
+#include "Game-Engine/AssetManagerView.hpp"
 #include "Game-Engine/Components.hpp"
+#include "Game-Engine/Culling.hpp"
+#include "Game-Engine/DrawPacket.hpp"
 #include "Game-Engine/ECSView.hpp"
 #include "Game-Engine/Entity.hpp"
+#include "Game-Engine/FrameResources.hpp"
 #include "Game-Engine/ICamera.hpp"
+#include "Game-Engine/LightClusters.hpp"
+#include "Game-Engine/LinearAllocator.hpp"
 #include "Game-Engine/Mesh.hpp"
+#include "Game-Engine/MeshLod.hpp"
+#include "Game-Engine/RenderQueue.hpp"
 
 #include "shaders/FrameData.slang"
 #include "shaders/Light.slang"
@@ -19,13 +27,108 @@
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <limits>
 #include <memory>
+#include <ranges>
+#include <span>
+#include <utility>
 #include <vector>
 
+namespace
+{
+
+struct DrawnMesh
+{
+    GE::AssetID assetId;
+    std::shared_ptr<GE::Mesh> mesh; // kept alive until the draws are recorded
+    uint32_t requestedLod = UINT32_MAX;
+    float requestPriority = 0.0f;
+};
+
+constexpr uint32_t MIN_DRAWS_PER_JOB = 256; // fewer are recorded faster than a job is started
+
+// of the far depth, for the projections whose near plane is not found from the matrix
+constexpr float MIN_CLUSTER_NEAR_DEPTH = 1e-4f;
+
+using GeometryDrawPacket = GE::DrawPacket<shader::flat_color::DrawData>;
+
+static_assert(sizeof(shader::LightCluster) == sizeof(GE::LightClusterGrid::Cluster));
+
+struct SubmeshDraw
+{
+    const GE::SubMesh* submesh;
+    glm::mat4 modelMatrix;
+    uint32_t mesh; // in the drawn meshes
+    uint32_t lod = 0;
+};
+
+// the same level of a submesh is the same geometry
+struct GeometryKey
+{
+    const GE::SubMesh* submesh;
+    uint32_t lod;
+    uint32_t draw;
+
+    inline std::pair<const GE::SubMesh*, uint32_t> geometry() const { return { submesh, lod }; }
+};
+
+// resolved by the frame graph once it is built
+struct GeometryPassHandles
+{
+    GE::TextureHandle colorAttachment;
+    GE::BufferHandle frameData;
+    GE::BufferHandle material;
+    GE::BufferHandle directionalLights;
+    GE::BufferHandle pointLights;
+    GE::BufferHandle instances;
+    GE::BufferHandle lightClusters;
+    GE::BufferHandle lightIndices;
+};
+
+// reused from frame to frame, the containers keep their memory
+struct GeometryPassState
+{
+    GeometryPassHandles handles;
+    GE::LightClusterGrid lightClusters;
+    std::vector<DrawnMesh> meshes;
+    std::vector<SubmeshDraw> draws;
+    GE::FrustumCuller culler;
+    std::vector<uint32_t> culledDraws;   // the draw of each box of the culler
+    std::vector<uint32_t> unculledDraws; // culling disabled, or no bounds
+    std::vector<GeometryKey> visibleGeometries; // sorted to number the geometries without a map
+    GE::RenderQueue renderQueue;
+    std::vector<shader::InstanceData> instances; // in the render queue order
+    uint32_t firstInstance = 0; // in the instance buffer
+    std::vector<std::vector<GeometryDrawPacket>> packetLists; // by recording job
+
+    void clear()
+    {
+        meshes.clear();
+        draws.clear();
+        culler.clear();
+        culledDraws.clear();
+        unculledDraws.clear();
+        visibleGeometries.clear();
+        renderQueue.clear();
+        instances.clear();
+    }
+};
+
+// the levels of a streamed mesh that are not resident yet have no index buffer, the coarsest one always has
+const std::shared_ptr<gfx::Buffer>& lodIndexBuffer(const GE::SubMesh& submesh, uint32_t lod)
+{
+    return lod == 0 ? submesh.indexBuffer : submesh.lods[lod - 1].indexBuffer;
+}
+
+} // namespace
+
 namespace GE
 {
 
@@ -56,22 +159,41 @@ FramePass FlatGeometryPassBuilder::build() const
     framePass.structuredBufferDeclarations = {
         { .name = "directionalLights" },
         { .name = "pointLights" },
+        { .name = "instances" },
+        { .name = "lightClusters" },
+        { .name = "lightIndices" },
     };
     framePass.usedBuffers.insert(framePass.usedBuffers.end(), {
-        "frameData", "material", "directionalLights", "pointLights"
+        "frameData", "material", "directionalLights", "pointLights", "instances", "lightClusters", "lightIndices"
     });
 
-    framePass.setup = [sceneProvider=m_sceneProvider, cameraProvider=m_cameraProvider, colorAttachmentName](FramePassSetupContext& ctx)
+    // the setup gathers the draws in the render queue and writes their instances, the execute records them
+    auto state = std::make_shared<GeometryPassState>();
+
+    framePass.resolveHandles = [colorAttachmentName, state](const FrameGraph& frameGraph) {
+        assert(colorAttachmentName.empty() == false);
+        state->handles.colorAttachment = frameGraph.textureHandle(colorAttachmentName);
+        state->handles.frameData = frameGraph.bufferHandle("frameData");
+        state->handles.material = frameGraph.bufferHandle("material");
+        state->handles.directionalLights = frameGraph.bufferHandle("directionalLights");
+        state->handles.pointLights = frameGraph.bufferHandle("pointLights");
+        state->handles.instances = frameGraph.bufferHandle("instances");
+        state->handles.lightClusters = frameGraph.bufferHandle("lightClusters");
+        state->handles.lightIndices = frameGraph.bufferHandle("lightIndices");
+    };
+
+    framePass.setup = [sceneProvider=m_sceneProvider, cameraProvider=m_cameraProvider, frustumCulling=m_frustumCulling,
+                       cullingStatistics=m_cullingStatistics, state](FramePassSetupContext& ctx)
     {
         const Scene* scene = sceneProvider();
         assert(scene);
-        assert(colorAttachmentName.empty() == false);
+        assert(state->handles.colorAttachment.isValid());
 
-        const std::shared_ptr<gfx::Texture>& colorAttachment = ctx.textureMap.at(colorAttachmentName);
+        const std::shared_ptr<gfx::Texture>& colorAttachment = ctx.resources.texture(state->handles.colorAttachment);
         assert(colorAttachment->height() != 0);
         const float aspectRatio = static_cast<float>(colorAttachment->width()) / static_cast<float>(colorAttachment->height());
 
-        shader::FrameData& frameData = *ctx.constantBuffers.at("frameData")->content<shader::FrameData>();
+        shader::FrameData& frameData = *ctx.resources.buffer(state->handles.frameData)->content<shader::FrameData>();
         if (const ICamera* camera = cameraProvider())
         {
             frameData.vpMatrix = camera->viewProjectionMatrix(aspectRatio);
@@ -95,95 +217,255 @@ FramePass FlatGeometryPassBuilder::build() const
         }
         frameData.ambientLightColor = glm::vec3(1.0f, 1.0f, 1.0f) * 0.1f;
 
-        std::vector<shader::DirectionalLight> directionalLights;
-        std::vector<shader::PointLight> pointLights;
-        for (GE::const_Entity entity : scene->ecsWorld()
-                                       | const_ECSView<TransformComponent, LightComponent>()
-                                       | std::views::transform([&](auto id){ return GE::const_Entity{&scene->ecsWorld(), id}; }))
-        {
+        // counted first so the lights can be written in the frame allocator
+        const auto lightEntities = [&]() {
+            return scene->ecsWorld()
+                   | const_ECSView<TransformComponent, LightComponent>()
+                   | std::views::transform([&](auto id){ return GE::const_Entity{&scene->ecsWorld(), id}; });
+        };
+        const auto pointLightSphere = [](GE::const_Entity entity) {
             const LightComponent& light = entity.get<LightComponent>();
-            switch (light.type)
+            return BoundingSphere{ .center = entity.worldTransform()[3], .radius = pointLightRadius(light.color * light.intentsity, light.attenuation) };
+        };
+        size_t directionalCount = 0;
+        size_t pointCount = 0;
+        size_t unboundedPointCount = 0; // without attenuation, not clustered
+        for (GE::const_Entity entity : lightEntities())
+        {
+            switch (entity.get<LightComponent>().type)
             {
             case LightComponent::Type::directional:
-                directionalLights.push_back({
-                    .position = entity.worldTransform()[3],
-                    .color = light.color * light.intentsity,
-                });
+                directionalCount++;
                 break;
             case LightComponent::Type::point:
-                pointLights.push_back({
-                    .position = entity.worldTransform()[3],
-                    .color = light.color * light.intentsity,
-                    .attenuation = light.attenuation
-                });
+                pointCount++;
+                if (std::isinf(pointLightSphere(entity).radius))
+                    unboundedPointCount++;
                 break;
             }
         }
 
-        const size_t directionalCount = directionalLights.size();
-        const size_t pointCount = pointLights.size();
-
         assert(directionalCount <= static_cast<size_t>(std::numeric_limits<int>::max()));
         assert(pointCount <= static_cast<size_t>(std::numeric_limits<int>::max()));
         frameData.directionalLightCount = static_cast<int>(directionalCount);
         frameData.pointLightCount = static_cast<int>(pointCount);
+        frameData.unboundedPointLightCount = static_cast<int>(unboundedPointCount);
+
+        // the buffers are never empty
+        const std::span<shader::DirectionalLight> directionalLights = ctx.frameAllocator.allocate<shader::DirectionalLight>(std::max<size_t>(directionalCount, 1));
+        const std::span<shader::PointLight> pointLights = ctx.frameAllocator.allocate<shader::PointLight>(std::max<size_t>(pointCount, 1));
+        const std::span<BoundingSphere> pointLightSpheres = ctx.frameAllocator.allocate<BoundingSphere>(pointCount);
+        size_t directionalIndex = 0;
+        size_t unboundedPointIndex = 0;
+        size_t boundedPointIndex = unboundedPointCount;
+        for (GE::const_Entity entity : lightEntities())
+        {
+            const LightComponent& light = entity.get<LightComponent>();
+            switch (light.type)
+            {
+            case LightComponent::Type::directional:
+                directionalLights[directionalIndex++] = {
+                    .position = entity.worldTransform()[3],
+                    .color = light.color * light.intentsity,
+                };
+                break;
+            case LightComponent::Type::point: {
+                const BoundingSphere sphere = pointLightSphere(entity);
+                const size_t pointIndex = std::isinf(sphere.radius) ? unboundedPointIndex++ : boundedPointIndex++;
+                pointLights[pointIndex] = {
+                    .position = sphere.center,
+                    .color = light.color * light.intentsity,
+                    .attenuation = light.attenuation,
+                    .radius = sphere.radius
+                };
+                pointLightSpheres[pointIndex] = sphere;
+                break;
+            }
+            }
+        }
 
-        const size_t directionalBufferBytes = (directionalCount > 0 ? directionalCount : 1) * sizeof(shader::DirectionalLight);
-        const size_t pointBufferBytes = (pointCount > 0 ? pointCount : 1) * sizeof(shader::PointLight);
-        assert(directionalBufferBytes <= std::numeric_limits<uint32_t>::max());
-        assert(pointBufferBytes <= std::numeric_limits<uint32_t>::max());
+        const uint32_t firstDirectionalLight = ctx.resources.setStructuredBufferContent(state->handles.directionalLights, directionalLights);
+        const uint32_t firstPointLight = ctx.resources.setStructuredBufferContent(state->handles.pointLights, pointLights);
+        assert(firstDirectionalLight <= static_cast<uint32_t>(std::numeric_limits<int>::max()));
+        assert(firstPointLight <= static_cast<uint32_t>(std::numeric_limits<int>::max()));
+        frameData.firstDirectionalLight = static_cast<int>(firstDirectionalLight);
+        frameData.firstPointLight = static_cast<int>(firstPointLight);
 
-        ctx.setStructuredBufferContent("directionalLights", directionalLights.data(), static_cast<uint32_t>(directionalBufferBytes));
-        ctx.setStructuredBufferContent("pointLights", pointLights.data(), static_cast<uint32_t>(pointBufferBytes));
+        // the attenuated point lights are assigned to the clusters of the view frustum,
+        // the depths are the distances of the camera to the near and far planes
+        const Frustum viewFrustum = frustum(frameData.vpMatrix);
+        const glm::vec4& nearPlane = viewFrustum.planes[4];
+        const glm::vec4& farPlane = viewFrustum.planes[5];
+        const float farDepth = glm::dot(glm::vec3(farPlane), frameData.cameraPosition) + farPlane.w;
+        const float nearDepth = std::max(-(glm::dot(glm::vec3(nearPlane), frameData.cameraPosition) + nearPlane.w), farDepth * MIN_CLUSTER_NEAR_DEPTH);
+        state->lightClusters.build(frameData.vpMatrix, nearDepth, farDepth, pointLightSpheres);
 
-        shader::flat_color::Material& material = *ctx.constantBuffers.at("material")->content<shader::flat_color::Material>();
+        const std::span<const LightClusterGrid::Cluster> lightClusters = state->lightClusters.clusters();
+        const std::span<const uint32_t> lightIndices = state->lightClusters.lightIndices();
+        assert(lightIndices.size() < static_cast<size_t>(std::numeric_limits<int>::max()));
+        const uint32_t firstLightCluster = ctx.resources.setStructuredBufferContent(state->handles.lightClusters, lightClusters.data(), sizeof(LightClusterGrid::Cluster),
+                                                                                    static_cast<uint32_t>(lightClusters.size()));
+        // never empty, the binding needs a buffer
+        const uint32_t firstLightIndex = ctx.resources.setStructuredBufferContent(state->handles.lightIndices, lightIndices.empty() ? nullptr : lightIndices.data(),
+                                                                                  sizeof(uint32_t), std::max(static_cast<uint32_t>(lightIndices.size()), 1u));
+        assert(firstLightCluster <= static_cast<uint32_t>(std::numeric_limits<int>::max()));
+        assert(firstLightIndex <= static_cast<uint32_t>(std::numeric_limits<int>::max()));
+        frameData.clusterCountX = static_cast<int>(state->lightClusters.size().x);
+        frameData.clusterCountY = static_cast<int>(state->lightClusters.size().y);
+        frameData.clusterCountZ = static_cast<int>(state->lightClusters.size().z);
+        frameData.clusterDepthScale = state->lightClusters.depthScale();
+        frameData.clusterDepthBias = state->lightClusters.depthBias();
+        frameData.firstLightCluster = static_cast<int>(firstLightCluster);
+        frameData.firstLightIndex = static_cast<int>(firstLightIndex);
+
+        shader::flat_color::Material& material = *ctx.resources.buffer(state->handles.material)->content<shader::flat_color::Material>();
         material.diffuseColor = glm::vec4(1.0f);
         material.specularColor = glm::vec3(0.0f);
         material.shininess = 0.0f;
-    };
 
-    framePass.execute = [sceneProvider=m_sceneProvider](FramePassExecuteContext& ctx)
-    {
-        const Scene* scene = sceneProvider();
-        assert(scene);
-
-        std::shared_ptr<gfx::ParameterBlock> frameDataPBlock = ctx.parameterBlockPool.get(ctx.frameDataBlockLayout);
-        frameDataPBlock->setBinding(0, ctx.bufferMap.at("frameData"));
-        frameDataPBlock->setBinding(1, ctx.bufferMap.at("directionalLights"));
-        frameDataPBlock->setBinding(2, ctx.bufferMap.at("pointLights"));
-
-        std::shared_ptr<gfx::ParameterBlock> materialPBlock = ctx.parameterBlockPool.get(ctx.materialBlockLayout);
-        materialPBlock->setBinding(0, ctx.bufferMap.at("material"));
-
-        ctx.commandBuffer.usePipeline(ctx.gfxPipeline);
-        ctx.commandBuffer.setParameterBlock(frameDataPBlock, 0);
-        ctx.commandBuffer.setParameterBlock(materialPBlock, 1);
+        const glm::vec3 cameraPosition = frameData.cameraPosition;
+        const float cameraProjectionScale = projectionScale(frameData.vpMatrix);
+        const auto viewportHeight = static_cast<float>(colorAttachment->height());
 
+        // gather the submeshes of the loaded meshes with their world space boxes
+        state->clear();
         for (auto entity : scene->ecsWorld() | const_ECSView<TransformComponent, MeshComponent>() | std::views::transform([&](auto id){ return GE::const_Entity{&scene->ecsWorld(), id}; }))
         {
             const MeshComponent& meshComponent = entity.get<MeshComponent>();
             // ? maybe i should not load asset here, just skip them, so user is require to load assets befor using
             // ? loading here could cause unexpected asset load
-            std::shared_future<const std::shared_ptr<Mesh>&> meshFuture = scene->assetManagerView().loadAsset<Mesh>(meshComponent);
-            if (meshFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
-            {
-                std::shared_ptr<Mesh> loadedMesh = meshFuture.get();
+            AssetFuture<Mesh> meshFuture = scene->assetManagerView().loadAsset<Mesh>(meshComponent);
+            if (meshFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                continue;
 
-                std::function<void(const SubMesh&, glm::mat4)> drawSubmesh = [&](const SubMesh& submesh, const glm::mat4& transform) {
-                    glm::mat4 modelMatrix = transform * submesh.transform;
+            const auto meshIndex = static_cast<uint32_t>(state->meshes.size());
+            state->meshes.push_back({ .assetId = meshComponent, .mesh = meshFuture.get() });
 
-                    for (auto& childSubmesh : submesh.subMeshes)
-                        drawSubmesh(childSubmesh, modelMatrix);
+            const auto gatherSubmesh = [&](const auto& gatherSubmesh, const SubMesh& submesh, const glm::mat4& transform) -> void {
+                const glm::mat4 modelMatrix = transform * submesh.transform;
+                for (auto& childSubmesh : submesh.subMeshes)
+                    gatherSubmesh(gatherSubmesh, childSubmesh, modelMatrix);
+                if (submesh.indexCount == 0)
+                    return;
+                const auto drawIndex = static_cast<uint32_t>(state->draws.size());
+                state->draws.push_back({ .submesh = &submesh, .modelMatrix = modelMatrix, .mesh = meshIndex });
+                // the submeshes cooked without bounds are always drawn
+                if (frustumCulling == false || submesh.boundingBox.isEmpty())
+                    state->unculledDraws.push_back(drawIndex);
+                else
+                {
+                    state->culler.add(transformBoundingBox(submesh.boundingBox, modelMatrix));
+                    state->culledDraws.push_back(drawIndex);
+                }
+            };
+            for (auto& submesh : state->meshes.back().mesh->subMeshes)
+                gatherSubmesh(gatherSubmesh, submesh, entity.worldTransform());
+        }
 
-                    ctx.commandBuffer.setPushConstants(&modelMatrix);
-                    ctx.commandBuffer.useVertexBuffer(submesh.vertexBuffer);
-                    ctx.commandBuffer.drawIndexedVertices(submesh.indexBuffer);
-                };
+        const std::vector<uint32_t>& visibleBoxes = state->culler.cull(viewFrustum);
+        *cullingStatistics = state->culler.statistics();
+        cullingStatistics->testedCount += static_cast<uint32_t>(state->unculledDraws.size());
+        cullingStatistics->visibleCount += static_cast<uint32_t>(state->unculledDraws.size());
+
+        // select the level of the visible submeshes
+        const auto selectDrawLod = [&](uint32_t drawIndex) {
+            SubmeshDraw& draw = state->draws[drawIndex];
+            const SubMesh& submesh = *draw.submesh;
+            DrawnMesh& drawnMesh = state->meshes[draw.mesh];
 
-                for (auto& submesh : loadedMesh->subMeshes)
-                    drawSubmesh(submesh, entity.worldTransform());
+            if (submesh.lods.empty() == false)
+            {
+                const float projectedRadius = projectedSphereRadius(submesh.boundingSphere, draw.modelMatrix, cameraPosition, cameraProjectionScale, viewportHeight);
+                draw.lod = selectLod(submesh.lods | std::views::transform(&SubMesh::Lod::error), submesh.boundingSphere.radius, projectedRadius);
+                drawnMesh.requestPriority = std::max(drawnMesh.requestPriority, projectedRadius);
             }
+            drawnMesh.requestedLod = std::min(drawnMesh.requestedLod, draw.lod);
+            while (draw.lod < submesh.lods.size() && lodIndexBuffer(submesh, draw.lod) == nullptr)
+                draw.lod++;
+
+            state->visibleGeometries.push_back({ .submesh = &submesh, .lod = draw.lod, .draw = drawIndex });
+        };
+        for (uint32_t drawIndex : state->unculledDraws)
+            selectDrawLod(drawIndex);
+        for (uint32_t boxIndex : visibleBoxes)
+            selectDrawLod(state->culledDraws[boxIndex]);
+
+        // queue them with the geometries numbered in the order of their keys
+        std::ranges::sort(state->visibleGeometries, {}, &GeometryKey::geometry);
+        uint32_t geometryId = 0;
+        for (size_t i = 0; i < state->visibleGeometries.size(); i++)
+        {
+            const GeometryKey& key = state->visibleGeometries[i];
+            if (i > 0 && key.geometry() != state->visibleGeometries[i - 1].geometry())
+                geometryId++;
+            assert(geometryId < (1u << SORT_KEY_GEOMETRY_BITS));
+            const SubmeshDraw& draw = state->draws[key.draw];
+            const float depth = glm::distance(cameraPosition, glm::vec3(draw.modelMatrix * glm::vec4(key.submesh->boundingSphere.center, 1.0f)));
+            state->renderQueue.push(makeSortKey(static_cast<uint32_t>(key.submesh->vertexFormat), 0, geometryId, depth), key.draw);
         }
+        state->renderQueue.sort();
+
+        for (const RenderQueue::Item& item : state->renderQueue.items())
+            state->instances.push_back({ .modelMatrix = state->draws[item.draw].modelMatrix });
+        // never empty, the binding needs a buffer
+        assert(state->instances.size() < std::numeric_limits<uint32_t>::max());
+        state->firstInstance = ctx.resources.setStructuredBufferContent(state->handles.instances, state->instances.empty() ? nullptr : state->instances.data(),
+                                                                        sizeof(shader::InstanceData), std::max(static_cast<uint32_t>(state->instances.size()), 1u));
+
+        // a streamed mesh is requested at the finest level selected by its visible submeshes
+        for (const DrawnMesh& drawnMesh : state->meshes)
+        {
+            if (drawnMesh.requestedLod != UINT32_MAX)
+                scene->assetManagerView().requestStreaming(drawnMesh.assetId, drawnMesh.requestedLod, drawnMesh.requestPriority);
+        }
+    };
+
+    framePass.execute = [state](FramePassExecuteContext& ctx)
+    {
+        std::shared_ptr<gfx::ParameterBlock> frameDataPBlock = ctx.parameterBlockPool.get(ctx.frameDataBlockLayout);
+        frameDataPBlock->setBinding(0, ctx.resources.buffer(state->handles.frameData));
+        frameDataPBlock->setBinding(1, ctx.resources.buffer(state->handles.directionalLights));
+        frameDataPBlock->setBinding(2, ctx.resources.buffer(state->handles.pointLights));
+        frameDataPBlock->setBinding(3, ctx.resources.buffer(state->handles.instances));
+        frameDataPBlock->setBinding(4, ctx.resources.buffer(state->handles.lightClusters));
+        frameDataPBlock->setBinding(5, ctx.resources.buffer(state->handles.lightIndices));
+
+        std::shared_ptr<gfx::ParameterBlock> materialPBlock = ctx.parameterBlockPool.get(ctx.materialBlockLayout);
+        materialPBlock->setBinding(0, ctx.resources.buffer(state->handles.material));
+
+        const std::array<std::shared_ptr<gfx::ParameterBlock>, 2> parameterBlocks = { frameDataPBlock, materialPBlock };
+
+        // contiguous ranges of the sorted draws, each job binds its first state then only the changes
+        const uint32_t drawCount = state->renderQueue.size();
+        const uint32_t jobCount = ctx.recordParallel ? std::clamp(drawCount / MIN_DRAWS_PER_JOB, 1u, ctx.threadCount) : 1;
+        if (state->packetLists.size() < jobCount)
+            state->packetLists.resize(jobCount);
+
+        const auto recordJob = [&](uint32_t job, FramePassExecuteContext& jobContext) {
+            std::vector<GeometryDrawPacket>& packets = state->packetLists[job];
+            packets.clear();
+            for (uint32_t i = drawCount * job / jobCount; i < drawCount * (job + 1) / jobCount; i++)
+            {
+                const SubmeshDraw& draw = state->draws[state->renderQueue.items()[i].draw];
+                const SubMesh& submesh = *draw.submesh;
+                packets.push_back({
+                    .pipeline = &ctx.gfxPipelines.at(submesh.vertexFormat),
+                    .vertexBuffer = &submesh.vertexBuffer,
+                    .indexBuffer = &lodIndexBuffer(submesh, draw.lod),
+                    .pushConstants = {
+                        .positionScale = glm::vec4(submesh.positionQuantization.scale, 0.0f),
+                        .positionOffset = glm::vec4(submesh.positionQuantization.offset, 0.0f),
+                        .instance = state->firstInstance + i
+                    }
+                });
+            }
+            recordDrawPackets<shader::flat_color::DrawData>(jobContext.commandBuffer, packets, parameterBlocks);
+        };
+
+        if (jobCount == 1)
+            recordJob(0, ctx);
+        else
+            ctx.recordParallel(jobCount, recordJob);
     };
 
     return framePass;
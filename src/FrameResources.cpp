@@ -0,0 +1,139 @@
+/*
+ * ---------------------------------------------------
+ * FrameResources.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/FrameResources.hpp"
+#include "Game-Engine/FrameGraph.hpp"
+
+#include <Graphics/Buffer.hpp>
+#include <Graphics/Enums.hpp>
+#include <Graphics/Texture.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace GE
+{
+
+FrameResources::FrameResources(gfx::Device* device)
+    : m_device(device)
+    , m_structuredBufferArena(device, gfx::BufferUsage::structuredBuffer)
+{
+    assert(m_device);
+}
+
+void FrameResources::prepare(const FrameGraph& frameGraph)
+{
+    m_frameGraph = &frameGraph;
+    m_backBuffer = nullptr;
+    m_structuredBufferArena.reset();
+
+    // one texture per alias slot, shared by the transient textures whose lifetimes do not overlap
+    const std::vector<gfx::Texture::Descriptor>& slotDescriptors = frameGraph.aliasSlotDescriptors();
+    m_slotTextures.resize(slotDescriptors.size());
+    for (size_t slot = 0; slot < slotDescriptors.size(); slot++)
+    {
+        SlotTexture& slotTexture = m_slotTextures[slot];
+        if (slotTexture.texture == nullptr || slotTexture.descriptor != slotDescriptors[slot])
+        {
+            slotTexture.texture = m_device->newTexture(slotDescriptors[slot]);
+            slotTexture.descriptor = slotDescriptors[slot];
+        }
+    }
+
+    const std::vector<CompiledResource>& resources = frameGraph.resources();
+    m_buffers.resize(resources.size());
+    for (size_t i = 0; i < resources.size(); i++)
+    {
+        ResourceBuffer& resourceBuffer = m_buffers[i];
+        if (resourceBuffer.kind != resources[i].kind)
+        {
+            resourceBuffer.kind = resources[i].kind;
+            resourceBuffer.buffer = nullptr;
+        }
+        if (resources[i].kind != ResourceKind::constantBuffer || resources[i].isUsed == false)
+            continue;
+        const gfx::Buffer::Descriptor& descriptor = frameGraph.constantBufferDescriptors().at(resources[i].name);
+        if (resourceBuffer.buffer == nullptr || resourceBuffer.buffer->size() != descriptor.size)
+            resourceBuffer.buffer = m_device->newBuffer(descriptor);
+    }
+}
+
+void FrameResources::setBackBuffer(std::shared_ptr<gfx::Texture> texture)
+{
+    m_backBuffer = std::move(texture);
+}
+
+const std::shared_ptr<gfx::Texture>& FrameResources::texture(TextureHandle handle) const
+{
+    assert(m_frameGraph);
+    const CompiledResource& resource = m_frameGraph->resources().at(handle.index);
+    if (resource.kind != ResourceKind::texture)
+        throw std::out_of_range("Frame graph resource \"" + resource.name + "\" is not a texture");
+    if (resource.aliasSlot != CompiledResource::NO_ALIAS_SLOT)
+        return m_slotTextures[resource.aliasSlot].texture;
+    if (resource.name == m_frameGraph->backBufferName())
+        return m_backBuffer;
+    throw std::out_of_range("Frame graph texture \"" + resource.name + "\" is not used by the compiled passes");
+}
+
+const std::shared_ptr<gfx::Texture>& FrameResources::texture(std::string_view name) const
+{
+    assert(m_frameGraph);
+    return texture(TextureHandle{ .index = m_frameGraph->resourceIndex(name) });
+}
+
+const std::shared_ptr<gfx::Buffer>& FrameResources::buffer(BufferHandle handle) const
+{
+    assert(m_frameGraph);
+    const CompiledResource& resource = m_frameGraph->resources().at(handle.index);
+    if (resource.kind == ResourceKind::texture)
+        throw std::out_of_range("Frame graph resource \"" + resource.name + "\" is not a buffer");
+    return m_buffers[handle.index].buffer;
+}
+
+const std::shared_ptr<gfx::Buffer>& FrameResources::buffer(std::string_view name) const
+{
+    assert(m_frameGraph);
+    return buffer(BufferHandle{ .index = m_frameGraph->resourceIndex(name) });
+}
+
+uint32_t FrameResources::setStructuredBufferContent(BufferHandle handle, const void* data, uint32_t elementSize, uint32_t elementCount)
+{
+    assert(m_frameGraph);
+    assert(elementSize > 0);
+    if (elementCount == 0)
+        return 0;
+    const CompiledResource& resource = m_frameGraph->resources().at(handle.index);
+    if (resource.kind != ResourceKind::structuredBuffer)
+        throw std::out_of_range("Frame graph resource \"" + resource.name + "\" is not a structured buffer");
+
+    // aligned on the element size so the offset is a whole number of elements
+    const size_t size = static_cast<size_t>(elementSize) * elementCount;
+    UploadArena::Allocation allocation = m_structuredBufferArena.allocate(size, elementSize);
+    if (data != nullptr)
+        std::memcpy(allocation.data, data, size);
+    m_buffers[handle.index].buffer = std::move(allocation.buffer);
+    assert(allocation.offset / elementSize <= UINT32_MAX);
+    return static_cast<uint32_t>(allocation.offset / elementSize);
+}
+
+uint32_t FrameResources::setStructuredBufferContent(std::string_view name, const void* data, uint32_t elementSize, uint32_t elementCount)
+{
+    assert(m_frameGraph);
+    return setStructuredBufferContent(BufferHandle{ .index = m_frameGraph->resourceIndex(name) }, data, elementSize, elementCount);
+}
+
+} // namespace GE
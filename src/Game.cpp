@@ -47,7 +47,7 @@ void setupScene(Game& game, Scene& scene, const ScriptLibrary* scriptLibrary)
     }
 }
 
-void tearDownScene(Game& game, Scene& scene)
+void tearDownScripts(Game& game, Scene& scene)
 {
     for (Entity entity : scene.ecsWorld() | ECSView<ScriptComponent>() | std::views::transform([&](auto id) { return Entity{ &scene.ecsWorld(), id }; }))
     {
@@ -56,6 +56,11 @@ void tearDownScene(Game& game, Scene& scene)
             scriptComponent.instance->teardown(entity, game);
         scriptComponent.instance.reset();
     }
+}
+
+void tearDownScene(Game& game, Scene& scene)
+{
+    tearDownScripts(game, scene);
     scene.unload();
 }
 
@@ -75,12 +80,29 @@ Game::Game(AssetManager* assetManager, const ScriptLibrary* scriptLibrary, const
 
 void Game::setActiveScene(const std::string& name)
 {
-    if (m_activeScene)
+    Scene& scene = m_scenes.at(name);
+    // retained before the previous scene releases its assets, so the shared ones are not reloaded
+    scene.load();
+    if (m_activeScene == &scene)
+        tearDownScripts(*this, scene);
+    else if (m_activeScene)
         tearDownScene(*this, *m_activeScene);
-    m_activeScene = &m_scenes.at(name);
+    m_activeScene = &scene;
     setupScene(*this, *m_activeScene, m_scriptLibrary);
 }
 
+void Game::preloadScene(const std::string& name)
+{
+    m_scenes.at(name).load();
+}
+
+void Game::cancelScenePreload(const std::string& name)
+{
+    Scene& scene = m_scenes.at(name);
+    if (&scene != m_activeScene)
+        scene.unload();
+}
+
 Game::~Game()
 {
     assert(m_activeScene);
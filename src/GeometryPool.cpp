@@ -0,0 +1,293 @@
+/*
+ * ---------------------------------------------------
+ * GeometryPool.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/GeometryPool.hpp"
+#include "Game-Engine/Renderer.hpp"
+
+#include <Graphics/Buffer.hpp>
+#include <Graphics/CommandBuffer.hpp>
+#include <Graphics/Enums.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <ranges>
+#include <vector>
+
+namespace GE
+{
+
+RangeAllocator::RangeAllocator(uint32_t capacity)
+    : m_capacity(capacity)
+    , m_freeCount(capacity)
+{
+    if (capacity > 0)
+        m_freeRanges.emplace(0, capacity);
+}
+
+std::optional<uint32_t> RangeAllocator::allocate(uint32_t count)
+{
+    assert(count > 0);
+    auto it = std::ranges::find_if(m_freeRanges, [&](const auto& range) { return range.second >= count; });
+    if (it == m_freeRanges.end())
+        return std::nullopt;
+
+    auto [offset, rangeCount] = *it;
+    m_freeRanges.erase(it);
+    if (rangeCount > count)
+        m_freeRanges.emplace(offset + count, rangeCount - count);
+    m_freeCount -= count;
+    return offset;
+}
+
+void RangeAllocator::free(uint32_t offset, uint32_t count)
+{
+    assert(count > 0);
+    assert(offset + count <= m_capacity);
+    m_freeCount += count;
+
+    auto next = m_freeRanges.lower_bound(offset);
+    assert(next == m_freeRanges.end() || offset + count <= next->first); // double free
+
+    if (next != m_freeRanges.end() && offset + count == next->first)
+    {
+        count += next->second;
+        next = m_freeRanges.erase(next);
+    }
+
+    if (next != m_freeRanges.begin())
+    {
+        auto prev = std::prev(next);
+        assert(prev->first + prev->second <= offset); // double free
+        if (prev->first + prev->second == offset)
+        {
+            prev->second += count;
+            return;
+        }
+    }
+    m_freeRanges.emplace_hint(next, offset, count);
+}
+
+uint32_t RangeAllocator::largestFreeRange() const
+{
+    uint32_t largest = 0;
+    for (const auto& [_, count] : m_freeRanges)
+        largest = std::max(largest, count);
+    return largest;
+}
+
+GeometryPool::GeometryPool(gfx::Device* device, uint32_t pageVertexCount)
+    : m_device(device)
+    , m_pageVertexCount(pageVertexCount)
+    , m_state(std::make_shared<State>())
+{
+    assert(m_device);
+    assert(m_pageVertexCount > 0);
+}
+
+std::shared_ptr<const GeometryPool::Allocation> GeometryPool::allocate(uint32_t stride, uint32_t count, std::span<const std::byte> data)
+{
+    assert(stride > 0);
+    assert(data.size() == static_cast<size_t>(stride) * count);
+
+    std::shared_ptr<Page> page;
+    uint32_t offset = 0;
+    if (count > 0)
+    {
+        std::scoped_lock lock(m_state->mutex);
+        std::vector<std::shared_ptr<Page>>& pages = m_state->pages[stride];
+        for (const std::shared_ptr<Page>& candidate : pages)
+        {
+            if (std::optional<uint32_t> allocated = candidate->allocator.allocate(count))
+            {
+                page = candidate;
+                offset = *allocated;
+                break;
+            }
+        }
+        if (page == nullptr)
+        {
+            const uint32_t pageCapacity = std::max(m_pageVertexCount, count);
+            page = std::make_shared<Page>();
+            page->buffer = m_device->newBuffer(gfx::Buffer::Descriptor{
+                .size = static_cast<size_t>(pageCapacity) * stride,
+                .usages = gfx::BufferUsage::vertexBuffer | gfx::BufferUsage::copyDestination,
+                .storageMode = gfx::ResourceStorageMode::deviceLocal });
+            assert(page->buffer);
+            // kept with the page, the relocations and the later allocations are written to it
+            page->stagingBuffer = m_device->newBuffer(gfx::Buffer::Descriptor{
+                .size = page->buffer->size(),
+                .usages = gfx::BufferUsage::copySource,
+                .storageMode = gfx::ResourceStorageMode::hostVisible });
+            assert(page->stagingBuffer);
+            page->allocator = RangeAllocator(pageCapacity);
+            std::optional<uint32_t> allocated = page->allocator.allocate(count);
+            assert(allocated.has_value());
+            offset = *allocated;
+            pages.push_back(page);
+        }
+    }
+
+    if (page != nullptr)
+        std::memcpy(page->stagingBuffer->content<std::byte>() + static_cast<size_t>(offset) * stride, data.data(), data.size());
+
+    return newAllocation(page, offset, count, stride);
+}
+
+std::shared_ptr<const GeometryPool::Allocation> GeometryPool::relocate(const Allocation& allocation)
+{
+    if (allocation.count == 0)
+        return nullptr;
+
+    std::shared_ptr<Page> page;
+    uint32_t offset = 0;
+    {
+        std::scoped_lock lock(m_state->mutex);
+        auto pages = m_state->pages.find(allocation.stride);
+        if (pages == m_state->pages.end())
+            return nullptr;
+        // the first fit is the lowest room of a page, the pages after the one of the allocation are not lower
+        for (const std::shared_ptr<Page>& candidate : pages->second)
+        {
+            const bool isSourcePage = candidate->buffer == allocation.buffer;
+            std::optional<uint32_t> allocated = candidate->allocator.allocate(allocation.count);
+            if (allocated.has_value() && isSourcePage && *allocated > allocation.offset)
+            {
+                candidate->allocator.free(*allocated, allocation.count);
+                allocated.reset();
+            }
+            if (allocated.has_value())
+            {
+                page = candidate;
+                offset = *allocated;
+                break;
+            }
+            if (isSourcePage)
+                break;
+        }
+    }
+    if (page == nullptr)
+        return nullptr;
+
+    // the new range was retired, no frame in flight reads it, and the original is still allocated so they do not overlap
+    const size_t byteSize = static_cast<size_t>(allocation.count) * allocation.stride;
+    std::memcpy(page->stagingBuffer->content<std::byte>() + static_cast<size_t>(offset) * allocation.stride,
+                allocation.stagingBuffer->content<std::byte>() + static_cast<size_t>(allocation.offset) * allocation.stride, byteSize);
+    return newAllocation(page, offset, allocation.count, allocation.stride);
+}
+
+size_t GeometryPool::upload(gfx::CommandBuffer& commandBuffer, std::span<const std::shared_ptr<const Allocation>> allocations) const
+{
+    struct PageCopy
+    {
+        const Allocation* allocation; // any of the page
+        size_t size;
+    };
+    std::vector<PageCopy> pageCopies;
+    for (const std::shared_ptr<const Allocation>& allocation : allocations)
+    {
+        if (allocation == nullptr || allocation->count == 0)
+            continue;
+        const size_t end = static_cast<size_t>(allocation->offset + allocation->count) * allocation->stride;
+        auto pageCopy = std::ranges::find(pageCopies, allocation->buffer, [](const PageCopy& pageCopy) { return pageCopy.allocation->buffer; });
+        if (pageCopy == pageCopies.end())
+            pageCopies.push_back(PageCopy{ .allocation = allocation.get(), .size = end });
+        else
+            pageCopy->size = std::max(pageCopy->size, end);
+    }
+
+    // the copies read the staging buffers when executed, a range written by an other thread meanwhile is complete
+    // in the page once the copy recorded by that thread, which is submitted after the write, is executed
+    size_t copiedBytes = 0;
+    for (const PageCopy& pageCopy : pageCopies)
+    {
+        commandBuffer.copyBufferToBuffer(pageCopy.allocation->stagingBuffer, pageCopy.allocation->buffer, pageCopy.size);
+        copiedBytes += pageCopy.size;
+    }
+    return copiedBytes;
+}
+
+uint64_t GeometryPool::retiredFreeCount() const
+{
+    std::scoped_lock lock(m_state->mutex);
+    return m_state->retiredFreeCount;
+}
+
+std::shared_ptr<const GeometryPool::Allocation> GeometryPool::newAllocation(const std::shared_ptr<Page>& page, uint32_t offset, uint32_t count, uint32_t stride) const
+{
+    auto* allocation = new Allocation{
+        .buffer = page ? page->buffer : nullptr,
+        .stagingBuffer = page ? page->stagingBuffer : nullptr,
+        .offset = offset,
+        .count = count,
+        .stride = stride
+    };
+    return std::shared_ptr<const Allocation>(allocation, [state = m_state, page](const Allocation* allocation) {
+        if (page != nullptr)
+        {
+            std::scoped_lock lock(state->mutex);
+            state->pendingFrees.push_back(PendingFree{
+                .page = page,
+                .offset = allocation->offset,
+                .count = allocation->count,
+                .frame = state->frame
+            });
+        }
+        delete allocation;
+    });
+}
+
+void GeometryPool::endFrame()
+{
+    std::scoped_lock lock(m_state->mutex);
+    m_state->frame++;
+
+    // ranges released this frame may still be read by the frames in flight
+    auto retired = std::ranges::partition(m_state->pendingFrees, [&](const PendingFree& pendingFree) {
+        return pendingFree.frame + maxFrameInFlight > m_state->frame;
+    });
+    if (retired.empty())
+        return;
+    for (PendingFree& pendingFree : retired)
+        pendingFree.page->allocator.free(pendingFree.offset, pendingFree.count);
+    m_state->retiredFreeCount += retired.size();
+    m_state->pendingFrees.erase(retired.begin(), retired.end());
+
+    // keep one page per stride around to avoid reallocating it on the next load
+    for (auto& [_, pages] : m_state->pages)
+    {
+        if (pages.empty())
+            continue;
+        auto emptyPages = std::remove_if(std::next(pages.begin()), pages.end(), [](const std::shared_ptr<Page>& page) {
+            return page->allocator.isEmpty();
+        });
+        pages.erase(emptyPages, pages.end());
+    }
+}
+
+GeometryPool::Statistics GeometryPool::statistics() const
+{
+    std::scoped_lock lock(m_state->mutex);
+    Statistics statistics;
+    for (const auto& [stride, pages] : m_state->pages)
+    {
+        for (const std::shared_ptr<Page>& page : pages)
+        {
+            statistics.pageCount++;
+            statistics.reservedBytes += static_cast<size_t>(page->allocator.capacity()) * stride;
+            statistics.usedBytes += static_cast<size_t>(page->allocator.usedCount()) * stride;
+            statistics.freeRangeCount += page->allocator.freeRangeCount();
+        }
+    }
+    statistics.pendingFreeCount = static_cast<uint32_t>(m_state->pendingFrees.size());
+    return statistics;
+}
+
+} // namespace GE
@@ -0,0 +1,66 @@
+/*
+ * ---------------------------------------------------
+ * Hash.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/Hash.hpp"
+
+#include <bit>
+#include <cstring>
+
+namespace
+{
+
+constexpr uint64_t PRIME1 = 0x9e3779b185ebca87ULL;
+constexpr uint64_t PRIME2 = 0xc2b2ae3d27d4eb4fULL;
+
+constexpr uint64_t mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace
+
+namespace GE
+{
+
+uint64_t hashBytes(std::span<const std::byte> bytes, uint64_t seed)
+{
+    // four independent lanes so the loop is not bound by the multiply latency
+    uint64_t lanes[4] = { seed + PRIME1, seed + PRIME2, seed, seed - PRIME1 };
+
+    size_t i = 0;
+    for (; i + 32 <= bytes.size(); i += 32)
+    {
+        for (uint64_t& lane : lanes)
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes.data() + i + (&lane - lanes) * 8, sizeof(word));
+            lane = std::rotl(lane + word * PRIME2, 31) * PRIME1;
+        }
+    }
+
+    uint64_t h = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+    h += bytes.size();
+
+    for (; i + 8 <= bytes.size(); i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes.data() + i, sizeof(word));
+        h = std::rotl(h ^ (std::rotl(word * PRIME2, 31) * PRIME1), 27) * PRIME1 + PRIME2;
+    }
+    for (; i < bytes.size(); i++)
+        h = std::rotl(h ^ (static_cast<uint64_t>(bytes[i]) * PRIME1), 11) * PRIME2;
+
+    return mix(h);
+}
+
+} // namespace GE
@@ -0,0 +1,113 @@
+/*
+ * ---------------------------------------------------
+ * JobSystem.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/JobSystem.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace GE
+{
+
+uint32_t JobSystem::defaultWorkerCount()
+{
+    return std::clamp(std::thread::hardware_concurrency(), 1u, 8u) - 1;
+}
+
+JobSystem::JobSystem(uint32_t workerCount)
+{
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++)
+        m_workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+}
+
+void JobSystem::parallelFor(uint32_t count, FunctionRef<void(uint32_t index, uint32_t threadIndex)> job)
+{
+    if (count == 0)
+        return;
+    std::scoped_lock submitLock(m_submitMutex);
+    if (m_workers.empty() || count == 1)
+    {
+        for (uint32_t i = 0; i < count; i++)
+            job(i, 0);
+        return;
+    }
+
+    {
+        std::scoped_lock lock(m_mutex);
+        m_job = &job;
+        m_jobCount = count;
+        m_nextJob.store(0, std::memory_order_relaxed);
+        m_exception = nullptr;
+        m_doneWorkerCount = 0;
+        m_generation++;
+    }
+    m_wakeCondition.notify_all();
+
+    runJobs(0);
+
+    // every worker takes part in every loop, so none of them can still see this one when the next starts
+    std::unique_lock lock(m_mutex);
+    m_doneCondition.wait(lock, [&]() { return m_doneWorkerCount == m_workers.size(); });
+    m_job = nullptr;
+    if (m_exception)
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+}
+
+void JobSystem::workerLoop(uint32_t threadIndex)
+{
+    uint64_t seenGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock lock(m_mutex);
+            m_wakeCondition.wait(lock, [&]() { return m_stop || m_generation != seenGeneration; });
+            if (m_stop)
+                return;
+            seenGeneration = m_generation;
+        }
+        runJobs(threadIndex);
+        {
+            std::scoped_lock lock(m_mutex);
+            m_doneWorkerCount++;
+        }
+        m_doneCondition.notify_one();
+    }
+}
+
+void JobSystem::runJobs(uint32_t threadIndex)
+{
+    assert(m_job != nullptr);
+    for (uint32_t i = m_nextJob.fetch_add(1, std::memory_order_relaxed); i < m_jobCount; i = m_nextJob.fetch_add(1, std::memory_order_relaxed))
+    {
+        try
+        {
+            (*m_job)(i, threadIndex);
+        }
+        catch (...)
+        {
+            std::scoped_lock lock(m_mutex);
+            if (m_exception == nullptr)
+                m_exception = std::current_exception();
+        }
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeCondition.notify_all();
+    for (std::thread& worker : m_workers)
+        worker.join();
+}
+
+} // namespace GE
@@ -0,0 +1,174 @@
+/*
+ * ---------------------------------------------------
+ * LightClusters.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/LightClusters.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+glm::vec4 matrixRow(const glm::mat4x4& matrix, int i)
+{
+    return glm::vec4(matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i]);
+}
+
+// the boundary k of the tiles of an axis is where its clip coordinate equals (-1 + 2k / count) * w
+void boundaryPlanes(const glm::vec4& axisRow, const glm::vec4& wRow, uint32_t count, std::vector<glm::vec4>& planes)
+{
+    planes.resize(count + 1);
+    for (uint32_t k = 0; k <= count; k++)
+    {
+        glm::vec4 plane = axisRow - (-1.0f + 2.0f * static_cast<float>(k) / static_cast<float>(count)) * wRow;
+        const float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f)
+            plane /= length;
+        planes[k] = plane;
+    }
+}
+
+// a sphere overlaps a tile unless it is entirely on the outer side of one of its boundaries, the planes all
+// go through the camera so the test is conservative for the spheres reaching behind it too
+std::optional<std::pair<uint32_t, uint32_t>> tileRange(const std::vector<glm::vec4>& planes, const GE::BoundingSphere& sphere)
+{
+    uint32_t first = UINT32_MAX;
+    uint32_t last = 0;
+    float lowDistance = glm::dot(glm::vec3(planes[0]), sphere.center) + planes[0].w;
+    for (uint32_t i = 0; i + 1 < planes.size(); i++)
+    {
+        const float highDistance = glm::dot(glm::vec3(planes[i + 1]), sphere.center) + planes[i + 1].w;
+        if (lowDistance >= -sphere.radius && highDistance <= sphere.radius)
+        {
+            first = std::min(first, i);
+            last = i;
+        }
+        lowDistance = highDistance;
+    }
+    if (first == UINT32_MAX)
+        return std::nullopt;
+    return std::make_pair(first, last);
+}
+
+uint32_t tileOf(float ndc, uint32_t count)
+{
+    const float tile = std::floor((ndc * 0.5f + 0.5f) * static_cast<float>(count));
+    return static_cast<uint32_t>(std::clamp(tile, 0.0f, static_cast<float>(count - 1)));
+}
+
+} // namespace
+
+namespace GE
+{
+
+float pointLightRadius(const glm::vec3& color, float attenuation)
+{
+    const float brightest = std::max({ color.x, color.y, color.z });
+    if (brightest <= POINT_LIGHT_CUTOFF)
+        return 0.0f;
+    if (attenuation <= 0.0f)
+        return std::numeric_limits<float>::infinity();
+    return std::sqrt((brightest / POINT_LIGHT_CUTOFF - 1.0f) / attenuation);
+}
+
+LightClusterGrid::LightClusterGrid(uint32_t tileCountX, uint32_t tileCountY, uint32_t sliceCount)
+    : m_size(tileCountX, tileCountY, sliceCount)
+    , m_clusters(static_cast<size_t>(tileCountX) * tileCountY * sliceCount)
+{
+    assert(tileCountX > 0 && tileCountY > 0 && sliceCount > 0);
+}
+
+void LightClusterGrid::build(const glm::mat4x4& viewProjectionMatrix, float nearDepth, float farDepth, std::span<const BoundingSphere> lights)
+{
+    assert(0.0f < nearDepth && nearDepth < farDepth);
+    assert(lights.size() < UINT32_MAX);
+    m_viewProjectionMatrix = viewProjectionMatrix;
+    m_depthScale = static_cast<float>(m_size.z) / std::log2(farDepth / nearDepth);
+    m_depthBias = -std::log2(nearDepth) * m_depthScale;
+
+    const glm::vec4 wRow = matrixRow(viewProjectionMatrix, 3);
+    boundaryPlanes(matrixRow(viewProjectionMatrix, 0), wRow, m_size.x, m_columnPlanes);
+    boundaryPlanes(matrixRow(viewProjectionMatrix, 1), wRow, m_size.y, m_rowPlanes);
+    const float depthPerDistance = glm::length(glm::vec3(wRow));
+
+    // the clusters overlapped by each light, then the lights are counted by cluster to place them
+    m_lightRanges.clear();
+    for (uint32_t i = 0; i < lights.size(); i++)
+    {
+        const BoundingSphere& light = lights[i];
+        if (std::isfinite(light.radius) == false || light.radius <= 0.0f)
+            continue;
+
+        const float depth = glm::dot(glm::vec3(wRow), light.center) + wRow.w;
+        const float depthRadius = light.radius * depthPerDistance;
+        if (depth + depthRadius < nearDepth || depth - depthRadius > farDepth)
+            continue;
+        const std::optional<std::pair<uint32_t, uint32_t>> columns = tileRange(m_columnPlanes, light);
+        if (columns.has_value() == false)
+            continue;
+        const std::optional<std::pair<uint32_t, uint32_t>> rows = tileRange(m_rowPlanes, light);
+        if (rows.has_value() == false)
+            continue;
+
+        m_lightRanges.push_back({
+            .light = i,
+            .min = glm::uvec3(columns->first, rows->first, sliceOf(depth - depthRadius)),
+            .max = glm::uvec3(columns->second, rows->second, sliceOf(depth + depthRadius))
+        });
+    }
+
+    std::ranges::fill(m_clusters, Cluster{ .offset = 0, .count = 0 });
+    const auto forEachCluster = [&](const LightRange& range, auto&& f) {
+        for (uint32_t z = range.min.z; z <= range.max.z; z++)
+        {
+            for (uint32_t y = range.min.y; y <= range.max.y; y++)
+            {
+                for (uint32_t x = range.min.x; x <= range.max.x; x++)
+                    f(m_clusters[clusterIndex(glm::uvec3(x, y, z))]);
+            }
+        }
+    };
+    for (const LightRange& range : m_lightRanges)
+        forEachCluster(range, [](Cluster& cluster) { cluster.count++; });
+
+    uint32_t offset = 0;
+    for (Cluster& cluster : m_clusters)
+    {
+        cluster.offset = offset;
+        offset += cluster.count;
+        cluster.count = 0;
+    }
+    m_lightIndices.resize(offset);
+
+    // in increasing light order in each cluster
+    for (const LightRange& range : m_lightRanges)
+        forEachCluster(range, [&](Cluster& cluster) { m_lightIndices[cluster.offset + cluster.count++] = range.light; });
+}
+
+glm::uvec3 LightClusterGrid::clusterOf(const glm::vec3& position) const
+{
+    const glm::vec4 clip = m_viewProjectionMatrix * glm::vec4(position, 1.0f);
+    assert(clip.w > 0.0f);
+    return glm::uvec3(tileOf(clip.x / clip.w, m_size.x), tileOf(clip.y / clip.w, m_size.y), sliceOf(clip.w));
+}
+
+uint32_t LightClusterGrid::sliceOf(float depth) const
+{
+    if (depth <= 0.0f)
+        return 0;
+    const float slice = std::floor(std::log2(depth) * m_depthScale + m_depthBias);
+    return static_cast<uint32_t>(std::clamp(slice, 0.0f, static_cast<float>(m_size.z - 1)));
+}
+
+} // namespace GE
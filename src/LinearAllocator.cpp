@@ -0,0 +1,76 @@
+/*
+ * ---------------------------------------------------
+ * LinearAllocator.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/LinearAllocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace GE
+{
+
+LinearAllocator::LinearAllocator(size_t blockSize)
+    : m_blockSize(blockSize)
+{
+    assert(m_blockSize > 0);
+}
+
+void* LinearAllocator::allocate(size_t size, size_t alignment)
+{
+    assert(std::has_single_bit(alignment));
+    const auto alignedOffset = [&](const Block& block, size_t offset) {
+        const auto address = reinterpret_cast<std::uintptr_t>(block.memory.get()) + offset;
+        return offset + ((alignment - address % alignment) % alignment);
+    };
+
+    // the following blocks are only the ones kept by a reset, they are empty
+    while (m_currentBlock < m_blocks.size() && alignedOffset(m_blocks[m_currentBlock], m_offset) + size > m_blocks[m_currentBlock].size)
+    {
+        m_currentBlock++;
+        m_offset = 0;
+    }
+    if (m_currentBlock == m_blocks.size())
+    {
+        const size_t blockSize = std::max(m_blockSize, size + alignment);
+        m_blocks.push_back(Block{ .memory = std::make_unique_for_overwrite<std::byte[]>(blockSize), .size = blockSize });
+        m_offset = 0;
+    }
+
+    Block& block = m_blocks[m_currentBlock];
+    const size_t offset = alignedOffset(block, m_offset);
+    m_usedBytes += offset + size - m_offset;
+    m_offset = offset + size;
+    return block.memory.get() + offset;
+}
+
+void LinearAllocator::reset()
+{
+    if (m_blocks.size() > 1)
+    {
+        const size_t size = capacity();
+        m_blocks.clear();
+        m_blocks.push_back(Block{ .memory = std::make_unique_for_overwrite<std::byte[]>(size), .size = size });
+    }
+    m_currentBlock = 0;
+    m_offset = 0;
+    m_usedBytes = 0;
+}
+
+size_t LinearAllocator::capacity() const
+{
+    size_t capacity = 0;
+    for (const Block& block : m_blocks)
+        capacity += block.size;
+    return capacity;
+}
+
+} // namespace GE
@@ -0,0 +1,174 @@
+/*
+ * ---------------------------------------------------
+ * Lz4.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Lz4.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace GE
+{
+
+namespace
+{
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5; // the block always ends with literals
+constexpr size_t MATCH_FIND_LIMIT = 12; // no match starts in the last bytes
+constexpr size_t MAX_OFFSET = 65535;
+constexpr uint32_t HASH_LOG = 16;
+constexpr uint32_t NO_POSITION = std::numeric_limits<uint32_t>::max();
+
+uint32_t read32(const std::byte* bytes)
+{
+    uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+uint32_t hashSequence(uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+void writeLength(std::vector<std::byte>& output, size_t length)
+{
+    for (; length >= 255; length -= 255)
+        output.push_back(std::byte{255});
+    output.push_back(static_cast<std::byte>(length));
+}
+
+void writeSequence(std::vector<std::byte>& output, std::span<const std::byte> literals, size_t offset, size_t matchLength)
+{
+    const size_t matchCode = matchLength - MIN_MATCH;
+    output.push_back(static_cast<std::byte>((std::min<size_t>(literals.size(), 15) << 4) | std::min<size_t>(matchCode, 15)));
+    if (literals.size() >= 15)
+        writeLength(output, literals.size() - 15);
+    output.insert(output.end(), literals.begin(), literals.end());
+    output.push_back(static_cast<std::byte>(offset & 0xFF));
+    output.push_back(static_cast<std::byte>(offset >> 8));
+    if (matchCode >= 15)
+        writeLength(output, matchCode - 15);
+}
+
+bool readLength(std::span<const std::byte> input, size_t& position, size_t& length)
+{
+    uint8_t byte = 0;
+    do {
+        if (position >= input.size())
+            return false;
+        byte = static_cast<uint8_t>(input[position++]);
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+} // namespace
+
+std::vector<std::byte> lz4Compress(std::span<const std::byte> input)
+{
+    std::vector<std::byte> output;
+    output.reserve(lz4CompressBound(input.size()));
+
+    size_t anchor = 0;
+    if (input.size() > MATCH_FIND_LIMIT)
+    {
+        std::vector<uint32_t> positions(size_t(1) << HASH_LOG, NO_POSITION);
+        const size_t matchEnd = input.size() - LAST_LITERALS;
+        const size_t searchEnd = input.size() - MATCH_FIND_LIMIT;
+        size_t position = 0;
+        while (position <= searchEnd)
+        {
+            const uint32_t sequence = read32(input.data() + position);
+            uint32_t& entry = positions[hashSequence(sequence)];
+            size_t candidate = entry;
+            entry = static_cast<uint32_t>(position);
+
+            if (candidate == NO_POSITION || position - candidate > MAX_OFFSET || read32(input.data() + candidate) != sequence)
+            {
+                // skip faster through the data that does not compress
+                position += 1 + ((position - anchor) >> 6);
+                continue;
+            }
+
+            while (position > anchor && candidate > 0 && input[position - 1] == input[candidate - 1])
+            {
+                position--;
+                candidate--;
+            }
+            size_t length = MIN_MATCH;
+            while (position + length < matchEnd && input[position + length] == input[candidate + length])
+                length++;
+
+            writeSequence(output, input.subspan(anchor, position - anchor), position - candidate, length);
+            position += length;
+            anchor = position;
+        }
+    }
+
+    const size_t literalCount = input.size() - anchor;
+    output.push_back(static_cast<std::byte>(std::min<size_t>(literalCount, 15) << 4));
+    if (literalCount >= 15)
+        writeLength(output, literalCount - 15);
+    output.insert(output.end(), input.begin() + static_cast<std::ptrdiff_t>(anchor), input.end());
+    return output;
+}
+
+bool lz4Decompress(std::span<const std::byte> input, std::span<std::byte> output)
+{
+    size_t inputPosition = 0;
+    size_t outputPosition = 0;
+    while (inputPosition < input.size())
+    {
+        const auto token = static_cast<uint8_t>(input[inputPosition++]);
+
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !readLength(input, inputPosition, literalCount))
+            return false;
+        if (literalCount > input.size() - inputPosition || literalCount > output.size() - outputPosition)
+            return false;
+        if (literalCount > 0)
+            std::memcpy(output.data() + outputPosition, input.data() + inputPosition, literalCount);
+        inputPosition += literalCount;
+        outputPosition += literalCount;
+
+        if (inputPosition == input.size())
+            break; // the last sequence has no match
+
+        if (input.size() - inputPosition < 2)
+            return false;
+        const size_t offset = static_cast<size_t>(input[inputPosition]) | (static_cast<size_t>(input[inputPosition + 1]) << 8);
+        inputPosition += 2;
+        if (offset == 0 || offset > outputPosition)
+            return false;
+
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLength(input, inputPosition, matchLength))
+            return false;
+        matchLength += MIN_MATCH;
+        if (matchLength > output.size() - outputPosition)
+            return false;
+
+        std::byte* destination = output.data() + outputPosition;
+        const std::byte* source = destination - offset;
+        if (offset >= matchLength)
+            std::memcpy(destination, source, matchLength);
+        else
+        {
+            // overlapping, repeats the last `offset` bytes
+            for (size_t i = 0; i < matchLength; i++)
+                destination[i] = source[i];
+        }
+        outputPosition += matchLength;
+    }
+    return outputPosition == output.size();
+}
+
+} // namespace GE
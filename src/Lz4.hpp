@@ -0,0 +1,37 @@
+/*
+ * ---------------------------------------------------
+ * Lz4.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * LZ4 block format codec used by the asset archives. The compressor is the
+ * greedy single probe one of the reference implementation, fast rather
+ * than tight, the decompressor validates the whole input and never reads
+ * or writes out of bounds.
+ *
+ */
+
+#ifndef LZ4_HPP
+#define LZ4_HPP
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace GE
+{
+
+constexpr size_t lz4CompressBound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+std::vector<std::byte> lz4Compress(std::span<const std::byte>);
+
+// `output` must be exactly the size of the uncompressed data, return false if the input is malformed
+bool lz4Decompress(std::span<const std::byte> input, std::span<std::byte> output);
+
+} // namespace GE
+
+#endif // LZ4_HPP
@@ -0,0 +1,131 @@
+/*
+ * ---------------------------------------------------
+ * MappedFile.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/MappedFile.hpp"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <stdexcept>
+#include <utility>
+
+namespace GE
+{
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+#if defined(_WIN32)
+    , m_fileHandle(std::exchange(other.m_fileHandle, nullptr))
+    , m_mappingHandle(std::exchange(other.m_mappingHandle, nullptr))
+#endif
+{
+}
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    m_fileHandle = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_fileHandle == INVALID_HANDLE_VALUE)
+    {
+        m_fileHandle = nullptr;
+        throw std::runtime_error("failed to open file: " + path.string());
+    }
+
+    LARGE_INTEGER size;
+    if (::GetFileSizeEx(m_fileHandle, &size) == FALSE)
+    {
+        ::CloseHandle(m_fileHandle);
+        throw std::runtime_error("failed to get the size of file: " + path.string());
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0)
+        return;
+
+    m_mappingHandle = ::CreateFileMappingW(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* data = m_mappingHandle ? ::MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (data == nullptr)
+    {
+        if (m_mappingHandle)
+            ::CloseHandle(m_mappingHandle);
+        ::CloseHandle(m_fileHandle);
+        throw std::runtime_error("failed to map file: " + path.string());
+    }
+    m_data = static_cast<const std::byte*>(data);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+        ::UnmapViewOfFile(m_data);
+    if (m_mappingHandle)
+        ::CloseHandle(m_mappingHandle);
+    if (m_fileHandle)
+        ::CloseHandle(m_fileHandle);
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("failed to open file: " + path.string());
+
+    struct stat st = {};
+    if (::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("failed to get the size of file: " + path.string());
+    }
+    m_size = static_cast<size_t>(st.st_size);
+    if (m_size == 0)
+    {
+        ::close(fd);
+        return;
+    }
+
+    void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps its own reference to the file
+    if (data == MAP_FAILED)
+        throw std::runtime_error("failed to map file: " + path.string());
+    m_data = static_cast<const std::byte*>(data);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+        ::munmap(const_cast<std::byte*>(m_data), m_size);
+}
+
+#endif
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+#if defined(_WIN32)
+        std::swap(m_fileHandle, other.m_fileHandle);
+        std::swap(m_mappingHandle, other.m_mappingHandle);
+#endif
+    }
+    return *this;
+}
+
+} // namespace GE
@@ -0,0 +1,610 @@
+/*
+ * ---------------------------------------------------
+ * MeshData.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/MeshData.hpp"
+#include "Game-Engine/Hash.hpp"
+#include "Game-Engine/MappedFile.hpp"
+#include "Game-Engine/MeshOptimizer.hpp"
+
+#include "CookedFile.hpp"
+
+#include <assimp/DefaultIOSystem.h>
+#include <assimp/Importer.hpp>
+#include <assimp/MemoryIOWrapper.h>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <format>
+#include <functional>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+constexpr unsigned int POST_PROCESSING_FLAGS = aiProcess_CalcTangentSpace
+                                               | aiProcess_JoinIdenticalVertices
+                                               | aiProcess_Triangulate
+                                               | aiProcess_GenNormals
+                                               | aiProcess_OptimizeMeshes
+                                               | aiProcess_FlipUVs;
+
+namespace
+{
+
+constexpr uint32_t COOKED_MESH_MAGIC = 0x434D4547; // "GEMC"
+constexpr uint32_t COOKED_MESH_VERSION = 8;        // to be incremented on any change of the layout or of the import
+
+struct CookedMeshHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t fileSize;
+    uint32_t vertexSize;
+    uint32_t geometryCount;
+    uint32_t nodeCount;
+    uint32_t dependencyCount;
+    uint32_t nameLength;
+    uint32_t lodCount;
+    uint64_t stringsOffset; // the mesh name is the first string
+    uint64_t stringsSize;
+};
+
+struct CookedGeometry
+{
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t nameOffset; // in the strings
+    uint32_t nameLength;
+    uint8_t vertexFormat;
+    uint8_t padding[3];
+    float positionScale[3];
+    float positionOffset[3];
+    uint32_t firstLod; // in the lods of the file
+    uint32_t lodCount;
+    float boundingSphere[4];
+    float boundingBox[6]; // min then max
+};
+
+// same vertices as its geometry
+struct CookedLod
+{
+    uint64_t indexOffset;
+    uint32_t indexCount;
+    float error;
+};
+
+struct CookedNode
+{
+    uint32_t geometry;
+    int32_t parent;
+    float transform[16];
+};
+
+struct CookedDependency
+{
+    uint64_t hash;
+    uint32_t pathOffset; // in the strings
+    uint32_t pathLength;
+};
+
+static_assert(std::is_trivially_copyable_v<GE::Vertex>);
+static_assert(std::is_trivially_copyable_v<GE::PackedVertex>);
+static_assert(sizeof(glm::mat4x4) == sizeof(CookedNode::transform));
+
+// record the files opened by assimp to know the dependencies of the source,
+// the source itself is read from its content already in memory
+class RecordingIOSystem : public Assimp::DefaultIOSystem
+{
+public:
+    RecordingIOSystem(const std::filesystem::path& sourcePath, std::span<const std::byte> sourceContent)
+        : m_sourcePath(sourcePath.lexically_normal())
+        , m_sourceContent(sourceContent)
+    {
+    }
+
+    bool Exists(const char* file) const override
+    {
+        return isSource(file) || DefaultIOSystem::Exists(file);
+    }
+
+    Assimp::IOStream* Open(const char* file, const char* mode) override
+    {
+        if (isSource(file) && std::string_view(mode).find_first_of("wa+") == std::string_view::npos)
+            return new Assimp::MemoryIOStream(reinterpret_cast<const uint8_t*>(m_sourceContent.data()), m_sourceContent.size());
+        openedFiles.emplace_back(file);
+        return DefaultIOSystem::Open(file, mode);
+    }
+
+    std::vector<std::filesystem::path> openedFiles;
+
+private:
+    inline bool isSource(const char* file) const { return std::filesystem::path(file).lexically_normal() == m_sourcePath; }
+
+    std::filesystem::path m_sourcePath;
+    std::span<const std::byte> m_sourceContent;
+};
+
+struct GeometryStorage
+{
+    std::vector<std::vector<GE::Vertex>> vertices;
+    std::vector<std::vector<GE::PackedVertex>> packedVertices;
+    std::vector<std::vector<uint32_t>> indices;
+};
+
+static inline glm::mat4x4 toGlmMat4(const aiMatrix4x4& from)
+{
+    glm::mat4x4 to;
+    to[0][0] = from.a1; to[1][0] = from.a2; to[2][0] = from.a3; to[3][0] = from.a4;
+    to[0][1] = from.b1; to[1][1] = from.b2; to[2][1] = from.b3; to[3][1] = from.b4;
+    to[0][2] = from.c1; to[1][2] = from.c2; to[2][2] = from.c3; to[3][2] = from.c4;
+    to[0][3] = from.d1; to[1][3] = from.d2; to[2][3] = from.d3; to[3][3] = from.d4;
+    return to;
+}
+
+} // namespace
+
+namespace GE
+{
+
+MeshData importMesh(const std::filesystem::path& path)
+{
+    assert(std::filesystem::is_regular_file(path));
+    const MappedFile source(path);
+    return importMesh(path, source.bytes());
+}
+
+MeshData importMesh(const std::filesystem::path& path, std::span<const std::byte> sourceContent)
+{
+    Assimp::Importer importer;
+    auto* ioSystem = new RecordingIOSystem(path, sourceContent); // owned by the importer
+    importer.SetIOHandler(ioSystem);
+
+    const aiScene* scene = importer.ReadFile(path.string(), POST_PROCESSING_FLAGS);
+    if (scene == nullptr)
+        throw std::runtime_error("fail to load the model using assimp");
+
+    auto storage = std::make_shared<GeometryStorage>();
+    MeshData meshData = { .name = scene->mRootNode->mName.C_Str() };
+
+    for (aiMesh* aiMesh : std::span(scene->mMeshes, scene->mNumMeshes))
+    {
+        const auto aiVtxToVtx = [aiMesh](uint32_t i) -> Vertex {
+            return Vertex{
+                .pos = glm::vec3(aiMesh->mVertices[i].x, aiMesh->mVertices[i].y, aiMesh->mVertices[i].z),
+                .uv = aiMesh->mTextureCoords[0] != nullptr ? glm::vec2(aiMesh->mTextureCoords[0][i].x, aiMesh->mTextureCoords[0][i].y) : glm::vec2(0.0f),
+                .normal = aiMesh->mNormals != nullptr ? glm::vec3(aiMesh->mNormals[i].x, aiMesh->mNormals[i].y, aiMesh->mNormals[i].z) : glm::vec3(0.0f),
+                .tangent = aiMesh->mTangents != nullptr ? glm::vec3(aiMesh->mTangents[i].x, aiMesh->mTangents[i].y, aiMesh->mTangents[i].z) : glm::vec3(0.0f)
+            };
+        };
+        const auto aiVtxToIdx = [aiMesh](uint32_t i) -> uint32_t {
+            return aiMesh->mFaces[i / 3].mIndices[i % 3];
+        };
+        storage->vertices.push_back(std::views::iota(0u, aiMesh->mNumVertices) | std::views::transform(aiVtxToVtx) | std::ranges::to<std::vector>());
+        storage->indices.push_back(std::views::iota(0u, aiMesh->mNumFaces * 3) | std::views::transform(aiVtxToIdx) | std::ranges::to<std::vector>());
+        meshData.geometries.push_back(MeshData::Geometry{
+            .name = aiMesh->mName.C_Str(),
+            .vertices = std::span<const Vertex>(storage->vertices.back()),
+            .indices = std::span<const uint32_t>(storage->indices.back())
+        });
+        // .material = materials[aiMesh->mMaterialIndex],
+    }
+
+    // the meshes of a node become siblings, and the children of the node are attached to its first mesh
+    std::function<void(const aiNode*, int32_t, const glm::mat4x4&)> addNode = [&](const aiNode* aiNode, int32_t parent, const glm::mat4x4& additionalTransform) {
+        glm::mat4x4 transform = additionalTransform * toGlmMat4(aiNode->mTransformation);
+
+        if (aiNode->mNumMeshes == 0)
+        {
+            for (const auto* child : std::span(aiNode->mChildren, aiNode->mNumChildren))
+                addNode(child, parent, transform);
+            return;
+        }
+
+        const auto firstNode = static_cast<int32_t>(meshData.nodes.size());
+        for (uint32_t geometry : std::span(aiNode->mMeshes, aiNode->mNumMeshes))
+            meshData.nodes.push_back(MeshData::Node{ .geometry = geometry, .parent = parent, .transform = transform });
+        for (const auto* child : std::span(aiNode->mChildren, aiNode->mNumChildren))
+            addNode(child, firstNode, glm::mat4x4(1.0F));
+    };
+
+    for (uint32_t geometry : std::span(scene->mRootNode->mMeshes, scene->mRootNode->mNumMeshes))
+        meshData.nodes.push_back(MeshData::Node{ .geometry = geometry, .parent = -1, .transform = glm::mat4x4(1.0F) });
+    for (const auto* node : std::span(scene->mRootNode->mChildren, scene->mRootNode->mNumChildren))
+        addNode(node, -1, glm::mat4x4(1.0F));
+
+    const std::filesystem::path sourceDirectory = path.parent_path();
+    for (const std::filesystem::path& openedFile : ioSystem->openedFiles)
+    {
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(openedFile, error) || std::filesystem::equivalent(openedFile, path, error))
+            continue;
+        std::string relativePath = std::filesystem::relative(openedFile, sourceDirectory, error).generic_string();
+        if (error || std::ranges::find(meshData.dependencies, relativePath, &MeshData::Dependency::path) != meshData.dependencies.end())
+            continue;
+        meshData.dependencies.push_back(MeshData::Dependency{
+            .path = std::move(relativePath),
+            .hash = hashBytes(MappedFile(openedFile).bytes())
+        });
+    }
+
+    meshData.storage = std::move(storage);
+    return meshData;
+}
+
+MeshData cookMesh(const MeshData& meshData, const MeshCookOptions& options)
+{
+    auto storage = std::make_shared<GeometryStorage>();
+    MeshData cooked = {
+        .name = meshData.name,
+        .nodes = meshData.nodes,
+        .dependencies = meshData.dependencies,
+    };
+    cooked.geometries.reserve(meshData.geometries.size());
+    storage->vertices.reserve(meshData.geometries.size());
+    storage->packedVertices.reserve(meshData.geometries.size());
+    storage->indices.reserve(meshData.geometries.size());
+
+    for (const MeshData::Geometry& geometry : meshData.geometries)
+    {
+        MeshData::Geometry& cookedGeometry = cooked.geometries.emplace_back(MeshData::Geometry{ .name = geometry.name });
+
+        std::vector<Vertex> vertices = std::visit([&](auto span) {
+            if constexpr (std::is_same_v<typename decltype(span)::value_type, PackedVertex>)
+                return span | std::views::transform([&](const PackedVertex& v) { return unpackVertex(v, geometry.positionQuantization); }) | std::ranges::to<std::vector>();
+            else
+                return std::vector<Vertex>(span.begin(), span.end());
+        }, geometry.vertices);
+
+        std::vector<uint32_t> indices(geometry.indices.begin(), geometry.indices.end());
+
+        if (options.optimize)
+        {
+            std::vector<uint32_t> clusters;
+            indices = optimizeVertexCache(indices, static_cast<uint32_t>(vertices.size()), &clusters);
+            indices = optimizeOverdraw(indices, vertices, clusters);
+        }
+
+        // each level is simplified from the previous one, which has fewer triangles to collapse than the full
+        // detail geometry, the error of a level adds up the errors of the levels it was simplified from
+        const BoundingSphere sphere = boundingSphere(vertices);
+        const float maxError = options.lodMaxError * sphere.radius;
+        std::vector<std::vector<uint32_t>> lodIndices;
+        std::vector<float> lodErrors;
+        for (uint32_t level = 1; level <= options.lodCount; level++)
+        {
+            const std::vector<uint32_t>& previous = lodIndices.empty() ? indices : lodIndices.back();
+            const float previousError = lodErrors.empty() ? 0.0f : lodErrors.back();
+            if (previousError >= maxError)
+                break;
+            const size_t targetIndexCount = static_cast<size_t>(static_cast<double>(indices.size()) * std::pow(options.lodReduction, level)) / 3 * 3;
+            float error = 0.0f;
+            std::vector<uint32_t> simplified = simplifyMesh(previous, vertices, targetIndexCount, maxError - previousError, &error);
+            if (simplified.empty() || simplified.size() > previous.size() - previous.size() / 8)
+                break; // not worth a level
+            if (options.optimize)
+                simplified = optimizeVertexCache(simplified, static_cast<uint32_t>(vertices.size()));
+            lodIndices.push_back(std::move(simplified));
+            lodErrors.push_back(previousError + error);
+        }
+
+        if (options.optimize)
+        {
+            // the levels share the vertices, so they are reordered for all the index lists at once
+            std::vector<uint32_t> allIndices = indices;
+            for (const std::vector<uint32_t>& lod : lodIndices)
+                allIndices.insert(allIndices.end(), lod.begin(), lod.end());
+            vertices = optimizeVertexFetch(vertices, allIndices);
+            auto it = allIndices.begin() + static_cast<std::ptrdiff_t>(indices.size());
+            std::copy(allIndices.begin(), it, indices.begin());
+            for (std::vector<uint32_t>& lod : lodIndices)
+            {
+                std::copy_n(it, lod.size(), lod.begin());
+                it += static_cast<std::ptrdiff_t>(lod.size());
+            }
+        }
+        cookedGeometry.boundingSphere = sphere;
+        cookedGeometry.boundingBox = boundingBox(vertices);
+
+        switch (options.vertexFormat)
+        {
+        case VertexFormat::full:
+            cookedGeometry.vertices = std::span<const Vertex>(storage->vertices.emplace_back(std::move(vertices)));
+            break;
+        case VertexFormat::packed:
+            cookedGeometry.positionQuantization = positionQuantization(vertices);
+            cookedGeometry.vertices = std::span<const PackedVertex>(storage->packedVertices.emplace_back(
+                vertices | std::views::transform([&](const Vertex& v) { return packVertex(v, cookedGeometry.positionQuantization); }) | std::ranges::to<std::vector>()));
+            break;
+        }
+
+        cookedGeometry.indices = storage->indices.emplace_back(std::move(indices));
+        for (size_t i = 0; i < lodIndices.size(); i++)
+            cookedGeometry.lods.push_back(MeshData::Lod{ .indices = storage->indices.emplace_back(std::move(lodIndices[i])), .error = lodErrors[i] });
+    }
+
+    cooked.storage = std::move(storage);
+    return cooked;
+}
+
+uint64_t cookedMeshKey(std::span<const std::byte> sourceContent, const MeshCookOptions& options)
+{
+    uint64_t settings = hashCombine(COOKED_MESH_VERSION, POST_PROCESSING_FLAGS);
+    settings = hashCombine(settings, sizeof(Vertex));
+    settings = hashCombine(settings, static_cast<uint64_t>(options.vertexFormat));
+    settings = hashCombine(settings, options.optimize);
+    settings = hashCombine(settings, options.lodCount);
+    settings = hashCombine(settings, std::bit_cast<uint32_t>(options.lodReduction));
+    settings = hashCombine(settings, std::bit_cast<uint32_t>(options.lodMaxError));
+    return hashBytes(sourceContent, settings);
+}
+
+std::optional<MeshData> readCookedMesh(const std::filesystem::path& path, uint64_t key)
+{
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error))
+        return std::nullopt;
+
+    std::shared_ptr<MappedFile> mappedFile;
+    try {
+        mappedFile = std::make_shared<MappedFile>(path);
+    }
+    catch (const std::runtime_error&) {
+        return std::nullopt;
+    }
+    const std::span<const std::byte> file = mappedFile->bytes();
+    return readCookedMesh(file, std::move(mappedFile), key);
+}
+
+std::optional<MeshData> readCookedMesh(std::span<const std::byte> file, std::shared_ptr<const void> storage, uint64_t key)
+{
+    const auto* header = readRecords<CookedMeshHeader>(file, 0, 1);
+    if (header == nullptr
+        || header->magic != COOKED_MESH_MAGIC
+        || header->version != COOKED_MESH_VERSION
+        || header->key != key
+        || header->fileSize != file.size()
+        || header->vertexSize != sizeof(Vertex)
+        || !isValidBlob<char>(file, header->stringsOffset, header->stringsSize)
+        || header->nameLength > header->stringsSize)
+        return std::nullopt;
+
+    const auto* geometries = readRecords<CookedGeometry>(file, sizeof(CookedMeshHeader), header->geometryCount);
+    const auto* nodes = readRecords<CookedNode>(file, sizeof(CookedMeshHeader) + sizeof(CookedGeometry) * header->geometryCount, header->nodeCount);
+    const auto* dependencies = readRecords<CookedDependency>(file, sizeof(CookedMeshHeader) + sizeof(CookedGeometry) * header->geometryCount + sizeof(CookedNode) * header->nodeCount, header->dependencyCount);
+    const auto* lods = readRecords<CookedLod>(file, sizeof(CookedMeshHeader) + sizeof(CookedGeometry) * header->geometryCount + sizeof(CookedNode) * header->nodeCount + sizeof(CookedDependency) * header->dependencyCount, header->lodCount);
+    if (geometries == nullptr || nodes == nullptr || dependencies == nullptr || lods == nullptr)
+        return std::nullopt;
+
+    const auto strings = std::string_view(reinterpret_cast<const char*>(file.data() + header->stringsOffset), header->stringsSize);
+
+    MeshData meshData = { .name = std::string(strings.substr(0, header->nameLength)) };
+    meshData.geometries.reserve(header->geometryCount);
+    for (const CookedGeometry& geometry : std::span(geometries, header->geometryCount))
+    {
+        if (geometry.nameOffset > strings.size() || geometry.nameLength > strings.size() - geometry.nameOffset)
+            return std::nullopt;
+
+        MeshData::Geometry& added = meshData.geometries.emplace_back(MeshData::Geometry{
+            .name = std::string(strings.substr(geometry.nameOffset, geometry.nameLength)),
+            .positionQuantization = {
+                .scale = glm::vec3(geometry.positionScale[0], geometry.positionScale[1], geometry.positionScale[2]),
+                .offset = glm::vec3(geometry.positionOffset[0], geometry.positionOffset[1], geometry.positionOffset[2])
+            },
+            .boundingSphere = {
+                .center = glm::vec3(geometry.boundingSphere[0], geometry.boundingSphere[1], geometry.boundingSphere[2]),
+                .radius = geometry.boundingSphere[3]
+            },
+            .boundingBox = {
+                .min = glm::vec3(geometry.boundingBox[0], geometry.boundingBox[1], geometry.boundingBox[2]),
+                .max = glm::vec3(geometry.boundingBox[3], geometry.boundingBox[4], geometry.boundingBox[5])
+            }
+        });
+
+        if (geometry.vertexFormat == static_cast<uint8_t>(VertexFormat::full) && isValidBlob<Vertex>(file, geometry.vertexOffset, geometry.vertexCount))
+            added.vertices = std::span(reinterpret_cast<const Vertex*>(file.data() + geometry.vertexOffset), geometry.vertexCount);
+        else if (geometry.vertexFormat == static_cast<uint8_t>(VertexFormat::packed) && isValidBlob<PackedVertex>(file, geometry.vertexOffset, geometry.vertexCount))
+            added.vertices = std::span(reinterpret_cast<const PackedVertex*>(file.data() + geometry.vertexOffset), geometry.vertexCount);
+        else
+            return std::nullopt;
+
+        const auto readIndices = [&](uint64_t offset, uint32_t count) -> std::optional<std::span<const uint32_t>> {
+            if (isValidBlob<uint32_t>(file, offset, count))
+                return std::span(reinterpret_cast<const uint32_t*>(file.data() + offset), count);
+            return std::nullopt;
+        };
+
+        std::optional<std::span<const uint32_t>> indices = readIndices(geometry.indexOffset, geometry.indexCount);
+        if (!indices)
+            return std::nullopt;
+        added.indices = *indices;
+
+        if (geometry.firstLod > header->lodCount || geometry.lodCount > header->lodCount - geometry.firstLod)
+            return std::nullopt;
+        for (const CookedLod& lod : std::span(lods + geometry.firstLod, geometry.lodCount))
+        {
+            std::optional<std::span<const uint32_t>> lodIndices = readIndices(lod.indexOffset, lod.indexCount);
+            if (!lodIndices)
+                return std::nullopt;
+            added.lods.push_back(MeshData::Lod{ .indices = *lodIndices, .error = lod.error });
+        }
+    }
+
+    meshData.nodes.reserve(header->nodeCount);
+    for (const CookedNode& node : std::span(nodes, header->nodeCount))
+    {
+        if (node.geometry >= header->geometryCount || node.parent < -1 || node.parent >= static_cast<int32_t>(meshData.nodes.size()))
+            return std::nullopt;
+        MeshData::Node& added = meshData.nodes.emplace_back(MeshData::Node{ .geometry = node.geometry, .parent = node.parent });
+        std::memcpy(&added.transform, node.transform, sizeof(node.transform));
+    }
+
+    meshData.dependencies.reserve(header->dependencyCount);
+    for (const CookedDependency& dependency : std::span(dependencies, header->dependencyCount))
+    {
+        if (dependency.pathOffset > strings.size() || dependency.pathLength > strings.size() - dependency.pathOffset)
+            return std::nullopt;
+        meshData.dependencies.push_back(MeshData::Dependency{
+            .path = std::string(strings.substr(dependency.pathOffset, dependency.pathLength)),
+            .hash = dependency.hash
+        });
+    }
+
+    meshData.storage = std::move(storage);
+    return meshData;
+}
+
+void writeCookedMesh(const std::filesystem::path& path, const MeshData& meshData, uint64_t key)
+{
+    writeFileAtomically(path, serializeCookedMesh(meshData, key));
+}
+
+std::vector<std::byte> serializeCookedMesh(const MeshData& meshData, uint64_t key)
+{
+    std::string strings = meshData.name;
+    std::vector<CookedGeometry> geometries;
+    std::vector<CookedLod> lods;
+    geometries.reserve(meshData.geometries.size());
+    for (const MeshData::Geometry& geometry : meshData.geometries)
+    {
+        geometries.push_back(CookedGeometry{
+            .vertexCount = static_cast<uint32_t>(geometry.vertexCount()),
+            .indexCount = static_cast<uint32_t>(geometry.indexCount()),
+            .nameOffset = static_cast<uint32_t>(strings.size()),
+            .nameLength = static_cast<uint32_t>(geometry.name.size()),
+            .vertexFormat = static_cast<uint8_t>(geometry.vertexFormat()),
+            .padding = {},
+            .positionScale = { geometry.positionQuantization.scale.x, geometry.positionQuantization.scale.y, geometry.positionQuantization.scale.z },
+            .positionOffset = { geometry.positionQuantization.offset.x, geometry.positionQuantization.offset.y, geometry.positionQuantization.offset.z },
+            .firstLod = static_cast<uint32_t>(lods.size()),
+            .lodCount = static_cast<uint32_t>(geometry.lods.size()),
+            .boundingSphere = { geometry.boundingSphere.center.x, geometry.boundingSphere.center.y, geometry.boundingSphere.center.z, geometry.boundingSphere.radius },
+            .boundingBox = { geometry.boundingBox.min.x, geometry.boundingBox.min.y, geometry.boundingBox.min.z, geometry.boundingBox.max.x, geometry.boundingBox.max.y, geometry.boundingBox.max.z }
+        });
+        for (const MeshData::Lod& lod : geometry.lods)
+            lods.push_back(CookedLod{ .indexCount = static_cast<uint32_t>(lod.indices.size()), .error = lod.error });
+        strings += geometry.name;
+    }
+
+    std::vector<CookedNode> nodes;
+    nodes.reserve(meshData.nodes.size());
+    for (const MeshData::Node& node : meshData.nodes)
+    {
+        CookedNode& cookedNode = nodes.emplace_back(CookedNode{ .geometry = node.geometry, .parent = node.parent });
+        std::memcpy(cookedNode.transform, &node.transform, sizeof(cookedNode.transform));
+    }
+
+    std::vector<CookedDependency> dependencies;
+    dependencies.reserve(meshData.dependencies.size());
+    for (const MeshData::Dependency& dependency : meshData.dependencies)
+    {
+        dependencies.push_back(CookedDependency{
+            .hash = dependency.hash,
+            .pathOffset = static_cast<uint32_t>(strings.size()),
+            .pathLength = static_cast<uint32_t>(dependency.path.size())
+        });
+        strings += dependency.path;
+    }
+
+    CookedMeshHeader header = {
+        .magic = COOKED_MESH_MAGIC,
+        .version = COOKED_MESH_VERSION,
+        .key = key,
+        .vertexSize = sizeof(Vertex),
+        .geometryCount = static_cast<uint32_t>(geometries.size()),
+        .nodeCount = static_cast<uint32_t>(nodes.size()),
+        .dependencyCount = static_cast<uint32_t>(dependencies.size()),
+        .nameLength = static_cast<uint32_t>(meshData.name.size()),
+        .lodCount = static_cast<uint32_t>(lods.size()),
+        .stringsOffset = sizeof(CookedMeshHeader) + sizeof(CookedGeometry) * geometries.size() + sizeof(CookedNode) * nodes.size() + sizeof(CookedDependency) * dependencies.size() + sizeof(CookedLod) * lods.size(),
+        .stringsSize = strings.size()
+    };
+
+    size_t fileSize = header.stringsOffset + header.stringsSize;
+    for (size_t i = 0; i < geometries.size(); i++)
+    {
+        geometries[i].vertexOffset = alignUp(fileSize, COOKED_FILE_BLOB_ALIGNMENT);
+        geometries[i].indexOffset = alignUp(geometries[i].vertexOffset + meshData.geometries[i].vertexBytes(), COOKED_FILE_BLOB_ALIGNMENT);
+        fileSize = geometries[i].indexOffset + meshData.geometries[i].indexBytes();
+        for (uint32_t l = 0; l < geometries[i].lodCount; l++)
+        {
+            CookedLod& lod = lods[geometries[i].firstLod + l];
+            lod.indexOffset = alignUp(fileSize, COOKED_FILE_BLOB_ALIGNMENT);
+            fileSize = lod.indexOffset + meshData.geometries[i].lods[l].indices.size_bytes();
+        }
+    }
+    header.fileSize = fileSize;
+
+    std::vector<std::byte> bytes(fileSize);
+    const auto write = [&](size_t offset, std::span<const std::byte> data) {
+        assert(offset + data.size() <= bytes.size());
+        std::ranges::copy(data, bytes.begin() + static_cast<std::ptrdiff_t>(offset));
+    };
+    write(0, std::as_bytes(std::span(&header, 1)));
+    write(sizeof(CookedMeshHeader), std::as_bytes(std::span(geometries)));
+    write(sizeof(CookedMeshHeader) + sizeof(CookedGeometry) * geometries.size(), std::as_bytes(std::span(nodes)));
+    write(sizeof(CookedMeshHeader) + sizeof(CookedGeometry) * geometries.size() + sizeof(CookedNode) * nodes.size(), std::as_bytes(std::span(dependencies)));
+    write(sizeof(CookedMeshHeader) + sizeof(CookedGeometry) * geometries.size() + sizeof(CookedNode) * nodes.size() + sizeof(CookedDependency) * dependencies.size(), std::as_bytes(std::span(lods)));
+    write(header.stringsOffset, std::as_bytes(std::span(strings)));
+    for (size_t i = 0; i < geometries.size(); i++)
+    {
+        std::visit([&](auto span) { write(geometries[i].vertexOffset, std::as_bytes(span)); }, meshData.geometries[i].vertices);
+        write(geometries[i].indexOffset, std::as_bytes(meshData.geometries[i].indices));
+        for (uint32_t l = 0; l < geometries[i].lodCount; l++)
+            write(lods[geometries[i].firstLod + l].indexOffset, std::as_bytes(meshData.geometries[i].lods[l].indices));
+    }
+    return bytes;
+}
+
+MeshData loadMeshData(const std::filesystem::path& path, const std::filesystem::path& cacheDirectory, const MeshCookOptions& options)
+{
+    const MappedFile source(path);
+    return loadMeshData(path, source.bytes(), cacheDirectory, options);
+}
+
+MeshData loadMeshData(const std::filesystem::path& path, std::span<const std::byte> sourceContent, const std::filesystem::path& cacheDirectory, const MeshCookOptions& options)
+{
+    if (cacheDirectory.empty())
+        return cookMesh(importMesh(path, sourceContent), options);
+
+    const uint64_t key = cookedMeshKey(sourceContent, options);
+    const std::filesystem::path cookedPath = cacheDirectory / std::format("{:016x}.gemesh", key);
+
+    const auto isUpToDate = [sourceDirectory = path.parent_path()](const MeshData::Dependency& dependency) {
+        try {
+            return hashBytes(MappedFile(sourceDirectory / dependency.path).bytes()) == dependency.hash;
+        }
+        catch (const std::runtime_error&) {
+            return false;
+        }
+    };
+    if (std::optional<MeshData> cooked = readCookedMesh(cookedPath, key); cooked && std::ranges::all_of(cooked->dependencies, isUpToDate))
+        return *std::move(cooked);
+
+    MeshData meshData = cookMesh(importMesh(path, sourceContent), options);
+    try {
+        std::filesystem::create_directories(cacheDirectory);
+        writeCookedMesh(cookedPath, meshData, key);
+    }
+    catch (const std::exception&) {
+        // the cache is only an optimization, the mesh is still usable
+    }
+    return meshData;
+}
+
+} // namespace GE
@@ -0,0 +1,78 @@
+/*
+ * ---------------------------------------------------
+ * MeshLod.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/MeshLod.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace GE
+{
+
+BoundingSphere boundingSphere(std::span<const Vertex> vertices)
+{
+    if (vertices.empty())
+        return BoundingSphere{};
+
+    // Ritter's bounding sphere, starting from the most distant pair of extreme points along the axes
+    glm::vec3 minPoints[3] = { vertices[0].pos, vertices[0].pos, vertices[0].pos };
+    glm::vec3 maxPoints[3] = { vertices[0].pos, vertices[0].pos, vertices[0].pos };
+    for (const Vertex& vertex : vertices)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (vertex.pos[axis] < minPoints[axis][axis])
+                minPoints[axis] = vertex.pos;
+            if (vertex.pos[axis] > maxPoints[axis][axis])
+                maxPoints[axis] = vertex.pos;
+        }
+    }
+    int widestAxis = 0;
+    for (int axis = 1; axis < 3; axis++)
+    {
+        if (glm::distance(minPoints[axis], maxPoints[axis]) > glm::distance(minPoints[widestAxis], maxPoints[widestAxis]))
+            widestAxis = axis;
+    }
+
+    BoundingSphere sphere = {
+        .center = (minPoints[widestAxis] + maxPoints[widestAxis]) * 0.5f,
+        .radius = glm::distance(minPoints[widestAxis], maxPoints[widestAxis]) * 0.5f
+    };
+    for (const Vertex& vertex : vertices)
+    {
+        const float distance = glm::distance(vertex.pos, sphere.center);
+        if (distance > sphere.radius)
+        {
+            const float radius = (sphere.radius + distance) * 0.5f;
+            sphere.center += (vertex.pos - sphere.center) * ((radius - sphere.radius) / distance);
+            sphere.radius = radius;
+        }
+    }
+    return sphere;
+}
+
+float projectionScale(const glm::mat4x4& viewProjectionMatrix)
+{
+    // the second row of the projection only has its y scale, and the rows of the view rotation are unit vectors
+    return glm::length(glm::vec3(viewProjectionMatrix[0][1], viewProjectionMatrix[1][1], viewProjectionMatrix[2][1]));
+}
+
+float projectedSphereRadius(const BoundingSphere& sphere, const glm::mat4x4& modelMatrix, const glm::vec3& cameraPosition, float projectionScale, float viewportHeight)
+{
+    const glm::vec3 center = glm::vec3(modelMatrix * glm::vec4(sphere.center, 1.0f));
+    const float scale = std::max({ glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2])) });
+    const float radius = sphere.radius * scale;
+
+    const glm::vec3 toCenter = center - cameraPosition;
+    const float squaredDistance = glm::dot(toCenter, toCenter);
+    if (squaredDistance <= radius * radius)
+        return std::numeric_limits<float>::infinity();
+    return radius / std::sqrt(squaredDistance - radius * radius) * projectionScale * viewportHeight * 0.5f;
+}
+
+} // namespace GE
@@ -0,0 +1,528 @@
+/*
+ * ---------------------------------------------------
+ * MeshOptimizer.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/MeshOptimizer.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+
+namespace
+{
+
+constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+class FifoCache
+{
+public:
+    FifoCache(uint32_t vertexCount, uint32_t cacheSize)
+        : m_timestamps(vertexCount, 0), m_cacheSize(cacheSize)
+    {
+    }
+
+    // return true on a cache miss
+    bool access(uint32_t vertex)
+    {
+        if (m_timestamps[vertex] != 0 && m_time - m_timestamps[vertex] < m_cacheSize)
+            return false;
+        m_timestamps[vertex] = ++m_time;
+        return true;
+    }
+
+    void clear() { m_time += m_cacheSize; }
+
+private:
+    std::vector<uint64_t> m_timestamps;
+    uint64_t m_time = 0;
+    uint32_t m_cacheSize;
+};
+
+// sum of squared distances to a set of planes, as a symmetric 4x4 matrix
+struct Quadric
+{
+    double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+    double b0 = 0, b1 = 0, b2 = 0;
+    double c = 0;
+
+    static Quadric plane(const glm::vec3& normal, const glm::vec3& point)
+    {
+        const double d = -glm::dot(normal, point);
+        return Quadric{
+            .a00 = normal.x * normal.x, .a01 = normal.x * normal.y, .a02 = normal.x * normal.z,
+            .a11 = normal.y * normal.y, .a12 = normal.y * normal.z, .a22 = normal.z * normal.z,
+            .b0 = normal.x * d, .b1 = normal.y * d, .b2 = normal.z * d,
+            .c = d * d
+        };
+    }
+
+    Quadric& operator+=(const Quadric& other)
+    {
+        a00 += other.a00; a01 += other.a01; a02 += other.a02;
+        a11 += other.a11; a12 += other.a12; a22 += other.a22;
+        b0 += other.b0; b1 += other.b1; b2 += other.b2;
+        c += other.c;
+        return *this;
+    }
+
+    double evaluate(const glm::vec3& p) const
+    {
+        const double x = p.x, y = p.y, z = p.z;
+        const double result = x * x * a00 + y * y * a11 + z * z * a22
+                            + 2.0 * (x * y * a01 + x * z * a02 + y * z * a12)
+                            + 2.0 * (x * b0 + y * b1 + z * b2)
+                            + c;
+        return std::max(result, 0.0);
+    }
+};
+
+struct Collapse
+{
+    uint32_t from;
+    uint32_t to;
+    double cost;
+};
+
+} // namespace
+
+namespace GE
+{
+
+VertexCacheStatistics analyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+    assert(indices.size() % 3 == 0);
+    if (indices.empty())
+        return VertexCacheStatistics{};
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> used(vertexCount, false);
+    uint32_t usedCount = 0;
+    VertexCacheStatistics statistics;
+    for (uint32_t index : indices)
+    {
+        assert(index < vertexCount);
+        if (cache.access(index))
+            statistics.transformedVertexCount++;
+        if (!used[index])
+        {
+            used[index] = true;
+            usedCount++;
+        }
+    }
+    statistics.acmr = static_cast<float>(statistics.transformedVertexCount) / static_cast<float>(indices.size() / 3);
+    statistics.atvr = static_cast<float>(statistics.transformedVertexCount) / static_cast<float>(usedCount);
+    return statistics;
+}
+
+std::vector<uint32_t> optimizeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, std::vector<uint32_t>* clusters, uint32_t cacheSize)
+{
+    assert(indices.size() % 3 == 0);
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+    if (clusters)
+        clusters->clear();
+    if (triangleCount == 0)
+        return {};
+
+    // vertex -> triangles adjacency, stored as offsets in a flat array
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (uint32_t index : indices)
+        liveTriangles[index]++;
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    std::inclusive_scan(liveTriangles.begin(), liveTriangles.end(), adjacencyOffsets.begin() + 1);
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (uint32_t i = 0; i < indices.size(); i++)
+            adjacency[fill[indices[i]]++] = i / 3;
+    }
+
+    std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnds;
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    uint32_t timestamp = cacheSize + 1;
+    uint32_t cursor = 0;
+    uint32_t fanningVertex = 0;
+    while (fanningVertex < vertexCount && liveTriangles[fanningVertex] == 0)
+        fanningVertex++;
+    if (clusters)
+        clusters->push_back(0);
+
+    std::vector<uint32_t> candidates;
+    while (fanningVertex != INVALID_INDEX)
+    {
+        candidates.clear();
+        for (uint32_t a = adjacencyOffsets[fanningVertex]; a < adjacencyOffsets[fanningVertex + 1]; a++)
+        {
+            const uint32_t triangle = adjacency[a];
+            if (emitted[triangle])
+                continue;
+            for (uint32_t v = 0; v < 3; v++)
+            {
+                const uint32_t vertex = indices[triangle * 3 + v];
+                output.push_back(vertex);
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                if (timestamp - cacheTimestamps[vertex] > cacheSize)
+                    cacheTimestamps[vertex] = timestamp++;
+            }
+            emitted[triangle] = true;
+        }
+
+        // next fanning vertex, prefer the candidate that will still be in cache the longest after its fan is emitted
+        uint32_t next = INVALID_INDEX;
+        int64_t bestPriority = -1;
+        for (uint32_t vertex : candidates)
+        {
+            if (liveTriangles[vertex] == 0)
+                continue;
+            int64_t priority = 0;
+            if (timestamp - cacheTimestamps[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+                priority = timestamp - cacheTimestamps[vertex];
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                next = vertex;
+            }
+        }
+
+        if (next == INVALID_INDEX)
+        {
+            // dead end, the next fan is not cache coherent with the previous one
+            while (!deadEnds.empty() && next == INVALID_INDEX)
+            {
+                const uint32_t vertex = deadEnds.back();
+                deadEnds.pop_back();
+                if (liveTriangles[vertex] > 0)
+                    next = vertex;
+            }
+            while (next == INVALID_INDEX && cursor < vertexCount)
+            {
+                if (liveTriangles[cursor] > 0)
+                    next = cursor;
+                cursor++;
+            }
+            if (clusters && next != INVALID_INDEX)
+                clusters->push_back(static_cast<uint32_t>(output.size() / 3));
+        }
+        fanningVertex = next;
+    }
+
+    assert(output.size() == indices.size());
+    return output;
+}
+
+std::vector<uint32_t> optimizeOverdraw(std::span<const uint32_t> indices, std::span<const Vertex> vertices, std::span<const uint32_t> clusters, float threshold, uint32_t cacheSize)
+{
+    assert(indices.size() % 3 == 0);
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0)
+        return {};
+
+    const auto vertexCount = static_cast<uint32_t>(vertices.size());
+    const float maxAcmr = analyzeVertexCache(indices, vertexCount, cacheSize).acmr * threshold;
+
+    // split the hard clusters where the cache behavior allows it
+    std::vector<uint32_t> softClusters;
+    FifoCache cache(vertexCount, cacheSize);
+    for (uint32_t c = 0; c < clusters.size(); c++)
+    {
+        const uint32_t begin = clusters[c];
+        const uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+        assert(begin < end && end <= triangleCount);
+
+        cache.clear();
+        uint32_t clusterBegin = begin;
+        uint32_t misses = 0;
+        softClusters.push_back(begin);
+        for (uint32_t triangle = begin; triangle < end; triangle++)
+        {
+            for (uint32_t v = 0; v < 3; v++)
+                misses += cache.access(indices[triangle * 3 + v]) ? 1 : 0;
+            const uint32_t clusterSize = triangle + 1 - clusterBegin;
+            if (triangle + 1 < end && static_cast<float>(misses) / static_cast<float>(clusterSize) <= maxAcmr && clusterSize >= cacheSize)
+            {
+                clusterBegin = triangle + 1;
+                misses = 0;
+                cache.clear();
+                softClusters.push_back(clusterBegin);
+            }
+        }
+    }
+
+    // the mesh centroid and the area weighted centroid and normal of each cluster
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    struct Cluster
+    {
+        uint32_t begin;
+        uint32_t end;
+        float sortKey;
+    };
+    std::vector<Cluster> sortedClusters;
+    std::vector<glm::vec3> clusterCentroids;
+    std::vector<glm::vec3> clusterNormals;
+    for (uint32_t c = 0; c < softClusters.size(); c++)
+    {
+        const uint32_t begin = softClusters[c];
+        const uint32_t end = c + 1 < softClusters.size() ? softClusters[c + 1] : triangleCount;
+        glm::vec3 centroid(0.0f);
+        glm::vec3 normal(0.0f);
+        float area = 0.0f;
+        for (uint32_t triangle = begin; triangle < end; triangle++)
+        {
+            const glm::vec3& p0 = vertices[indices[triangle * 3 + 0]].pos;
+            const glm::vec3& p1 = vertices[indices[triangle * 3 + 1]].pos;
+            const glm::vec3& p2 = vertices[indices[triangle * 3 + 2]].pos;
+            const glm::vec3 crossProduct = glm::cross(p1 - p0, p2 - p0);
+            const float triangleArea = glm::length(crossProduct);
+            centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+            normal += crossProduct;
+            area += triangleArea;
+        }
+        meshCentroid += centroid;
+        meshArea += area;
+        clusterCentroids.push_back(area > 0.0f ? centroid / area : centroid);
+        clusterNormals.push_back(glm::length(normal) > 0.0f ? glm::normalize(normal) : normal);
+        sortedClusters.push_back(Cluster{ .begin = begin, .end = end, .sortKey = 0.0f });
+    }
+    if (meshArea > 0.0f)
+        meshCentroid /= meshArea;
+
+    // outward facing clusters far from the center are likely to occlude the others
+    for (uint32_t c = 0; c < sortedClusters.size(); c++)
+        sortedClusters[c].sortKey = glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c]);
+    std::ranges::stable_sort(sortedClusters, [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (const Cluster& cluster : sortedClusters)
+        output.insert(output.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+    return output;
+}
+
+std::vector<Vertex> optimizeVertexFetch(std::span<const Vertex> vertices, std::span<uint32_t> indices)
+{
+    std::vector<uint32_t> remap(vertices.size(), INVALID_INDEX);
+    std::vector<Vertex> output;
+    output.reserve(vertices.size());
+    for (uint32_t& index : indices)
+    {
+        assert(index < vertices.size());
+        if (remap[index] == INVALID_INDEX)
+        {
+            remap[index] = static_cast<uint32_t>(output.size());
+            output.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    return output;
+}
+
+std::vector<uint32_t> simplifyMesh(std::span<const uint32_t> indices, std::span<const Vertex> vertices, size_t targetIndexCount, float targetError, float* resultError)
+{
+    assert(indices.size() % 3 == 0);
+    const auto vertexCount = static_cast<uint32_t>(vertices.size());
+    std::vector<uint32_t> output(indices.begin(), indices.end());
+    float error = 0.0f;
+
+    // an edge used by a single triangle is on the border or on an attribute seam, an edge used by
+    // more than two is non manifold, their vertices are not collapsed to keep the mesh closed
+    std::vector<bool> locked(vertexCount, false);
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        edges.reserve(output.size());
+        for (size_t i = 0; i < output.size(); i += 3)
+        {
+            for (size_t e = 0; e < 3; e++)
+            {
+                const uint32_t a = output[i + e];
+                const uint32_t b = output[i + (e + 1) % 3];
+                edges.emplace_back(std::min(a, b), std::max(a, b));
+            }
+        }
+        std::ranges::sort(edges);
+        for (size_t begin = 0; begin < edges.size();)
+        {
+            size_t end = begin + 1;
+            while (end < edges.size() && edges[end] == edges[begin])
+                end++;
+            if (end - begin != 2)
+            {
+                locked[edges[begin].first] = true;
+                locked[edges[begin].second] = true;
+            }
+            begin = end;
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i < output.size(); i += 3)
+    {
+        const glm::vec3& p0 = vertices[output[i + 0]].pos;
+        const glm::vec3& p1 = vertices[output[i + 1]].pos;
+        const glm::vec3& p2 = vertices[output[i + 2]].pos;
+        const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        if (glm::length(normal) == 0.0f)
+            continue;
+        const Quadric quadric = Quadric::plane(glm::normalize(normal), p0);
+        for (size_t v = 0; v < 3; v++)
+            quadrics[output[i + v]] += quadric;
+    }
+
+    const double maxCost = static_cast<double>(targetError) * static_cast<double>(targetError);
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> neighbors;
+    std::vector<uint32_t> toNeighbors;
+    std::vector<uint32_t> sharedNeighbors;
+
+    const auto triangleNormal = [&](uint32_t triangle, uint32_t replaced, uint32_t replacement) {
+        glm::vec3 p[3];
+        for (uint32_t v = 0; v < 3; v++)
+        {
+            const uint32_t index = output[triangle * 3 + v];
+            p[v] = vertices[index == replaced ? replacement : index].pos;
+        }
+        return glm::cross(p[1] - p[0], p[2] - p[0]);
+    };
+
+    while (output.size() > targetIndexCount)
+    {
+        const auto triangleCount = static_cast<uint32_t>(output.size() / 3);
+
+        // vertex -> triangles adjacency of the current mesh
+        std::ranges::fill(adjacencyOffsets, 0);
+        for (uint32_t index : output)
+            adjacencyOffsets[index + 1]++;
+        std::inclusive_scan(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+        adjacency.resize(output.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (uint32_t i = 0; i < output.size(); i++)
+                adjacency[fill[output[i]]++] = i / 3;
+        }
+        const auto trianglesOf = [&](uint32_t vertex) {
+            return std::span(adjacency).subspan(adjacencyOffsets[vertex], adjacencyOffsets[vertex + 1] - adjacencyOffsets[vertex]);
+        };
+
+        collapses.clear();
+        for (size_t i = 0; i < output.size(); i += 3)
+        {
+            for (size_t e = 0; e < 3; e++)
+            {
+                const uint32_t a = output[i + e];
+                const uint32_t b = output[i + (e + 1) % 3];
+                Quadric quadric = quadrics[a];
+                quadric += quadrics[b];
+                if (!locked[a])
+                    collapses.push_back(Collapse{ .from = a, .to = b, .cost = quadric.evaluate(vertices[b].pos) });
+                if (!locked[b])
+                    collapses.push_back(Collapse{ .from = b, .to = a, .cost = quadric.evaluate(vertices[a].pos) });
+            }
+        }
+        std::ranges::sort(collapses, {}, &Collapse::cost);
+
+        std::iota(remap.begin(), remap.end(), 0);
+        std::fill(touched.begin(), touched.end(), false);
+        uint32_t removedTriangles = 0;
+        const uint32_t maxRemovedTriangles = triangleCount - static_cast<uint32_t>(targetIndexCount / 3);
+        // a pass only applies collapses whose neighborhoods do not overlap, so their checks stay valid
+        for (const Collapse& collapse : collapses)
+        {
+            if (collapse.cost > maxCost || removedTriangles >= maxRemovedTriangles)
+                break;
+            if (touched[collapse.from] || touched[collapse.to])
+                continue;
+
+            // link condition, the only vertices shared by the neighborhoods are the ones opposite to the edge
+            neighbors.clear();
+            uint32_t sharedTriangles = 0;
+            for (uint32_t triangle : trianglesOf(collapse.from))
+            {
+                bool hasTo = false;
+                for (uint32_t v = 0; v < 3; v++)
+                {
+                    hasTo |= output[triangle * 3 + v] == collapse.to;
+                    neighbors.push_back(output[triangle * 3 + v]);
+                }
+                sharedTriangles += hasTo ? 1 : 0;
+            }
+            std::ranges::sort(neighbors);
+            neighbors.erase(std::ranges::unique(neighbors).begin(), neighbors.end());
+            toNeighbors.clear();
+            for (uint32_t triangle : trianglesOf(collapse.to))
+                toNeighbors.insert(toNeighbors.end(), output.begin() + triangle * 3, output.begin() + triangle * 3 + 3);
+            std::ranges::sort(toNeighbors);
+            toNeighbors.erase(std::ranges::unique(toNeighbors).begin(), toNeighbors.end());
+            sharedNeighbors.clear();
+            std::ranges::set_intersection(neighbors, toNeighbors, std::back_inserter(sharedNeighbors));
+            if (sharedNeighbors.size() != sharedTriangles + 2) // `from` and `to` are in both
+                continue;
+
+            // the remaining triangles around `from` must not flip
+            bool flips = false;
+            for (uint32_t triangle : trianglesOf(collapse.from))
+            {
+                const uint32_t* triangleIndices = &output[triangle * 3];
+                if (triangleIndices[0] == collapse.to || triangleIndices[1] == collapse.to || triangleIndices[2] == collapse.to)
+                    continue;
+                const glm::vec3 before = triangleNormal(triangle, collapse.from, collapse.from);
+                const glm::vec3 after = triangleNormal(triangle, collapse.from, collapse.to);
+                if (glm::dot(before, after) <= 0.0f)
+                {
+                    flips = true;
+                    break;
+                }
+            }
+            if (flips)
+                continue;
+
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            for (uint32_t vertex : neighbors)
+                touched[vertex] = true;
+            removedTriangles += sharedTriangles;
+            error = std::max(error, static_cast<float>(std::sqrt(collapse.cost)));
+        }
+        if (removedTriangles == 0)
+            break;
+
+        // apply the collapses and drop the triangles that became degenerate
+        size_t written = 0;
+        for (size_t i = 0; i < output.size(); i += 3)
+        {
+            const uint32_t a = remap[output[i + 0]];
+            const uint32_t b = remap[output[i + 1]];
+            const uint32_t c = remap[output[i + 2]];
+            if (a == b || b == c || c == a)
+                continue;
+            output[written++] = a;
+            output[written++] = b;
+            output[written++] = c;
+        }
+        output.resize(written);
+    }
+
+    if (resultError)
+        *resultError = error;
+    return output;
+}
+
+} // namespace GE
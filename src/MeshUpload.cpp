@@ -0,0 +1,113 @@
+/*
+ * ---------------------------------------------------
+ * MeshUpload.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "MeshUpload.hpp"
+
+#include <glm/glm.hpp>
+
+#include <functional>
+#include <utility>
+#include <variant>
+
+namespace GE
+{
+
+std::shared_ptr<gfx::Buffer> newIndexBuffer(gfx::Device& device, gfx::CommandBuffer& commandBuffer, std::span<const uint32_t> indices, uint32_t vertexOffset)
+{
+    return newDeviceLocalBuffer(device, commandBuffer, gfx::BufferUsage::indexBuffer, indices | std::views::transform([vertexOffset](uint32_t i) { return i + vertexOffset; }));
+}
+
+SubMesh newSubMesh(gfx::Device& device, GeometryPool& geometryPool, gfx::CommandBuffer& commandBuffer, const MeshData::Geometry& geometry, bool coarsestLevelOnly)
+{
+    assert(geometry.indexCount() <= UINT32_MAX);
+    std::shared_ptr<const GeometryPool::Allocation> vertexAllocation = std::visit([&](auto vertices) { return geometryPool.allocateVertices(vertices); }, geometry.vertices);
+    assert(vertexAllocation);
+    const uint32_t vertexOffset = vertexAllocation->offset;
+
+    const auto isUploaded = [&](size_t level) { return coarsestLevelOnly == false || level == geometry.lods.size(); };
+
+    std::shared_ptr<gfx::Buffer> indexBuffer = isUploaded(0) ? newIndexBuffer(device, commandBuffer, geometry.indices, vertexOffset) : nullptr;
+
+    std::vector<SubMesh::Lod> lods = std::views::iota(size_t(0), geometry.lods.size())
+                                     | std::views::transform([&](size_t i) {
+                                           const MeshData::Lod& lod = geometry.lods[i];
+                                           return SubMesh::Lod{
+                                               .indexBuffer = isUploaded(i + 1) ? newIndexBuffer(device, commandBuffer, lod.indices, vertexOffset) : nullptr,
+                                               .indexCount = static_cast<uint32_t>(lod.indices.size()),
+                                               .error = lod.error
+                                           };
+                                       })
+                                     | std::ranges::to<std::vector>();
+
+    return SubMesh{
+        .name = geometry.name,
+        .transform = glm::mat4x4(1.0f),
+        .vertexBuffer = vertexAllocation->buffer,
+        .indexBuffer = std::move(indexBuffer),
+        .vertexOffset = vertexOffset,
+        .vertexCount = vertexAllocation->count,
+        .indexCount = static_cast<uint32_t>(geometry.indexCount()),
+        .vertexFormat = geometry.vertexFormat(),
+        .positionQuantization = geometry.positionQuantization,
+        .lods = std::move(lods),
+        .boundingSphere = geometry.boundingSphere,
+        .boundingBox = geometry.boundingBox,
+        .vertexAllocation = std::move(vertexAllocation),
+        .subMeshes = {}
+    };
+}
+
+Mesh newMesh(gfx::Device& device, GeometryPool& geometryPool, gfx::CommandBuffer& commandBuffer, const MeshData& meshData, bool coarsestLevelOnly, std::vector<uint32_t>* subMeshGeometries)
+{
+    commandBuffer.beginBlitPass();
+    auto flatSubMeshes = meshData.geometries
+                         | std::views::transform([&](const MeshData::Geometry& geometry) {
+                               return newSubMesh(device, geometryPool, commandBuffer, geometry, coarsestLevelOnly);
+                           })
+                         | std::ranges::to<std::vector>();
+    geometryPool.upload(commandBuffer, flatSubMeshes | std::views::transform(&SubMesh::vertexAllocation) | std::ranges::to<std::vector>());
+    commandBuffer.endBlitPass();
+
+    std::vector<std::vector<uint32_t>> children(meshData.nodes.size());
+    std::vector<uint32_t> roots;
+    for (uint32_t i = 0; i < meshData.nodes.size(); i++)
+    {
+        int32_t parent = meshData.nodes[i].parent;
+        (parent < 0 ? roots : children[parent]).push_back(i);
+    }
+
+    std::function<SubMesh(uint32_t)> nodeToSubMesh = [&](uint32_t i) -> SubMesh {
+        SubMesh submesh = flatSubMeshes[meshData.nodes[i].geometry];
+        submesh.transform = meshData.nodes[i].transform;
+        if (subMeshGeometries != nullptr)
+            subMeshGeometries->push_back(meshData.nodes[i].geometry);
+        submesh.subMeshes = children[i] | std::views::transform(nodeToSubMesh) | std::ranges::to<std::vector>();
+        return submesh;
+    };
+
+    Mesh mesh = {
+        .name = meshData.name,
+        .subMeshes = roots | std::views::transform(nodeToSubMesh) | std::ranges::to<std::vector>()
+    };
+    mesh.boundingBox = meshBoundingBox(mesh.subMeshes);
+    return mesh;
+}
+
+BoundingBox meshBoundingBox(const std::vector<SubMesh>& subMeshes, const glm::mat4x4& transform)
+{
+    BoundingBox box;
+    for (const SubMesh& submesh : subMeshes)
+    {
+        const glm::mat4x4 submeshTransform = transform * submesh.transform;
+        box.expand(transformBoundingBox(submesh.boundingBox, submeshTransform));
+        box.expand(meshBoundingBox(submesh.subMeshes, submeshTransform));
+    }
+    return box;
+}
+
+} // namespace GE
@@ -0,0 +1,74 @@
+/*
+ * ---------------------------------------------------
+ * MeshUpload.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Creation of the GPU resources of a mesh from its CPU side data, shared
+ * by the AssetManager and the AssetStreamer. Except for newMesh, the copies
+ * are recorded in a blit pass the caller begins and ends.
+ *
+ */
+
+#ifndef MESHUPLOAD_HPP
+#define MESHUPLOAD_HPP
+
+#include "Game-Engine/GeometryPool.hpp"
+#include "Game-Engine/Mesh.hpp"
+#include "Game-Engine/MeshData.hpp"
+
+#include <Graphics/Buffer.hpp>
+#include <Graphics/CommandBuffer.hpp>
+#include <Graphics/Device.hpp>
+#include <Graphics/Enums.hpp>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <ranges>
+#include <vector>
+
+namespace GE
+{
+
+std::shared_ptr<gfx::Buffer> newDeviceLocalBuffer(gfx::Device& device, gfx::CommandBuffer& commandBuffer, gfx::BufferUsage usage, const std::ranges::sized_range auto& data)
+{
+    std::shared_ptr<gfx::Buffer> buffer = device.newBuffer(gfx::Buffer::Descriptor{
+        .size = sizeof(std::ranges::range_value_t<decltype(data)>) * data.size(),
+        .usages = usage | gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::deviceLocal });
+    assert(buffer);
+
+    std::shared_ptr<gfx::Buffer> stagingBuffer = device.newBuffer(gfx::Buffer::Descriptor{
+        .size = buffer->size(),
+        .usages = gfx::BufferUsage::copySource,
+        .storageMode = gfx::ResourceStorageMode::hostVisible });
+    assert(stagingBuffer);
+
+    std::ranges::copy(data, stagingBuffer->content<std::ranges::range_value_t<decltype(data)>>());
+
+    commandBuffer.copyBufferToBuffer(stagingBuffer, buffer, buffer->size());
+
+    return buffer;
+}
+
+// the indices are widened since they are rebased in the pool page which can be larger than 65536 vertices
+std::shared_ptr<gfx::Buffer> newIndexBuffer(gfx::Device&, gfx::CommandBuffer&, std::span<const uint32_t> indices, uint32_t vertexOffset);
+
+// with `coarsestLevelOnly` only the index buffer of the coarsest level of detail is created,
+// the others are left null for the AssetStreamer, the vertices are left to GeometryPool::upload
+SubMesh newSubMesh(gfx::Device&, GeometryPool&, gfx::CommandBuffer&, const MeshData::Geometry&, bool coarsestLevelOnly = false);
+
+// `subMeshGeometries` receives the geometry index of each submesh of the tree, in depth first order
+Mesh newMesh(gfx::Device&, GeometryPool&, gfx::CommandBuffer&, const MeshData&, bool coarsestLevelOnly = false, std::vector<uint32_t>* subMeshGeometries = nullptr);
+
+// of the submeshes and their children, in the space `transform` transforms to
+BoundingBox meshBoundingBox(const std::vector<SubMesh>&, const glm::mat4x4& transform = glm::mat4x4(1.0f));
+
+} // namespace GE
+
+#endif // MESHUPLOAD_HPP
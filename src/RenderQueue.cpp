@@ -0,0 +1,88 @@
+/*
+ * ---------------------------------------------------
+ * RenderQueue.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/RenderQueue.hpp"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <utility>
+
+namespace
+{
+
+constexpr uint32_t RADIX_BITS = 8;
+constexpr uint32_t RADIX_SIZE = 1u << RADIX_BITS;
+constexpr uint32_t PASS_COUNT = 64 / RADIX_BITS;
+
+// the float bits of a positive number sort like the number, the top ones are kept
+uint64_t quantizeDepth(float depth)
+{
+    const float clamped = depth > 0.0f ? depth : 0.0f; // nan included
+    return std::bit_cast<uint32_t>(clamped) >> (32 - GE::SORT_KEY_DEPTH_BITS);
+}
+
+} // namespace
+
+namespace GE
+{
+
+uint64_t makeSortKey(uint32_t pipeline, uint32_t material, uint32_t geometry, float depth)
+{
+    assert(pipeline < (1u << SORT_KEY_PIPELINE_BITS));
+    assert(material < (1u << SORT_KEY_MATERIAL_BITS));
+    assert(geometry < (1u << SORT_KEY_GEOMETRY_BITS));
+
+    uint64_t key = pipeline;
+    key = (key << SORT_KEY_MATERIAL_BITS) | material;
+    key = (key << SORT_KEY_GEOMETRY_BITS) | geometry;
+    key = (key << SORT_KEY_DEPTH_BITS) | quantizeDepth(depth);
+    return key;
+}
+
+void RenderQueue::clear()
+{
+    m_items.clear();
+    m_batches.clear();
+}
+
+void RenderQueue::sort()
+{
+    // least significant byte first, all the histograms are counted in a single read of the keys
+    std::array<std::array<uint32_t, RADIX_SIZE>, PASS_COUNT> histograms = {};
+    for (const Item& item : m_items)
+    {
+        for (uint32_t pass = 0; pass < PASS_COUNT; pass++)
+            histograms[pass][(item.sortKey >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+    }
+
+    m_scratchItems.resize(m_items.size());
+    for (uint32_t pass = 0; pass < PASS_COUNT; pass++)
+    {
+        std::array<uint32_t, RADIX_SIZE>& histogram = histograms[pass];
+        if (m_items.empty() || histogram[(m_items.front().sortKey >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)] == m_items.size())
+            continue; // the byte is the same for all the keys, most of them for the few pipelines and materials
+
+        uint32_t offset = 0;
+        for (uint32_t& count : histogram)
+            offset += std::exchange(count, offset);
+        for (const Item& item : m_items)
+            m_scratchItems[histogram[(item.sortKey >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++] = item;
+        std::swap(m_items, m_scratchItems);
+    }
+
+    m_batches.clear();
+    for (uint32_t i = 0; i < m_items.size(); i++)
+    {
+        if (m_batches.empty() || sortKeyBatch(m_items[i].sortKey) != sortKeyBatch(m_items[m_batches.back().firstItem].sortKey))
+            m_batches.push_back({ .firstItem = i, .itemCount = 0 });
+        m_batches.back().itemCount++;
+    }
+}
+
+} // namespace GE
@@ -9,6 +9,8 @@
 
 #include "Game-Engine/Renderer.hpp"
 #include "Game-Engine/FrameGraph.hpp"
+#include "Game-Engine/FrameResources.hpp"
+#include "Game-Engine/FunctionRef.hpp"
 #include "Game-Engine/Mesh.hpp"
 
 #include <Graphics/CommandBuffer.hpp>
@@ -22,14 +24,39 @@
 #include <cassert>
 #include <cstddef>
 #include <cstring>
-#include <map>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <print>
 #include <string>
 #include <utility>
 #include <vector>
-#include <ranges>
+
+namespace
+{
+
+// rewritten in place so the attachments keep their memory, `loadAction` replaces the ones of the pass
+void updateFramebuffer(gfx::Framebuffer& framebuffer, const GE::FramePass& framePass, const GE::FrameGraph::CompiledPass& compiledPass,
+                       const GE::FrameResources& resources, std::optional<gfx::LoadAction> loadAction)
+{
+    framebuffer.colorAttachments.clear();
+    for (size_t i = 0; i < framePass.colorAttachments.size(); i++)
+    {
+        framebuffer.colorAttachments.push_back(gfx::Framebuffer::Attachment{
+            .loadAction = loadAction.value_or(framePass.colorAttachments[i].loadAction),
+            .clearColor = framePass.colorAttachments[i].clearColor,
+            .texture = resources.texture(compiledPass.colorAttachments[i])
+        });
+    }
+    framebuffer.depthAttachment = framePass.depthAttachment
+                                      ? std::make_optional(gfx::Framebuffer::Attachment{
+                                            .loadAction = loadAction.value_or(framePass.depthAttachment->loadAction),
+                                            .clearDepth = framePass.depthAttachment->clearDepth,
+                                            .texture = resources.texture(*compiledPass.depthAttachment) })
+                                      : std::nullopt;
+}
+
+} // namespace
 
 namespace GE
 {
@@ -41,7 +68,10 @@ Renderer::Renderer(gfx::Device* device, gfx::Surface* surface)
         .bindings = {
             { .type = gfx::BindingType::constantBuffer,   .usages = gfx::BindingUsage::vertexRead | gfx::BindingUsage::fragmentRead },
             { .type = gfx::BindingType::structuredBuffer, .usages = gfx::BindingUsage::vertexRead | gfx::BindingUsage::fragmentRead },
-            { .type = gfx::BindingType::structuredBuffer, .usages = gfx::BindingUsage::vertexRead | gfx::BindingUsage::fragmentRead }
+            { .type = gfx::BindingType::structuredBuffer, .usages = gfx::BindingUsage::vertexRead | gfx::BindingUsage::fragmentRead },
+            { .type = gfx::BindingType::structuredBuffer, .usages = gfx::BindingUsage::vertexRead },
+            { .type = gfx::BindingType::structuredBuffer, .usages = gfx::BindingUsage::fragmentRead },
+            { .type = gfx::BindingType::structuredBuffer, .usages = gfx::BindingUsage::fragmentRead }
         }
     });
     m_materialBlockLayout = m_device->newParameterBlockLayout({
@@ -52,196 +82,201 @@ Renderer::Renderer(gfx::Device* device, gfx::Surface* surface)
 
     auto shaderLib = m_device->newShaderLib(SHADER_DIR"/flat_color.slib");
 
-    m_gfxPipeline = m_device->newGraphicsPipeline(gfx::GraphicsPipeline::Descriptor{
-        .vertexLayout = gfx::VertexLayout{
-            .stride = sizeof(Vertex),
-            .attributes = {
-                gfx::VertexAttribute{
-                    .format = gfx::VertexAttributeFormat::float3,
-                    .offset = offsetof(Vertex, pos)},
-                gfx::VertexAttribute{
-                    .format = gfx::VertexAttributeFormat::float3,
-                    .offset = offsetof(Vertex, normal)},
+    const auto newGfxPipeline = [&](VertexFormat vertexFormat, const char* vertexShader) {
+        m_gfxPipelines[vertexFormat] = m_device->newGraphicsPipeline(gfx::GraphicsPipeline::Descriptor{
+            .vertexLayout = vertexLayout(vertexFormat),
+            .vertexShader = &shaderLib->getFunction(vertexShader),
+            .fragmentShader = &shaderLib->getFunction("fragmentMain"),
+            .colorAttachmentPxFormats = {gfx::PixelFormat::BGRA8Unorm},
+            .depthAttachmentPxFormat = gfx::PixelFormat::Depth32Float,
+            .blendOperation = gfx::BlendOperation::blendingOff,
+            .cullMode = gfx::CullMode::back,
+            .parameterBlockLayouts = {
+                m_frameDataBlockLayout,
+                m_materialBlockLayout
             }
-        },
-        .vertexShader = &shaderLib->getFunction("vertexMain"),
-        .fragmentShader = &shaderLib->getFunction("fragmentMain"),
-        .colorAttachmentPxFormats = {gfx::PixelFormat::BGRA8Unorm},
-        .depthAttachmentPxFormat = gfx::PixelFormat::Depth32Float,
-        .blendOperation = gfx::BlendOperation::blendingOff,
-        .cullMode = gfx::CullMode::back,
-        .parameterBlockLayouts = {
-            m_frameDataBlockLayout,
-            m_materialBlockLayout
-        }
-    });
+        });
+    };
+    newGfxPipeline(VertexFormat::full, "vertexMain");
+    newGfxPipeline(VertexFormat::packed, "vertexMainPacked");
 
+    const gfx::ParameterBlockPool::Descriptor parameterBlockPoolDescriptor = {
+        .maxBindingCount = {
+            {gfx::BindingType::constantBuffer, 2},
+            {gfx::BindingType::structuredBuffer, 5},
+        }
+    };
     for (auto& inFlightData : m_inFlightDatas)
     {
         inFlightData.commandBufferPool = m_device->newCommandBufferPool();
         assert(inFlightData.commandBufferPool);
 
-        inFlightData.parameterBlockPool = m_device->newParameterBlockPool({
-            .maxBindingCount = {
-                {gfx::BindingType::constantBuffer, 2},
-                {gfx::BindingType::structuredBuffer, 2},
-            }
-        });
+        inFlightData.parameterBlockPool = m_device->newParameterBlockPool(parameterBlockPoolDescriptor);
         assert(inFlightData.parameterBlockPool);
+
+        inFlightData.resources = std::make_unique<FrameResources>(m_device);
+
+        for (uint32_t i = 0; i < m_jobSystem.threadCount(); i++)
+        {
+            ThreadPools& pools = inFlightData.jobPools.emplace_back();
+            pools.commandBufferPool = m_device->newCommandBufferPool();
+            pools.parameterBlockPool = m_device->newParameterBlockPool(parameterBlockPoolDescriptor);
+            assert(pools.commandBufferPool && pools.parameterBlockPool);
+        }
     }
 
 }
 
 void Renderer::renderFrame(const FrameGraph& frameGraph)
 {
-    if (cfd.waitedCmdBuffer != nullptr)
+    if (cfd.commandBuffers.empty() == false)
     {
-        m_device->waitCommandBuffer(*cfd.waitedCmdBuffer);
-        cfd.waitedCmdBuffer = nullptr;
+        for (const std::shared_ptr<gfx::CommandBuffer>& submittedCommandBuffer : cfd.commandBuffers)
+            m_device->waitCommandBuffer(*submittedCommandBuffer);
+        cfd.commandBuffers.clear();
         cfd.commandBufferPool->reset();
         cfd.parameterBlockPool->reset();
-    }
-
-    std::map<std::string, std::shared_ptr<gfx::Texture>> textureMap;
-    std::map<gfx::Texture::Descriptor, std::set<std::shared_ptr<gfx::Texture>>> newTextureCache;
-    for (auto& [textureName, textureDescriptor] : frameGraph.textureDescriptors())
-    {
-        if (textureName == frameGraph.backBufferName() && (m_swapchain == nullptr || m_swapchain->drawablesTextureDescriptor() != textureDescriptor))
-        {
-            gfx::Swapchain::Descriptor swapchainDescriptor = {
-                .surface = m_surface,
-                .width = textureDescriptor.width,
-                .height = textureDescriptor.height,
-                .imageCount = 3,
-                .drawableCount = maxFrameInFlight,
-                .pixelFormat = textureDescriptor.pixelFormat,
-                .presentMode = gfx::PresentMode::fifo,
-            };
-            // std::println("recreating swapchain with size w:{}, h:{}", swapchainDescriptor.width, swapchainDescriptor.height);
-            m_device->waitIdle();
-            m_swapchain = m_device->newSwapchain(swapchainDescriptor);
-            assert(m_swapchain);
-        }
-        else
+        for (ThreadPools& pools : cfd.jobPools)
         {
-            std::shared_ptr<gfx::Texture> texture;
-            auto it = cfd.textureCache.find(textureDescriptor);
-            if (it == cfd.textureCache.end() || it->second.empty())
-                texture = m_device->newTexture(textureDescriptor);
-            else
-                texture = it->second.extract(it->second.begin()).value();
-            auto [_, inserted] = textureMap.insert(std::make_pair(textureName, texture));
-            assert(inserted);
-            newTextureCache[textureDescriptor].insert(texture);
+            pools.commandBufferPool->reset();
+            pools.parameterBlockPool->reset();
         }
     }
+    cfd.frameAllocator.reset();
 
-    std::map<std::string, std::shared_ptr<gfx::Buffer>> bufferMap;
-    std::map<gfx::Buffer::Descriptor, std::set<std::shared_ptr<gfx::Buffer>>> newBufferCache;
-    for (auto& [bufferName, bufferDescriptor] : frameGraph.constantBufferDescriptors())
+    auto backBufferDescriptor = frameGraph.textureDescriptors().find(frameGraph.backBufferName());
+    if (backBufferDescriptor != frameGraph.textureDescriptors().end() && frameGraph.lifetimes().contains(frameGraph.backBufferName())
+        && (m_swapchain == nullptr || m_swapchain->drawablesTextureDescriptor() != backBufferDescriptor->second))
     {
-        std::shared_ptr<gfx::Buffer> buffer;
-        auto it = cfd.bufferCache.find(bufferDescriptor);
-        if (it == cfd.bufferCache.end() || it->second.empty())
-            buffer = m_device->newBuffer(bufferDescriptor);
-        else
-            buffer = it->second.extract(it->second.begin()).value();
-        auto [_, inserted] = bufferMap.insert(std::make_pair(bufferName, buffer));
-        assert(inserted);
-        newBufferCache[bufferDescriptor].insert(buffer);
+        const gfx::Texture::Descriptor& textureDescriptor = backBufferDescriptor->second;
+        gfx::Swapchain::Descriptor swapchainDescriptor = {
+            .surface = m_surface,
+            .width = textureDescriptor.width,
+            .height = textureDescriptor.height,
+            .imageCount = 3,
+            .drawableCount = maxFrameInFlight,
+            .pixelFormat = textureDescriptor.pixelFormat,
+            .presentMode = gfx::PresentMode::fifo,
+        };
+        // std::println("recreating swapchain with size w:{}, h:{}", swapchainDescriptor.width, swapchainDescriptor.height);
+        m_device->waitIdle();
+        m_swapchain = m_device->newSwapchain(swapchainDescriptor);
+        assert(m_swapchain);
     }
 
-    auto setStructuredBufferContent = [&](const std::string& bufferName, const void* data, uint32_t size) {
-        if (size == 0)
-            return;
-        gfx::Buffer::Descriptor bufferDescriptor = gfx::Buffer::Descriptor{
-            .size = size,
-            .usages = gfx::BufferUsage::structuredBuffer,
-            .storageMode = gfx::ResourceStorageMode::hostVisible
-        };
-        std::shared_ptr<gfx::Buffer> buffer;
-        auto it = cfd.bufferCache.find(bufferDescriptor);
-        if (it == cfd.bufferCache.end() || it->second.empty())
-            buffer = m_device->newBuffer(bufferDescriptor);
-        else
-            buffer = it->second.extract(it->second.begin()).value();
-        auto [_, inserted] = bufferMap.insert(std::make_pair(bufferName, buffer));
-        assert(inserted);
-        newBufferCache[bufferDescriptor].insert(buffer);
-        if (data != nullptr)
-            std::memcpy(buffer->content<std::byte>(), data, size);
-    };
+    cfd.resources->prepare(frameGraph);
+
+    const std::vector<FrameGraph::CompiledPass>& compiledPasses = frameGraph.compiledPasses();
+    cfd.framebuffers.resize(compiledPasses.size());
+    cfd.continuedFramebuffers.resize(compiledPasses.size());
 
+    // a pass recording jobs splits the main command buffer, they are submitted in recording order
     std::shared_ptr<gfx::CommandBuffer> commandBuffer = cfd.commandBufferPool->get();
+    cfd.commandBuffers.push_back(commandBuffer);
     std::shared_ptr<gfx::Drawable> drawable;
-    for (auto& framePass : frameGraph.passes())
+    for (size_t position = 0; position < compiledPasses.size(); position++)
     {
-        if (drawable == nullptr /* TODO check if pass uses swapchain image */)
+        const FrameGraph::CompiledPass& compiledPass = compiledPasses[position];
+        const FramePass& framePass = frameGraph.passes()[compiledPass.passIndex];
+
+        // as late as possible, the swapchain may block until an image is available
+        if (compiledPass.acquiresDrawable)
         {
             drawable = m_swapchain->nextDrawable();
             if (drawable == nullptr)
-                return;
-            textureMap[frameGraph.backBufferName()] = drawable->texture();
+                break; // the passes already recorded are still submitted, their resources kept until they are done
+            cfd.resources->setBackBuffer(drawable->texture());
         }
 
         if (framePass.setup)
         {
             FramePassSetupContext setupContext = {
-                .textureMap = textureMap,
-                .constantBuffers = bufferMap,
-                .setStructuredBufferContent = setStructuredBufferContent,
+                .resources = *cfd.resources,
+                .frameAllocator = cfd.frameAllocator,
             };
             framePass.setup(setupContext);
         }
 
-        gfx::Framebuffer framebuffer = gfx::Framebuffer{
-            .colorAttachments = framePass.colorAttachments
-                                | std::views::transform([&](const AttachmentDescriptor& attachment) {
-                                      return gfx::Framebuffer::Attachment{
-                                          .loadAction = attachment.loadAction,
-                                          .clearColor = attachment.clearColor,
-                                          .texture = textureMap.at(attachment.texture)
-                                      };
-                                  })
-                                | std::ranges::to<std::vector>(),
-            .depthAttachment = framePass.depthAttachment
-                                   ? std::make_optional(gfx::Framebuffer::Attachment{
-                                         .loadAction = framePass.depthAttachment->loadAction,
-                                         .clearDepth = framePass.depthAttachment->clearDepth,
-                                         .texture = textureMap.at(framePass.depthAttachment->texture) })
-                                   : std::nullopt
-        };
+        // the command buffers of the jobs continue the render pass without clearing it
+        gfx::Framebuffer& framebuffer = cfd.framebuffers[position];
+        gfx::Framebuffer& continuedFramebuffer = cfd.continuedFramebuffers[position];
+        updateFramebuffer(framebuffer, framePass, compiledPass, *cfd.resources, std::nullopt);
+        updateFramebuffer(continuedFramebuffer, framePass, compiledPass, *cfd.resources, gfx::LoadAction::load);
 
-        for (auto& textureName : framePass.sampledTextures)
-            commandBuffer->addSampledTexture(textureMap.at(textureName));
+        for (TextureHandle sampledTexture : compiledPass.sampledTextures)
+            commandBuffer->addSampledTexture(cfd.resources->texture(sampledTexture));
 
+        m_passRecording = PassRecording{
+            .compiledPass = &compiledPass,
+            .commandBuffer = commandBuffer.get(),
+            .continuedFramebuffer = &continuedFramebuffer
+        };
         commandBuffer->beginRenderPass(framebuffer);
         {
             FramePassExecuteContext framePassContext = {
                 .commandBuffer = *commandBuffer,
                 .parameterBlockPool = *cfd.parameterBlockPool,
-                .textureMap = textureMap,
-                .bufferMap = bufferMap,
+                .resources = *cfd.resources,
                 .frameDataBlockLayout = m_frameDataBlockLayout,
                 .materialBlockLayout = m_materialBlockLayout,
-                .gfxPipeline = m_gfxPipeline
+                .gfxPipelines = m_gfxPipelines,
+                .recordParallel = [this](uint32_t jobCount, FunctionRef<void(uint32_t, FramePassExecuteContext&)> job) {
+                    recordParallel(jobCount, job);
+                },
+                .threadCount = m_jobSystem.threadCount()
             };
             framePass.execute(framePassContext);
         }
-        commandBuffer->endRenderPass();
+        if (m_passRecording.recordedJobs)
+        {
+            // the next passes are recorded after the jobs
+            commandBuffer = cfd.commandBufferPool->get();
+            cfd.commandBuffers.push_back(commandBuffer);
+        }
+        else
+            commandBuffer->endRenderPass();
     }
+    m_passRecording = PassRecording{};
 
     if (drawable)
         commandBuffer->presentDrawable(drawable);
 
-    m_device->submitCommandBuffers(commandBuffer);
-    cfd.waitedCmdBuffer = commandBuffer.get();
-
-    cfd.textureCache = std::move(newTextureCache);
-    cfd.bufferCache = std::move(newBufferCache);
+    m_device->submitCommandBuffers(cfd.commandBuffers);
     m_frameIdx = (m_frameIdx + 1) % maxFrameInFlight;
 }
 
+void Renderer::recordParallel(uint32_t jobCount, FunctionRef<void(uint32_t, FramePassExecuteContext&)> job)
+{
+    assert(m_passRecording.compiledPass != nullptr);
+    assert(m_passRecording.recordedJobs == false);
+    m_passRecording.recordedJobs = true;
+    m_passRecording.commandBuffer->endRenderPass();
+
+    cfd.jobCommandBuffers.resize(jobCount);
+    m_jobSystem.parallelFor(jobCount, [&](uint32_t index, uint32_t threadIndex) {
+        ThreadPools& pools = cfd.jobPools.at(threadIndex);
+        std::shared_ptr<gfx::CommandBuffer> jobCommandBuffer = pools.commandBufferPool->get();
+        for (TextureHandle sampledTexture : m_passRecording.compiledPass->sampledTextures)
+            jobCommandBuffer->addSampledTexture(cfd.resources->texture(sampledTexture));
+        jobCommandBuffer->beginRenderPass(*m_passRecording.continuedFramebuffer);
+        FramePassExecuteContext jobContext = {
+            .commandBuffer = *jobCommandBuffer,
+            .parameterBlockPool = *pools.parameterBlockPool,
+            .resources = *cfd.resources,
+            .frameDataBlockLayout = m_frameDataBlockLayout,
+            .materialBlockLayout = m_materialBlockLayout,
+            .gfxPipelines = m_gfxPipelines,
+            .recordParallel = nullptr,
+            .threadCount = 1
+        };
+        job(index, jobContext);
+        jobCommandBuffer->endRenderPass();
+        cfd.jobCommandBuffers[index] = std::move(jobCommandBuffer);
+    });
+    cfd.commandBuffers.insert(cfd.commandBuffers.end(), cfd.jobCommandBuffers.begin(), cfd.jobCommandBuffers.end());
+    cfd.jobCommandBuffers.clear();
+}
+
 Renderer::~Renderer()
 {
     m_device->waitIdle();
@@ -10,7 +10,12 @@
 #include "Game-Engine/Scene.hpp"
 
 #include "Game-Engine/Components.hpp"
+#include "Game-Engine/Culling.hpp"
+#include "Game-Engine/ECSView.hpp"
+#include "Game-Engine/Mesh.hpp"
 
+#include <memory>
+#include <ranges>
 #include <type_traits>
 #include <variant>
 
@@ -51,6 +56,41 @@ Entity Scene::newEntity(const std::string& name)
     return newEntity;
 }
 
+void Scene::updateSpatialIndex()
+{
+    m_spatialIndexUpdateCount++;
+
+    for (auto entity : m_ecsWorld | const_ECSView<TransformComponent, MeshComponent>() | std::views::transform([&](auto id){ return const_Entity{&m_ecsWorld, id}; }))
+    {
+        const AssetID meshId = entity.get<MeshComponent>();
+        if (m_assetManagerView.isAssetLoaded(meshId) == false)
+            continue;
+        const std::shared_ptr<Mesh> mesh = m_assetManagerView.loadAsset<Mesh>(meshId).get();
+        if (mesh->boundingBox.isEmpty())
+            continue;
+        const BoundingBox box = transformBoundingBox(mesh->boundingBox, entity.worldTransform());
+
+        auto [it, inserted] = m_spatialIndexEntries.try_emplace(entity.entityId, SpatialIndexEntry{ .node = AabbTree::INVALID_NODE_ID, .updateCount = 0 });
+        if (inserted)
+            it->second.node = m_spatialIndex.insert(box, entity.entityId);
+        else
+            m_spatialIndex.move(it->second.node, box);
+        it->second.updateCount = m_spatialIndexUpdateCount;
+    }
+
+    // destroyed entities, or without a transform or a loaded mesh anymore
+    for (auto it = m_spatialIndexEntries.begin(); it != m_spatialIndexEntries.end();)
+    {
+        if (it->second.updateCount == m_spatialIndexUpdateCount)
+            ++it;
+        else
+        {
+            m_spatialIndex.remove(it->second.node);
+            it = m_spatialIndexEntries.erase(it);
+        }
+    }
+}
+
 Scene::Descriptor Scene::makeDescriptor() const
 {
     Scene::Descriptor desc;
@@ -0,0 +1,529 @@
+/*
+ * ---------------------------------------------------
+ * TextureCompression.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/TextureCompression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+
+using Pixel = std::array<uint8_t, 4>;
+using Block = std::array<Pixel, 16>;
+
+Block fetchBlock(std::span<const std::byte> pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY)
+{
+    Block block;
+    for (uint32_t y = 0; y < 4; y++)
+    {
+        for (uint32_t x = 0; x < 4; x++)
+        {
+            const uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+            const uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+            std::memcpy(block[y * 4 + x].data(), pixels.data() + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+        }
+    }
+    return block;
+}
+
+void storeBlock(const Block& block, std::span<std::byte> pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY)
+{
+    for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; y++)
+    {
+        for (uint32_t x = 0; x < 4 && blockX * 4 + x < width; x++)
+            std::memcpy(pixels.data() + (static_cast<size_t>(blockY * 4 + y) * width + blockX * 4 + x) * 4, block[y * 4 + x].data(), 4);
+    }
+}
+
+// extremes of the block colors along their principal axis, on the first `channelCount` channels
+template<int channelCount>
+void principalEndpoints(const Block& block, std::array<float, channelCount>& low, std::array<float, channelCount>& high)
+{
+    std::array<float, channelCount> mean = {};
+    for (const Pixel& pixel : block)
+    {
+        for (int c = 0; c < channelCount; c++)
+            mean[c] += pixel[c] / 16.0f;
+    }
+
+    std::array<std::array<float, channelCount>, channelCount> covariance = {};
+    for (const Pixel& pixel : block)
+    {
+        for (int i = 0; i < channelCount; i++)
+        {
+            for (int j = 0; j < channelCount; j++)
+                covariance[i][j] += (pixel[i] - mean[i]) * (pixel[j] - mean[j]);
+        }
+    }
+
+    // power iteration, starting from the diagonal of the bounding box
+    std::array<float, channelCount> axis;
+    for (int c = 0; c < channelCount; c++)
+    {
+        const auto [minIt, maxIt] = std::ranges::minmax_element(block, {}, [c](const Pixel& pixel) { return pixel[c]; });
+        axis[c] = static_cast<float>((*maxIt)[c] - (*minIt)[c]) + 1e-3f;
+    }
+    for (int iteration = 0; iteration < 8; iteration++)
+    {
+        std::array<float, channelCount> next = {};
+        float length = 0.0f;
+        for (int i = 0; i < channelCount; i++)
+        {
+            for (int j = 0; j < channelCount; j++)
+                next[i] += covariance[i][j] * axis[j];
+            length = std::max(length, std::abs(next[i]));
+        }
+        if (length < 1e-6f)
+            break;
+        for (int c = 0; c < channelCount; c++)
+            axis[c] = next[c] / length;
+    }
+    float squaredLength = 0.0f;
+    for (float value : axis)
+        squaredLength += value * value;
+
+    float minProjection = 0.0f;
+    float maxProjection = 0.0f;
+    for (const Pixel& pixel : block)
+    {
+        float projection = 0.0f;
+        for (int c = 0; c < channelCount; c++)
+            projection += (pixel[c] - mean[c]) * axis[c];
+        projection /= squaredLength;
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+    for (int c = 0; c < channelCount; c++)
+    {
+        low[c] = std::clamp(mean[c] + axis[c] * minProjection, 0.0f, 255.0f);
+        high[c] = std::clamp(mean[c] + axis[c] * maxProjection, 0.0f, 255.0f);
+    }
+}
+
+template<size_t N>
+int squaredDistance(const Pixel& lhs, const std::array<int, N>& rhs)
+{
+    int distance = 0;
+    for (size_t c = 0; c < N; c++)
+        distance += (lhs[c] - rhs[c]) * (lhs[c] - rhs[c]);
+    return distance;
+}
+
+void writeLittleEndian(std::byte* out, uint64_t value, size_t byteCount)
+{
+    for (size_t i = 0; i < byteCount; i++)
+        out[i] = static_cast<std::byte>(value >> (8 * i));
+}
+
+uint64_t readLittleEndian(const std::byte* in, size_t byteCount)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < byteCount; i++)
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+uint16_t packRgb565(const std::array<float, 3>& color)
+{
+    const auto r = static_cast<uint16_t>(std::lround(color[0] * 31.0f / 255.0f));
+    const auto g = static_cast<uint16_t>(std::lround(color[1] * 63.0f / 255.0f));
+    const auto b = static_cast<uint16_t>(std::lround(color[2] * 31.0f / 255.0f));
+    return static_cast<uint16_t>(r << 11 | g << 5 | b);
+}
+
+std::array<int, 3> unpackRgb565(uint16_t color)
+{
+    const int r = color >> 11 & 0x1F;
+    const int g = color >> 5 & 0x3F;
+    const int b = color & 0x1F;
+    return { r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2 };
+}
+
+std::array<std::array<int, 3>, 4> colorPalette(uint16_t color0, uint16_t color1, bool fourColors)
+{
+    const std::array<int, 3> c0 = unpackRgb565(color0);
+    const std::array<int, 3> c1 = unpackRgb565(color1);
+    std::array<std::array<int, 3>, 4> palette = { c0, c1 };
+    for (int c = 0; c < 3; c++)
+    {
+        if (fourColors)
+        {
+            palette[2][c] = (2 * c0[c] + c1[c]) / 3;
+            palette[3][c] = (c0[c] + 2 * c1[c]) / 3;
+        }
+        else
+        {
+            palette[2][c] = (c0[c] + c1[c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    return palette;
+}
+
+void encodeColorBlock(const Block& block, std::byte* out)
+{
+    std::array<float, 3> low;
+    std::array<float, 3> high;
+    principalEndpoints<3>(block, low, high);
+
+    // inset the endpoints to reduce the error of the interpolated colors
+    for (int c = 0; c < 3; c++)
+    {
+        const float inset = (high[c] - low[c]) / 16.0f;
+        low[c] += inset;
+        high[c] -= inset;
+    }
+
+    uint16_t color0 = packRgb565(high);
+    uint16_t color1 = packRgb565(low);
+    if (color0 < color1)
+        std::swap(color0, color1);
+
+    uint32_t indices = 0;
+    if (color0 != color1)
+    {
+        const auto palette = colorPalette(color0, color1, true);
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            uint32_t best = 0;
+            for (uint32_t p = 1; p < 4; p++)
+            {
+                if (squaredDistance(block[i], palette[p]) < squaredDistance(block[i], palette[best]))
+                    best = p;
+            }
+            indices |= best << (2 * i);
+        }
+    }
+    writeLittleEndian(out, color0, 2);
+    writeLittleEndian(out + 2, color1, 2);
+    writeLittleEndian(out + 4, indices, 4);
+}
+
+void decodeColorBlock(const std::byte* in, Block& block, bool alwaysFourColors)
+{
+    const auto color0 = static_cast<uint16_t>(readLittleEndian(in, 2));
+    const auto color1 = static_cast<uint16_t>(readLittleEndian(in + 2, 2));
+    const auto indices = static_cast<uint32_t>(readLittleEndian(in + 4, 4));
+    const bool fourColors = alwaysFourColors || color0 > color1;
+    const auto palette = colorPalette(color0, color1, fourColors);
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        const uint32_t index = indices >> (2 * i) & 3;
+        for (int c = 0; c < 3; c++)
+            block[i][c] = static_cast<uint8_t>(palette[index][c]);
+        block[i][3] = fourColors || index != 3 ? 255 : 0;
+    }
+}
+
+std::array<int, 8> channelPalette(int value0, int value1)
+{
+    std::array<int, 8> palette = { value0, value1 };
+    if (value0 > value1)
+    {
+        for (int i = 2; i < 8; i++)
+            palette[i] = ((8 - i) * value0 + (i - 1) * value1) / 7;
+    }
+    else
+    {
+        for (int i = 2; i < 6; i++)
+            palette[i] = ((6 - i) * value0 + (i - 1) * value1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    return palette;
+}
+
+void encodeChannelBlock(const Block& block, int channel, std::byte* out)
+{
+    const auto [minIt, maxIt] = std::ranges::minmax_element(block, {}, [channel](const Pixel& pixel) { return pixel[channel]; });
+    const int value0 = (*maxIt)[channel];
+    const int value1 = (*minIt)[channel];
+
+    uint64_t indices = 0;
+    if (value0 != value1)
+    {
+        const std::array<int, 8> palette = channelPalette(value0, value1);
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            uint64_t best = 0;
+            for (uint64_t p = 1; p < 8; p++)
+            {
+                if (std::abs(block[i][channel] - palette[p]) < std::abs(block[i][channel] - palette[best]))
+                    best = p;
+            }
+            indices |= best << (3 * i);
+        }
+    }
+    out[0] = static_cast<std::byte>(value0);
+    out[1] = static_cast<std::byte>(value1);
+    writeLittleEndian(out + 2, indices, 6);
+}
+
+void decodeChannelBlock(const std::byte* in, Block& block, int channel)
+{
+    const std::array<int, 8> palette = channelPalette(static_cast<int>(in[0]), static_cast<int>(in[1]));
+    const uint64_t indices = readLittleEndian(in + 2, 6);
+    for (uint32_t i = 0; i < 16; i++)
+        block[i][channel] = static_cast<uint8_t>(palette[indices >> (3 * i) & 7]);
+}
+
+constexpr std::array<int, 16> BC7_WEIGHTS_4 = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+class BitWriter
+{
+public:
+    explicit BitWriter(std::byte* out) : m_out(out) { std::memset(m_out, 0, 16); }
+
+    void write(uint32_t value, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; i++, m_position++)
+        {
+            if (value >> i & 1)
+                m_out[m_position / 8] |= static_cast<std::byte>(1 << (m_position % 8));
+        }
+    }
+
+private:
+    std::byte* m_out;
+    uint32_t m_position = 0;
+};
+
+class BitReader
+{
+public:
+    explicit BitReader(const std::byte* in) : m_in(in) {}
+
+    uint32_t read(uint32_t count)
+    {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < count; i++, m_position++)
+            value |= static_cast<uint32_t>(m_in[m_position / 8] >> (m_position % 8) & std::byte{ 1 }) << i;
+        return value;
+    }
+
+private:
+    const std::byte* m_in;
+    uint32_t m_position = 0;
+};
+
+std::array<std::array<int, 4>, 16> bc7Mode6Palette(const std::array<int, 4>& endpoint0, const std::array<int, 4>& endpoint1)
+{
+    std::array<std::array<int, 4>, 16> palette;
+    for (size_t i = 0; i < 16; i++)
+    {
+        for (int c = 0; c < 4; c++)
+            palette[i][c] = ((64 - BC7_WEIGHTS_4[i]) * endpoint0[c] + BC7_WEIGHTS_4[i] * endpoint1[c] + 32) >> 6;
+    }
+    return palette;
+}
+
+// mode 6: one subset, RGBA endpoints of 7 bits plus a shared lowest bit per endpoint, 4 bits indices
+void encodeBc7Block(const Block& block, std::byte* out)
+{
+    std::array<float, 4> low;
+    std::array<float, 4> high;
+    principalEndpoints<4>(block, low, high);
+
+    // the lowest bit of each endpoint is shared by its 4 channels, keep the one closest to the endpoint
+    const auto quantize = [](const std::array<float, 4>& endpoint, std::array<uint32_t, 4>& quantized, uint32_t& pBit) {
+        float bestError = std::numeric_limits<float>::max();
+        for (uint32_t p = 0; p < 2; p++)
+        {
+            float error = 0.0f;
+            std::array<uint32_t, 4> candidate;
+            for (int c = 0; c < 4; c++)
+            {
+                candidate[c] = static_cast<uint32_t>(std::clamp(std::lround((endpoint[c] - static_cast<float>(p)) / 2.0f), 0L, 127L));
+                const float reconstructed = static_cast<float>(candidate[c] << 1 | p);
+                error += (reconstructed - endpoint[c]) * (reconstructed - endpoint[c]);
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                quantized = candidate;
+                pBit = p;
+            }
+        }
+    };
+    std::array<uint32_t, 4> quantized0;
+    std::array<uint32_t, 4> quantized1;
+    uint32_t pBit0 = 0;
+    uint32_t pBit1 = 0;
+    quantize(low, quantized0, pBit0);
+    quantize(high, quantized1, pBit1);
+
+    std::array<int, 4> endpoint0;
+    std::array<int, 4> endpoint1;
+    for (int c = 0; c < 4; c++)
+    {
+        endpoint0[c] = static_cast<int>(quantized0[c] << 1 | pBit0);
+        endpoint1[c] = static_cast<int>(quantized1[c] << 1 | pBit1);
+    }
+    const auto palette = bc7Mode6Palette(endpoint0, endpoint1);
+
+    std::array<uint32_t, 16> indices;
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        uint32_t best = 0;
+        for (uint32_t p = 1; p < 16; p++)
+        {
+            if (squaredDistance(block[i], palette[p]) < squaredDistance(block[i], palette[best]))
+                best = p;
+        }
+        indices[i] = best;
+    }
+
+    // the highest bit of the first index is implicit and must be 0
+    if (indices[0] >= 8)
+    {
+        std::swap(quantized0, quantized1);
+        std::swap(pBit0, pBit1);
+        for (uint32_t& index : indices)
+            index = 15 - index;
+    }
+
+    BitWriter writer(out);
+    writer.write(1 << 6, 7);
+    for (int c = 0; c < 4; c++)
+    {
+        writer.write(quantized0[c], 7);
+        writer.write(quantized1[c], 7);
+    }
+    writer.write(pBit0, 1);
+    writer.write(pBit1, 1);
+    writer.write(indices[0], 3);
+    for (uint32_t i = 1; i < 16; i++)
+        writer.write(indices[i], 4);
+}
+
+void decodeBc7Block(const std::byte* in, Block& block)
+{
+    BitReader reader(in);
+    if (reader.read(7) != 1 << 6)
+        throw std::runtime_error("unsupported BC7 block mode, only the mode 6 can be decoded");
+
+    std::array<int, 4> endpoint0;
+    std::array<int, 4> endpoint1;
+    for (int c = 0; c < 4; c++)
+    {
+        endpoint0[c] = static_cast<int>(reader.read(7) << 1);
+        endpoint1[c] = static_cast<int>(reader.read(7) << 1);
+    }
+    const uint32_t pBit0 = reader.read(1);
+    const uint32_t pBit1 = reader.read(1);
+    for (int c = 0; c < 4; c++)
+    {
+        endpoint0[c] |= static_cast<int>(pBit0);
+        endpoint1[c] |= static_cast<int>(pBit1);
+    }
+
+    const auto palette = bc7Mode6Palette(endpoint0, endpoint1);
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        const uint32_t index = reader.read(i == 0 ? 3 : 4);
+        for (int c = 0; c < 4; c++)
+            block[i][c] = static_cast<uint8_t>(palette[index][c]);
+    }
+}
+
+} // namespace
+
+namespace GE
+{
+
+std::vector<std::byte> encodeTexture(TextureFormat format, std::span<const std::byte> pixels, uint32_t width, uint32_t height)
+{
+    assert(pixels.size() == static_cast<size_t>(width) * height * 4);
+    if (format == TextureFormat::rgba8)
+        return std::vector<std::byte>(pixels.begin(), pixels.end());
+
+    std::vector<std::byte> bytes(textureByteSize(format, width, height));
+    const size_t blockSize = textureFormatBlockSize(format);
+    const uint32_t blockCountX = (width + 3) / 4;
+    const uint32_t blockCountY = (height + 3) / 4;
+    for (uint32_t blockY = 0; blockY < blockCountY; blockY++)
+    {
+        for (uint32_t blockX = 0; blockX < blockCountX; blockX++)
+        {
+            const Block block = fetchBlock(pixels, width, height, blockX, blockY);
+            std::byte* out = bytes.data() + (static_cast<size_t>(blockY) * blockCountX + blockX) * blockSize;
+            switch (format)
+            {
+            case TextureFormat::bc1:
+                encodeColorBlock(block, out);
+                break;
+            case TextureFormat::bc3:
+                encodeChannelBlock(block, 3, out);
+                encodeColorBlock(block, out + 8);
+                break;
+            case TextureFormat::bc5:
+                encodeChannelBlock(block, 0, out);
+                encodeChannelBlock(block, 1, out + 8);
+                break;
+            case TextureFormat::bc7:
+                encodeBc7Block(block, out);
+                break;
+            case TextureFormat::rgba8:
+                std::unreachable();
+            }
+        }
+    }
+    return bytes;
+}
+
+std::vector<std::byte> decodeTexture(TextureFormat format, std::span<const std::byte> bytes, uint32_t width, uint32_t height)
+{
+    assert(bytes.size() == textureByteSize(format, width, height));
+    if (format == TextureFormat::rgba8)
+        return std::vector<std::byte>(bytes.begin(), bytes.end());
+
+    std::vector<std::byte> pixels(static_cast<size_t>(width) * height * 4);
+    const size_t blockSize = textureFormatBlockSize(format);
+    const uint32_t blockCountX = (width + 3) / 4;
+    const uint32_t blockCountY = (height + 3) / 4;
+    for (uint32_t blockY = 0; blockY < blockCountY; blockY++)
+    {
+        for (uint32_t blockX = 0; blockX < blockCountX; blockX++)
+        {
+            const std::byte* in = bytes.data() + (static_cast<size_t>(blockY) * blockCountX + blockX) * blockSize;
+            Block block;
+            switch (format)
+            {
+            case TextureFormat::bc1:
+                decodeColorBlock(in, block, false);
+                break;
+            case TextureFormat::bc3:
+                decodeColorBlock(in + 8, block, true);
+                decodeChannelBlock(in, block, 3);
+                break;
+            case TextureFormat::bc5:
+                for (Pixel& pixel : block)
+                    pixel = { 0, 0, 0, 255 };
+                decodeChannelBlock(in, block, 0);
+                decodeChannelBlock(in + 8, block, 1);
+                break;
+            case TextureFormat::bc7:
+                decodeBc7Block(in, block);
+                break;
+            case TextureFormat::rgba8:
+                std::unreachable();
+            }
+            storeBlock(block, pixels, width, height, blockX, blockY);
+        }
+    }
+    return pixels;
+}
+
+} // namespace GE
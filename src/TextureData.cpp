@@ -0,0 +1,337 @@
+/*
+ * ---------------------------------------------------
+ * TextureData.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/TextureData.hpp"
+#include "Game-Engine/Hash.hpp"
+#include "Game-Engine/MappedFile.hpp"
+
+#include "CookedFile.hpp"
+
+#include <Graphics/Buffer.hpp>
+#include <Graphics/Enums.hpp>
+
+#include <stb_image/stb_image.h>
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+
+constexpr uint32_t COOKED_TEXTURE_MAGIC = 0x43544547; // "GETC"
+constexpr uint32_t COOKED_TEXTURE_VERSION = 1;        // to be incremented on any change of the layout or of the cooking
+
+struct CookedTextureHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t fileSize;
+    uint8_t format;
+    uint8_t padding[3];
+    uint32_t mipCount;
+};
+
+struct CookedMip
+{
+    uint64_t offset;
+    uint64_t size;
+    uint32_t width;
+    uint32_t height;
+};
+
+static_assert(std::is_trivially_copyable_v<CookedTextureHeader>);
+static_assert(std::is_trivially_copyable_v<CookedMip>);
+
+float srgbToLinear(uint8_t value)
+{
+    static const std::array<float, 256> table = []() {
+        std::array<float, 256> table;
+        for (size_t i = 0; i < table.size(); i++)
+        {
+            const float c = static_cast<float>(i) / 255.0f;
+            table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return table;
+    }();
+    return table[value];
+}
+
+uint8_t linearToSrgb(float value)
+{
+    const float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    return static_cast<uint8_t>(std::lround(std::clamp(c, 0.0f, 1.0f) * 255.0f));
+}
+
+} // namespace
+
+namespace GE
+{
+
+std::vector<std::byte> downsampleImage(std::span<const std::byte> pixels, uint32_t width, uint32_t height, bool srgb)
+{
+    assert(pixels.size() == static_cast<size_t>(width) * height * 4);
+    const uint32_t outWidth = std::max(width / 2, 1u);
+    const uint32_t outHeight = std::max(height / 2, 1u);
+
+    std::vector<std::byte> downsampled(static_cast<size_t>(outWidth) * outHeight * 4);
+    for (uint32_t y = 0; y < outHeight; y++)
+    {
+        const uint32_t firstRow = static_cast<uint32_t>(static_cast<uint64_t>(y) * height / outHeight);
+        const uint32_t lastRow = static_cast<uint32_t>(static_cast<uint64_t>(y + 1) * height / outHeight);
+        for (uint32_t x = 0; x < outWidth; x++)
+        {
+            const uint32_t firstColumn = static_cast<uint32_t>(static_cast<uint64_t>(x) * width / outWidth);
+            const uint32_t lastColumn = static_cast<uint32_t>(static_cast<uint64_t>(x + 1) * width / outWidth);
+
+            std::array<float, 4> sum = {};
+            for (uint32_t sourceY = firstRow; sourceY < lastRow; sourceY++)
+            {
+                for (uint32_t sourceX = firstColumn; sourceX < lastColumn; sourceX++)
+                {
+                    const std::byte* pixel = pixels.data() + (static_cast<size_t>(sourceY) * width + sourceX) * 4;
+                    for (int c = 0; c < 3; c++)
+                        sum[c] += srgb ? srgbToLinear(static_cast<uint8_t>(pixel[c])) : static_cast<float>(pixel[c]) / 255.0f;
+                    sum[3] += static_cast<float>(pixel[3]) / 255.0f;
+                }
+            }
+
+            const auto count = static_cast<float>((lastRow - firstRow) * (lastColumn - firstColumn));
+            std::byte* out = downsampled.data() + (static_cast<size_t>(y) * outWidth + x) * 4;
+            for (int c = 0; c < 3; c++)
+                out[c] = static_cast<std::byte>(srgb ? linearToSrgb(sum[c] / count) : static_cast<uint8_t>(std::lround(sum[c] / count * 255.0f)));
+            out[3] = static_cast<std::byte>(std::lround(sum[3] / count * 255.0f));
+        }
+    }
+    return downsampled;
+}
+
+TextureData importTexture(const std::filesystem::path& path)
+{
+    const MappedFile source(path);
+    return importTexture(path, source.bytes());
+}
+
+TextureData importTexture(const std::filesystem::path& path, std::span<const std::byte> sourceContent)
+{
+    if (sourceContent.size() > static_cast<size_t>(std::numeric_limits<int>::max()))
+        throw std::runtime_error("failed to load texture: " + path.string() + ": file too large");
+    int width = 0;
+    int height = 0;
+    stbi_uc* decoded = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(sourceContent.data()), static_cast<int>(sourceContent.size()), &width, &height, nullptr, STBI_rgb_alpha);
+    if (decoded == nullptr)
+        throw std::runtime_error("failed to load texture: " + path.string());
+
+    auto storage = std::shared_ptr<const stbi_uc>(decoded, stbi_image_free);
+    return TextureData{
+        .format = TextureFormat::rgba8,
+        .mips = { TextureData::Mip{
+            .width = static_cast<uint32_t>(width),
+            .height = static_cast<uint32_t>(height),
+            .bytes = std::span(reinterpret_cast<const std::byte*>(decoded), static_cast<size_t>(width) * static_cast<size_t>(height) * 4) } },
+        .storage = std::move(storage)
+    };
+}
+
+TextureData cookTexture(const TextureData& textureData, const TextureCookOptions& options)
+{
+    if (textureData.format != TextureFormat::rgba8 || textureData.mips.size() != 1)
+        throw std::runtime_error("only single mip RGBA8 textures can be cooked");
+
+    auto storage = std::make_shared<std::vector<std::vector<std::byte>>>();
+    const uint32_t mipCount = options.mipmaps ? mipLevelCount(textureData.width(), textureData.height()) : 1;
+    storage->reserve(mipCount);
+
+    TextureData cooked = { .format = options.format };
+    cooked.mips.reserve(mipCount);
+
+    std::vector<std::byte> pixels(textureData.mips.front().bytes.begin(), textureData.mips.front().bytes.end());
+    uint32_t width = textureData.width();
+    uint32_t height = textureData.height();
+    for (uint32_t level = 0; level < mipCount; level++)
+    {
+        if (level > 0)
+        {
+            // each mip is filtered from the previous one, the error of the block compression does not accumulate
+            pixels = downsampleImage(pixels, width, height, options.srgb);
+            width = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+        const std::vector<std::byte>& encoded = storage->emplace_back(encodeTexture(options.format, pixels, width, height));
+        cooked.mips.push_back(TextureData::Mip{ .width = width, .height = height, .bytes = encoded });
+    }
+    cooked.storage = std::move(storage);
+    return cooked;
+}
+
+std::vector<std::byte> decodeMip(const TextureData& textureData, size_t mipIndex)
+{
+    const TextureData::Mip& mip = textureData.mips.at(mipIndex);
+    return decodeTexture(textureData.format, mip.bytes, mip.width, mip.height);
+}
+
+uint64_t cookedTextureKey(std::span<const std::byte> sourceContent, const TextureCookOptions& options)
+{
+    uint64_t settings = hashCombine(COOKED_TEXTURE_VERSION, static_cast<uint64_t>(options.format));
+    settings = hashCombine(settings, options.mipmaps);
+    settings = hashCombine(settings, options.srgb);
+    return hashBytes(sourceContent, settings);
+}
+
+std::optional<TextureData> readCookedTexture(const std::filesystem::path& path, uint64_t key)
+{
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error))
+        return std::nullopt;
+
+    std::shared_ptr<MappedFile> mappedFile;
+    try {
+        mappedFile = std::make_shared<MappedFile>(path);
+    }
+    catch (const std::runtime_error&) {
+        return std::nullopt;
+    }
+    const std::span<const std::byte> file = mappedFile->bytes();
+    return readCookedTexture(file, std::move(mappedFile), key);
+}
+
+std::optional<TextureData> readCookedTexture(std::span<const std::byte> file, std::shared_ptr<const void> storage, uint64_t key)
+{
+    const auto* header = readRecords<CookedTextureHeader>(file, 0, 1);
+    if (header == nullptr
+        || header->magic != COOKED_TEXTURE_MAGIC
+        || header->version != COOKED_TEXTURE_VERSION
+        || header->key != key
+        || header->fileSize != file.size()
+        || header->format > static_cast<uint8_t>(TextureFormat::bc7)
+        || header->mipCount == 0)
+        return std::nullopt;
+
+    const auto* mips = readRecords<CookedMip>(file, sizeof(CookedTextureHeader), header->mipCount);
+    if (mips == nullptr)
+        return std::nullopt;
+
+    TextureData textureData = { .format = static_cast<TextureFormat>(header->format) };
+    textureData.mips.reserve(header->mipCount);
+    for (const CookedMip& mip : std::span(mips, header->mipCount))
+    {
+        if (mip.width == 0 || mip.height == 0
+            || mip.size != textureByteSize(textureData.format, mip.width, mip.height)
+            || !isValidBlob<std::byte>(file, mip.offset, mip.size))
+            return std::nullopt;
+        textureData.mips.push_back(TextureData::Mip{ .width = mip.width, .height = mip.height, .bytes = file.subspan(mip.offset, mip.size) });
+    }
+
+    textureData.storage = std::move(storage);
+    return textureData;
+}
+
+void writeCookedTexture(const std::filesystem::path& path, const TextureData& textureData, uint64_t key)
+{
+    writeFileAtomically(path, serializeCookedTexture(textureData, key));
+}
+
+std::vector<std::byte> serializeCookedTexture(const TextureData& textureData, uint64_t key)
+{
+    CookedTextureHeader header = {
+        .magic = COOKED_TEXTURE_MAGIC,
+        .version = COOKED_TEXTURE_VERSION,
+        .key = key,
+        .format = static_cast<uint8_t>(textureData.format),
+        .padding = {},
+        .mipCount = static_cast<uint32_t>(textureData.mips.size())
+    };
+
+    std::vector<CookedMip> mips;
+    mips.reserve(textureData.mips.size());
+    size_t fileSize = sizeof(CookedTextureHeader) + sizeof(CookedMip) * textureData.mips.size();
+    for (const TextureData::Mip& mip : textureData.mips)
+    {
+        CookedMip& cookedMip = mips.emplace_back(CookedMip{
+            .offset = alignUp(fileSize, COOKED_FILE_BLOB_ALIGNMENT),
+            .size = mip.bytes.size(),
+            .width = mip.width,
+            .height = mip.height
+        });
+        fileSize = cookedMip.offset + cookedMip.size;
+    }
+    header.fileSize = fileSize;
+
+    std::vector<std::byte> bytes(fileSize);
+    std::memcpy(bytes.data(), &header, sizeof(CookedTextureHeader));
+    std::memcpy(bytes.data() + sizeof(CookedTextureHeader), mips.data(), sizeof(CookedMip) * mips.size());
+    for (size_t i = 0; i < mips.size(); i++)
+        std::ranges::copy(textureData.mips[i].bytes, bytes.begin() + static_cast<std::ptrdiff_t>(mips[i].offset));
+    return bytes;
+}
+
+TextureData loadTextureData(const std::filesystem::path& path, const std::filesystem::path& cacheDirectory, const TextureCookOptions& options)
+{
+    const MappedFile source(path);
+    return loadTextureData(path, source.bytes(), cacheDirectory, options);
+}
+
+TextureData loadTextureData(const std::filesystem::path& path, std::span<const std::byte> sourceContent, const std::filesystem::path& cacheDirectory, const TextureCookOptions& options)
+{
+    if (cacheDirectory.empty())
+        return cookTexture(importTexture(path, sourceContent), options);
+
+    const uint64_t key = cookedTextureKey(sourceContent, options);
+    const std::filesystem::path cookedPath = cacheDirectory / std::format("{:016x}.getex", key);
+
+    if (std::optional<TextureData> cooked = readCookedTexture(cookedPath, key))
+        return *std::move(cooked);
+
+    TextureData textureData = cookTexture(importTexture(path, sourceContent), options);
+    try {
+        std::filesystem::create_directories(cacheDirectory);
+        writeCookedTexture(cookedPath, textureData, key);
+    }
+    catch (const std::exception&) {
+        // the cache is only an optimization, the texture is still usable
+    }
+    return textureData;
+}
+
+std::shared_ptr<gfx::Texture> uploadTexture(gfx::Device& device, gfx::CommandBuffer& commandBuffer, std::span<const std::byte> pixels, uint32_t width, uint32_t height)
+{
+    assert(pixels.size() == static_cast<size_t>(width) * height * pixelFormatSize(gfx::PixelFormat::RGBA8Unorm));
+    std::shared_ptr<gfx::Texture> texture = device.newTexture(gfx::Texture::Descriptor{
+        .type = gfx::TextureType::texture2d,
+        .width = width,
+        .height = height,
+        .pixelFormat = gfx::PixelFormat::RGBA8Unorm,
+        .usages = gfx::TextureUsage::copyDestination | gfx::TextureUsage::shaderRead,
+        .storageMode = gfx::ResourceStorageMode::deviceLocal });
+    assert(texture);
+
+    std::shared_ptr<gfx::Buffer> stagingBuffer = device.newBuffer(gfx::Buffer::Descriptor{
+        .size = pixels.size(),
+        .usages = gfx::BufferUsage::copySource,
+        .storageMode = gfx::ResourceStorageMode::hostVisible });
+    assert(stagingBuffer);
+
+    std::memcpy(stagingBuffer->content<std::byte>(), pixels.data(), pixels.size());
+
+    commandBuffer.beginBlitPass();
+    commandBuffer.copyBufferToTexture(stagingBuffer, texture);
+    commandBuffer.endBlitPass();
+
+    return texture;
+}
+
+} // namespace GE
@@ -0,0 +1,64 @@
+/*
+ * ---------------------------------------------------
+ * UploadArena.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/UploadArena.hpp"
+
+#include <Graphics/Buffer.hpp>
+#include <Graphics/Enums.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <numeric>
+
+namespace GE
+{
+
+UploadArena::UploadArena(gfx::Device* device, gfx::BufferUsages usages, size_t initialCapacity)
+    : m_device(device)
+    , m_usages(usages)
+    , m_initialCapacity(initialCapacity)
+{
+    assert(m_device);
+    assert(m_initialCapacity > 0);
+}
+
+UploadArena::Allocation UploadArena::allocate(size_t size, size_t alignment)
+{
+    assert(alignment > 0);
+    alignment = std::lcm(alignment, MIN_ALIGNMENT);
+    const size_t offset = (m_usedBytes + alignment - 1) / alignment * alignment;
+
+    if (m_buffer == nullptr || offset + size > m_buffer->size())
+    {
+        const size_t capacity = std::max(offset + size, m_buffer == nullptr ? m_initialCapacity : m_buffer->size() * 2);
+        std::shared_ptr<gfx::Buffer> buffer = m_device->newBuffer(gfx::Buffer::Descriptor{
+            .size = capacity,
+            .usages = m_usages,
+            .storageMode = gfx::ResourceStorageMode::hostVisible
+        });
+        assert(buffer);
+        // the previous allocations of the frame were already bound with the old buffer, which keeps its content,
+        // they are also copied for the ones still to be bound
+        if (m_buffer != nullptr && m_usedBytes > 0)
+            std::memcpy(buffer->content<std::byte>(), m_buffer->content<std::byte>(), m_usedBytes);
+        m_buffer = std::move(buffer);
+    }
+
+    m_usedBytes = offset + size;
+    return Allocation{ .buffer = m_buffer, .offset = offset, .data = m_buffer->content<std::byte>() + offset };
+}
+
+void UploadArena::reset()
+{
+    m_usedBytes = 0;
+}
+
+} // namespace GE
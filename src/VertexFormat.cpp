@@ -0,0 +1,183 @@
+/*
+ * ---------------------------------------------------
+ * VertexFormat.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Game-Engine/VertexFormat.hpp"
+
+#include <Graphics/Enums.hpp>
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+namespace
+{
+
+constexpr float QUANTIZED_MAX = std::numeric_limits<uint16_t>::max();
+constexpr float SNORM12_MAX = 2047.0f;
+
+// the high byte of the words read through the float3 attribute, a positive exponent of 126 or 127
+constexpr uint32_t PACKED_WORD_HIGH_BYTE = 0x3Fu << 24;
+
+glm::vec2 octahedralEncode(const glm::vec3& direction)
+{
+    const float l1Norm = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+    if (l1Norm == 0.0f)
+        return glm::vec2(0.0f);
+
+    glm::vec3 n = direction / l1Norm;
+    if (n.z >= 0.0f)
+        return glm::vec2(n.x, n.y);
+    return glm::vec2(
+        (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+        (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+}
+
+glm::vec3 octahedralDecode(const glm::vec2& encoded)
+{
+    glm::vec3 n = glm::vec3(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+    const float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+uint32_t packSnorm12(float value)
+{
+    return static_cast<uint32_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * SNORM12_MAX)) & 0xFFFu;
+}
+
+// of the 12 low bits
+float unpackSnorm12(uint32_t packed)
+{
+    const int32_t value = static_cast<int32_t>(packed << 20) >> 20;
+    return std::max(static_cast<float>(value) / SNORM12_MAX, -1.0f);
+}
+
+} // namespace
+
+namespace GE
+{
+
+uint32_t vertexSize(VertexFormat format)
+{
+    switch (format)
+    {
+    case VertexFormat::full:
+        return sizeof(Vertex);
+    case VertexFormat::packed:
+        return sizeof(PackedVertex);
+    }
+    std::unreachable();
+}
+
+gfx::VertexLayout vertexLayout(VertexFormat format)
+{
+    switch (format)
+    {
+    case VertexFormat::full:
+        return gfx::VertexLayout{
+            .stride = sizeof(Vertex),
+            .attributes = {
+                gfx::VertexAttribute{
+                    .format = gfx::VertexAttributeFormat::float3,
+                    .offset = offsetof(Vertex, pos)},
+                gfx::VertexAttribute{
+                    .format = gfx::VertexAttributeFormat::float3,
+                    .offset = offsetof(Vertex, normal)},
+            }
+        };
+    case VertexFormat::packed:
+        // position and normal bits, reinterpreted by the shader, the words are always normal floats
+        return gfx::VertexLayout{
+            .stride = sizeof(PackedVertex),
+            .attributes = {
+                gfx::VertexAttribute{
+                    .format = gfx::VertexAttributeFormat::float3,
+                    .offset = offsetof(PackedVertex, posNormal)},
+            }
+        };
+    }
+    std::unreachable();
+}
+
+uint32_t packOctahedral(const glm::vec3& direction)
+{
+    return glm::packSnorm2x16(octahedralEncode(direction));
+}
+
+glm::vec3 unpackOctahedral(uint32_t packed)
+{
+    return octahedralDecode(glm::unpackSnorm2x16(packed));
+}
+
+uint32_t packOctahedral24(const glm::vec3& direction)
+{
+    const glm::vec2 encoded = octahedralEncode(direction);
+    return packSnorm12(encoded.x) | packSnorm12(encoded.y) << 12;
+}
+
+glm::vec3 unpackOctahedral24(uint32_t packed)
+{
+    return octahedralDecode(glm::vec2(unpackSnorm12(packed), unpackSnorm12(packed >> 12)));
+}
+
+PositionQuantization positionQuantization(std::span<const Vertex> vertices)
+{
+    if (vertices.empty())
+        return PositionQuantization{};
+
+    glm::vec3 min = vertices.front().pos;
+    glm::vec3 max = vertices.front().pos;
+    for (const Vertex& vertex : vertices)
+    {
+        min = glm::min(min, vertex.pos);
+        max = glm::max(max, vertex.pos);
+    }
+    return PositionQuantization{
+        .scale = (max - min) / QUANTIZED_MAX,
+        .offset = min
+    };
+}
+
+PackedVertex packVertex(const Vertex& vertex, const PositionQuantization& quantization)
+{
+    PackedVertex packed = {};
+    const uint32_t normal = packOctahedral24(vertex.normal);
+    for (int i = 0; i < 3; i++)
+    {
+        const float quantized = quantization.scale[i] > 0.0f ? (vertex.pos[i] - quantization.offset[i]) / quantization.scale[i] : 0.0f;
+        const auto position = static_cast<uint32_t>(std::lround(std::clamp(quantized, 0.0f, QUANTIZED_MAX)));
+        packed.posNormal[i] = PACKED_WORD_HIGH_BYTE | (normal >> (8 * i) & 0xFFu) << 16 | position;
+    }
+    packed.tangent = packOctahedral(vertex.tangent);
+    packed.uv = glm::packHalf2x16(vertex.uv);
+    return packed;
+}
+
+Vertex unpackVertex(const PackedVertex& packed, const PositionQuantization& quantization)
+{
+    glm::vec3 position;
+    uint32_t normal = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        position[i] = static_cast<float>(packed.posNormal[i] & 0xFFFFu);
+        normal |= (packed.posNormal[i] >> 16 & 0xFFu) << (8 * i);
+    }
+    return Vertex{
+        .pos = position * quantization.scale + quantization.offset,
+        .uv = glm::unpackHalf2x16(packed.uv),
+        .normal = unpackOctahedral24(normal),
+        .tangent = unpackOctahedral(packed.tangent)
+    };
+}
+
+} // namespace GE
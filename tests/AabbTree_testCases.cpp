@@ -0,0 +1,202 @@
+/*
+ * ---------------------------------------------------
+ * AabbTree_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/AabbTree.hpp"
+#include "Game-Engine/Culling.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+std::vector<GE::BoundingBox> randomBoxes(uint32_t count, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.1f, 3.0f);
+    std::vector<GE::BoundingBox> boxes;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const glm::vec3 center(position(random), position(random), position(random));
+        const glm::vec3 extent(size(random), size(random), size(random));
+        boxes.push_back({ .min = center - extent, .max = center + extent });
+    }
+    return boxes;
+}
+
+template<typename Query>
+std::vector<uint64_t> sortedQuery(Query&& query)
+{
+    std::vector<uint64_t> found;
+    query([&](uint64_t userData) { found.push_back(userData); });
+    std::ranges::sort(found);
+    return found;
+}
+
+template<typename Predicate>
+std::vector<uint64_t> bruteForce(const std::vector<GE::BoundingBox>& boxes, Predicate&& predicate)
+{
+    std::vector<uint64_t> found;
+    for (uint64_t i = 0; i < boxes.size(); i++)
+    {
+        if (boxes[i].isEmpty() == false && predicate(boxes[i]))
+            found.push_back(i);
+    }
+    return found;
+}
+
+// the queries of the tree give the same leaves as tests of all the boxes
+void expectQueriesMatchBruteForce(const GE::AabbTree& tree, const std::vector<GE::BoundingBox>& boxes)
+{
+    const GE::BoundingBox queryBox = { .min = glm::vec3(-20.0f), .max = glm::vec3(10.0f, 30.0f, 5.0f) };
+    EXPECT_EQ(sortedQuery([&](auto&& fn) { tree.query(queryBox, fn); }),
+              bruteForce(boxes, [&](const GE::BoundingBox& box) { return GE::overlaps(box, queryBox); }));
+
+    const GE::BoundingSphere sphere = { .center = glm::vec3(30.0f, -10.0f, 0.0f), .radius = 25.0f };
+    EXPECT_EQ(sortedQuery([&](auto&& fn) { tree.query(sphere, fn); }),
+              bruteForce(boxes, [&](const GE::BoundingBox& box) { return GE::overlaps(box, sphere); }));
+
+    const GE::Frustum frustum = GE::frustum(glm::perspective(glm::radians(60.0f), 1.5f, 0.1f, 80.0f) * glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+    EXPECT_EQ(sortedQuery([&](auto&& fn) { tree.query(frustum, fn); }),
+              bruteForce(boxes, [&](const GE::BoundingBox& box) { return GE::isBoxInFrustum(frustum, box); }));
+
+    const GE::Ray ray = { .origin = glm::vec3(-120.0f, 1.0f, 2.0f), .direction = glm::normalize(glm::vec3(1.0f, 0.05f, -0.02f)) };
+    EXPECT_EQ(sortedQuery([&](auto&& fn) { tree.query(ray, 200.0f, [&](uint64_t userData, float) { fn(userData); }); }),
+              bruteForce(boxes, [&](const GE::BoundingBox& box) { return GE::rayBoxDistance(ray, box, 200.0f).has_value(); }));
+}
+
+TEST(AabbTreeTest, rayBoxDistance)
+{
+    const GE::BoundingBox box = { .min = glm::vec3(-1.0f), .max = glm::vec3(1.0f) };
+
+    EXPECT_EQ(GE::rayBoxDistance(GE::Ray{ .origin = { 0.0f, 0.0f, 5.0f }, .direction = { 0.0f, 0.0f, -1.0f } }, box), 4.0f);
+    EXPECT_EQ(GE::rayBoxDistance(GE::Ray{ .origin = { 0.0f, 0.0f, 0.0f }, .direction = { 0.0f, 0.0f, -1.0f } }, box), 0.0f); // inside
+    EXPECT_FALSE(GE::rayBoxDistance(GE::Ray{ .origin = { 0.0f, 0.0f, 5.0f }, .direction = { 0.0f, 0.0f, 1.0f } }, box)); // pointing away
+    EXPECT_FALSE(GE::rayBoxDistance(GE::Ray{ .origin = { 2.0f, 0.0f, 5.0f }, .direction = { 0.0f, 0.0f, -1.0f } }, box)); // parallel, outside the x slab
+    EXPECT_FALSE(GE::rayBoxDistance(GE::Ray{ .origin = { 0.0f, 0.0f, 5.0f }, .direction = { 0.0f, 0.0f, -1.0f } }, box, 3.0f)); // too short
+}
+
+TEST(AabbTreeTest, queriesMatchBruteForce)
+{
+    const std::vector<GE::BoundingBox> boxes = randomBoxes(2000, 1);
+    GE::AabbTree tree;
+    for (uint64_t i = 0; i < boxes.size(); i++)
+        tree.insert(boxes[i], i);
+
+    EXPECT_EQ(tree.size(), boxes.size());
+    EXPECT_LE(tree.height(), 2 * static_cast<uint32_t>(std::ceil(std::log2(boxes.size())))); // balanced by the rotations
+    expectQueriesMatchBruteForce(tree, boxes);
+}
+
+TEST(AabbTreeTest, removedLeavesAreNotFound)
+{
+    std::vector<GE::BoundingBox> boxes = randomBoxes(500, 2);
+    GE::AabbTree tree;
+    std::vector<GE::AabbTree::NodeID> ids;
+    for (uint64_t i = 0; i < boxes.size(); i++)
+        ids.push_back(tree.insert(boxes[i], i));
+
+    // the empty boxes are skipped by the brute force queries
+    for (uint64_t i = 0; i < boxes.size(); i += 2)
+    {
+        tree.remove(ids[i]);
+        boxes[i] = GE::BoundingBox{};
+    }
+    EXPECT_EQ(tree.size(), 250u);
+    expectQueriesMatchBruteForce(tree, boxes);
+
+    // the freed nodes are reused
+    boxes.push_back(GE::BoundingBox{ .min = glm::vec3(0.0f), .max = glm::vec3(1.0f) });
+    tree.insert(boxes.back(), boxes.size() - 1);
+    expectQueriesMatchBruteForce(tree, boxes);
+}
+
+TEST(AabbTreeTest, smallMovesStayInTheMargin)
+{
+    GE::AabbTree tree(0.5f);
+    const GE::AabbTree::NodeID id = tree.insert(GE::BoundingBox{ .min = glm::vec3(0.0f), .max = glm::vec3(1.0f) }, 7);
+    tree.insert(GE::BoundingBox{ .min = glm::vec3(5.0f), .max = glm::vec3(6.0f) }, 8);
+
+    EXPECT_FALSE(tree.move(id, GE::BoundingBox{ .min = glm::vec3(0.25f), .max = glm::vec3(1.25f) }));
+    EXPECT_EQ(tree.box(id), (GE::BoundingBox{ .min = glm::vec3(0.25f), .max = glm::vec3(1.25f) }));
+    EXPECT_TRUE(tree.move(id, GE::BoundingBox{ .min = glm::vec3(3.0f), .max = glm::vec3(4.0f) }));
+    EXPECT_EQ(tree.userData(id), 7u);
+
+    // the queries use the box, not the margin
+    EXPECT_TRUE(sortedQuery([&](auto&& fn) { tree.query(GE::BoundingBox{ .min = glm::vec3(2.6f), .max = glm::vec3(2.9f) }, fn); }).empty());
+    EXPECT_EQ(sortedQuery([&](auto&& fn) { tree.query(GE::BoundingBox{ .min = glm::vec3(3.5f), .max = glm::vec3(3.6f) }, fn); }), std::vector<uint64_t>{ 7 });
+}
+
+TEST(AabbTreeTest, movedRefittedAndRebuiltTreesMatchBruteForce)
+{
+    std::vector<GE::BoundingBox> boxes = randomBoxes(1000, 3);
+    GE::AabbTree movedTree, refittedTree, rebuiltTree;
+    std::vector<GE::AabbTree::NodeID> movedIds, refittedIds, rebuiltIds;
+    for (uint64_t i = 0; i < boxes.size(); i++)
+    {
+        movedIds.push_back(movedTree.insert(boxes[i], i));
+        refittedIds.push_back(refittedTree.insert(boxes[i], i));
+        rebuiltIds.push_back(rebuiltTree.insert(boxes[i], i));
+    }
+
+    std::mt19937 random(4);
+    std::uniform_real_distribution<float> step(-5.0f, 5.0f);
+    for (int frame = 0; frame < 10; frame++)
+    {
+        for (uint64_t i = 0; i < boxes.size(); i += 3)
+        {
+            const glm::vec3 offset(step(random), step(random), step(random));
+            boxes[i].min += offset;
+            boxes[i].max += offset;
+            movedTree.move(movedIds[i], boxes[i]);
+            refittedTree.setBox(refittedIds[i], boxes[i]);
+            rebuiltTree.setBox(rebuiltIds[i], boxes[i]);
+        }
+        refittedTree.refit();
+        rebuiltTree.rebuild();
+    }
+
+    expectQueriesMatchBruteForce(movedTree, boxes);
+    expectQueriesMatchBruteForce(refittedTree, boxes);
+    expectQueriesMatchBruteForce(rebuiltTree, boxes);
+    for (uint64_t i = 0; i < boxes.size(); i++)
+        EXPECT_EQ(rebuiltTree.userData(rebuiltIds[i]), i); // the leaves keep their id
+    EXPECT_LE(rebuiltTree.height(), 2 * static_cast<uint32_t>(std::ceil(std::log2(boxes.size()))));
+}
+
+TEST(AabbTreeTest, closestHit)
+{
+    GE::AabbTree tree;
+    for (uint64_t i = 0; i < 10; i++)
+    {
+        const glm::vec3 center(0.0f, 0.0f, -5.0f * static_cast<float>(i + 1));
+        tree.insert(GE::BoundingBox{ .min = center - glm::vec3(1.0f), .max = center + glm::vec3(1.0f) }, i);
+    }
+    tree.insert(GE::BoundingBox{ .min = glm::vec3(10.0f), .max = glm::vec3(11.0f) }, 100);
+
+    EXPECT_EQ(tree.closestHit(GE::Ray{ .origin = glm::vec3(0.0f), .direction = { 0.0f, 0.0f, -1.0f } }), 0u);
+    EXPECT_EQ(tree.closestHit(GE::Ray{ .origin = { 0.0f, 0.0f, -100.0f }, .direction = { 0.0f, 0.0f, 1.0f } }), 9u);
+    EXPECT_FALSE(tree.closestHit(GE::Ray{ .origin = glm::vec3(0.0f), .direction = { 0.0f, 1.0f, 0.0f } }).has_value());
+    EXPECT_FALSE(tree.closestHit(GE::Ray{ .origin = glm::vec3(0.0f), .direction = { 0.0f, 0.0f, -1.0f } }, 2.0f).has_value());
+}
+
+} // namespace
+
+} // namespace GE_tests
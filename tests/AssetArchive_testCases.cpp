@@ -0,0 +1,185 @@
+/*
+ * ---------------------------------------------------
+ * AssetArchive_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "GraphicsMocks.hpp"
+
+#include "Game-Engine/AssetArchive.hpp"
+#include "Game-Engine/AssetManager.hpp"
+#include "Game-Engine/TextureData.hpp"
+
+#include <Graphics/Texture.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+class AssetArchiveTest : public ::testing::Test
+{
+protected:
+    AssetArchiveTest()
+        : m_directory(std::filesystem::temp_directory_path() / ("GE_AssetArchiveTest_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name())))
+    {
+        std::filesystem::remove_all(m_directory);
+        std::filesystem::create_directories(m_directory);
+    }
+
+    ~AssetArchiveTest() override
+    {
+        std::error_code error;
+        std::filesystem::remove_all(m_directory, error);
+    }
+
+    static GE::TextureData makeTextureData(uint32_t width, uint32_t height)
+    {
+        auto pixels = std::make_shared<std::vector<std::byte>>(static_cast<size_t>(width) * height * 4);
+        for (size_t i = 0; i < pixels->size(); i++)
+            (*pixels)[i] = static_cast<std::byte>(i / 64 % 256);
+        return GE::TextureData{
+            .format = GE::TextureFormat::rgba8,
+            .mips = { { .width = width, .height = height, .bytes = *pixels } },
+            .storage = pixels
+        };
+    }
+
+    std::filesystem::path m_directory;
+};
+
+TEST_F(AssetArchiveTest, entriesRoundTrip)
+{
+    const GE::TextureData textureData = makeTextureData(64, 32);
+    const std::vector<std::byte> cookedFile = GE::serializeCookedTexture(textureData, 42);
+
+    GE::AssetArchiveWriter writer;
+    writer.add("Texture", "textures/stored.png", 42, cookedFile, GE::ArchiveCompression::none);
+    writer.add("Texture", "textures/compressed.png", 42, cookedFile, GE::ArchiveCompression::lz4);
+    writer.write(m_directory / "assets.gearchive");
+
+    const GE::AssetArchive archive(m_directory / "assets.gearchive");
+    ASSERT_EQ(archive.entries().size(), 2u);
+    EXPECT_EQ(archive.find("Mesh", "textures/stored.png"), nullptr);
+    EXPECT_EQ(archive.find("Texture", "textures/missing.png"), nullptr);
+
+    const GE::AssetArchive::Entry* stored = archive.find("Texture", "textures/stored.png");
+    const GE::AssetArchive::Entry* compressed = archive.find("Texture", std::filesystem::path("textures") / "compressed.png");
+    ASSERT_NE(stored, nullptr);
+    ASSERT_NE(compressed, nullptr);
+    EXPECT_EQ(stored->compression, GE::ArchiveCompression::none);
+    EXPECT_EQ(compressed->compression, GE::ArchiveCompression::lz4);
+    EXPECT_LT(compressed->size, compressed->uncompressedSize);
+
+    for (const GE::AssetArchive::Entry* entry : { stored, compressed })
+    {
+        const GE::AssetArchive::Blob blob = archive.read(*entry);
+        EXPECT_TRUE(std::ranges::equal(blob.bytes, cookedFile));
+        const std::optional<GE::TextureData> read = GE::readCookedTexture(blob.bytes, blob.storage, entry->key);
+        ASSERT_TRUE(read.has_value());
+        EXPECT_TRUE(std::ranges::equal(read->mips.front().bytes, textureData.mips.front().bytes));
+    }
+
+    // the uncompressed entries are read in place from the page aligned mapping
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(archive.read(*stored).bytes.data()) % GE::ASSET_ARCHIVE_BLOB_ALIGNMENT, 0u);
+}
+
+TEST_F(AssetArchiveTest, incompressibleEntriesAreStored)
+{
+    std::vector<std::byte> noise(10000);
+    std::mt19937 random(7);
+    std::ranges::generate(noise, [&]() { return static_cast<std::byte>(random()); });
+
+    GE::AssetArchiveWriter writer;
+    writer.add("Mesh", "noise.obj", 1, noise, GE::ArchiveCompression::lz4);
+    writer.write(m_directory / "assets.gearchive");
+
+    const GE::AssetArchive archive(m_directory / "assets.gearchive");
+    const GE::AssetArchive::Entry* entry = archive.find("Mesh", "noise.obj");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->compression, GE::ArchiveCompression::none);
+    EXPECT_TRUE(std::ranges::equal(archive.read(*entry).bytes, noise));
+}
+
+TEST_F(AssetArchiveTest, rejectsInvalidArchives)
+{
+    GE::AssetArchiveWriter writer;
+    writer.add("Texture", "a.png", 1, GE::serializeCookedTexture(makeTextureData(16, 16), 1));
+    writer.write(m_directory / "assets.gearchive");
+
+    const auto fileSize = std::filesystem::file_size(m_directory / "assets.gearchive");
+    std::filesystem::resize_file(m_directory / "assets.gearchive", fileSize - 1);
+    EXPECT_THROW(GE::AssetArchive(m_directory / "assets.gearchive"), std::runtime_error);
+
+    std::ofstream(m_directory / "garbage.gearchive") << "not an archive, not an archive, not an archive";
+    EXPECT_THROW(GE::AssetArchive(m_directory / "garbage.gearchive"), std::runtime_error);
+}
+
+TEST_F(AssetArchiveTest, addDirectoryCooksTheRecognizedFiles)
+{
+    std::filesystem::create_directories(m_directory / "resources" / "textures");
+    std::filesystem::copy_file(std::filesystem::path(GE_TEST_RESOURCE_DIR) / "dummy_texture.png", m_directory / "resources" / "textures" / "albedo.PNG");
+    std::ofstream(m_directory / "resources" / "readme.txt") << "not an asset";
+    std::ofstream(m_directory / "resources" / "broken.png") << "not an image";
+
+    GE::AssetArchiveWriter writer;
+    const std::vector<std::filesystem::path> failedFiles = writer.addDirectory(m_directory / "resources");
+    EXPECT_EQ(failedFiles, std::vector{ m_directory / "resources" / "broken.png" });
+    writer.write(m_directory / "assets.gearchive");
+
+    const GE::AssetArchive archive(m_directory / "assets.gearchive");
+    ASSERT_EQ(archive.entries().size(), 1u);
+    const GE::AssetArchive::Entry* entry = archive.find("Texture", "textures/albedo.PNG");
+    ASSERT_NE(entry, nullptr);
+    const GE::AssetArchive::Blob blob = archive.read(*entry);
+    EXPECT_TRUE(GE::readCookedTexture(blob.bytes, blob.storage, entry->key).has_value());
+}
+
+TEST_F(AssetManagerMockDeviceTest, archivedAssetsAreLoadedWithoutTheirSource)
+{
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "GE_AssetManagerTest_archive";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "textures");
+
+    auto pixels = std::make_shared<std::vector<std::byte>>(size_t(8) * 8 * 4, std::byte{0x7F});
+    const GE::TextureData textureData = { .format = GE::TextureFormat::rgba8, .mips = { { .width = 8, .height = 8, .bytes = *pixels } }, .storage = pixels };
+    GE::AssetArchiveWriter writer;
+    writer.add("Texture", "textures/albedo.png", 3, GE::serializeCookedTexture(textureData, 3), GE::ArchiveCompression::lz4);
+    writer.write(root / "assets.gearchive");
+
+    GE::AssetManager assetManager(&m_device);
+    assetManager.mountArchive(root / "assets.gearchive", root);
+    const GE::VAssetPath assetPath = GE::AssetPath<gfx::Texture>(root / "textures" / "albedo.png");
+    assetManager.registerAsset(assetPath);
+
+    const std::shared_ptr<gfx::Texture> texture = assetManager.loadAsset<gfx::Texture>(assetPath).get();
+    ASSERT_NE(texture, nullptr);
+    EXPECT_EQ(texture->width(), 8u);
+    EXPECT_EQ(assetManager.loadProgress(std::vector{ assetPath }).sourceBytes, GE::AssetArchive(root / "assets.gearchive").entries().front().size);
+
+    assetManager.unloadAsset(assetPath);
+    std::error_code error;
+    std::filesystem::remove_all(root, error);
+}
+
+} // namespace
+
+} // namespace GE_tests
@@ -9,23 +9,26 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "GraphicsMocks.hpp"
+
 #include "Game-Engine/AssetManager.hpp"
 #include "Game-Engine/AssetManagerView.hpp"
+#include "Game-Engine/Game.hpp"
 #include "Game-Engine/Scene.hpp"
 
-#include <Graphics/Buffer.hpp>
-#include <Graphics/CommandBuffer.hpp>
-#include <Graphics/CommandBufferPool.hpp>
-#include <Graphics/Device.hpp>
 #include <Graphics/Texture.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
-#include <cstring>
 #include <filesystem>
+#include <limits>
 #include <memory>
-#include <optional>
+#include <set>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace GE_tests
@@ -34,146 +37,36 @@ namespace GE_tests
 namespace
 {
 
-class MockBuffer final : public gfx::Buffer
+std::filesystem::path dummyTexturePath()
 {
-public:
-    explicit MockBuffer(const Descriptor& desc)
-        : m_desc(desc)
-        , m_bytes(desc.size)
-    {
-    }
-
-    size_t size() const override { return m_desc.size; }
-    gfx::BufferUsages usages() const override { return m_desc.usages; }
-    gfx::ResourceStorageMode storageMode() const override { return m_desc.storageMode; }
-
-    void setContent(const void* data, size_t size) override
-    {
-        if (size > m_bytes.size())
-            throw std::runtime_error("buffer overflow in mock buffer");
-        std::memcpy(m_bytes.data(), data, size);
-    }
-
-protected:
-    void* contentVoid() override { return m_bytes.data(); }
-
-private:
-    Descriptor m_desc;
-    std::vector<std::byte> m_bytes;
-};
+    return std::filesystem::path(GE_TEST_RESOURCE_DIR) / "dummy_texture.png";
+}
 
-class TestTexture final : public gfx::Texture
+// copies of the dummy texture, to have distinct assets
+class TextureCopies
 {
 public:
-    explicit TestTexture(const Descriptor& desc)
-        : m_desc(desc)
+    TextureCopies(const std::string& name, const std::vector<std::string>& fileNames)
+        : m_directory(std::filesystem::temp_directory_path() / name)
     {
+        std::filesystem::remove_all(m_directory);
+        std::filesystem::create_directories(m_directory);
+        for (const std::string& fileName : fileNames)
+            std::filesystem::copy_file(dummyTexturePath(), m_directory / fileName);
     }
 
-    gfx::TextureType type() const override { return m_desc.type; }
-    uint32_t width() const override { return m_desc.width; }
-    uint32_t height() const override { return m_desc.height; }
-    gfx::PixelFormat pixelFormat() const override { return m_desc.pixelFormat; }
-    gfx::TextureUsages usages() const override { return m_desc.usages; }
-    gfx::ResourceStorageMode storageMode() const override { return m_desc.storageMode; }
-
-#if defined(GFX_IMGUI_ENABLED)
-    void initImTextureId() override {}
-    std::optional<uint64_t> imTextureId() const override { return std::nullopt; }
-#endif
-
-private:
-    Descriptor m_desc;
-};
-
-class MockCommandBuffer : public gfx::CommandBuffer
-{
-public:
-    MOCK_METHOD(void, beginRenderPass, (const gfx::Framebuffer&), (override));
-    MOCK_METHOD(void, usePipeline, ((const std::shared_ptr<const gfx::GraphicsPipeline>&)), (override));
-    MOCK_METHOD(void, useVertexBuffer, ((const std::shared_ptr<gfx::Buffer>&)), (override));
-    MOCK_METHOD(void, setParameterBlock, ((const std::shared_ptr<const gfx::ParameterBlock>&), uint32_t), (override));
-    MOCK_METHOD(void, setPushConstants, (const void*, size_t), (override));
-    MOCK_METHOD(void, drawVertices, (uint32_t, uint32_t), (override));
-    MOCK_METHOD(void, drawIndexedVertices, ((const std::shared_ptr<gfx::Buffer>&)), (override));
-#if defined(GFX_IMGUI_ENABLED)
-    MOCK_METHOD(void, imGuiRenderDrawData, (ImDrawData*), (const, override));
-#endif
-    MOCK_METHOD(void, endRenderPass, (), (override));
-
-    MOCK_METHOD(void, beginBlitPass, (), (override));
-    MOCK_METHOD(void, copyBufferToBuffer, ((const std::shared_ptr<gfx::Buffer>&), (const std::shared_ptr<gfx::Buffer>&), size_t), (override));
-    MOCK_METHOD(void, copyBufferToTexture, ((const std::shared_ptr<gfx::Buffer>&), size_t, (const std::shared_ptr<gfx::Texture>&), uint32_t), (override));
-    MOCK_METHOD(void, endBlitPass, (), (override));
-    MOCK_METHOD(void, presentDrawable, ((const std::shared_ptr<gfx::Drawable>&)), (override));
-    MOCK_METHOD(void, addSampledTexture, ((const std::shared_ptr<gfx::Texture>&)), (override));
-};
-
-class MockCommandBufferPool : public gfx::CommandBufferPool
-{
-public:
-    MOCK_METHOD(std::shared_ptr<gfx::CommandBuffer>, get, (), (override));
-    MOCK_METHOD(void, reset, (), (override));
-};
+    GE::VAssetPath operator[](const std::string& fileName) const { return GE::AssetPath<gfx::Texture>(m_directory / fileName); }
 
-class MockDevice : public gfx::Device
-{
-public:
-    MOCK_METHOD(gfx::Backend, backend, (), (const, override));
-    MOCK_METHOD(std::unique_ptr<gfx::Swapchain>, newSwapchain, (const gfx::Swapchain::Descriptor&), (const, override));
-    MOCK_METHOD(std::unique_ptr<gfx::ShaderLib>, newShaderLib, (const std::filesystem::path&), (const, override));
-    MOCK_METHOD(std::unique_ptr<gfx::ParameterBlockLayout>, newParameterBlockLayout, (const gfx::ParameterBlockLayout::Descriptor&), (const, override));
-    MOCK_METHOD(std::unique_ptr<gfx::GraphicsPipeline>, newGraphicsPipeline, (const gfx::GraphicsPipeline::Descriptor&), (const, override));
-    MOCK_METHOD(std::unique_ptr<gfx::Buffer>, newBuffer, (const gfx::Buffer::Descriptor&), (const, override));
-    MOCK_METHOD(std::unique_ptr<gfx::Texture>, newTexture, (const gfx::Texture::Descriptor&), (const, override));
-    MOCK_METHOD(std::unique_ptr<gfx::CommandBufferPool>, newCommandBufferPool, (), (const, override));
-    MOCK_METHOD(std::unique_ptr<gfx::ParameterBlockPool>, newParameterBlockPool, (const gfx::ParameterBlockPool::Descriptor&), (const, override));
-    MOCK_METHOD(std::unique_ptr<gfx::Sampler>, newSampler, (const gfx::Sampler::Descriptor&), (const, override));
-
-#if defined(GFX_IMGUI_ENABLED)
-    MOCK_METHOD(void, imguiInit, (std::vector<gfx::PixelFormat>, std::optional<gfx::PixelFormat>), (const, override));
-    MOCK_METHOD(void, imguiNewFrame, (), (const, override));
-    MOCK_METHOD(void, imguiShutdown, (), (override));
-#endif
-
-    MOCK_METHOD(void, submitCommandBuffers, ((const std::shared_ptr<gfx::CommandBuffer>&)), (override));
-    MOCK_METHOD(void, submitCommandBuffers, ((const std::vector<std::shared_ptr<gfx::CommandBuffer>>&)), (override));
-    MOCK_METHOD(void, waitCommandBuffer, (const gfx::CommandBuffer&), (override));
-    MOCK_METHOD(void, waitIdle, (), (override));
-};
-
-class AssetManagerMockDeviceTest : public ::testing::Test
-{
-protected:
-    AssetManagerMockDeviceTest()
-        : m_commandBuffer(std::make_shared<testing::NiceMock<MockCommandBuffer>>())
+    ~TextureCopies()
     {
-        ON_CALL(m_device, backend()).WillByDefault(testing::Return(gfx::Backend::metal));
-        ON_CALL(m_device, newBuffer(testing::_)).WillByDefault([](const gfx::Buffer::Descriptor& desc) {
-            return std::make_unique<MockBuffer>(desc);
-        });
-        ON_CALL(m_device, newTexture(testing::_)).WillByDefault([](const gfx::Texture::Descriptor& desc) {
-            return std::make_unique<TestTexture>(desc);
-        });
-        ON_CALL(m_device, newCommandBufferPool()).WillByDefault([this]() {
-            auto pool = std::make_unique<testing::NiceMock<MockCommandBufferPool>>();
-            ON_CALL(*pool, get()).WillByDefault(testing::Return(m_commandBuffer));
-            return pool;
-        });
-        ON_CALL(*m_commandBuffer, copyBufferToBuffer(testing::_, testing::_, testing::_)).WillByDefault([](const std::shared_ptr<gfx::Buffer>& src, const std::shared_ptr<gfx::Buffer>& dst, size_t size) {
-            dst->setContent(src->content<std::byte>(), size);
-        });
+        std::error_code error;
+        std::filesystem::remove_all(m_directory, error);
     }
 
-    testing::NiceMock<MockDevice> m_device;
-    std::shared_ptr<testing::NiceMock<MockCommandBuffer>> m_commandBuffer;
+private:
+    std::filesystem::path m_directory;
 };
 
-std::filesystem::path dummyTexturePath()
-{
-    return std::filesystem::path(GE_TEST_RESOURCE_DIR) / "dummy_texture.png";
-}
-
 TEST_F(AssetManagerMockDeviceTest, reportsTextureLoadedState)
 {
     const std::filesystem::path texturePath = dummyTexturePath();
@@ -246,6 +139,464 @@ TEST_F(AssetManagerMockDeviceTest, loadAndUnloadAffectsAllRegisteredAssets)
     EXPECT_FALSE(scene.assetManagerView().isAssetLoaded(textureAssetId));
 }
 
+TEST_F(AssetManagerMockDeviceTest, sharedAssetsStayLoadedWhileAViewUsesThem)
+{
+    GE::AssetManager assetManager(&m_device);
+    GE::VAssetPath textureAssetPath = GE::AssetPath<gfx::Texture>(dummyTexturePath());
+
+    GE::AssetManagerView firstView(&assetManager, { { textureAssetPath, 1 } });
+    GE::AssetManagerView secondView(&assetManager, { { textureAssetPath, 1 } });
+
+    firstView.loadAllAssets().get();
+    secondView.loadAllAssets().get();
+    EXPECT_EQ(assetManager.assetReferenceCount(textureAssetPath), 2u);
+
+    firstView.unloadAllAssets();
+    EXPECT_EQ(assetManager.assetReferenceCount(textureAssetPath), 1u);
+    EXPECT_TRUE(secondView.isAssetLoaded(1));
+
+    secondView.unloadAllAssets();
+    EXPECT_EQ(assetManager.assetReferenceCount(textureAssetPath), 0u);
+    EXPECT_FALSE(secondView.isAssetLoaded(1));
+    EXPECT_EQ(assetManager.residentBytes(), 0u);
+}
+
+TEST_F(AssetManagerMockDeviceTest, unreferencedAssetsAreReusedWithinTheBudget)
+{
+    EXPECT_CALL(m_device, newTexture(testing::_)).Times(1);
+
+    GE::AssetManager assetManager(&m_device);
+    assetManager.setResidencyBudget(SIZE_MAX);
+    GE::VAssetPath textureAssetPath = GE::AssetPath<gfx::Texture>(dummyTexturePath());
+
+    {
+        GE::AssetManagerView view(&assetManager, { { textureAssetPath, 1 } });
+        view.loadAllAssets().get();
+    }
+    EXPECT_EQ(assetManager.assetReferenceCount(textureAssetPath), 0u);
+    EXPECT_TRUE(assetManager.isAssetLoaded(textureAssetPath));
+    const size_t textureBytes = assetManager.residentBytes();
+    EXPECT_GT(textureBytes, 0u);
+
+    // an other scene using the same texture does not load it again
+    GE::AssetManagerView view(&assetManager, { { textureAssetPath, 1 } });
+    view.loadAllAssets().get();
+    EXPECT_EQ(assetManager.residentBytes(), textureBytes);
+
+    view.unloadAllAssets();
+    EXPECT_TRUE(assetManager.isAssetLoaded(textureAssetPath));
+    assetManager.setResidencyBudget(textureBytes - 1);
+    EXPECT_FALSE(assetManager.isAssetLoaded(textureAssetPath));
+    EXPECT_EQ(assetManager.residentBytes(), 0u);
+}
+
+TEST_F(AssetManagerMockDeviceTest, leastRecentlyReleasedAssetsAreEvictedFirst)
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "GE_AssetManagerTest_lru";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::filesystem::copy_file(dummyTexturePath(), directory / "first.png");
+    std::filesystem::copy_file(dummyTexturePath(), directory / "second.png");
+
+    GE::AssetManager assetManager(&m_device);
+    assetManager.setResidencyBudget(SIZE_MAX);
+    GE::VAssetPath firstAssetPath = GE::AssetPath<gfx::Texture>(directory / "first.png");
+    GE::VAssetPath secondAssetPath = GE::AssetPath<gfx::Texture>(directory / "second.png");
+
+    GE::AssetManagerView view(&assetManager, { { firstAssetPath, 1 }, { secondAssetPath, 2 } });
+    view.loadAllAssets().get();
+    const size_t textureBytes = assetManager.residentBytes() / 2;
+
+    view.unloadAsset(1);
+    view.unloadAsset(2);
+    EXPECT_TRUE(assetManager.isAssetLoaded(firstAssetPath));
+    EXPECT_TRUE(assetManager.isAssetLoaded(secondAssetPath));
+
+    assetManager.setResidencyBudget(textureBytes);
+    EXPECT_FALSE(assetManager.isAssetLoaded(firstAssetPath));
+    EXPECT_TRUE(assetManager.isAssetLoaded(secondAssetPath));
+
+    // a referenced asset is never evicted
+    view.loadAsset<gfx::Texture>(2).get();
+    assetManager.setResidencyBudget(1);
+    EXPECT_TRUE(assetManager.isAssetLoaded(secondAssetPath));
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+}
+
+TEST_F(AssetManagerMockDeviceTest, dependenciesAreLoadedAndRetainedWithTheirAsset)
+{
+    TextureCopies textures("GE_AssetManagerTest_dependencies", { "material.png", "albedo.png" });
+    GE::AssetManager assetManager(&m_device);
+    assetManager.registerAsset(textures["material.png"]);
+    assetManager.registerAsset(textures["albedo.png"]);
+    assetManager.addAssetDependency(textures["material.png"], textures["albedo.png"]);
+
+    GE::AssetManagerView view(&assetManager, { { textures["material.png"], 1 } });
+    GE::AssetManager::LoadProgress progress = view.allAssetsLoadProgress();
+    EXPECT_EQ(progress.assetCount, 2u);
+    EXPECT_EQ(progress.loadedAssetCount, 0u);
+    EXPECT_EQ(progress.sourceBytes, 2 * std::filesystem::file_size(dummyTexturePath()));
+    EXPECT_FALSE(progress.isComplete());
+
+    view.loadAllAssets().get();
+    assetManager.loadAsset<gfx::Texture>(textures["albedo.png"]).get();
+    EXPECT_EQ(assetManager.assetReferenceCount(textures["albedo.png"]), 1u);
+
+    progress = view.allAssetsLoadProgress();
+    EXPECT_TRUE(progress.isComplete());
+    EXPECT_FLOAT_EQ(progress.ratio(), 1.0f);
+    EXPECT_EQ(progress.residentBytes, assetManager.residentBytes());
+
+    view.unloadAllAssets();
+    EXPECT_EQ(assetManager.assetReferenceCount(textures["albedo.png"]), 0u);
+    EXPECT_FALSE(assetManager.isAssetLoaded(textures["albedo.png"]));
+}
+
+TEST_F(AssetManagerMockDeviceTest, dependencyClosureListsTheDependenciesFirst)
+{
+    TextureCopies textures("GE_AssetManagerTest_closure", { "a.png", "b.png", "c.png" });
+    GE::AssetManager assetManager(&m_device);
+    for (const char* name : { "a.png", "b.png", "c.png" })
+        assetManager.registerAsset(textures[name]);
+
+    assetManager.addAssetDependency(textures["a.png"], textures["b.png"]);
+    assetManager.addAssetDependency(textures["a.png"], textures["c.png"]);
+    assetManager.addAssetDependency(textures["b.png"], textures["c.png"]);
+
+    const std::vector<GE::VAssetPath> closure = assetManager.dependencyClosure(std::vector{ textures["a.png"] });
+    EXPECT_EQ(closure, (std::vector{ textures["c.png"], textures["b.png"], textures["a.png"] }));
+
+    EXPECT_THROW(assetManager.addAssetDependency(textures["c.png"], textures["a.png"]), std::runtime_error);
+    EXPECT_TRUE(assetManager.assetDependencies(textures["c.png"]).empty());
+}
+
+TEST_F(AssetManagerMockDeviceTest, pathsToTheSameFileShareOneAsset)
+{
+    TextureCopies textures("GE_AssetManagerTest_aliases", { "albedo.png" });
+    const std::filesystem::path absolutePath = std::get<GE::AssetPath<gfx::Texture>>(textures["albedo.png"]).path;
+    const std::filesystem::path relativePath = std::filesystem::relative(absolutePath);
+    const std::filesystem::path symlinkPath = absolutePath.parent_path() / "link.png";
+    std::filesystem::create_symlink(absolutePath, symlinkPath);
+
+    EXPECT_CALL(m_device, newTexture(testing::_)).Times(1);
+
+    GE::AssetManager assetManager(&m_device);
+    GE::AssetManagerView view(&assetManager);
+    const GE::AssetID absoluteId = view.registerAsset<gfx::Texture>(absolutePath);
+    const GE::AssetID relativeId = view.registerAsset<gfx::Texture>(relativePath);
+    const GE::AssetID symlinkId = view.registerAsset<gfx::Texture>(symlinkPath);
+    EXPECT_EQ(view.registerAsset<gfx::Texture>(absolutePath), absoluteId);
+    EXPECT_EQ(relativeId, absoluteId + 1); // registering a path twice does not consume an id
+    EXPECT_EQ(symlinkId, relativeId + 1);
+
+    EXPECT_EQ(view.getAsset<gfx::Texture>(absoluteId), view.getAsset<gfx::Texture>(relativeId));
+    EXPECT_EQ(view.getAsset<gfx::Texture>(absoluteId), view.getAsset<gfx::Texture>(symlinkId));
+    EXPECT_EQ(assetManager.assetReferenceCount(GE::AssetPath<gfx::Texture>(absolutePath)), 3u);
+
+    view.unloadAsset(absoluteId);
+    view.unloadAsset(relativeId);
+    EXPECT_TRUE(assetManager.isAssetLoaded(GE::AssetPath<gfx::Texture>(symlinkPath)));
+    view.unloadAsset(symlinkId);
+    EXPECT_FALSE(assetManager.isAssetLoaded(GE::AssetPath<gfx::Texture>(relativePath)));
+}
+
+TEST_F(AssetManagerMockDeviceTest, identicalTexturesShareOneAssetWithContentDeduplication)
+{
+    TextureCopies textures("GE_AssetManagerTest_contentDeduplication", { "wall.png", "floor.png", "ceiling.png", "roof.png" });
+    EXPECT_CALL(m_device, newTexture(testing::_)).Times(2);
+
+    GE::AssetManager assetManager(&m_device);
+    assetManager.registerAsset(textures["wall.png"]);
+    assetManager.setContentDeduplication(true);
+    for (const char* name : { "floor.png", "ceiling.png", "roof.png" })
+        assetManager.registerAsset(textures[name]);
+
+    assetManager.loadAssets(std::vector{ textures["wall.png"], textures["floor.png"], textures["ceiling.png"], textures["roof.png"] }).get();
+    EXPECT_EQ(assetManager.loadAsset<gfx::Texture>(textures["floor.png"]).get(), assetManager.loadAsset<gfx::Texture>(textures["roof.png"]).get());
+    EXPECT_NE(assetManager.loadAsset<gfx::Texture>(textures["wall.png"]).get(), assetManager.loadAsset<gfx::Texture>(textures["roof.png"]).get());
+
+    const GE::AssetManager::DeduplicationStatistics statistics = assetManager.deduplicationStatistics();
+    EXPECT_EQ(statistics.registeredPathCount, 4u);
+    EXPECT_EQ(statistics.uniqueAssetCount, 2u);
+    EXPECT_EQ(statistics.savedBytes, assetManager.residentBytes()); // the 2 duplicates of one of the 2 loaded textures
+
+    RecordProperty("residentBytes", std::to_string(assetManager.residentBytes()));
+    RecordProperty("savedBytes", std::to_string(statistics.savedBytes));
+}
+
+TEST_F(AssetManagerMockDeviceTest, writtenSourceIsReloadedAndSwappedAtTheEndOfAFrame)
+{
+    TextureCopies textures("GE_AssetManagerTest_hotReload", { "albedo.png", "unloaded.png" });
+    GE::AssetManager assetManager(&m_device);
+    assetManager.registerAsset(textures["albedo.png"]);
+    assetManager.registerAsset(textures["unloaded.png"]);
+    assetManager.enableHotReload(std::get<GE::AssetPath<gfx::Texture>>(textures["albedo.png"]).path.parent_path());
+    ASSERT_TRUE(assetManager.isHotReloadEnabled());
+
+    const std::shared_ptr<gfx::Texture> texture = assetManager.loadAsset<gfx::Texture>(textures["albedo.png"]).get();
+    const size_t residentBytes = assetManager.residentBytes();
+
+    for (const char* name : { "albedo.png", "unloaded.png" })
+    {
+        const std::filesystem::path path = std::get<GE::AssetPath<gfx::Texture>>(textures[name]).path;
+        std::filesystem::copy_file(dummyTexturePath(), path, std::filesystem::copy_options::overwrite_existing);
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (assetManager.loadAsset<gfx::Texture>(textures["albedo.png"]).get() == texture && std::chrono::steady_clock::now() < deadline)
+    {
+        assetManager.endFrame();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    // the frames still using the previous texture keep it alive
+    EXPECT_NE(assetManager.loadAsset<gfx::Texture>(textures["albedo.png"]).get(), texture);
+    EXPECT_EQ(texture->width(), assetManager.loadAsset<gfx::Texture>(textures["albedo.png"]).get()->width());
+    EXPECT_EQ(assetManager.residentBytes(), residentBytes);
+    EXPECT_FALSE(assetManager.isAssetLoaded(textures["unloaded.png"]));
+
+    assetManager.disableHotReload();
+    EXPECT_FALSE(assetManager.isHotReloadEnabled());
+}
+
+TEST_F(AssetManagerMockDeviceTest, loadsAreRecordedInTheStatistics)
+{
+    TextureCopies textures("GE_AssetManagerTest_statistics", { "albedo.png", "normal.png" });
+    GE::AssetManager assetManager(&m_device);
+    assetManager.registerAsset(textures["albedo.png"]);
+    assetManager.registerAsset(textures["normal.png"]);
+
+    assetManager.loadAssets(std::vector{ textures["albedo.png"], textures["normal.png"] }).get();
+    assetManager.unloadAsset(textures["normal.png"]);
+
+    const GE::AssetStatistics statistics = assetManager.statistics();
+    EXPECT_EQ(statistics.loadCount, 2u);
+    EXPECT_EQ(statistics.unloadCount, 1u);
+    EXPECT_EQ(statistics.failedLoadCount, 0u);
+    EXPECT_EQ(statistics.readBytes, 2 * std::filesystem::file_size(dummyTexturePath()));
+    EXPECT_EQ(statistics.residentBytes, assetManager.residentBytes());
+    EXPECT_EQ(statistics.loadTimes.count(), 2u);
+
+    ASSERT_TRUE(statistics.types.contains("Texture"));
+    EXPECT_EQ(statistics.types.at("Texture").assetCount, 2u);
+    EXPECT_EQ(statistics.types.at("Texture").loadedCount, 1u);
+    EXPECT_EQ(statistics.types.at("Texture").residentBytes, assetManager.residentBytes());
+
+    ASSERT_EQ(statistics.records.size(), 2u);
+    for (const GE::AssetLoadRecord& record : statistics.records)
+    {
+        EXPECT_EQ(record.type, "Texture");
+        EXPECT_FALSE(record.failed);
+        EXPECT_EQ(record.sourceBytes, std::filesystem::file_size(dummyTexturePath()));
+        EXPECT_GT(record.residentBytes, 0u);
+    }
+    EXPECT_NE(statistics.toJson().find("\"loadCount\":2"), std::string::npos);
+
+    assetManager.resetStatistics();
+    EXPECT_EQ(assetManager.statistics().loadCount, 0u);
+    EXPECT_TRUE(assetManager.statistics().records.empty());
+}
+
+TEST_F(AssetManagerMockDeviceTest, assetsAreRegisteredAndLoadedFromManyThreads)
+{
+    constexpr int THREAD_COUNT = 8;
+    constexpr int TEXTURE_COUNT = 32;
+    std::vector<std::string> fileNames;
+    for (int i = 0; i < TEXTURE_COUNT; i++)
+        fileNames.push_back("texture_" + std::to_string(i) + ".png");
+    TextureCopies textures("GE_AssetManagerTest_threads", fileNames);
+    EXPECT_CALL(m_device, newTexture(testing::_)).Times(TEXTURE_COUNT);
+
+    GE::AssetManager assetManager(&m_device);
+    assetManager.setResidencyBudget(std::numeric_limits<size_t>::max()); // released assets stay loaded, each is loaded once
+
+    std::vector<std::vector<GE::AssetID>> assetIds(THREAD_COUNT);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; t++)
+    {
+        threads.emplace_back([&, t]() {
+            GE::AssetManagerView assetManagerView(&assetManager);
+            // each thread starts with a different texture, half of them through an other path to the same files
+            for (int i = 0; i < TEXTURE_COUNT; i++)
+            {
+                std::filesystem::path path = std::get<GE::AssetPath<gfx::Texture>>(textures[fileNames[(t + i) % TEXTURE_COUNT]]).path;
+                if (t % 2 == 1)
+                    path = path.parent_path() / "." / path.filename();
+                const GE::AssetID assetId = assetManagerView.registerAsset<gfx::Texture>(path);
+                assetManagerView.loadAsset<gfx::Texture>(assetId).get();
+                EXPECT_TRUE(assetManagerView.isAssetLoaded(assetId));
+                assetIds[t].push_back(assetId);
+            }
+            EXPECT_TRUE(assetManagerView.allAssetsLoadProgress().isComplete());
+            assetManagerView.unloadAllAssets();
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    std::set<GE::AssetID> uniqueAssetIds;
+    for (const std::vector<GE::AssetID>& ids : assetIds)
+        uniqueAssetIds.insert(ids.begin(), ids.end());
+    EXPECT_EQ(uniqueAssetIds.size(), static_cast<size_t>(THREAD_COUNT * TEXTURE_COUNT));
+
+    const GE::AssetManager::DeduplicationStatistics statistics = assetManager.deduplicationStatistics();
+    EXPECT_EQ(statistics.registeredPathCount, static_cast<uint32_t>(2 * TEXTURE_COUNT));
+    EXPECT_EQ(statistics.uniqueAssetCount, static_cast<uint32_t>(TEXTURE_COUNT));
+    EXPECT_EQ(assetManager.statistics().loadCount, static_cast<uint64_t>(TEXTURE_COUNT));
+    for (const std::string& fileName : fileNames)
+    {
+        EXPECT_TRUE(assetManager.isAssetLoaded(textures[fileName]));
+        EXPECT_EQ(assetManager.assetReferenceCount(textures[fileName]), 0u);
+    }
+}
+
+// a handle found by its canonical path must be complete even while the registration of an other path to it is running
+TEST_F(AssetManagerMockDeviceTest, canonicalLookupDuringRegistration)
+{
+    constexpr int THREAD_COUNT = 4;
+    constexpr int TEXTURE_COUNT = 64;
+    std::vector<std::string> fileNames;
+    for (int i = 0; i < TEXTURE_COUNT; i++)
+        fileNames.push_back("texture_" + std::to_string(i) + ".png");
+    TextureCopies textures("GE_AssetManagerTest_canonicalLookup", fileNames);
+
+    GE::AssetManager assetManager(&m_device);
+    std::atomic<int> waitingCount = 0;
+    std::vector<std::thread> lookups;
+    for (int t = 0; t < THREAD_COUNT; t++)
+    {
+        lookups.emplace_back([&, t]() {
+            waitingCount++;
+            for (int i = t; i < TEXTURE_COUNT; i += THREAD_COUNT)
+            {
+                const GE::VAssetPath canonicalPath = GE::AssetPath<gfx::Texture>(std::filesystem::weakly_canonical(std::get<GE::AssetPath<gfx::Texture>>(textures[fileNames[i]]).path));
+                std::shared_ptr<gfx::Texture> texture;
+                while (texture == nullptr)
+                {
+                    try
+                    {
+                        texture = assetManager.loadAsset<gfx::Texture>(canonicalPath).get();
+                        ASSERT_NE(texture, nullptr);
+                    }
+                    catch (const std::out_of_range&)
+                    {
+                        std::this_thread::yield(); // not registered yet
+                    }
+                }
+                EXPECT_TRUE(assetManager.isAssetLoaded(canonicalPath));
+            }
+        });
+    }
+
+    // the lookups are already spinning when the relative paths are registered
+    while (waitingCount.load() < THREAD_COUNT)
+        std::this_thread::yield();
+    for (const std::string& fileName : fileNames)
+        assetManager.registerAsset(GE::AssetPath<gfx::Texture>(std::filesystem::relative(std::get<GE::AssetPath<gfx::Texture>>(textures[fileName]).path)));
+    for (std::thread& lookup : lookups)
+        lookup.join();
+    EXPECT_EQ(assetManager.deduplicationStatistics().uniqueAssetCount, static_cast<uint32_t>(TEXTURE_COUNT));
+}
+
+// the asset returned to an other thread stays valid while endFrame swaps in the reloaded one
+TEST_F(AssetManagerMockDeviceTest, getAssetDuringAReloadSwap)
+{
+    TextureCopies textures("GE_AssetManagerTest_reloadSwap", { "albedo.png" });
+    GE::AssetManager assetManager(&m_device);
+    assetManager.registerAsset(textures["albedo.png"]);
+    assetManager.enableHotReload(std::get<GE::AssetPath<gfx::Texture>>(textures["albedo.png"]).path.parent_path());
+
+    const std::shared_ptr<gfx::Texture> texture = assetManager.loadAsset<gfx::Texture>(textures["albedo.png"]).get();
+    std::atomic<bool> swapped = false;
+    std::thread reader([&]() {
+        GE::VAssetPath assetPath = textures["albedo.png"];
+        while (swapped.load() == false)
+        {
+            const std::shared_ptr<gfx::Texture> current = assetManager.getAsset<gfx::Texture>(assetPath);
+            ASSERT_NE(current, nullptr);
+            EXPECT_EQ(current->width(), texture->width());
+        }
+    });
+
+    const std::filesystem::path path = std::get<GE::AssetPath<gfx::Texture>>(textures["albedo.png"]).path;
+    std::filesystem::copy_file(dummyTexturePath(), path, std::filesystem::copy_options::overwrite_existing);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (assetManager.loadAsset<gfx::Texture>(textures["albedo.png"]).get() == texture && std::chrono::steady_clock::now() < deadline)
+    {
+        assetManager.endFrame();
+        std::this_thread::yield();
+    }
+    swapped.store(true);
+    reader.join();
+    EXPECT_NE(assetManager.loadAsset<gfx::Texture>(textures["albedo.png"]).get(), texture);
+}
+
+TEST_F(AssetManagerMockDeviceTest, preloadedSceneSwapsWithoutReloadingSharedAssets)
+{
+    TextureCopies textures("GE_AssetManagerTest_preload", { "shared.png", "first.png", "second.png" });
+    EXPECT_CALL(m_device, newTexture(testing::_)).Times(3);
+
+    GE::AssetManager assetManager(&m_device);
+    GE::Game game(&assetManager, nullptr, GE::Game::Descriptor{
+        .scenes = {
+            { "first", GE::Scene::Descriptor{ .name = "first", .registredAssets = { { textures["shared.png"], 1 }, { textures["first.png"], 2 } } } },
+            { "second", GE::Scene::Descriptor{ .name = "second", .registredAssets = { { textures["shared.png"], 1 }, { textures["second.png"], 2 } } } },
+        },
+        .activeScene = "first",
+        .inputContext = {}
+    });
+    game.activeScene().load().get();
+
+    game.preloadScene("second");
+    EXPECT_EQ(game.sceneLoadProgress("second").assetCount, 2u);
+    game.activeScene().load().get();
+    game.setActiveScene("first"); // a no-op swap keeps everything loaded
+    EXPECT_TRUE(assetManager.isAssetLoaded(textures["first.png"]));
+
+    assetManager.loadAsset<gfx::Texture>(textures["second.png"]).get();
+    EXPECT_TRUE(game.sceneLoadProgress("second").isComplete());
+
+    game.setActiveScene("second");
+    EXPECT_TRUE(game.activeScene().isLoaded());
+    EXPECT_TRUE(assetManager.isAssetLoaded(textures["shared.png"]));
+    EXPECT_FALSE(assetManager.isAssetLoaded(textures["first.png"]));
+}
+
+TEST_F(AssetManagerMockDeviceTest, sceneSpatialIndexFollowsTheEntities)
+{
+    GE::AssetManager assetManager(&m_device);
+    GE::Scene scene(&assetManager, GE::Scene::Descriptor{
+        .name = "spatial_index",
+        .registredAssets = { { GE::AssetPath<GE::Mesh>(), GE::BUILT_IN_CUBE_ASSET_ID } }
+    });
+    GE::Entity first = scene.newEntity("first");
+    first.emplace<GE::TransformComponent>(GE::TransformComponent{ .position = { 0.0f, 0.0f, -5.0f } });
+    first.emplace<GE::MeshComponent>(GE::BUILT_IN_CUBE_ASSET_ID);
+    GE::Entity second = scene.newEntity("second");
+    second.emplace<GE::TransformComponent>(GE::TransformComponent{ .position = { 0.0f, 0.0f, -10.0f } });
+    second.emplace<GE::MeshComponent>(GE::BUILT_IN_CUBE_ASSET_ID);
+
+    scene.updateSpatialIndex();
+    EXPECT_EQ(scene.spatialIndex().size(), 0u); // the mesh is not loaded yet
+
+    scene.load().get();
+    scene.updateSpatialIndex();
+    EXPECT_EQ(scene.spatialIndex().size(), 2u);
+    const GE::Ray ray = { .origin = glm::vec3(0.0f), .direction = { 0.0f, 0.0f, -1.0f } };
+    EXPECT_EQ(scene.spatialIndex().closestHit(ray), first.entityId);
+
+    first.get<GE::TransformComponent>().position.x = 10.0f;
+    scene.updateSpatialIndex();
+    EXPECT_EQ(scene.spatialIndex().closestHit(ray), second.entityId);
+
+    second.destroy();
+    scene.updateSpatialIndex();
+    EXPECT_EQ(scene.spatialIndex().size(), 1u);
+    EXPECT_FALSE(scene.spatialIndex().closestHit(ray).has_value());
+}
+
 } // namespace
 
 } // namespace GE_tests
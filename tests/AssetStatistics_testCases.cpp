@@ -0,0 +1,102 @@
+/*
+ * ---------------------------------------------------
+ * AssetStatistics_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/AssetStatistics.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+using std::chrono::microseconds;
+
+TEST(DurationHistogramTest, bucketsArePowersOfTwo)
+{
+    GE::DurationHistogram histogram;
+    for (int64_t duration : { 0, 1, 2, 3, 4, 1000 })
+        histogram.record(microseconds(duration));
+
+    EXPECT_EQ(histogram.count(), 6u);
+    EXPECT_EQ(histogram.buckets()[0], 2u); // 0 and 1
+    EXPECT_EQ(histogram.buckets()[1], 2u); // 2 and 3
+    EXPECT_EQ(histogram.buckets()[2], 1u);
+    EXPECT_EQ(histogram.buckets()[9], 1u); // [512, 1024)
+    EXPECT_EQ(histogram.min(), microseconds(0));
+    EXPECT_EQ(histogram.max(), microseconds(1000));
+    EXPECT_EQ(histogram.total(), microseconds(1010));
+}
+
+TEST(DurationHistogramTest, percentilesAreBucketUpperBounds)
+{
+    GE::DurationHistogram histogram;
+    EXPECT_EQ(histogram.percentile(0.5), microseconds(0));
+
+    for (int i = 0; i < 90; i++)
+        histogram.record(microseconds(100)); // [64, 128)
+    for (int i = 0; i < 10; i++)
+        histogram.record(microseconds(5000)); // [4096, 8192)
+
+    EXPECT_EQ(histogram.percentile(0.5), microseconds(128));
+    EXPECT_EQ(histogram.percentile(0.9), microseconds(128));
+    EXPECT_EQ(histogram.percentile(0.99), microseconds(5000)); // clamped to the maximum
+    EXPECT_EQ(histogram.mean(), microseconds(590));
+}
+
+TEST(AssetLoadRecorderTest, failedLoadsAreCountedOutOfTheHistograms)
+{
+    GE::AssetLoadRecorder recorder;
+    recorder.record({ .type = "Mesh", .path = "a.obj", .readTime = microseconds(10), .sourceBytes = 100 });
+    recorder.record({ .type = "Mesh", .path = "b.obj", .failed = true, .sourceBytes = 50 });
+    recorder.record({ .type = "Texture", .path = "c.png", .reload = true, .decodeTime = microseconds(20), .sourceBytes = 10 });
+    recorder.countEviction();
+
+    GE::AssetStatistics statistics;
+    recorder.fill(statistics);
+    EXPECT_EQ(statistics.loadCount, 2u);
+    EXPECT_EQ(statistics.reloadCount, 1u);
+    EXPECT_EQ(statistics.failedLoadCount, 1u);
+    EXPECT_EQ(statistics.evictionCount, 1u);
+    EXPECT_EQ(statistics.readBytes, 160u);
+    EXPECT_EQ(statistics.loadTimes.count(), 2u);
+    EXPECT_EQ(statistics.records.size(), 3u);
+}
+
+TEST(AssetLoadRecorderTest, onlyTheLastRecordsAreKept)
+{
+    GE::AssetLoadRecorder recorder;
+    for (size_t i = 0; i < GE::AssetLoadRecorder::RECORD_CAPACITY + 10; i++)
+        recorder.record({ .type = "Mesh", .path = std::to_string(i) });
+
+    GE::AssetStatistics statistics;
+    recorder.fill(statistics);
+    EXPECT_EQ(statistics.loadCount, GE::AssetLoadRecorder::RECORD_CAPACITY + 10);
+    ASSERT_EQ(statistics.records.size(), GE::AssetLoadRecorder::RECORD_CAPACITY);
+    EXPECT_EQ(statistics.records.front().path, "10");
+}
+
+TEST(AssetStatisticsTest, jsonEscapesThePaths)
+{
+    GE::AssetStatistics statistics;
+    statistics.records.push_back({ .type = "Texture", .path = "dir/\"quoted\"\\name.png" });
+    const std::string json = statistics.toJson();
+
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_NE(json.find(R"("path":"dir/\"quoted\"\\name.png")"), std::string::npos);
+}
+
+} // namespace
+
+} // namespace GE_tests
@@ -0,0 +1,414 @@
+/*
+ * ---------------------------------------------------
+ * AssetStreamer_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "GraphicsMocks.hpp"
+
+#include "Game-Engine/AssetManager.hpp"
+#include "Game-Engine/AssetStreamer.hpp"
+#include "Game-Engine/GeometryPool.hpp"
+#include "Game-Engine/MeshData.hpp"
+#include "Game-Engine/TextureData.hpp"
+
+#include <Graphics/Texture.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+GE::TextureData makeTextureData(uint32_t size)
+{
+    auto pixels = std::make_shared<std::vector<std::byte>>(static_cast<size_t>(size) * size * 4, std::byte{ 128 });
+    return GE::cookTexture(GE::TextureData{ .mips = { { .width = size, .height = size, .bytes = *pixels } }, .storage = pixels }, {});
+}
+
+// one geometry with `lodCount` levels of detail halving the triangle count, used by two nodes
+GE::MeshData makeMeshData(uint32_t triangleCount, uint32_t lodCount)
+{
+    struct Storage
+    {
+        std::vector<GE::Vertex> vertices;
+        std::vector<std::vector<uint32_t>> indices;
+    };
+    auto storage = std::make_shared<Storage>();
+    storage->vertices.resize(triangleCount * 3);
+    for (uint32_t level = 0; level <= lodCount; level++)
+    {
+        std::vector<uint32_t>& indices = storage->indices.emplace_back();
+        for (uint32_t i = 0; i < (triangleCount >> level) * 3; i++)
+            indices.push_back(i);
+    }
+
+    GE::MeshData::Geometry geometry{
+        .name = "geometry",
+        .vertices = std::span<const GE::Vertex>(storage->vertices),
+        .indices = std::span<const uint32_t>(storage->indices[0]),
+        .boundingSphere = { .radius = 1.0f }
+    };
+    for (uint32_t level = 1; level <= lodCount; level++)
+        geometry.lods.push_back({ .indices = std::span<const uint32_t>(storage->indices[level]), .error = static_cast<float>(level) });
+
+    return GE::MeshData{
+        .name = "mesh",
+        .geometries = { std::move(geometry) },
+        .nodes = {
+            { .geometry = 0, .parent = -1, .transform = glm::mat4x4(1.0f) },
+            { .geometry = 0, .parent = 0, .transform = glm::mat4x4(1.0f) },
+        },
+        .storage = storage
+    };
+}
+
+const std::shared_ptr<gfx::Buffer>& lodIndexBuffer(const GE::SubMesh& subMesh, uint32_t level)
+{
+    return level == 0 ? subMesh.indexBuffer : subMesh.lods[level - 1].indexBuffer;
+}
+
+TEST(AssetStreamerTest, selectMip)
+{
+    EXPECT_EQ(GE::selectMip(256, 256, 256.0f), 0u);
+    EXPECT_EQ(GE::selectMip(256, 256, 1000.0f), 0u);
+    EXPECT_EQ(GE::selectMip(256, 256, 200.0f), 0u);
+    EXPECT_EQ(GE::selectMip(256, 256, 128.0f), 1u);
+    EXPECT_EQ(GE::selectMip(256, 128, 100.0f), 1u);
+    EXPECT_EQ(GE::selectMip(256, 256, 0.5f), 8u);
+    EXPECT_EQ(GE::selectMip(256, 256, 0.0f), 8u);
+}
+
+TEST_F(AssetManagerMockDeviceTest, streamedTextureKeepsTheMipTailResident)
+{
+    std::vector<uint32_t> changedWidths;
+    GE::StreamedTexture texture(m_device, *m_commandBuffer, makeTextureData(256), [&](const std::shared_ptr<gfx::Texture>& texture) {
+        changedWidths.push_back(texture->width());
+    });
+
+    // 256, 128 and the 64x64 mip tail
+    ASSERT_EQ(texture.levelCount(), 3u);
+    EXPECT_EQ(texture.residentLevel(), 2u);
+    EXPECT_EQ(texture.texture()->width(), 64u);
+    EXPECT_EQ(texture.residentBytes(), 64u * 64 * 4);
+    EXPECT_EQ(texture.uploadSize(0), 256u * 256 * 4);
+    EXPECT_EQ(texture.uploadSize(2), 0u);
+
+    texture.makeResident(0, m_device, *m_commandBuffer);
+    EXPECT_EQ(texture.residentLevel(), 0u);
+    EXPECT_EQ(texture.texture()->width(), 256u);
+    EXPECT_EQ(texture.residentBytes(), 256u * 256 * 4 + 64 * 64 * 4);
+
+    // evicting never uploads, the texture falls back to the mip tail
+    EXPECT_CALL(m_device, newTexture(testing::_)).Times(0);
+    texture.evict(1);
+    EXPECT_EQ(texture.residentLevel(), 2u);
+    EXPECT_EQ(texture.texture()->width(), 64u);
+    EXPECT_EQ(texture.residentBytes(), 64u * 64 * 4);
+
+    EXPECT_EQ(changedWidths, (std::vector<uint32_t>{ 256, 64 }));
+}
+
+TEST_F(AssetManagerMockDeviceTest, smallTextureIsOnlyItsMipTail)
+{
+    GE::StreamedTexture texture(m_device, *m_commandBuffer, makeTextureData(32));
+    EXPECT_EQ(texture.levelCount(), 1u);
+    EXPECT_EQ(texture.residentLevel(), 0u);
+    EXPECT_EQ(texture.texture()->width(), 32u);
+}
+
+TEST_F(AssetManagerMockDeviceTest, streamedMeshKeepsTheCoarsestLevelResident)
+{
+    GE::GeometryPool geometryPool(&m_device);
+    GE::StreamedMesh mesh(m_device, geometryPool, *m_commandBuffer, makeMeshData(64, 3));
+
+    ASSERT_EQ(mesh.levelCount(), 4u);
+    EXPECT_EQ(mesh.residentLevel(), 3u);
+
+    const GE::SubMesh& root = mesh.mesh()->subMeshes.at(0);
+    const GE::SubMesh& child = root.subMeshes.at(0);
+    for (const GE::SubMesh* subMesh : { &root, &child })
+    {
+        EXPECT_EQ(lodIndexBuffer(*subMesh, 0), nullptr);
+        EXPECT_EQ(lodIndexBuffer(*subMesh, 2), nullptr);
+        ASSERT_NE(lodIndexBuffer(*subMesh, 3), nullptr);
+        EXPECT_EQ(subMesh->lods.size(), 3u);
+        EXPECT_EQ(subMesh->indexCount, 64u * 3);
+    }
+
+    const size_t vertexBytes = 64u * 3 * sizeof(GE::Vertex);
+    EXPECT_EQ(mesh.residentBytes(), vertexBytes + 8 * 3 * 4);
+    // the shared geometry is only counted once
+    EXPECT_EQ(mesh.uploadSize(1), (32u + 16) * 3 * 4);
+    EXPECT_EQ(mesh.uploadSize(3), 0u);
+
+    mesh.makeResident(1, m_device, *m_commandBuffer);
+    EXPECT_EQ(mesh.residentLevel(), 1u);
+    EXPECT_EQ(lodIndexBuffer(root, 0), nullptr);
+    ASSERT_NE(lodIndexBuffer(root, 1), nullptr);
+    EXPECT_EQ(lodIndexBuffer(root, 1), lodIndexBuffer(child, 1));
+    EXPECT_EQ(lodIndexBuffer(root, 1)->size(), 32u * 3 * 4);
+    EXPECT_EQ(mesh.residentBytes(), vertexBytes + (32 + 16 + 8) * 3 * 4);
+
+    mesh.evict(2);
+    EXPECT_EQ(mesh.residentLevel(), 2u);
+    EXPECT_EQ(lodIndexBuffer(child, 1), nullptr);
+    EXPECT_NE(lodIndexBuffer(child, 2), nullptr);
+    EXPECT_NE(lodIndexBuffer(child, 3), nullptr);
+}
+
+TEST_F(AssetManagerMockDeviceTest, streamerCompactsTheMeshesIntoTheReleasedRoom)
+{
+    GE::GeometryPool geometryPool(&m_device, 64 * 3 * 2);
+    auto released = std::make_shared<GE::StreamedMesh>(m_device, geometryPool, *m_commandBuffer, makeMeshData(64, 3));
+    auto kept = std::make_shared<GE::StreamedMesh>(m_device, geometryPool, *m_commandBuffer, makeMeshData(64, 3));
+    GE::AssetStreamer streamer(&m_device, SIZE_MAX);
+    streamer.addCompactable(kept);
+    streamer.request(kept, 1);
+    streamer.update();
+    ASSERT_EQ(kept->residentLevel(), 1u);
+
+    const GE::SubMesh& root = kept->mesh()->subMeshes.at(0);
+    const GE::SubMesh& child = root.subMeshes.at(0);
+    ASSERT_EQ(root.vertexOffset, 64u * 3);
+    EXPECT_FALSE(kept->canCompact());
+
+    released.reset();
+    for (uint32_t i = 0; i < GE::maxFrameInFlight; i++)
+        geometryPool.endFrame();
+    ASSERT_TRUE(kept->canCompact());
+
+    streamer.request(kept, 1);
+    EXPECT_EQ(streamer.update(), 0);
+    EXPECT_FALSE(kept->canCompact());
+    for (const GE::SubMesh* subMesh : { &root, &child })
+    {
+        EXPECT_EQ(subMesh->vertexOffset, 0u);
+        EXPECT_EQ(subMesh->vertexAllocation->offset, 0u);
+        EXPECT_EQ(subMesh->vertexBuffer, subMesh->vertexAllocation->buffer);
+    }
+    // the resident levels are rebuilt with the new offset, the others stay not resident
+    EXPECT_EQ(lodIndexBuffer(root, 0), nullptr);
+    for (uint32_t level = 1; level <= 3; level++)
+    {
+        ASSERT_NE(lodIndexBuffer(root, level), nullptr);
+        EXPECT_EQ(lodIndexBuffer(root, level), lodIndexBuffer(child, level));
+        EXPECT_EQ(lodIndexBuffer(root, level)->content<uint32_t>()[5], 5u);
+    }
+    EXPECT_EQ(streamer.statistics().frameCompactedBytes, 64u * 3 * sizeof(GE::Vertex) + (32u + 16 + 8) * 3 * 4);
+
+    // the original range is released after the frames in flight
+    for (uint32_t i = 0; i < GE::maxFrameInFlight; i++)
+        geometryPool.endFrame();
+    EXPECT_EQ(geometryPool.statistics().usedBytes, 64u * 3 * sizeof(GE::Vertex));
+}
+
+TEST_F(AssetManagerMockDeviceTest, streamerCompactsTheMeshesNotStreamedWithoutStreamingBudget)
+{
+    GE::GeometryPool geometryPool(&m_device, 64 * 3 * 2);
+    auto released = std::make_shared<GE::StreamedMesh>(m_device, geometryPool, *m_commandBuffer, makeMeshData(64, 3), true);
+    auto kept = std::make_shared<GE::StreamedMesh>(m_device, geometryPool, *m_commandBuffer, makeMeshData(64, 3), true);
+    ASSERT_EQ(kept->residentLevel(), 0u);
+    GE::AssetStreamer streamer(&m_device, 0);
+    streamer.addCompactable(released);
+    streamer.addCompactable(kept);
+
+    const GE::SubMesh& root = kept->mesh()->subMeshes.at(0);
+    ASSERT_EQ(root.vertexOffset, 64u * 3);
+    released.reset();
+    for (uint32_t i = 0; i < GE::maxFrameInFlight; i++)
+        geometryPool.endFrame();
+
+    EXPECT_EQ(streamer.update(), 0);
+    EXPECT_EQ(root.vertexOffset, 0u);
+    for (uint32_t level = 0; level <= 3; level++)
+    {
+        ASSERT_NE(lodIndexBuffer(root, level), nullptr);
+        EXPECT_EQ(lodIndexBuffer(root, level)->content<uint32_t>()[5], 5u);
+    }
+    EXPECT_EQ(streamer.statistics().frameCompactedBytes, 64u * 3 * sizeof(GE::Vertex) + (64u + 32 + 16 + 8) * 3 * 4);
+    EXPECT_EQ(streamer.statistics().frameStreamedBytes, 0u);
+}
+
+TEST_F(AssetManagerMockDeviceTest, streamerUploadsTheHighestPriorityFirstWithinTheBudget)
+{
+    auto near = std::make_shared<GE::StreamedTexture>(m_device, *m_commandBuffer, makeTextureData(256));
+    auto far = std::make_shared<GE::StreamedTexture>(m_device, *m_commandBuffer, makeTextureData(256));
+    GE::AssetStreamer streamer(&m_device, 128 * 128 * 4);
+
+    streamer.request(far, 0, 1.0f);
+    streamer.request(near, 0, 2.0f);
+    EXPECT_EQ(streamer.update(), 128 * 128 * 4);
+
+    // the 256x256 mip does not fit, the intermediate one is uploaded instead
+    EXPECT_EQ(near->residentLevel(), 1u);
+    EXPECT_EQ(far->residentLevel(), 2u);
+    EXPECT_EQ(streamer.statistics().frameUploadCount, 1u);
+    EXPECT_EQ(streamer.statistics().deferredRequestCount, 2u);
+
+    // an upload larger than the budget is still done when it is the only one of the frame
+    streamer.request(far, 0, 1.0f);
+    streamer.request(near, 0, 2.0f);
+    streamer.update();
+    EXPECT_EQ(near->residentLevel(), 0u);
+    EXPECT_EQ(far->residentLevel(), 2u);
+    EXPECT_EQ(streamer.statistics().frameStreamedBytes, 256u * 256 * 4);
+    EXPECT_EQ(streamer.statistics().streamedBytes, (256u * 256 + 128 * 128) * 4);
+    EXPECT_EQ(streamer.statistics().assetCount, 2u);
+}
+
+TEST_F(AssetManagerMockDeviceTest, streamerReleasesTheLevelsNotRequestedAfterTheDelay)
+{
+    auto texture = std::make_shared<GE::StreamedTexture>(m_device, *m_commandBuffer, makeTextureData(256));
+    GE::AssetStreamer streamer(&m_device, SIZE_MAX, 10);
+
+    streamer.request(texture, 0);
+    streamer.update();
+    ASSERT_EQ(texture->residentLevel(), 0u);
+
+    // requesting a coarser level does not release the finer one before the delay
+    for (int i = 0; i < 9; i++)
+    {
+        streamer.request(texture, 1);
+        EXPECT_EQ(streamer.update(), 0);
+        EXPECT_EQ(texture->residentLevel(), 0u);
+    }
+    EXPECT_EQ(streamer.update(), -256 * 256 * 4);
+    EXPECT_EQ(texture->residentLevel(), 2u);
+
+    // the asset is dropped by the streamer once it is destroyed
+    texture.reset();
+    streamer.update();
+    EXPECT_EQ(streamer.statistics().assetCount, 0u);
+    EXPECT_EQ(streamer.statistics().residentBytes, 0u);
+}
+
+// Replays a camera moving along a row of streamed textures and meshes, the
+// assets in front of the camera are requested at a level depending on their
+// distance and the ones behind it are not requested anymore.
+TEST_F(AssetManagerMockDeviceTest, streamingCameraPathSimulation)
+{
+    constexpr size_t frameByteBudget = 256 * 1024;
+    constexpr uint32_t evictionDelay = 30;
+    constexpr uint32_t frameCount = 600;
+    constexpr float spacing = 10.0f;
+    constexpr float viewportHeight = 1080.0f;
+    constexpr float viewDistance = 100.0f;
+
+    struct Object
+    {
+        float z;
+        std::shared_ptr<GE::StreamedTexture> texture;
+        std::shared_ptr<GE::StreamedMesh> mesh;
+    };
+
+    GE::GeometryPool geometryPool(&m_device);
+    std::vector<Object> objects;
+    for (uint32_t i = 0; i < 32; i++)
+    {
+        objects.push_back(Object{
+            .z = static_cast<float>(i + 1) * spacing,
+            .texture = std::make_shared<GE::StreamedTexture>(m_device, *m_commandBuffer, makeTextureData(512)),
+            .mesh = std::make_shared<GE::StreamedMesh>(m_device, geometryPool, *m_commandBuffer, makeMeshData(4096, 4))
+        });
+    }
+
+    GE::AssetStreamer streamer(&m_device, frameByteBudget, evictionDelay);
+    size_t peakResidentBytes = 0;
+    uint32_t overBudgetFrameCount = 0;
+
+    const auto requestedLevels = [&](const Object& object, float cameraZ) {
+        const float distance = std::max(object.z - cameraZ, 1.0f);
+        const float projectedSize = viewportHeight / distance;
+        return std::make_pair(GE::selectMip(512, 512, projectedSize), std::min(static_cast<uint32_t>(distance / 20.0f), 4u));
+    };
+
+    for (uint32_t frame = 0; frame < frameCount; frame++)
+    {
+        const float cameraZ = static_cast<float>(frame) * 0.5f;
+        for (const Object& object : objects)
+        {
+            if (object.z < cameraZ || object.z - cameraZ > viewDistance)
+                continue;
+            auto [mip, lod] = requestedLevels(object, cameraZ);
+            const float priority = viewportHeight / std::max(object.z - cameraZ, 1.0f);
+            streamer.request(object.texture, mip, priority);
+            streamer.request(object.mesh, lod, priority);
+        }
+        streamer.update();
+
+        const GE::AssetStreamer::Statistics& statistics = streamer.statistics();
+        if (statistics.frameStreamedBytes > frameByteBudget)
+        {
+            overBudgetFrameCount++;
+            EXPECT_EQ(statistics.frameUploadCount, 1u) << "frame " << frame;
+        }
+        peakResidentBytes = std::max(peakResidentBytes, statistics.residentBytes);
+    }
+
+    const float cameraZ = static_cast<float>(frameCount - 1) * 0.5f;
+    for (const Object& object : objects)
+    {
+        if (object.z + spacing * 2 < cameraZ)
+        {
+            // long behind the camera
+            EXPECT_EQ(object.texture->residentLevel(), object.texture->coarsestLevel()) << object.z;
+            EXPECT_EQ(object.mesh->residentLevel(), object.mesh->coarsestLevel()) << object.z;
+        }
+        else if (object.z >= cameraZ && object.z - cameraZ <= viewDistance)
+        {
+            auto [mip, lod] = requestedLevels(object, cameraZ);
+            EXPECT_LE(object.texture->residentLevel(), std::min(mip, object.texture->coarsestLevel())) << object.z;
+            EXPECT_LE(object.mesh->residentLevel(), lod) << object.z;
+        }
+    }
+
+    const GE::AssetStreamer::Statistics& statistics = streamer.statistics();
+    EXPECT_LE(peakResidentBytes, objects.size() * (512 * 512 * 4 + 64 * 64 * 4 + 4096 * 3 * (sizeof(GE::Vertex) + 4 * 2)));
+    EXPECT_LT(overBudgetFrameCount, frameCount / 10);
+
+    RecordProperty("streamedBytes", std::to_string(statistics.streamedBytes));
+    RecordProperty("peakResidentBytes", std::to_string(peakResidentBytes));
+    RecordProperty("finalResidentBytes", std::to_string(statistics.residentBytes));
+    RecordProperty("overBudgetFrames", std::to_string(overBudgetFrameCount));
+}
+
+TEST_F(AssetManagerMockDeviceTest, streamedAssetsCountInTheResidentBytes)
+{
+    GE::AssetManager assetManager(&m_device, {}, {}, {});
+    GE::VAssetPath assetPath = GE::AssetPath<gfx::Texture>(std::filesystem::path(GE_TEST_RESOURCE_DIR) / "dummy_texture.png");
+    assetManager.registerAsset(assetPath);
+    assetManager.setStreamingBudget(1024 * 1024);
+
+    const std::shared_ptr<gfx::Texture> texture = assetManager.loadAsset<gfx::Texture>(assetPath).get();
+    ASSERT_NE(texture, nullptr);
+    EXPECT_EQ(assetManager.residentBytes(), static_cast<size_t>(texture->width()) * texture->height() * 4);
+
+    assetManager.requestStreaming(assetPath, 0);
+    assetManager.endFrame();
+    EXPECT_EQ(assetManager.streamingStatistics().assetCount, 1u);
+
+    assetManager.unloadAsset(assetPath);
+    EXPECT_EQ(assetManager.residentBytes(), 0u);
+    assetManager.endFrame();
+    EXPECT_EQ(assetManager.streamingStatistics().assetCount, 0u);
+}
+
+} // namespace
+
+} // namespace GE_tests
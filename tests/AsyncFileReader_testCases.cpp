@@ -0,0 +1,120 @@
+/*
+ * ---------------------------------------------------
+ * AsyncFileReader_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/AsyncFileReader.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+// each test runs with the io_uring, when the platform has it, and with the thread pool
+class AsyncFileReaderTest : public ::testing::TestWithParam<GE::AsyncFileReader::Backend>
+{
+protected:
+    void SetUp() override
+    {
+        m_directory = std::filesystem::temp_directory_path() / "AsyncFileReader_testCases";
+        std::filesystem::remove_all(m_directory);
+        std::filesystem::create_directories(m_directory);
+    }
+
+    void TearDown() override
+    {
+        std::error_code error;
+        std::filesystem::remove_all(m_directory, error);
+    }
+
+    std::filesystem::path writeFile(const std::string& name, const std::string& content) const
+    {
+        std::ofstream(m_directory / name, std::ios::binary) << content;
+        return m_directory / name;
+    }
+
+    static std::string toString(const std::vector<std::byte>& bytes)
+    {
+        return std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    std::filesystem::path m_directory;
+};
+
+TEST_P(AsyncFileReaderTest, readsTheWholeFile)
+{
+    GE::AsyncFileReader reader(GetParam());
+    std::string content;
+    for (int i = 0; i < 100000; i++)
+        content += std::to_string(i);
+    const std::filesystem::path path = writeFile("file.bin", content);
+
+    EXPECT_EQ(toString(reader.read(path).get()), content);
+    EXPECT_TRUE(reader.read(writeFile("empty.bin", "")).get().empty());
+}
+
+TEST_P(AsyncFileReaderTest, batchFuturesAreInTheOrderOfThePaths)
+{
+    GE::AsyncFileReader reader(GetParam());
+    // more files than the reads the io_uring keeps in flight
+    std::vector<std::filesystem::path> paths;
+    for (uint32_t i = 0; i < GE::AsyncFileReader::IO_URING_QUEUE_DEPTH * 3; i++)
+        paths.push_back(writeFile("file" + std::to_string(i), "content of file " + std::to_string(i)));
+
+    std::vector<std::future<std::vector<std::byte>>> futures = reader.read(paths);
+    ASSERT_EQ(futures.size(), paths.size());
+    for (size_t i = 0; i < futures.size(); i++)
+        EXPECT_EQ(toString(futures[i].get()), "content of file " + std::to_string(i));
+}
+
+TEST_P(AsyncFileReaderTest, unreadableFilesThrowFromTheirFuture)
+{
+    GE::AsyncFileReader reader(GetParam());
+    const std::vector<std::filesystem::path> paths = { m_directory / "missing.bin", m_directory, writeFile("file.bin", "content") };
+
+    std::vector<std::future<std::vector<std::byte>>> futures = reader.read(paths);
+    EXPECT_THROW(futures[0].get(), std::runtime_error);
+    EXPECT_THROW(futures[1].get(), std::runtime_error);
+    EXPECT_EQ(toString(futures[2].get()), "content");
+}
+
+TEST_P(AsyncFileReaderTest, pendingReadsAreCompletedOnDestruction)
+{
+    std::vector<std::filesystem::path> paths;
+    for (int i = 0; i < 100; i++)
+        paths.push_back(writeFile("file" + std::to_string(i), std::string(10000, 'a' + i % 26)));
+
+    std::vector<std::future<std::vector<std::byte>>> futures;
+    {
+        GE::AsyncFileReader reader(GetParam());
+        futures = reader.read(paths);
+    }
+    for (size_t i = 0; i < futures.size(); i++)
+    {
+        ASSERT_EQ(futures[i].wait_for(std::chrono::seconds(0)), std::future_status::ready);
+        EXPECT_EQ(toString(futures[i].get()), std::string(10000, 'a' + i % 26));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(, AsyncFileReaderTest, ::testing::Values(GE::AsyncFileReader::Backend::ioUring, GE::AsyncFileReader::Backend::threadPool),
+                         [](const ::testing::TestParamInfo<GE::AsyncFileReader::Backend>& info) {
+                             return info.param == GE::AsyncFileReader::Backend::ioUring ? "ioUring" : "threadPool";
+                         });
+
+} // namespace
+
+} // namespace GE_tests
@@ -0,0 +1,129 @@
+/*
+ * ---------------------------------------------------
+ * Culling_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/Culling.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+// camera at the origin looking down -z, like the CameraComponent projection
+glm::mat4 viewProjection()
+{
+    return glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f) * glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+GE::BoundingBox unitBoxAt(const glm::vec3& center)
+{
+    return GE::BoundingBox{ .min = center - glm::vec3(0.5f), .max = center + glm::vec3(0.5f) };
+}
+
+TEST(CullingTest, boundingBoxContainsVertices)
+{
+    std::vector<GE::Vertex> vertices(3);
+    vertices[0].pos = { -1.0f, 0.0f, 2.0f };
+    vertices[1].pos = { 3.0f, -2.0f, 0.0f };
+    vertices[2].pos = { 0.0f, 5.0f, 1.0f };
+
+    const GE::BoundingBox box = GE::boundingBox(vertices);
+    EXPECT_EQ(box.min, glm::vec3(-1.0f, -2.0f, 0.0f));
+    EXPECT_EQ(box.max, glm::vec3(3.0f, 5.0f, 2.0f));
+    EXPECT_TRUE(GE::boundingBox({}).isEmpty());
+}
+
+TEST(CullingTest, transformedBoxContainsTheTransformedCorners)
+{
+    const GE::BoundingBox box = unitBoxAt(glm::vec3(0.0f));
+    const glm::mat4 transform = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(10.0f, 0.0f, 0.0f)), glm::radians(45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    const GE::BoundingBox transformed = GE::transformBoundingBox(box, transform);
+    EXPECT_NEAR(transformed.min.x, 10.0f - glm::sqrt(0.5f), 1e-5f);
+    EXPECT_NEAR(transformed.max.x, 10.0f + glm::sqrt(0.5f), 1e-5f);
+    EXPECT_NEAR(transformed.min.y, -0.5f, 1e-5f);
+    EXPECT_NEAR(transformed.max.y, 0.5f, 1e-5f);
+    EXPECT_TRUE(GE::transformBoundingBox(GE::BoundingBox{}, transform).isEmpty());
+}
+
+TEST(CullingTest, frustumPlanesSeparateTheBoxes)
+{
+    const GE::Frustum frustum = GE::frustum(viewProjection());
+
+    EXPECT_TRUE(GE::isBoxInFrustum(frustum, unitBoxAt({ 0.0f, 0.0f, -10.0f })));
+    EXPECT_TRUE(GE::isBoxInFrustum(frustum, unitBoxAt({ 0.0f, 0.0f, -99.8f })));  // across the far plane
+    EXPECT_FALSE(GE::isBoxInFrustum(frustum, unitBoxAt({ 0.0f, 0.0f, 10.0f })));  // behind
+    EXPECT_FALSE(GE::isBoxInFrustum(frustum, unitBoxAt({ 0.0f, 0.0f, -150.0f }))); // beyond the far plane
+    EXPECT_FALSE(GE::isBoxInFrustum(frustum, unitBoxAt({ 50.0f, 0.0f, -10.0f }))); // right
+    EXPECT_FALSE(GE::isBoxInFrustum(frustum, unitBoxAt({ 0.0f, -50.0f, -10.0f }))); // below
+}
+
+TEST(CullingTest, cullerMatchesTheScalarTest)
+{
+    // a synthetic scene around the camera, not a multiple of the lane count
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> position(-120.0f, 120.0f);
+    std::uniform_real_distribution<float> size(0.1f, 4.0f);
+    std::vector<GE::BoundingBox> boxes;
+    for (int i = 0; i < 5003; i++)
+    {
+        const glm::vec3 center(position(random), position(random), position(random));
+        const glm::vec3 extent(size(random), size(random), size(random));
+        boxes.push_back({ .min = center - extent, .max = center + extent });
+    }
+
+    const GE::Frustum frustum = GE::frustum(viewProjection());
+    GE::FrustumCuller culler;
+    for (const GE::BoundingBox& box : boxes)
+        culler.add(box);
+    ASSERT_EQ(culler.size(), boxes.size());
+
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < boxes.size(); i++)
+    {
+        if (GE::isBoxInFrustum(frustum, boxes[i]))
+            expected.push_back(i);
+    }
+    EXPECT_EQ(culler.cull(frustum), expected);
+
+    const GE::CullingStatistics& statistics = culler.statistics();
+    EXPECT_EQ(statistics.testedCount, boxes.size());
+    EXPECT_EQ(statistics.visibleCount, expected.size());
+    EXPECT_EQ(statistics.visibleCount + statistics.culledCount, statistics.testedCount);
+    EXPECT_GT(statistics.culledCount, statistics.visibleCount); // most of the scene is out of the 60 degrees field of view
+}
+
+TEST(CullingTest, clearedCullerIsReused)
+{
+    const GE::Frustum frustum = GE::frustum(viewProjection());
+    GE::FrustumCuller culler;
+    for (int i = 0; i < 20; i++)
+        culler.add(unitBoxAt({ 0.0f, 0.0f, -10.0f }));
+    EXPECT_EQ(culler.cull(frustum).size(), 20u);
+
+    culler.clear();
+    EXPECT_TRUE(culler.cull(frustum).empty());
+
+    culler.add(unitBoxAt({ 0.0f, 0.0f, 10.0f }));
+    culler.add(unitBoxAt({ 0.0f, 0.0f, -10.0f }));
+    EXPECT_EQ(culler.cull(frustum), std::vector<uint32_t>{ 1 });
+    EXPECT_EQ(culler.statistics().culledCount, 1u);
+}
+
+} // namespace
+
+} // namespace GE_tests
@@ -0,0 +1,151 @@
+/*
+ * ---------------------------------------------------
+ * DrawPacket_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "GraphicsMocks.hpp"
+
+#include "Game-Engine/DrawPacket.hpp"
+#include "Game-Engine/JobSystem.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+using Type = RecordingCommandBuffer::Type;
+
+struct PushConstants
+{
+    uint32_t instance;
+};
+
+using Packet = GE::DrawPacket<PushConstants>;
+
+// the pipelines are only compared by the recording, never used
+std::shared_ptr<gfx::GraphicsPipeline> fakePipeline(std::byte& identity)
+{
+    return std::shared_ptr<gfx::GraphicsPipeline>(std::shared_ptr<void>(), reinterpret_cast<gfx::GraphicsPipeline*>(&identity));
+}
+
+std::shared_ptr<gfx::Buffer> newBuffer()
+{
+    return std::make_shared<MockBuffer>(gfx::Buffer::Descriptor{ .size = 16 });
+}
+
+// instance of each draw, with the index buffer it used
+std::vector<std::pair<uint32_t, const void*>> recordedDraws(const RecordingCommandBuffer& commandBuffer)
+{
+    std::vector<std::pair<uint32_t, const void*>> draws;
+    uint32_t instance = UINT32_MAX;
+    for (const RecordingCommandBuffer::Command& command : commandBuffer.commands)
+    {
+        if (command.type == Type::setPushConstants)
+        {
+            EXPECT_EQ(command.pushConstants.size(), sizeof(PushConstants));
+            std::memcpy(&instance, command.pushConstants.data(), sizeof(uint32_t));
+        }
+        else if (command.type == Type::drawIndexedVertices)
+            draws.emplace_back(instance, command.object);
+    }
+    return draws;
+}
+
+TEST(DrawPacketTest, onlyTheChangesAreBound)
+{
+    std::array<std::byte, 2> pipelineIdentities = {};
+    const std::array pipelines = { fakePipeline(pipelineIdentities[0]), fakePipeline(pipelineIdentities[1]) };
+    const std::array vertexBuffers = { newBuffer(), newBuffer() };
+    const std::shared_ptr<gfx::Buffer> indexBuffer = newBuffer();
+    const std::array<std::shared_ptr<gfx::ParameterBlock>, 2> parameterBlocks = {};
+
+    const std::vector<Packet> packets = {
+        { .pipeline = &pipelines[0], .vertexBuffer = &vertexBuffers[0], .indexBuffer = &indexBuffer, .pushConstants = { 0 } },
+        { .pipeline = &pipelines[0], .vertexBuffer = &vertexBuffers[0], .indexBuffer = &indexBuffer, .pushConstants = { 1 } },
+        { .pipeline = &pipelines[0], .vertexBuffer = &vertexBuffers[1], .indexBuffer = &indexBuffer, .pushConstants = { 2 } },
+        { .pipeline = &pipelines[1], .vertexBuffer = &vertexBuffers[1], .indexBuffer = &indexBuffer, .pushConstants = { 3 } },
+    };
+    RecordingCommandBuffer commandBuffer;
+    GE::recordDrawPackets<PushConstants>(commandBuffer, packets, parameterBlocks);
+
+    std::vector<Type> types;
+    for (const RecordingCommandBuffer::Command& command : commandBuffer.commands)
+        types.push_back(command.type);
+    EXPECT_EQ(types, (std::vector<Type>{
+        Type::usePipeline, Type::setParameterBlock, Type::setParameterBlock, Type::useVertexBuffer, Type::setPushConstants, Type::drawIndexedVertices,
+        Type::setPushConstants, Type::drawIndexedVertices,
+        Type::useVertexBuffer, Type::setPushConstants, Type::drawIndexedVertices,
+        Type::usePipeline, Type::setParameterBlock, Type::setParameterBlock, Type::setPushConstants, Type::drawIndexedVertices
+    }));
+    EXPECT_EQ(commandBuffer.commands[0].object, pipelines[0].get());
+    EXPECT_EQ(commandBuffer.commands[2].index, 1u);
+    EXPECT_EQ(commandBuffer.commands[8].object, vertexBuffers[1].get());
+    EXPECT_EQ(commandBuffer.commands[11].object, pipelines[1].get());
+    EXPECT_EQ(recordedDraws(commandBuffer), (std::vector<std::pair<uint32_t, const void*>>{ { 0, indexBuffer.get() }, { 1, indexBuffer.get() }, { 2, indexBuffer.get() }, { 3, indexBuffer.get() } }));
+}
+
+TEST(DrawPacketTest, listsRecordedByJobsMatchOneList)
+{
+    std::array<std::byte, 3> pipelineIdentities = {};
+    const std::array pipelines = { fakePipeline(pipelineIdentities[0]), fakePipeline(pipelineIdentities[1]), fakePipeline(pipelineIdentities[2]) };
+    std::vector<std::shared_ptr<gfx::Buffer>> vertexBuffers, indexBuffers;
+    for (int i = 0; i < 4; i++)
+        vertexBuffers.push_back(newBuffer());
+    for (int i = 0; i < 50; i++)
+        indexBuffers.push_back(newBuffer());
+
+    // sorted by pipeline like the render queue
+    std::mt19937 random(5);
+    std::vector<Packet> packets;
+    for (uint32_t i = 0; i < 3000; i++)
+    {
+        packets.push_back({
+            .pipeline = &pipelines[i * pipelines.size() / 3000],
+            .vertexBuffer = &vertexBuffers[random() % vertexBuffers.size()],
+            .indexBuffer = &indexBuffers[random() % indexBuffers.size()],
+            .pushConstants = { i }
+        });
+    }
+    RecordingCommandBuffer singleCommandBuffer;
+    GE::recordDrawPackets<PushConstants>(singleCommandBuffer, packets, {});
+
+    // each job builds its own list from a range of the draws and records it in its own command buffer
+    constexpr uint32_t jobCount = 7;
+    GE::JobSystem jobSystem(3);
+    std::array<std::vector<Packet>, jobCount> jobPackets;
+    std::array<RecordingCommandBuffer, jobCount> jobCommandBuffers;
+    jobSystem.parallelFor(jobCount, [&](uint32_t job, uint32_t) {
+        for (size_t i = packets.size() * job / jobCount; i < packets.size() * (job + 1) / jobCount; i++)
+            jobPackets[job].push_back(packets[i]);
+        GE::recordDrawPackets<PushConstants>(jobCommandBuffers[job], jobPackets[job], {});
+    });
+
+    std::vector<std::pair<uint32_t, const void*>> stitchedDraws;
+    for (const RecordingCommandBuffer& commandBuffer : jobCommandBuffers)
+    {
+        // nothing is inherited from the previous job
+        ASSERT_GE(commandBuffer.commands.size(), 2u);
+        EXPECT_EQ(commandBuffer.commands[0].type, Type::usePipeline);
+        EXPECT_EQ(commandBuffer.commands[1].type, Type::useVertexBuffer);
+        for (const auto& draw : recordedDraws(commandBuffer))
+            stitchedDraws.push_back(draw);
+    }
+    EXPECT_EQ(stitchedDraws, recordedDraws(singleCommandBuffer));
+}
+
+} // namespace
+
+} // namespace GE_tests
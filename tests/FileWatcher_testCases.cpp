@@ -0,0 +1,107 @@
+/*
+ * ---------------------------------------------------
+ * FileWatcher_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/FileWatcher.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+class FileWatcherTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_directory = std::filesystem::temp_directory_path() / "FileWatcher_testCases";
+        std::filesystem::remove_all(m_directory);
+        std::filesystem::create_directories(m_directory);
+        m_directory = std::filesystem::canonical(m_directory);
+    }
+
+    void TearDown() override
+    {
+        std::error_code error;
+        std::filesystem::remove_all(m_directory, error);
+    }
+
+    static void writeFile(const std::filesystem::path& path, const std::string& content)
+    {
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    // the changes are polled until `path` is reported, or a timeout for the platforms comparing the write times
+    static std::vector<std::filesystem::path> pollUntil(GE::FileWatcher& watcher, const std::filesystem::path& path)
+    {
+        std::vector<std::filesystem::path> changedFiles;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::ranges::find(changedFiles, path) == changedFiles.end() && std::chrono::steady_clock::now() < deadline)
+        {
+            for (std::filesystem::path& changedFile : watcher.poll())
+                changedFiles.push_back(std::move(changedFile));
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return changedFiles;
+    }
+
+    std::filesystem::path m_directory;
+};
+
+TEST_F(FileWatcherTest, writtenFileIsReportedOnce)
+{
+    GE::FileWatcher watcher(m_directory);
+    EXPECT_TRUE(watcher.poll().empty());
+
+    writeFile(m_directory / "texture.png", "first");
+
+    const std::vector<std::filesystem::path> changedFiles = pollUntil(watcher, m_directory / "texture.png");
+    EXPECT_EQ(std::ranges::count(changedFiles, m_directory / "texture.png"), 1);
+    EXPECT_TRUE(watcher.poll().empty());
+}
+
+TEST_F(FileWatcherTest, filesOfNewSubDirectoriesAreReported)
+{
+    GE::FileWatcher watcher(m_directory);
+
+    std::filesystem::create_directories(m_directory / "meshes" / "props");
+    writeFile(m_directory / "meshes" / "props" / "crate.obj", "o crate");
+
+    const std::vector<std::filesystem::path> changedFiles = pollUntil(watcher, m_directory / "meshes" / "props" / "crate.obj");
+    EXPECT_EQ(std::ranges::count(changedFiles, m_directory / "meshes" / "props" / "crate.obj"), 1);
+
+    writeFile(m_directory / "meshes" / "props" / "crate.obj", "o crate_v2");
+    EXPECT_EQ(pollUntil(watcher, m_directory / "meshes" / "props" / "crate.obj").size(), 1u);
+}
+
+TEST_F(FileWatcherTest, fileRenamedInPlaceIsReported)
+{
+    writeFile(m_directory / "texture.png", "first");
+    GE::FileWatcher watcher(m_directory);
+
+    // how most editors save a file
+    writeFile(m_directory / "texture.png.tmp", "second");
+    std::filesystem::rename(m_directory / "texture.png.tmp", m_directory / "texture.png");
+
+    const std::vector<std::filesystem::path> changedFiles = pollUntil(watcher, m_directory / "texture.png");
+    EXPECT_EQ(std::ranges::count(changedFiles, m_directory / "texture.png"), 1);
+}
+
+} // namespace
+
+} // namespace GE_tests
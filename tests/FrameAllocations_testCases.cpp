@@ -0,0 +1,251 @@
+/*
+ * ---------------------------------------------------
+ * FrameAllocations_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * The global allocation functions of the test executable are replaced to
+ * count the heap allocations, so the per frame code can be checked not to
+ * allocate once the first frames have sized its memory.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "GraphicsMocks.hpp"
+
+#include "Game-Engine/DrawPacket.hpp"
+#include "Game-Engine/FrameGraph.hpp"
+#include "Game-Engine/FrameResources.hpp"
+#include "Game-Engine/JobSystem.hpp"
+#include "Game-Engine/LinearAllocator.hpp"
+#include "Game-Engine/RenderQueue.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace
+{
+
+std::atomic<uint64_t> allocationCount = 0; // by all the threads
+
+void* countedAllocation(std::size_t size, std::size_t alignment)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    size = size == 0 ? 1 : size;
+    void* memory = alignment <= alignof(std::max_align_t) ? std::malloc(size) : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (memory == nullptr)
+        throw std::bad_alloc();
+    return memory;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return countedAllocation(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return countedAllocation(size, static_cast<std::size_t>(alignment)); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+namespace GE_tests
+{
+
+namespace
+{
+
+// the allocations made since the creation of the counter
+class AllocationCounter
+{
+public:
+    uint64_t count() const { return allocationCount.load() - m_start; }
+
+private:
+    uint64_t m_start = allocationCount.load();
+};
+
+constexpr int WARM_UP_FRAME_COUNT = 3;
+constexpr int STEADY_FRAME_COUNT = 10;
+
+struct PushConstants
+{
+    uint32_t instance;
+};
+
+GE::FrameGraph testFrameGraph()
+{
+    GE::FramePass geometryPass;
+    geometryPass.colorAttachments = { GE::AttachmentDescriptor{ .texture = "viewport", .loadAction = gfx::LoadAction::clear, .clearColor = {} } };
+    geometryPass.depthAttachment = GE::AttachmentDescriptor{ .texture = "depth", .loadAction = gfx::LoadAction::clear, .clearDepth = 1.0f };
+    geometryPass.constantBufferDeclarations = { { .name = "frameData", .size = 256 } };
+    geometryPass.structuredBufferDeclarations = { { .name = "lights" } };
+    geometryPass.usedBuffers = { "frameData", "lights" };
+
+    GE::FramePass uiPass;
+    uiPass.colorAttachments = { GE::AttachmentDescriptor{ .texture = "backBuffer", .loadAction = gfx::LoadAction::clear, .clearColor = {} } };
+    uiPass.sampledTextures = { "viewport" };
+
+    return GE::FrameGraph(GE::FrameGraph::Descriptor{
+        .backBufferName = "backBuffer",
+        .textures = {
+            { .name = "backBuffer", .size = { 64, 64 }, .pixelFormat = gfx::PixelFormat::BGRA8Unorm },
+            { .name = "viewport", .size = { 64, 64 }, .pixelFormat = gfx::PixelFormat::BGRA8Unorm },
+            { .name = "depth", .size = { 64, 64 }, .pixelFormat = gfx::PixelFormat::Depth32Float },
+        },
+        .passes = { geometryPass, uiPass }
+    });
+}
+
+TEST(FrameAllocationsTest, frameResourcesAreReused)
+{
+    testing::NiceMock<MockDevice> device;
+    ON_CALL(device, newBuffer(testing::_)).WillByDefault([](const gfx::Buffer::Descriptor& desc) {
+        return std::make_unique<MockBuffer>(desc);
+    });
+    ON_CALL(device, newTexture(testing::_)).WillByDefault([](const gfx::Texture::Descriptor& desc) {
+        return std::make_unique<TestTexture>(desc);
+    });
+    EXPECT_CALL(device, newTexture(testing::_)).Times(2); // the viewport and the depth
+    EXPECT_CALL(device, newBuffer(testing::_)).Times(3);  // the frame data, the upload arena then a bigger one
+
+    constexpr uint32_t lightSize = 32;
+    const GE::FrameGraph frameGraph = testFrameGraph();
+    const std::shared_ptr<gfx::Texture> backBuffer = std::make_shared<TestTexture>(gfx::Texture::Descriptor{ .width = 64, .height = 64 });
+    const std::vector<std::byte> lights(lightSize * 4096);
+    const GE::TextureHandle viewport = frameGraph.textureHandle("viewport");
+    const GE::BufferHandle lightsHandle = frameGraph.bufferHandle("lights");
+
+    GE::FrameResources resources(&device);
+    const auto renderFrame = [&](uint32_t lightCount) {
+        resources.prepare(frameGraph);
+        resources.setBackBuffer(backBuffer);
+        EXPECT_EQ(resources.setStructuredBufferContent("lights", lights.data(), lightSize, lightCount), 0u);
+        // a second range of the same frame follows the first one in the buffer
+        EXPECT_GE(resources.setStructuredBufferContent(lightsHandle, lights.data(), lightSize, 2), lightCount);
+        *resources.buffer("frameData")->content<uint32_t>() = lightCount;
+        EXPECT_EQ(resources.texture("backBuffer"), backBuffer);
+        EXPECT_EQ(resources.texture(viewport), resources.texture("viewport"));
+        EXPECT_NE(resources.texture("viewport"), resources.texture("depth"));
+        EXPECT_GE(resources.buffer("lights")->size(), (lightCount + 2) * lightSize);
+    };
+
+    for (int frame = 0; frame < WARM_UP_FRAME_COUNT; frame++)
+        renderFrame(300);
+    const gfx::Buffer* lightsBuffer = resources.buffer("lights").get();
+    {
+        AllocationCounter allocations;
+        for (int frame = 0; frame < STEADY_FRAME_COUNT; frame++)
+            renderFrame(100 + frame * 20);
+        EXPECT_EQ(allocations.count(), 0u);
+    }
+    EXPECT_EQ(resources.buffer("lights").get(), lightsBuffer);
+
+    // a content too big for the arena replaces its buffer
+    renderFrame(4000);
+    EXPECT_NE(resources.buffer("lights").get(), lightsBuffer);
+    EXPECT_EQ(resources.setStructuredBufferContent(lightsHandle, nullptr, lightSize, 0), 0u);
+    EXPECT_THROW(resources.texture("frameData"), std::out_of_range);
+    EXPECT_THROW(resources.buffer("unknown"), std::out_of_range);
+    EXPECT_THROW(resources.setStructuredBufferContent("frameData", lights.data(), lightSize, 1), std::out_of_range);
+}
+
+TEST(FrameAllocationsTest, linearAllocatorKeepsOneBlock)
+{
+    GE::LinearAllocator allocator(256);
+    const auto allocateFrame = [&]() {
+        const std::span<uint8_t> bytes = allocator.allocate<uint8_t>(3);
+        const std::span<double> doubles = allocator.allocate<double>(20);
+        const std::span<uint32_t> integers = allocator.allocate<uint32_t>(100);
+        EXPECT_EQ(bytes.size(), 3u); // the doubles follow an odd size
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(doubles.data()) % alignof(double), 0u);
+        EXPECT_TRUE(reinterpret_cast<std::byte*>(doubles.data() + doubles.size()) <= reinterpret_cast<std::byte*>(integers.data())
+                    || reinterpret_cast<std::byte*>(integers.data() + integers.size()) <= reinterpret_cast<std::byte*>(doubles.data()));
+        for (uint32_t i = 0; i < integers.size(); i++)
+            integers[i] = i;
+        for (double& value : doubles)
+            value = 1.0;
+        EXPECT_EQ(integers[99], 99u);
+    };
+
+    // the first frame does not fit in a block
+    allocateFrame();
+    const size_t firstFrameCapacity = allocator.capacity();
+    EXPECT_GT(firstFrameCapacity, 256u);
+    allocator.reset();
+    EXPECT_EQ(allocator.capacity(), firstFrameCapacity);
+    EXPECT_EQ(allocator.usedBytes(), 0u);
+
+    AllocationCounter allocations;
+    for (int frame = 0; frame < STEADY_FRAME_COUNT; frame++)
+    {
+        allocateFrame();
+        allocator.reset();
+    }
+    EXPECT_EQ(allocations.count(), 0u);
+}
+
+TEST(FrameAllocationsTest, drawRecordingDoesNotAllocate)
+{
+    std::array<std::byte, 2> pipelineIdentities = {};
+    const std::array pipelines = {
+        std::shared_ptr<gfx::GraphicsPipeline>(std::shared_ptr<void>(), reinterpret_cast<gfx::GraphicsPipeline*>(&pipelineIdentities[0])),
+        std::shared_ptr<gfx::GraphicsPipeline>(std::shared_ptr<void>(), reinterpret_cast<gfx::GraphicsPipeline*>(&pipelineIdentities[1]))
+    };
+    std::vector<std::shared_ptr<gfx::Buffer>> indexBuffers;
+    for (int i = 0; i < 16; i++)
+        indexBuffers.push_back(std::make_shared<MockBuffer>(gfx::Buffer::Descriptor{ .size = 16 }));
+
+    // the geometry pass: queue the draws, sort them, build the packets of each job and record them
+    constexpr uint32_t drawCount = 2000;
+    constexpr uint32_t jobCount = 4;
+    GE::JobSystem jobSystem(3);
+    GE::RenderQueue renderQueue;
+    std::array<std::vector<GE::DrawPacket<PushConstants>>, jobCount> packetLists;
+    std::array<CountingCommandBuffer, jobCount> commandBuffers;
+    std::mt19937 random(3);
+    const auto renderFrame = [&]() {
+        renderQueue.clear();
+        for (uint32_t draw = 0; draw < drawCount; draw++)
+            renderQueue.push(GE::makeSortKey(draw % 2, 0, draw % 16, static_cast<float>(random() % 100)), draw);
+        renderQueue.sort();
+
+        jobSystem.parallelFor(jobCount, [&](uint32_t job, uint32_t) {
+            std::vector<GE::DrawPacket<PushConstants>>& packets = packetLists[job];
+            packets.clear();
+            for (uint32_t i = drawCount * job / jobCount; i < drawCount * (job + 1) / jobCount; i++)
+            {
+                const uint32_t draw = renderQueue.items()[i].draw;
+                packets.push_back({ .pipeline = &pipelines[draw % 2], .vertexBuffer = &indexBuffers[0], .indexBuffer = &indexBuffers[draw % 16], .pushConstants = { i } });
+            }
+            commandBuffers[job].drawCount = 0;
+            GE::recordDrawPackets<PushConstants>(commandBuffers[job], packets, {});
+        });
+    };
+
+    for (int frame = 0; frame < WARM_UP_FRAME_COUNT; frame++)
+        renderFrame();
+    {
+        AllocationCounter allocations;
+        for (int frame = 0; frame < STEADY_FRAME_COUNT; frame++)
+            renderFrame();
+        EXPECT_EQ(allocations.count(), 0u);
+    }
+
+    uint32_t recordedDrawCount = 0;
+    for (const CountingCommandBuffer& commandBuffer : commandBuffers)
+        recordedDrawCount += commandBuffer.drawCount;
+    EXPECT_EQ(recordedDrawCount, drawCount);
+}
+
+} // namespace
+
+} // namespace GE_tests
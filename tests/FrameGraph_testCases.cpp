@@ -0,0 +1,241 @@
+/*
+ * ---------------------------------------------------
+ * FrameGraph_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/FrameGraph.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+GE::AttachmentDescriptor attachment(const std::string& texture, gfx::LoadAction loadAction = gfx::LoadAction::clear)
+{
+    return GE::AttachmentDescriptor{ .texture = texture, .loadAction = loadAction, .clearColor = { 0.0f, 0.0f, 0.0f, 1.0f } };
+}
+
+GE::FramePass pass(std::vector<std::string> colorAttachments, std::vector<std::string> sampledTextures = {}, std::optional<std::string> depthAttachment = std::nullopt)
+{
+    GE::FramePass framePass;
+    for (const std::string& texture : colorAttachments)
+        framePass.colorAttachments.push_back(attachment(texture));
+    if (depthAttachment)
+        framePass.depthAttachment = attachment(*depthAttachment);
+    framePass.sampledTextures = std::move(sampledTextures);
+    return framePass;
+}
+
+std::vector<GE::TextureDescriptor> textures(const std::vector<std::string>& names)
+{
+    std::vector<GE::TextureDescriptor> descriptors;
+    for (const std::string& name : names)
+        descriptors.push_back({ .name = name, .size = { 64, 64 }, .pixelFormat = gfx::PixelFormat::BGRA8Unorm });
+    return descriptors;
+}
+
+std::vector<uint32_t> compiledOrder(const GE::FrameGraph& frameGraph)
+{
+    std::vector<uint32_t> order;
+    for (const GE::FrameGraph::CompiledPass& compiledPass : frameGraph.compiledPasses())
+        order.push_back(compiledPass.passIndex);
+    return order;
+}
+
+TEST(FrameGraphTest, readersRunAfterTheWriters)
+{
+    // declared before the pass rendering what it samples
+    const GE::FrameGraph frameGraph(GE::FrameGraph::Descriptor{
+        .backBufferName = "backBuffer",
+        .textures = textures({ "backBuffer", "viewport", "depth" }),
+        .passes = {
+            pass({ "backBuffer" }, { "viewport" }),
+            pass({ "viewport" }, {}, "depth"),
+        }
+    });
+
+    EXPECT_EQ(compiledOrder(frameGraph), (std::vector<uint32_t>{ 1, 0 }));
+    const GE::FrameGraph::CompiledPass& geometry = frameGraph.compiledPasses()[0];
+    const GE::FrameGraph::CompiledPass& ui = frameGraph.compiledPasses()[1];
+
+    EXPECT_FALSE(geometry.acquiresDrawable);
+    EXPECT_TRUE(ui.acquiresDrawable);
+    EXPECT_EQ(geometry.transitions, (std::vector<GE::ResourceTransition>{
+        { .resource = "viewport", .before = GE::ResourceState::undefined, .after = GE::ResourceState::colorAttachment },
+        { .resource = "depth", .before = GE::ResourceState::undefined, .after = GE::ResourceState::depthStencilAttachment },
+    }));
+    EXPECT_EQ(ui.transitions, (std::vector<GE::ResourceTransition>{
+        { .resource = "viewport", .before = GE::ResourceState::colorAttachment, .after = GE::ResourceState::shaderRead },
+        { .resource = "backBuffer", .before = GE::ResourceState::undefined, .after = GE::ResourceState::colorAttachment },
+    }));
+    EXPECT_EQ(frameGraph.finalTransitions(), (std::vector<GE::ResourceTransition>{
+        { .resource = "backBuffer", .before = GE::ResourceState::colorAttachment, .after = GE::ResourceState::present },
+    }));
+}
+
+TEST(FrameGraphTest, passesNotReachingTheBackBufferAreCulled)
+{
+    GE::FramePass lightsPass = pass({ "shadowMap" });
+    lightsPass.structuredBufferDeclarations = { { .name = "lights" } };
+    lightsPass.usedBuffers = { "lights" };
+
+    GE::FramePass debugPass = pass({ "debug" }, { "shadowMap" });
+    debugPass.constantBufferDeclarations = { { .name = "debugData", .size = 16 } };
+    debugPass.usedBuffers = { "debugData" };
+
+    GE::FramePass mainPass = pass({ "backBuffer" });
+    mainPass.usedBuffers = { "lights" }; // written by the setup of the lights pass
+
+    const GE::FrameGraph frameGraph(GE::FrameGraph::Descriptor{
+        .backBufferName = "backBuffer",
+        .textures = textures({ "backBuffer", "shadowMap", "debug" }),
+        .passes = { lightsPass, debugPass, mainPass }
+    });
+
+    EXPECT_EQ(compiledOrder(frameGraph), (std::vector<uint32_t>{ 0, 2 }));
+    EXPECT_TRUE(frameGraph.lifetimes().contains("shadowMap"));
+    EXPECT_FALSE(frameGraph.lifetimes().contains("debug"));
+    EXPECT_FALSE(frameGraph.lifetimes().contains("debugData"));
+    EXPECT_EQ(frameGraph.lifetimes().at("lights").firstPass, 0u);
+    EXPECT_EQ(frameGraph.lifetimes().at("lights").lastPass, 1u);
+
+    // nothing reaches a back buffer no pass writes
+    const GE::FrameGraph offscreen(GE::FrameGraph::Descriptor{
+        .backBufferName = "backBuffer",
+        .textures = textures({ "backBuffer", "debug" }),
+        .passes = { pass({ "debug" }) }
+    });
+    EXPECT_TRUE(offscreen.compiledPasses().empty());
+    EXPECT_TRUE(offscreen.finalTransitions().empty());
+}
+
+TEST(FrameGraphTest, writersOfTheSameTextureKeepTheirOrder)
+{
+    GE::FramePass overlayPass = pass({});
+    overlayPass.colorAttachments.push_back(attachment("backBuffer", gfx::LoadAction::load));
+
+    const GE::FrameGraph frameGraph(GE::FrameGraph::Descriptor{
+        .backBufferName = "backBuffer",
+        .textures = textures({ "backBuffer", "a", "b" }),
+        .passes = {
+            pass({ "backBuffer" }, { "a" }),
+            overlayPass,
+            pass({ "a" }),
+            pass({ "b" }), // independent and culled
+        }
+    });
+
+    EXPECT_EQ(compiledOrder(frameGraph), (std::vector<uint32_t>{ 2, 0, 1 }));
+    EXPECT_TRUE(frameGraph.compiledPasses()[1].acquiresDrawable);
+    EXPECT_FALSE(frameGraph.compiledPasses()[2].acquiresDrawable);
+    EXPECT_TRUE(frameGraph.compiledPasses()[2].transitions.empty()); // already a color attachment
+    EXPECT_EQ(frameGraph.lifetimes().at("a").firstPass, 0u);
+    EXPECT_EQ(frameGraph.lifetimes().at("a").lastPass, 1u);
+    EXPECT_EQ(frameGraph.lifetimes().at("backBuffer").firstPass, 1u);
+    EXPECT_EQ(frameGraph.lifetimes().at("backBuffer").lastPass, 2u);
+}
+
+TEST(FrameGraphTest, texturesWithDisjointLifetimesShareSlots)
+{
+    std::vector<GE::TextureDescriptor> textureDescriptors = textures({ "backBuffer", "blur0", "blur1", "blur2" });
+    textureDescriptors.push_back({ .name = "depth", .size = { 64, 64 }, .pixelFormat = gfx::PixelFormat::Depth32Float });
+
+    // a chain of passes each sampling the output of the previous one
+    const GE::FrameGraph frameGraph(GE::FrameGraph::Descriptor{
+        .backBufferName = "backBuffer",
+        .textures = textureDescriptors,
+        .passes = {
+            pass({ "blur0" }, {}, "depth"),
+            pass({ "blur1" }, { "blur0" }),
+            pass({ "blur2" }, { "blur1" }),
+            pass({ "backBuffer" }, { "blur2" }, "depth"),
+        }
+    });
+
+    const std::map<std::string, uint32_t>& slots = frameGraph.aliasSlots();
+    EXPECT_FALSE(slots.contains("backBuffer"));
+    EXPECT_EQ(slots.at("blur0"), slots.at("blur2"));
+    EXPECT_NE(slots.at("blur0"), slots.at("blur1"));
+    EXPECT_NE(slots.at("depth"), slots.at("blur0"));
+    EXPECT_NE(slots.at("depth"), slots.at("blur1"));
+
+    // blur0 is only an attachment, blur2 is also sampled
+    const gfx::Texture::Descriptor& sharedDescriptor = frameGraph.aliasSlotDescriptors().at(slots.at("blur0"));
+    EXPECT_EQ(sharedDescriptor.usages, frameGraph.textureDescriptors().at("blur2").usages | frameGraph.textureDescriptors().at("blur0").usages);
+
+    const uint64_t colorBytes = 64 * 64 * pixelFormatSize(gfx::PixelFormat::BGRA8Unorm);
+    const uint64_t depthBytes = 64 * 64 * pixelFormatSize(gfx::PixelFormat::Depth32Float);
+    const GE::TransientMemoryStatistics& memory = frameGraph.transientMemory();
+    EXPECT_EQ(memory.textureCount, 4u);
+    EXPECT_EQ(memory.slotCount, 3u);
+    EXPECT_EQ(memory.naiveBytes, 3 * colorBytes + depthBytes);
+    EXPECT_EQ(memory.aliasedBytes, 2 * colorBytes + depthBytes);
+    EXPECT_EQ(memory.peakBytes, 2 * colorBytes + depthBytes);
+}
+
+TEST(FrameGraphTest, passesResolveTheirHandlesOnce)
+{
+    auto handles = std::make_shared<std::pair<GE::TextureHandle, GE::BufferHandle>>();
+    auto resolveCount = std::make_shared<int>(0);
+
+    GE::FramePass mainPass = pass({ "backBuffer" }, { "shadowMap" }, "depth");
+    mainPass.constantBufferDeclarations = { { .name = "frameData", .size = 16 } };
+    mainPass.usedBuffers = { "frameData" };
+    mainPass.resolveHandles = [handles, resolveCount](const GE::FrameGraph& frameGraph) {
+        *handles = { frameGraph.textureHandle("shadowMap"), frameGraph.bufferHandle("frameData") };
+        (*resolveCount)++;
+    };
+
+    const GE::FrameGraph frameGraph(GE::FrameGraph::Descriptor{
+        .backBufferName = "backBuffer",
+        .textures = textures({ "backBuffer", "shadowMap", "depth" }),
+        .passes = { pass({ "shadowMap" }), mainPass }
+    });
+
+    EXPECT_EQ(*resolveCount, 1);
+    ASSERT_TRUE(handles->first.isValid());
+    ASSERT_TRUE(handles->second.isValid());
+    EXPECT_EQ(frameGraph.resources().at(handles->first.index).name, "shadowMap");
+    EXPECT_EQ(frameGraph.resources().at(handles->second.index).kind, GE::ResourceKind::constantBuffer);
+
+    // the renderer binds the attachments of the compiled passes through their handles
+    const GE::FrameGraph::CompiledPass& compiledMainPass = frameGraph.compiledPasses().at(1);
+    EXPECT_EQ(compiledMainPass.colorAttachments, (std::vector<GE::TextureHandle>{ frameGraph.textureHandle("backBuffer") }));
+    EXPECT_EQ(compiledMainPass.depthAttachment, frameGraph.textureHandle("depth"));
+    EXPECT_EQ(compiledMainPass.sampledTextures, (std::vector<GE::TextureHandle>{ handles->first }));
+
+    EXPECT_THROW(frameGraph.textureHandle("frameData"), std::out_of_range);
+    EXPECT_THROW(frameGraph.bufferHandle("depth"), std::out_of_range);
+    EXPECT_THROW(frameGraph.bufferHandle("unknown"), std::out_of_range);
+}
+
+TEST(FrameGraphTest, cyclesThrow)
+{
+    EXPECT_THROW(GE::FrameGraph(GE::FrameGraph::Descriptor{
+        .backBufferName = "backBuffer",
+        .textures = textures({ "backBuffer", "a", "b" }),
+        .passes = {
+            pass({ "a" }, { "b" }),
+            pass({ "b", "backBuffer" }, { "a" }),
+        }
+    }), std::runtime_error);
+}
+
+} // namespace
+
+} // namespace GE_tests
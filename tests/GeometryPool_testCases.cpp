@@ -0,0 +1,247 @@
+/*
+ * ---------------------------------------------------
+ * GeometryPool_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "GraphicsMocks.hpp"
+
+#include "Game-Engine/GeometryPool.hpp"
+#include "Game-Engine/Renderer.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+TEST(RangeAllocatorTest, allocatesFirstFit)
+{
+    GE::RangeAllocator allocator(100);
+
+    EXPECT_EQ(allocator.allocate(10), 0u);
+    EXPECT_EQ(allocator.allocate(20), 10u);
+    EXPECT_EQ(allocator.allocate(70), 30u);
+    EXPECT_FALSE(allocator.allocate(1).has_value());
+    EXPECT_EQ(allocator.freeCount(), 0u);
+
+    allocator.free(10, 20);
+    EXPECT_EQ(allocator.allocate(5), 10u);
+    EXPECT_EQ(allocator.allocate(15), 15u);
+    EXPECT_FALSE(allocator.allocate(1).has_value());
+}
+
+TEST(RangeAllocatorTest, coalescesAdjacentFreeRanges)
+{
+    GE::RangeAllocator allocator(90);
+    ASSERT_EQ(allocator.allocate(30), 0u);
+    ASSERT_EQ(allocator.allocate(30), 30u);
+    ASSERT_EQ(allocator.allocate(30), 60u);
+
+    allocator.free(0, 30);
+    allocator.free(60, 30);
+    EXPECT_EQ(allocator.freeRangeCount(), 2u);
+    EXPECT_EQ(allocator.largestFreeRange(), 30u);
+
+    allocator.free(30, 30);
+    EXPECT_EQ(allocator.freeRangeCount(), 1u);
+    EXPECT_EQ(allocator.largestFreeRange(), 90u);
+    EXPECT_TRUE(allocator.isEmpty());
+    EXPECT_EQ(allocator.allocate(90), 0u);
+}
+
+class GeometryPoolMockDeviceTest : public ::testing::Test
+{
+protected:
+    GeometryPoolMockDeviceTest()
+    {
+        ON_CALL(m_device, newBuffer(testing::_)).WillByDefault([](const gfx::Buffer::Descriptor& desc) {
+            return std::make_unique<MockBuffer>(desc);
+        });
+        ON_CALL(m_commandBuffer, copyBufferToBuffer(testing::_, testing::_, testing::_)).WillByDefault([](const std::shared_ptr<gfx::Buffer>& src, const std::shared_ptr<gfx::Buffer>& dst, size_t size) {
+            dst->setContent(src->content<std::byte>(), size);
+        });
+    }
+
+    std::vector<uint32_t> uploadedContent(const std::shared_ptr<const GE::GeometryPool::Allocation>& allocation, const GE::GeometryPool& pool, size_t count)
+    {
+        pool.upload(m_commandBuffer, std::span(&allocation, 1));
+        const uint32_t* content = allocation->buffer->content<uint32_t>();
+        return std::vector<uint32_t>(content, content + count);
+    }
+
+    testing::NiceMock<MockDevice> m_device;
+    testing::NiceMock<MockCommandBuffer> m_commandBuffer;
+};
+
+TEST_F(GeometryPoolMockDeviceTest, packsAllocationsInASharedPage)
+{
+    GE::GeometryPool pool(&m_device, 64);
+    const std::vector<uint32_t> first = { 1, 2, 3 };
+    const std::vector<uint32_t> second = { 4, 5, 6, 7 };
+
+    auto firstAllocation = pool.allocateVertices(std::span(first));
+    auto secondAllocation = pool.allocateVertices(std::span(second));
+
+    ASSERT_NE(firstAllocation->buffer, nullptr);
+    EXPECT_EQ(firstAllocation->buffer, secondAllocation->buffer);
+    EXPECT_EQ(firstAllocation->offset, 0u);
+    EXPECT_EQ(secondAllocation->offset, 3u);
+    EXPECT_EQ(secondAllocation->stride, sizeof(uint32_t));
+
+    EXPECT_EQ(uploadedContent(secondAllocation, pool, 7), (std::vector<uint32_t>{ 1, 2, 3, 4, 5, 6, 7 }));
+
+    GE::GeometryPool::Statistics statistics = pool.statistics();
+    EXPECT_EQ(statistics.pageCount, 1u);
+    EXPECT_EQ(statistics.usedBytes, 7 * sizeof(uint32_t));
+    EXPECT_EQ(statistics.reservedBytes, 64 * sizeof(uint32_t));
+}
+
+TEST_F(GeometryPoolMockDeviceTest, uploadsEachPageOnceUpToItsHighestAllocation)
+{
+    GE::GeometryPool pool(&m_device, 8);
+    const std::vector<uint32_t> vertices(4, 7);
+    const std::vector<std::shared_ptr<const GE::GeometryPool::Allocation>> allocations = {
+        pool.allocateVertices(std::span(vertices)),
+        pool.allocateVertices(std::span(vertices)),
+        pool.allocateVertices(std::span(vertices))
+    };
+    ASSERT_EQ(allocations[0]->buffer, allocations[1]->buffer);
+    ASSERT_NE(allocations[0]->buffer, allocations[2]->buffer);
+    EXPECT_EQ(allocations[0]->buffer->storageMode(), gfx::ResourceStorageMode::deviceLocal);
+    EXPECT_EQ(allocations[0]->stagingBuffer->storageMode(), gfx::ResourceStorageMode::hostVisible);
+
+    // nothing reaches the pages before the upload
+    EXPECT_EQ(allocations[0]->buffer->content<uint32_t>()[0], 0u);
+
+    EXPECT_CALL(m_commandBuffer, copyBufferToBuffer(allocations[0]->stagingBuffer, allocations[0]->buffer, 8 * sizeof(uint32_t)));
+    EXPECT_CALL(m_commandBuffer, copyBufferToBuffer(allocations[2]->stagingBuffer, allocations[2]->buffer, 4 * sizeof(uint32_t)));
+    EXPECT_EQ(pool.upload(m_commandBuffer, allocations), 12 * sizeof(uint32_t));
+    EXPECT_EQ(allocations[1]->buffer->content<uint32_t>()[7], 7u);
+}
+
+TEST_F(GeometryPoolMockDeviceTest, createsAPageForOversizedAllocations)
+{
+    GE::GeometryPool pool(&m_device, 4);
+    const std::vector<uint32_t> small = { 1, 2 };
+    const std::vector<uint32_t> large(10, 42);
+
+    auto smallAllocation = pool.allocateVertices(std::span(small));
+    auto largeAllocation = pool.allocateVertices(std::span(large));
+
+    EXPECT_NE(smallAllocation->buffer, largeAllocation->buffer);
+    EXPECT_EQ(largeAllocation->buffer->size(), large.size() * sizeof(uint32_t));
+    EXPECT_EQ(pool.statistics().pageCount, 2u);
+}
+
+TEST_F(GeometryPoolMockDeviceTest, releasesRangesAfterFramesInFlight)
+{
+    GE::GeometryPool pool(&m_device, 8);
+    const std::vector<uint32_t> vertices(8, 0);
+
+    auto kept = pool.allocateVertices(std::span(vertices));
+    auto released = pool.allocateVertices(std::span(vertices));
+    ASSERT_NE(kept->buffer, released->buffer);
+    released.reset();
+
+    for (uint32_t i = 1; i < GE::maxFrameInFlight; i++)
+    {
+        pool.endFrame();
+        EXPECT_EQ(pool.statistics().pendingFreeCount, 1u);
+        EXPECT_EQ(pool.statistics().pageCount, 2u);
+    }
+    pool.endFrame();
+
+    GE::GeometryPool::Statistics statistics = pool.statistics();
+    EXPECT_EQ(statistics.pendingFreeCount, 0u);
+    EXPECT_EQ(statistics.pageCount, 1u);
+    EXPECT_EQ(statistics.usedBytes, vertices.size() * sizeof(uint32_t));
+}
+
+TEST_F(GeometryPoolMockDeviceTest, reusesReleasedRanges)
+{
+    GE::GeometryPool pool(&m_device, 8);
+    const std::vector<uint32_t> vertices(4, 0);
+
+    auto first = pool.allocateVertices(std::span(vertices));
+    auto second = pool.allocateVertices(std::span(vertices));
+    first.reset();
+    for (uint32_t i = 0; i < GE::maxFrameInFlight; i++)
+        pool.endFrame();
+
+    auto third = pool.allocateVertices(std::span(vertices));
+    EXPECT_EQ(third->buffer, second->buffer);
+    EXPECT_EQ(third->offset, 0u);
+    EXPECT_EQ(pool.statistics().pageCount, 1u);
+}
+
+TEST_F(GeometryPoolMockDeviceTest, relocatesIntoTheReleasedRanges)
+{
+    GE::GeometryPool pool(&m_device, 12);
+    const std::vector<uint32_t> vertices1(4, 1);
+    const std::vector<uint32_t> vertices2(4, 2);
+    const std::vector<uint32_t> vertices3(4, 3);
+    const std::vector<uint32_t> vertices4(4, 4);
+    auto first = pool.allocateVertices(std::span(vertices1));
+    auto second = pool.allocateVertices(std::span(vertices2));
+    auto third = pool.allocateVertices(std::span(vertices3));
+    EXPECT_EQ(pool.relocate(*third), nullptr);
+
+    first.reset();
+    for (uint32_t i = 0; i < GE::maxFrameInFlight; i++)
+        pool.endFrame();
+    EXPECT_EQ(pool.retiredFreeCount(), 1u);
+
+    auto relocated = pool.relocate(*third);
+    ASSERT_NE(relocated, nullptr);
+    EXPECT_EQ(relocated->buffer, third->buffer);
+    EXPECT_EQ(relocated->offset, 0u);
+    EXPECT_EQ(relocated->count, 4u);
+    EXPECT_EQ(uploadedContent(third, pool, 12), (std::vector<uint32_t>{ 3, 3, 3, 3, 2, 2, 2, 2, 3, 3, 3, 3 }));
+
+    // nothing is lower than the second range now, the original of the third one is released after the frames in flight
+    EXPECT_EQ(pool.relocate(*second), nullptr);
+    third = relocated;
+    for (uint32_t i = 0; i < GE::maxFrameInFlight; i++)
+        pool.endFrame();
+    EXPECT_EQ(pool.statistics().usedBytes, 8 * sizeof(uint32_t));
+    EXPECT_EQ(pool.allocateVertices(std::span(vertices4))->offset, 8u);
+}
+
+TEST_F(GeometryPoolMockDeviceTest, relocationEmptiesTheLastPages)
+{
+    GE::GeometryPool pool(&m_device, 8);
+    const std::vector<uint32_t> pageVertices1(8, 1);
+    const std::vector<uint32_t> pageVertices2(8, 2);
+    auto first = pool.allocateVertices(std::span(pageVertices1));
+    auto second = pool.allocateVertices(std::span(pageVertices2));
+    ASSERT_NE(first->buffer, second->buffer);
+
+    first.reset();
+    for (uint32_t i = 0; i < GE::maxFrameInFlight; i++)
+        pool.endFrame();
+    EXPECT_EQ(pool.statistics().pageCount, 2u);
+
+    second = pool.relocate(*second);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(second->offset, 0u);
+    EXPECT_EQ(uploadedContent(second, pool, 8)[7], 2u);
+    for (uint32_t i = 0; i < GE::maxFrameInFlight; i++)
+        pool.endFrame();
+    EXPECT_EQ(pool.statistics().pageCount, 1u);
+    EXPECT_EQ(pool.statistics().pendingFreeCount, 0u);
+}
+
+} // namespace
+
+} // namespace GE_tests
@@ -0,0 +1,241 @@
+/*
+ * ---------------------------------------------------
+ * GraphicsMocks.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * gfx mocks shared by the test cases that need a device
+ *
+ */
+
+#ifndef GRAPHICSMOCKS_HPP
+#define GRAPHICSMOCKS_HPP
+
+#include <gmock/gmock.h>
+
+#include <Graphics/Buffer.hpp>
+#include <Graphics/CommandBuffer.hpp>
+#include <Graphics/CommandBufferPool.hpp>
+#include <Graphics/Device.hpp>
+#include <Graphics/Texture.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace GE_tests
+{
+
+class MockBuffer final : public gfx::Buffer
+{
+public:
+    explicit MockBuffer(const Descriptor& desc)
+        : m_desc(desc)
+        , m_bytes(desc.size)
+    {
+    }
+
+    size_t size() const override { return m_desc.size; }
+    gfx::BufferUsages usages() const override { return m_desc.usages; }
+    gfx::ResourceStorageMode storageMode() const override { return m_desc.storageMode; }
+
+    void setContent(const void* data, size_t size) override
+    {
+        if (size > m_bytes.size())
+            throw std::runtime_error("buffer overflow in mock buffer");
+        std::memcpy(m_bytes.data(), data, size);
+    }
+
+protected:
+    void* contentVoid() override { return m_bytes.data(); }
+
+private:
+    Descriptor m_desc;
+    std::vector<std::byte> m_bytes;
+};
+
+class TestTexture final : public gfx::Texture
+{
+public:
+    explicit TestTexture(const Descriptor& desc)
+        : m_desc(desc)
+    {
+    }
+
+    gfx::TextureType type() const override { return m_desc.type; }
+    uint32_t width() const override { return m_desc.width; }
+    uint32_t height() const override { return m_desc.height; }
+    gfx::PixelFormat pixelFormat() const override { return m_desc.pixelFormat; }
+    gfx::TextureUsages usages() const override { return m_desc.usages; }
+    gfx::ResourceStorageMode storageMode() const override { return m_desc.storageMode; }
+
+#if defined(GFX_IMGUI_ENABLED)
+    void initImTextureId() override {}
+    std::optional<uint64_t> imTextureId() const override { return std::nullopt; }
+#endif
+
+private:
+    Descriptor m_desc;
+};
+
+class MockCommandBuffer : public gfx::CommandBuffer
+{
+public:
+    MOCK_METHOD(void, beginRenderPass, (const gfx::Framebuffer&), (override));
+    MOCK_METHOD(void, usePipeline, ((const std::shared_ptr<const gfx::GraphicsPipeline>&)), (override));
+    MOCK_METHOD(void, useVertexBuffer, ((const std::shared_ptr<gfx::Buffer>&)), (override));
+    MOCK_METHOD(void, setParameterBlock, ((const std::shared_ptr<const gfx::ParameterBlock>&), uint32_t), (override));
+    MOCK_METHOD(void, setPushConstants, (const void*, size_t), (override));
+    MOCK_METHOD(void, drawVertices, (uint32_t, uint32_t), (override));
+    MOCK_METHOD(void, drawIndexedVertices, ((const std::shared_ptr<gfx::Buffer>&)), (override));
+#if defined(GFX_IMGUI_ENABLED)
+    MOCK_METHOD(void, imGuiRenderDrawData, (ImDrawData*), (const, override));
+#endif
+    MOCK_METHOD(void, endRenderPass, (), (override));
+
+    MOCK_METHOD(void, beginBlitPass, (), (override));
+    MOCK_METHOD(void, copyBufferToBuffer, ((const std::shared_ptr<gfx::Buffer>&), (const std::shared_ptr<gfx::Buffer>&), size_t), (override));
+    MOCK_METHOD(void, copyBufferToTexture, ((const std::shared_ptr<gfx::Buffer>&), size_t, (const std::shared_ptr<gfx::Texture>&), uint32_t), (override));
+    MOCK_METHOD(void, endBlitPass, (), (override));
+    MOCK_METHOD(void, presentDrawable, ((const std::shared_ptr<gfx::Drawable>&)), (override));
+    MOCK_METHOD(void, addSampledTexture, ((const std::shared_ptr<gfx::Texture>&)), (override));
+};
+
+// keeps the recorded commands, to check a recording without expectations on each call
+class RecordingCommandBuffer final : public gfx::CommandBuffer
+{
+public:
+    enum class Type : uint8_t { usePipeline, useVertexBuffer, setParameterBlock, setPushConstants, drawIndexedVertices, other };
+
+    struct Command
+    {
+        Type type;
+        const void* object = nullptr;    // the pipeline, buffer or parameter block
+        uint32_t index = 0;              // of the parameter block
+        std::vector<std::byte> pushConstants;
+    };
+
+    void beginRenderPass(const gfx::Framebuffer&) override { commands.push_back({ .type = Type::other }); }
+    void usePipeline(const std::shared_ptr<const gfx::GraphicsPipeline>& pipeline) override { commands.push_back({ .type = Type::usePipeline, .object = pipeline.get() }); }
+    void useVertexBuffer(const std::shared_ptr<gfx::Buffer>& buffer) override { commands.push_back({ .type = Type::useVertexBuffer, .object = buffer.get() }); }
+    void setParameterBlock(const std::shared_ptr<const gfx::ParameterBlock>& block, uint32_t index) override { commands.push_back({ .type = Type::setParameterBlock, .object = block.get(), .index = index }); }
+    void setPushConstants(const void* data, size_t size) override
+    {
+        const auto* bytes = static_cast<const std::byte*>(data);
+        commands.push_back({ .type = Type::setPushConstants, .pushConstants = std::vector<std::byte>(bytes, bytes + size) });
+    }
+    using gfx::CommandBuffer::setPushConstants;
+    void drawVertices(uint32_t, uint32_t) override { commands.push_back({ .type = Type::other }); }
+    void drawIndexedVertices(const std::shared_ptr<gfx::Buffer>& indexBuffer) override { commands.push_back({ .type = Type::drawIndexedVertices, .object = indexBuffer.get() }); }
+#if defined(GFX_IMGUI_ENABLED)
+    void imGuiRenderDrawData(ImDrawData*) const override {}
+#endif
+    void endRenderPass() override { commands.push_back({ .type = Type::other }); }
+
+    void beginBlitPass() override {}
+    void copyBufferToBuffer(const std::shared_ptr<gfx::Buffer>&, const std::shared_ptr<gfx::Buffer>&, size_t) override {}
+    void copyBufferToTexture(const std::shared_ptr<gfx::Buffer>&, size_t, const std::shared_ptr<gfx::Texture>&, uint32_t) override {}
+    void endBlitPass() override {}
+    void presentDrawable(const std::shared_ptr<gfx::Drawable>&) override {}
+    void addSampledTexture(const std::shared_ptr<gfx::Texture>&) override {}
+
+    std::vector<Command> commands;
+};
+
+// only counts the draws, recording does not allocate
+class CountingCommandBuffer final : public gfx::CommandBuffer
+{
+public:
+    void beginRenderPass(const gfx::Framebuffer&) override {}
+    void usePipeline(const std::shared_ptr<const gfx::GraphicsPipeline>&) override { bindCount++; }
+    void useVertexBuffer(const std::shared_ptr<gfx::Buffer>&) override { bindCount++; }
+    void setParameterBlock(const std::shared_ptr<const gfx::ParameterBlock>&, uint32_t) override { bindCount++; }
+    void setPushConstants(const void*, size_t) override {}
+    using gfx::CommandBuffer::setPushConstants;
+    void drawVertices(uint32_t, uint32_t) override { drawCount++; }
+    void drawIndexedVertices(const std::shared_ptr<gfx::Buffer>&) override { drawCount++; }
+#if defined(GFX_IMGUI_ENABLED)
+    void imGuiRenderDrawData(ImDrawData*) const override {}
+#endif
+    void endRenderPass() override {}
+
+    void beginBlitPass() override {}
+    void copyBufferToBuffer(const std::shared_ptr<gfx::Buffer>&, const std::shared_ptr<gfx::Buffer>&, size_t) override {}
+    void copyBufferToTexture(const std::shared_ptr<gfx::Buffer>&, size_t, const std::shared_ptr<gfx::Texture>&, uint32_t) override {}
+    void endBlitPass() override {}
+    void presentDrawable(const std::shared_ptr<gfx::Drawable>&) override {}
+    void addSampledTexture(const std::shared_ptr<gfx::Texture>&) override {}
+
+    uint32_t bindCount = 0;
+    uint32_t drawCount = 0;
+};
+
+class MockCommandBufferPool : public gfx::CommandBufferPool
+{
+public:
+    MOCK_METHOD(std::shared_ptr<gfx::CommandBuffer>, get, (), (override));
+    MOCK_METHOD(void, reset, (), (override));
+};
+
+class MockDevice : public gfx::Device
+{
+public:
+    MOCK_METHOD(gfx::Backend, backend, (), (const, override));
+    MOCK_METHOD(std::unique_ptr<gfx::Swapchain>, newSwapchain, (const gfx::Swapchain::Descriptor&), (const, override));
+    MOCK_METHOD(std::unique_ptr<gfx::ShaderLib>, newShaderLib, (const std::filesystem::path&), (const, override));
+    MOCK_METHOD(std::unique_ptr<gfx::ParameterBlockLayout>, newParameterBlockLayout, (const gfx::ParameterBlockLayout::Descriptor&), (const, override));
+    MOCK_METHOD(std::unique_ptr<gfx::GraphicsPipeline>, newGraphicsPipeline, (const gfx::GraphicsPipeline::Descriptor&), (const, override));
+    MOCK_METHOD(std::unique_ptr<gfx::Buffer>, newBuffer, (const gfx::Buffer::Descriptor&), (const, override));
+    MOCK_METHOD(std::unique_ptr<gfx::Texture>, newTexture, (const gfx::Texture::Descriptor&), (const, override));
+    MOCK_METHOD(std::unique_ptr<gfx::CommandBufferPool>, newCommandBufferPool, (), (const, override));
+    MOCK_METHOD(std::unique_ptr<gfx::ParameterBlockPool>, newParameterBlockPool, (const gfx::ParameterBlockPool::Descriptor&), (const, override));
+    MOCK_METHOD(std::unique_ptr<gfx::Sampler>, newSampler, (const gfx::Sampler::Descriptor&), (const, override));
+
+#if defined(GFX_IMGUI_ENABLED)
+    MOCK_METHOD(void, imguiInit, (std::vector<gfx::PixelFormat>, std::optional<gfx::PixelFormat>), (const, override));
+    MOCK_METHOD(void, imguiNewFrame, (), (const, override));
+    MOCK_METHOD(void, imguiShutdown, (), (override));
+#endif
+
+    MOCK_METHOD(void, submitCommandBuffers, ((const std::shared_ptr<gfx::CommandBuffer>&)), (override));
+    MOCK_METHOD(void, submitCommandBuffers, ((const std::vector<std::shared_ptr<gfx::CommandBuffer>>&)), (override));
+    MOCK_METHOD(void, waitCommandBuffer, (const gfx::CommandBuffer&), (override));
+    MOCK_METHOD(void, waitIdle, (), (override));
+};
+
+class AssetManagerMockDeviceTest : public ::testing::Test
+{
+protected:
+    AssetManagerMockDeviceTest()
+        : m_commandBuffer(std::make_shared<testing::NiceMock<MockCommandBuffer>>())
+    {
+        ON_CALL(m_device, backend()).WillByDefault(testing::Return(gfx::Backend::metal));
+        ON_CALL(m_device, newBuffer(testing::_)).WillByDefault([](const gfx::Buffer::Descriptor& desc) {
+            return std::make_unique<MockBuffer>(desc);
+        });
+        ON_CALL(m_device, newTexture(testing::_)).WillByDefault([](const gfx::Texture::Descriptor& desc) {
+            return std::make_unique<TestTexture>(desc);
+        });
+        ON_CALL(m_device, newCommandBufferPool()).WillByDefault([this]() {
+            auto pool = std::make_unique<testing::NiceMock<MockCommandBufferPool>>();
+            ON_CALL(*pool, get()).WillByDefault(testing::Return(m_commandBuffer));
+            return pool;
+        });
+        ON_CALL(*m_commandBuffer, copyBufferToBuffer(testing::_, testing::_, testing::_)).WillByDefault([](const std::shared_ptr<gfx::Buffer>& src, const std::shared_ptr<gfx::Buffer>& dst, size_t size) {
+            dst->setContent(src->content<std::byte>(), size);
+        });
+    }
+
+    testing::NiceMock<MockDevice> m_device;
+    std::shared_ptr<testing::NiceMock<MockCommandBuffer>> m_commandBuffer;
+};
+
+} // namespace GE_tests
+
+#endif // GRAPHICSMOCKS_HPP
@@ -0,0 +1,77 @@
+/*
+ * ---------------------------------------------------
+ * JobSystem_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/JobSystem.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+TEST(JobSystemTest, eachIndexRunsOnce)
+{
+    GE::JobSystem jobSystem(3);
+    EXPECT_EQ(jobSystem.threadCount(), 4u);
+
+    // repeated loops, the workers must not see the previous one
+    for (uint32_t count : { 1u, 2u, 1000u, 0u, 7u, 5000u })
+    {
+        std::vector<std::atomic<uint32_t>> runCounts(count);
+        std::atomic<bool> validThreadIndices = true;
+        jobSystem.parallelFor(count, [&](uint32_t index, uint32_t threadIndex) {
+            runCounts[index]++;
+            if (threadIndex >= jobSystem.threadCount())
+                validThreadIndices = false;
+        });
+        for (uint32_t i = 0; i < count; i++)
+            EXPECT_EQ(runCounts[i].load(), 1u);
+        EXPECT_TRUE(validThreadIndices);
+    }
+}
+
+TEST(JobSystemTest, withoutWorkersTheCallerRunsTheJobs)
+{
+    GE::JobSystem jobSystem(0);
+    EXPECT_EQ(jobSystem.threadCount(), 1u);
+
+    std::vector<uint32_t> indices;
+    jobSystem.parallelFor(5, [&](uint32_t index, uint32_t threadIndex) {
+        EXPECT_EQ(threadIndex, 0u);
+        indices.push_back(index);
+    });
+    EXPECT_EQ(indices, (std::vector<uint32_t>{ 0, 1, 2, 3, 4 }));
+}
+
+TEST(JobSystemTest, exceptionsAreRethrownAfterTheOtherJobs)
+{
+    GE::JobSystem jobSystem(2);
+    std::atomic<uint32_t> runCount = 0;
+    EXPECT_THROW(jobSystem.parallelFor(100, [&](uint32_t index, uint32_t) {
+        runCount++;
+        if (index == 10)
+            throw std::runtime_error("job failed");
+    }), std::runtime_error);
+    EXPECT_EQ(runCount.load(), 100u);
+
+    // still usable
+    runCount = 0;
+    jobSystem.parallelFor(10, [&](uint32_t, uint32_t) { runCount++; });
+    EXPECT_EQ(runCount.load(), 10u);
+}
+
+} // namespace
+
+} // namespace GE_tests
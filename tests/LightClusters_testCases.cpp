@@ -0,0 +1,176 @@
+/*
+ * ---------------------------------------------------
+ * LightClusters_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/LightClusters.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+constexpr float NEAR_DEPTH = 0.1f;
+constexpr float FAR_DEPTH = 100.0f;
+
+// camera at `position` looking down -z, like the CameraComponent projection
+glm::mat4 viewProjection(const glm::vec3& position = glm::vec3(0.0f))
+{
+    return glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, NEAR_DEPTH, FAR_DEPTH) * glm::lookAt(position, position + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+bool clusterHasLight(const GE::LightClusterGrid& grid, const glm::uvec3& cluster, uint32_t light)
+{
+    const GE::LightClusterGrid::Cluster& range = grid.clusters()[grid.clusterIndex(cluster)];
+    const auto lights = grid.lightIndices().subspan(range.offset, range.count);
+    return std::ranges::find(lights, light) != lights.end();
+}
+
+TEST(LightClustersTest, pointLightRadius)
+{
+    const float radius = GE::pointLightRadius(glm::vec3(2.0f, 1.0f, 0.5f), 0.5f);
+    EXPECT_NEAR(2.0f / (1.0f + 0.5f * radius * radius), GE::POINT_LIGHT_CUTOFF, 1e-6f);
+    EXPECT_GT(GE::pointLightRadius(glm::vec3(1.0f), 0.1f), GE::pointLightRadius(glm::vec3(1.0f), 0.5f));
+    EXPECT_EQ(GE::pointLightRadius(glm::vec3(1.0f), 0.0f), std::numeric_limits<float>::infinity());
+    EXPECT_EQ(GE::pointLightRadius(glm::vec3(0.0f), 0.0f), 0.0f);
+}
+
+TEST(LightClustersTest, lightIsInTheClusterOfItsCenter)
+{
+    GE::LightClusterGrid grid;
+    const std::vector<GE::BoundingSphere> lights = {
+        { .center = glm::vec3(0.0f, 0.0f, -10.0f), .radius = 0.01f },
+        { .center = glm::vec3(3.0f, -2.0f, -40.0f), .radius = 0.01f },
+    };
+    grid.build(viewProjection(), NEAR_DEPTH, FAR_DEPTH, lights);
+
+    // the first one is on the boundary of two columns, it is in both
+    EXPECT_GE(grid.lightIndices().size(), 3u);
+    EXPECT_LE(grid.lightIndices().size(), 8u);
+    EXPECT_TRUE(clusterHasLight(grid, grid.clusterOf(lights[0].center), 0));
+    EXPECT_TRUE(clusterHasLight(grid, grid.clusterOf(lights[1].center), 1));
+    EXPECT_EQ(grid.clusterOf(lights[0].center).x, GE::LightClusterGrid::DEFAULT_TILE_COUNT_X / 2);
+
+    // the slices grow exponentially, the formula of the shader gives the same slice
+    const float depth = 10.0f;
+    const auto slice = static_cast<uint32_t>(std::floor(std::log2(depth) * grid.depthScale() + grid.depthBias()));
+    EXPECT_EQ(grid.clusterOf(lights[0].center).z, slice);
+    EXPECT_EQ(grid.clusterOf(glm::vec3(0.0f, 0.0f, -NEAR_DEPTH * 1.001f)).z, 0u);
+    EXPECT_EQ(grid.clusterOf(glm::vec3(0.0f, 0.0f, -FAR_DEPTH * 0.999f)).z, GE::LightClusterGrid::DEFAULT_SLICE_COUNT - 1);
+}
+
+TEST(LightClustersTest, lightsOutsideTheFrustumAreNotAssigned)
+{
+    GE::LightClusterGrid grid;
+    const std::vector<GE::BoundingSphere> lights = {
+        { .center = glm::vec3(0.0f, 0.0f, 10.0f), .radius = 5.0f },     // behind the camera
+        { .center = glm::vec3(0.0f, 0.0f, -200.0f), .radius = 50.0f },  // after the far plane
+        { .center = glm::vec3(100.0f, 0.0f, -10.0f), .radius = 5.0f },  // on the right
+        { .center = glm::vec3(0.0f, 0.0f, -10.0f), .radius = std::numeric_limits<float>::infinity() },
+        { .center = glm::vec3(0.0f, 0.0f, -10.0f), .radius = 0.0f },
+    };
+    grid.build(viewProjection(), NEAR_DEPTH, FAR_DEPTH, lights);
+
+    EXPECT_TRUE(grid.lightIndices().empty());
+    for (const GE::LightClusterGrid::Cluster& cluster : grid.clusters())
+        EXPECT_EQ(cluster.count, 0u);
+}
+
+TEST(LightClustersTest, lightAroundTheCameraIsInTheNearClusters)
+{
+    GE::LightClusterGrid grid(4, 4, 8);
+    const std::vector<GE::BoundingSphere> lights = { { .center = glm::vec3(0.0f), .radius = 1.0f } };
+    grid.build(viewProjection(), NEAR_DEPTH, FAR_DEPTH, lights);
+
+    for (uint32_t y = 0; y < 4; y++)
+    {
+        for (uint32_t x = 0; x < 4; x++)
+        {
+            EXPECT_TRUE(clusterHasLight(grid, glm::uvec3(x, y, 0), 0));
+            EXPECT_FALSE(clusterHasLight(grid, glm::uvec3(x, y, 7), 0));
+        }
+    }
+}
+
+// every position lit by a light must find it in its cluster, and the lights must not be in every cluster
+TEST(LightClustersTest, assignmentContainsTheLitPositions)
+{
+    const glm::vec3 cameraPosition(5.0f, 2.0f, 3.0f);
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> coordinate(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> depth(-FAR_DEPTH, 5.0f);
+    std::uniform_real_distribution<float> radius(0.5f, 8.0f);
+
+    std::vector<GE::BoundingSphere> lights(500);
+    for (GE::BoundingSphere& light : lights)
+        light = { .center = cameraPosition + glm::vec3(coordinate(random), coordinate(random) * 0.5f, depth(random)), .radius = radius(random) };
+
+    GE::LightClusterGrid grid;
+    const glm::mat4 matrix = viewProjection(cameraPosition);
+    grid.build(matrix, NEAR_DEPTH, FAR_DEPTH, lights);
+
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    uint32_t testedCount = 0;
+    for (int i = 0; i < 20000; i++)
+    {
+        // a position around a light, kept if it is in the frustum
+        const GE::BoundingSphere& light = lights[random() % lights.size()];
+        const glm::vec3 position = light.center + glm::vec3(unit(random), unit(random), unit(random)) * light.radius;
+        const glm::vec4 clip = matrix * glm::vec4(position, 1.0f);
+        if (clip.w < NEAR_DEPTH || clip.w > FAR_DEPTH || std::abs(clip.x) > clip.w || std::abs(clip.y) > clip.w)
+            continue;
+        testedCount++;
+
+        const glm::uvec3 cluster = grid.clusterOf(position);
+        for (uint32_t j = 0; j < lights.size(); j++)
+        {
+            if (glm::distance(position, lights[j].center) <= lights[j].radius)
+            {
+                ASSERT_TRUE(clusterHasLight(grid, cluster, j)) << "light " << j << " at " << i;
+            }
+        }
+    }
+    EXPECT_GT(testedCount, 1000u);
+    EXPECT_LT(grid.lightIndices().size(), lights.size() * grid.clusters().size() / 20);
+
+    // the clusters list their lights once, in increasing order
+    for (const GE::LightClusterGrid::Cluster& cluster : grid.clusters())
+    {
+        const auto clusterLights = grid.lightIndices().subspan(cluster.offset, cluster.count);
+        EXPECT_TRUE(std::ranges::adjacent_find(clusterLights, std::ranges::greater_equal()) == clusterLights.end());
+    }
+}
+
+TEST(LightClustersTest, rebuildingKeepsTheMemory)
+{
+    GE::LightClusterGrid grid;
+    std::vector<GE::BoundingSphere> lights(100, GE::BoundingSphere{ .center = glm::vec3(0.0f, 0.0f, -20.0f), .radius = 3.0f });
+    grid.build(viewProjection(), NEAR_DEPTH, FAR_DEPTH, lights);
+    const uint32_t* indices = grid.lightIndices().data();
+    const size_t indexCount = grid.lightIndices().size();
+
+    lights.resize(50);
+    grid.build(viewProjection(), NEAR_DEPTH, FAR_DEPTH, lights);
+    EXPECT_EQ(grid.lightIndices().data(), indices);
+    EXPECT_EQ(grid.lightIndices().size(), indexCount / 2);
+}
+
+} // namespace
+
+} // namespace GE_tests
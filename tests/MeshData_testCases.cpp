@@ -0,0 +1,210 @@
+/*
+ * ---------------------------------------------------
+ * MeshData_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/MeshData.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+class MeshDataTest : public ::testing::Test
+{
+protected:
+    MeshDataTest()
+        : m_directory(std::filesystem::temp_directory_path() / ("GE_MeshDataTest_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name())))
+    {
+        std::filesystem::remove_all(m_directory);
+        std::filesystem::create_directories(m_directory);
+    }
+
+    ~MeshDataTest() override
+    {
+        std::error_code error;
+        std::filesystem::remove_all(m_directory, error);
+    }
+
+    static GE::MeshData makeMeshData()
+    {
+        auto vertices = std::make_shared<std::vector<GE::Vertex>>(std::vector<GE::Vertex>{
+            { .pos = { 0, 0, 0 }, .uv = { 0, 0 }, .normal = { 0, 0, 1 }, .tangent = { 1, 0, 0 } },
+            { .pos = { 1, 0, 0 }, .uv = { 1, 0 }, .normal = { 0, 0, 1 }, .tangent = { 1, 0, 0 } },
+            { .pos = { 0, 1, 0 }, .uv = { 0, 1 }, .normal = { 0, 0, 1 }, .tangent = { 1, 0, 0 } },
+        });
+        auto indices = std::make_shared<std::vector<uint32_t>>(std::vector<uint32_t>{ 0, 1, 2 });
+
+        GE::MeshData meshData = { .name = "triangle_mesh" };
+        meshData.geometries.push_back({ .name = "triangle", .vertices = std::span<const GE::Vertex>(*vertices), .indices = std::span<const uint32_t>(*indices) });
+        meshData.geometries.push_back({ .name = "empty", .vertices = std::span<const GE::Vertex>(), .indices = std::span<const uint32_t>() });
+        meshData.nodes.push_back({ .geometry = 0, .parent = -1, .transform = glm::mat4x4(1.0f) });
+        meshData.nodes.push_back({ .geometry = 1, .parent = 0, .transform = glm::mat4x4(2.0f) });
+        meshData.nodes.push_back({ .geometry = 0, .parent = 1, .transform = glm::mat4x4(3.0f) });
+        meshData.dependencies.push_back({ .path = "triangle.bin", .hash = 7 });
+        meshData.storage = std::make_shared<std::pair<decltype(vertices), decltype(indices)>>(vertices, indices);
+        return meshData;
+    }
+
+    std::filesystem::path m_directory;
+};
+
+TEST_F(MeshDataTest, cookedMeshRoundTrip)
+{
+    const GE::MeshData meshData = makeMeshData();
+    const std::filesystem::path cookedPath = m_directory / "mesh.gemesh";
+
+    GE::writeCookedMesh(cookedPath, meshData, 42);
+    std::optional<GE::MeshData> cooked = GE::readCookedMesh(cookedPath, 42);
+    ASSERT_TRUE(cooked.has_value());
+
+    EXPECT_EQ(cooked->name, meshData.name);
+    ASSERT_EQ(cooked->geometries.size(), meshData.geometries.size());
+    for (size_t i = 0; i < meshData.geometries.size(); i++)
+    {
+        EXPECT_EQ(cooked->geometries[i].name, meshData.geometries[i].name);
+        EXPECT_EQ(cooked->geometries[i].vertexFormat(), GE::VertexFormat::full);
+        const auto cookedVertices = std::get<std::span<const GE::Vertex>>(cooked->geometries[i].vertices);
+        const auto vertices = std::get<std::span<const GE::Vertex>>(meshData.geometries[i].vertices);
+        ASSERT_EQ(cookedVertices.size(), vertices.size());
+        for (size_t v = 0; v < vertices.size(); v++)
+        {
+            EXPECT_EQ(cookedVertices[v].pos, vertices[v].pos);
+            EXPECT_EQ(cookedVertices[v].uv, vertices[v].uv);
+        }
+        EXPECT_TRUE(std::ranges::equal(cooked->geometries[i].indices, meshData.geometries[i].indices));
+    }
+    ASSERT_EQ(cooked->nodes.size(), meshData.nodes.size());
+    for (size_t i = 0; i < meshData.nodes.size(); i++)
+    {
+        EXPECT_EQ(cooked->nodes[i].geometry, meshData.nodes[i].geometry);
+        EXPECT_EQ(cooked->nodes[i].parent, meshData.nodes[i].parent);
+        EXPECT_EQ(cooked->nodes[i].transform, meshData.nodes[i].transform);
+    }
+    ASSERT_EQ(cooked->dependencies.size(), 1u);
+    EXPECT_EQ(cooked->dependencies[0].path, "triangle.bin");
+    EXPECT_EQ(cooked->dependencies[0].hash, 7u);
+}
+
+TEST_F(MeshDataTest, packedCookedMeshRoundTrip)
+{
+    const GE::MeshData meshData = GE::cookMesh(makeMeshData(), GE::MeshCookOptions{ .vertexFormat = GE::VertexFormat::packed });
+    const std::filesystem::path cookedPath = m_directory / "mesh.gemesh";
+
+    GE::writeCookedMesh(cookedPath, meshData, 42);
+    std::optional<GE::MeshData> cooked = GE::readCookedMesh(cookedPath, 42);
+    ASSERT_TRUE(cooked.has_value());
+
+    const GE::MeshData::Geometry& geometry = cooked->geometries[0];
+    EXPECT_EQ(geometry.vertexFormat(), GE::VertexFormat::packed);
+    EXPECT_TRUE(std::ranges::equal(geometry.indices, std::vector<uint32_t>{ 0, 1, 2 }));
+    EXPECT_EQ(geometry.positionQuantization.offset, meshData.geometries[0].positionQuantization.offset);
+    EXPECT_EQ(geometry.positionQuantization.scale, meshData.geometries[0].positionQuantization.scale);
+
+    const auto packed = std::get<std::span<const GE::PackedVertex>>(geometry.vertices);
+    const GE::Vertex last = GE::unpackVertex(packed[2], geometry.positionQuantization);
+    EXPECT_NEAR(last.pos.y, 1.0f, 1e-4f);
+    EXPECT_NEAR(last.normal.z, 1.0f, 1e-4f);
+}
+
+TEST_F(MeshDataTest, cookedMeshLodsRoundTrip)
+{
+    GE::MeshData meshData = makeMeshData();
+    auto lodIndices = std::make_shared<std::vector<uint32_t>>(std::vector<uint32_t>{ 2, 1, 0 });
+    meshData.geometries[0].lods.push_back({ .indices = std::span<const uint32_t>(*lodIndices), .error = 0.5f });
+    meshData.geometries[0].boundingSphere = { .center = { 0.5f, 0.5f, 0.0f }, .radius = 0.75f };
+    meshData.geometries[0].boundingBox = { .min = { 0.0f, 0.0f, 0.0f }, .max = { 1.0f, 1.0f, 0.0f } };
+    meshData.storage = std::make_shared<std::pair<std::shared_ptr<const void>, decltype(lodIndices)>>(meshData.storage, lodIndices);
+
+    const std::filesystem::path cookedPath = m_directory / "mesh.gemesh";
+    GE::writeCookedMesh(cookedPath, meshData, 42);
+    std::optional<GE::MeshData> cooked = GE::readCookedMesh(cookedPath, 42);
+    ASSERT_TRUE(cooked.has_value());
+
+    const GE::MeshData::Geometry& geometry = cooked->geometries[0];
+    ASSERT_EQ(geometry.lods.size(), 1u);
+    EXPECT_TRUE(std::ranges::equal(geometry.lods[0].indices, *lodIndices));
+    EXPECT_EQ(geometry.lods[0].error, 0.5f);
+    EXPECT_EQ(geometry.boundingSphere.center, glm::vec3(0.5f, 0.5f, 0.0f));
+    EXPECT_EQ(geometry.boundingSphere.radius, 0.75f);
+    EXPECT_EQ(geometry.boundingBox, (GE::BoundingBox{ .min = { 0.0f, 0.0f, 0.0f }, .max = { 1.0f, 1.0f, 0.0f } }));
+    EXPECT_TRUE(cooked->geometries[1].lods.empty());
+}
+
+TEST_F(MeshDataTest, rejectsCookedMeshWithAnOtherKey)
+{
+    const std::filesystem::path cookedPath = m_directory / "mesh.gemesh";
+    GE::writeCookedMesh(cookedPath, makeMeshData(), 42);
+
+    EXPECT_FALSE(GE::readCookedMesh(cookedPath, 43).has_value());
+    EXPECT_FALSE(GE::readCookedMesh(m_directory / "missing.gemesh", 42).has_value());
+}
+
+TEST_F(MeshDataTest, rejectsTruncatedCookedMesh)
+{
+    const std::filesystem::path cookedPath = m_directory / "mesh.gemesh";
+    GE::writeCookedMesh(cookedPath, makeMeshData(), 42);
+    std::filesystem::resize_file(cookedPath, std::filesystem::file_size(cookedPath) - 4);
+
+    EXPECT_FALSE(GE::readCookedMesh(cookedPath, 42).has_value());
+}
+
+TEST_F(MeshDataTest, cookedMeshKeyDependsOnContent)
+{
+    const std::string a = "v 0 0 0";
+    const std::string b = "v 0 0 1";
+
+    const GE::MeshCookOptions options;
+
+    EXPECT_EQ(GE::cookedMeshKey(std::as_bytes(std::span(a)), options), GE::cookedMeshKey(std::as_bytes(std::span(a)), options));
+    EXPECT_NE(GE::cookedMeshKey(std::as_bytes(std::span(a)), options), GE::cookedMeshKey(std::as_bytes(std::span(b)), options));
+    EXPECT_NE(GE::cookedMeshKey(std::as_bytes(std::span(a)), options), GE::cookedMeshKey(std::as_bytes(std::span(a)), GE::MeshCookOptions{ .vertexFormat = GE::VertexFormat::full }));
+}
+
+TEST_F(MeshDataTest, loadMeshDataCooksOnFirstLoad)
+{
+    const std::filesystem::path sourcePath = m_directory / "quad.obj";
+    const std::filesystem::path cacheDirectory = m_directory / "cache";
+    std::ofstream(sourcePath) << "o quad\n"
+                                 "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+                                 "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+                                 "vn 0 0 1\n"
+                                 "f 1/1/1 2/2/1 3/3/1\nf 1/1/1 3/3/1 4/4/1\n";
+
+    GE::MeshData cold = GE::loadMeshData(sourcePath, cacheDirectory);
+    ASSERT_EQ(std::ranges::distance(std::filesystem::directory_iterator(cacheDirectory)), 1);
+
+    GE::MeshData warm = GE::loadMeshData(sourcePath, cacheDirectory);
+    ASSERT_EQ(warm.geometries.size(), cold.geometries.size());
+    ASSERT_EQ(warm.nodes.size(), cold.nodes.size());
+    for (size_t i = 0; i < cold.geometries.size(); i++)
+    {
+        EXPECT_EQ(warm.geometries[i].vertexCount(), cold.geometries[i].vertexCount());
+        EXPECT_EQ(warm.geometries[i].indexBytes(), cold.geometries[i].indexBytes());
+    }
+
+    std::ofstream(sourcePath, std::ios::app) << "f 1/1/1 2/2/1 4/4/1\n";
+    GE::MeshData modified = GE::loadMeshData(sourcePath, cacheDirectory);
+    EXPECT_EQ(std::ranges::distance(std::filesystem::directory_iterator(cacheDirectory)), 2);
+}
+
+} // namespace
+
+} // namespace GE_tests
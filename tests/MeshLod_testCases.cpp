@@ -0,0 +1,91 @@
+/*
+ * ---------------------------------------------------
+ * MeshLod_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/MeshLod.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace GE_tests
+{
+
+TEST(MeshLodTest, boundingSphereContainsVertices)
+{
+    std::vector<GE::Vertex> vertices;
+    for (int i = 0; i < 100; i++)
+    {
+        const float t = static_cast<float>(i);
+        vertices.push_back(GE::Vertex{ .pos = { std::sin(t) * 3.0f + 1.0f, std::cos(t * 1.7f) * 2.0f, std::sin(t * 0.3f) - 4.0f } });
+    }
+
+    const GE::BoundingSphere sphere = GE::boundingSphere(vertices);
+    for (const GE::Vertex& vertex : vertices)
+        EXPECT_LE(glm::distance(vertex.pos, sphere.center), sphere.radius * 1.0001f);
+    EXPECT_LT(sphere.radius, 4.5f);
+
+    EXPECT_EQ(GE::boundingSphere({}).radius, 0.0f);
+}
+
+TEST(MeshLodTest, projectionScale)
+{
+    const float fov = glm::radians(60.0f);
+    const glm::mat4x4 projection = glm::perspective(fov, 16.0f / 9.0f, 0.1f, 100.0f);
+    const glm::mat4x4 view = glm::lookAt(glm::vec3(3, 2, 1), glm::vec3(-1, 0, 5), glm::vec3(0, 1, 0));
+    EXPECT_NEAR(GE::projectionScale(projection * view), 1.0f / std::tan(fov / 2.0f), 1e-4f);
+}
+
+TEST(MeshLodTest, projectedSphereRadius)
+{
+    const GE::BoundingSphere sphere = { .center = glm::vec3(0.0f), .radius = 1.0f };
+    const glm::mat4x4 identity(1.0f);
+
+    const float nearRadius = GE::projectedSphereRadius(sphere, identity, glm::vec3(0, 0, 10), 1.0f, 1000.0f);
+    const float farRadius = GE::projectedSphereRadius(sphere, identity, glm::vec3(0, 0, 20), 1.0f, 1000.0f);
+    EXPECT_NEAR(nearRadius, 1.0f / std::sqrt(99.0f) * 500.0f, 1e-3f);
+    EXPECT_NEAR(farRadius / nearRadius, 0.5f, 0.01f);
+
+    // the scale of the model matrix applies to the radius
+    const glm::mat4x4 scaled = glm::scale(glm::mat4x4(1.0f), glm::vec3(2.0f));
+    EXPECT_NEAR(GE::projectedSphereRadius(sphere, scaled, glm::vec3(0, 0, 20), 1.0f, 1000.0f), nearRadius, 1e-3f);
+
+    EXPECT_EQ(GE::projectedSphereRadius(sphere, identity, glm::vec3(0, 0, 0.5f), 1.0f, 1000.0f), std::numeric_limits<float>::infinity());
+}
+
+TEST(MeshLodTest, selectLod)
+{
+    const std::vector<float> errors = { 0.01f, 0.05f, 0.2f };
+
+    // 100 pixels for a radius of 1, one pixel is 0.01 units
+    EXPECT_EQ(GE::selectLod(errors, 1.0f, 100.0f), 1u);
+    EXPECT_EQ(GE::selectLod(errors, 1.0f, 1000.0f), 0u);
+    EXPECT_EQ(GE::selectLod(errors, 1.0f, 10.0f), 2u);
+    EXPECT_EQ(GE::selectLod(errors, 1.0f, 1.0f), 3u);
+    EXPECT_EQ(GE::selectLod(errors, 1.0f, 10.0f, 2.0f), 3u);
+    EXPECT_EQ(GE::selectLod(errors, 1.0f, std::numeric_limits<float>::infinity()), 0u);
+    EXPECT_EQ(GE::selectLod(std::vector<float>(), 1.0f, 1.0f), 0u);
+
+    // coarser levels as the camera moves away
+    const GE::BoundingSphere sphere = { .center = glm::vec3(0.0f), .radius = 1.0f };
+    uint32_t previous = 0;
+    for (float distance = 2.0f; distance < 1000.0f; distance *= 1.5f)
+    {
+        const float projected = GE::projectedSphereRadius(sphere, glm::mat4x4(1.0f), glm::vec3(0, 0, distance), 1.7f, 1080.0f);
+        const uint32_t lod = GE::selectLod(errors, sphere.radius, projected);
+        EXPECT_GE(lod, previous);
+        previous = lod;
+    }
+    EXPECT_EQ(previous, 3u);
+}
+
+} // namespace GE_tests
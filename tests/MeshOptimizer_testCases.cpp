@@ -0,0 +1,320 @@
+/*
+ * ---------------------------------------------------
+ * MeshOptimizer_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/MeshData.hpp"
+#include "Game-Engine/MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cmath>
+#include <filesystem>
+#include <numbers>
+#include <random>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+// grid of (size + 1)^2 vertices with its triangles in random order
+void makeShuffledGrid(uint32_t size, std::vector<GE::Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    vertices.clear();
+    for (uint32_t y = 0; y <= size; y++)
+    {
+        for (uint32_t x = 0; x <= size; x++)
+            vertices.push_back(GE::Vertex{ .pos = { static_cast<float>(x), static_cast<float>(y), 0.0f }, .normal = { 0, 0, 1 } });
+    }
+
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            const uint32_t i = y * (size + 1) + x;
+            triangles.push_back({ i, i + 1, i + size + 1 });
+            triangles.push_back({ i + 1, i + size + 2, i + size + 1 });
+        }
+    }
+    std::ranges::shuffle(triangles, std::mt19937(29));
+
+    indices.clear();
+    for (const auto& triangle : triangles)
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+}
+
+// closed sphere without seams, so every vertex can be collapsed
+void makeSphere(uint32_t slices, uint32_t stacks, std::vector<GE::Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    vertices.clear();
+    indices.clear();
+    vertices.push_back(GE::Vertex{ .pos = { 0, 1, 0 }, .normal = { 0, 1, 0 } });
+    for (uint32_t stack = 1; stack < stacks; stack++)
+    {
+        const float theta = std::numbers::pi_v<float> * static_cast<float>(stack) / static_cast<float>(stacks);
+        for (uint32_t slice = 0; slice < slices; slice++)
+        {
+            const float phi = 2.0f * std::numbers::pi_v<float> * static_cast<float>(slice) / static_cast<float>(slices);
+            const glm::vec3 pos = { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+            vertices.push_back(GE::Vertex{ .pos = pos, .normal = pos });
+        }
+    }
+    vertices.push_back(GE::Vertex{ .pos = { 0, -1, 0 }, .normal = { 0, -1, 0 } });
+
+    const auto ring = [&](uint32_t stack, uint32_t slice) { return 1 + (stack - 1) * slices + slice % slices; };
+    const auto bottom = static_cast<uint32_t>(vertices.size() - 1);
+    for (uint32_t slice = 0; slice < slices; slice++)
+    {
+        indices.insert(indices.end(), { 0, ring(1, slice + 1), ring(1, slice) });
+        for (uint32_t stack = 1; stack + 1 < stacks; stack++)
+        {
+            indices.insert(indices.end(), { ring(stack, slice), ring(stack, slice + 1), ring(stack + 1, slice) });
+            indices.insert(indices.end(), { ring(stack, slice + 1), ring(stack + 1, slice + 1), ring(stack + 1, slice) });
+        }
+        indices.insert(indices.end(), { bottom, ring(stacks - 1, slice), ring(stacks - 1, slice + 1) });
+    }
+}
+
+// triangles rotated so their smallest index comes first, then sorted, to compare triangle sets
+std::vector<std::array<uint32_t, 3>> canonicalTriangles(std::span<const uint32_t> indices, std::span<const GE::Vertex> vertices)
+{
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        // identify the vertices by position so a vertex fetch remap is also covered
+        std::array<uint32_t, 3> triangle;
+        for (uint32_t v = 0; v < 3; v++)
+        {
+            const glm::vec3& pos = vertices[indices[i + v]].pos;
+            triangle[v] = static_cast<uint32_t>(pos.y) * 1000 + static_cast<uint32_t>(pos.x);
+        }
+        std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+        triangles.push_back(triangle);
+    }
+    std::ranges::sort(triangles);
+    return triangles;
+}
+
+} // namespace
+
+TEST(MeshOptimizerTest, analyzeVertexCache)
+{
+    // two triangles sharing an edge, 4 transformed vertices
+    const std::vector<uint32_t> quad = { 0, 1, 2, 2, 1, 3 };
+    GE::VertexCacheStatistics statistics = GE::analyzeVertexCache(quad, 4);
+    EXPECT_EQ(statistics.transformedVertexCount, 4u);
+    EXPECT_FLOAT_EQ(statistics.acmr, 2.0f);
+    EXPECT_FLOAT_EQ(statistics.atvr, 1.0f);
+
+    // with a cache of 3 vertices, vertex 0 is evicted by the time it is reused
+    const std::vector<uint32_t> fan = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+    statistics = GE::analyzeVertexCache(fan, 6, 3);
+    EXPECT_EQ(statistics.transformedVertexCount, 9u);
+    EXPECT_FLOAT_EQ(statistics.atvr, 1.5f);
+
+    EXPECT_EQ(GE::analyzeVertexCache({}, 0).transformedVertexCount, 0u);
+}
+
+TEST(MeshOptimizerTest, optimizeVertexCacheKeepsTriangles)
+{
+    std::vector<GE::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeShuffledGrid(32, vertices, indices);
+
+    std::vector<uint32_t> clusters;
+    const std::vector<uint32_t> optimized = GE::optimizeVertexCache(indices, static_cast<uint32_t>(vertices.size()), &clusters);
+
+    ASSERT_EQ(optimized.size(), indices.size());
+    EXPECT_EQ(canonicalTriangles(optimized, vertices), canonicalTriangles(indices, vertices));
+    ASSERT_FALSE(clusters.empty());
+    EXPECT_EQ(clusters.front(), 0u);
+    EXPECT_TRUE(std::ranges::is_sorted(clusters));
+    EXPECT_LT(clusters.back(), optimized.size() / 3);
+}
+
+TEST(MeshOptimizerTest, optimizeVertexCacheLowersAcmr)
+{
+    std::vector<GE::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeShuffledGrid(32, vertices, indices);
+    const auto vertexCount = static_cast<uint32_t>(vertices.size());
+
+    const GE::VertexCacheStatistics before = GE::analyzeVertexCache(indices, vertexCount);
+    const GE::VertexCacheStatistics after = GE::analyzeVertexCache(GE::optimizeVertexCache(indices, vertexCount), vertexCount);
+
+    EXPECT_GT(before.acmr, 2.0f);
+    EXPECT_LT(after.acmr, 0.8f);
+    EXPECT_LT(after.atvr, 1.5f);
+}
+
+TEST(MeshOptimizerTest, optimizeOverdrawKeepsTriangles)
+{
+    std::vector<GE::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeShuffledGrid(32, vertices, indices);
+    const auto vertexCount = static_cast<uint32_t>(vertices.size());
+
+    std::vector<uint32_t> clusters;
+    const std::vector<uint32_t> cacheOptimized = GE::optimizeVertexCache(indices, vertexCount, &clusters);
+    const std::vector<uint32_t> optimized = GE::optimizeOverdraw(cacheOptimized, vertices, clusters, 1.05f);
+
+    ASSERT_EQ(optimized.size(), indices.size());
+    EXPECT_EQ(canonicalTriangles(optimized, vertices), canonicalTriangles(indices, vertices));
+    EXPECT_LE(GE::analyzeVertexCache(optimized, vertexCount).acmr, GE::analyzeVertexCache(cacheOptimized, vertexCount).acmr * 1.2f);
+}
+
+TEST(MeshOptimizerTest, optimizeVertexFetch)
+{
+    std::vector<GE::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeShuffledGrid(8, vertices, indices);
+    vertices.push_back(GE::Vertex{ .pos = { 500, 500, 0 } }); // unused
+
+    const std::vector<uint32_t> original = indices;
+    const std::vector<GE::Vertex> optimized = GE::optimizeVertexFetch(vertices, indices);
+
+    EXPECT_EQ(optimized.size(), vertices.size() - 1);
+    EXPECT_EQ(canonicalTriangles(indices, optimized), canonicalTriangles(original, vertices));
+
+    // vertices are in first use order
+    uint32_t next = 0;
+    for (uint32_t index : indices)
+    {
+        ASSERT_LE(index, next);
+        if (index == next)
+            next++;
+    }
+}
+
+TEST(MeshOptimizerTest, simplifyPlanarGrid)
+{
+    std::vector<GE::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeShuffledGrid(16, vertices, indices);
+
+    float error = -1.0f;
+    const std::vector<uint32_t> simplified = GE::simplifyMesh(indices, vertices, indices.size() / 4, 0.01f, &error);
+
+    // a flat surface can be simplified without error, down to the vertices of the locked border
+    EXPECT_LE(simplified.size(), indices.size() / 4);
+    EXPECT_GT(simplified.size(), 0u);
+    EXPECT_NEAR(error, 0.0f, 1e-5f);
+    for (size_t i = 0; i < simplified.size(); i += 3)
+    {
+        const glm::vec3& p0 = vertices[simplified[i + 0]].pos;
+        const glm::vec3& p1 = vertices[simplified[i + 1]].pos;
+        const glm::vec3& p2 = vertices[simplified[i + 2]].pos;
+        EXPECT_GT(glm::cross(p1 - p0, p2 - p0).z, 0.0f); // no flipped or degenerate triangle
+    }
+
+    // the border is kept
+    std::vector<bool> used(vertices.size(), false);
+    for (uint32_t index : simplified)
+        used[index] = true;
+    for (uint32_t i = 0; i < vertices.size(); i++)
+    {
+        const glm::vec3& pos = vertices[i].pos;
+        if (pos.x == 0.0f || pos.y == 0.0f || pos.x == 16.0f || pos.y == 16.0f)
+        {
+            EXPECT_TRUE(used[i]);
+        }
+    }
+}
+
+TEST(MeshOptimizerTest, simplifySphereWithinError)
+{
+    std::vector<GE::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeSphere(32, 16, vertices, indices);
+
+    // stops on the error before reaching the requested triangle count
+    float error = 0.0f;
+    const std::vector<uint32_t> coarse = GE::simplifyMesh(indices, vertices, 0, 0.1f, &error);
+    EXPECT_LT(coarse.size(), indices.size() / 2);
+    EXPECT_GT(coarse.size(), 0u);
+    EXPECT_LE(error, 0.1f);
+
+    // the simplified surface stays within the error of the sphere, checked at the triangle centers
+    for (size_t i = 0; i < coarse.size(); i += 3)
+    {
+        const glm::vec3 center = (vertices[coarse[i]].pos + vertices[coarse[i + 1]].pos + vertices[coarse[i + 2]].pos) / 3.0f;
+        EXPECT_LT(1.0f - glm::length(center), 0.15f);
+    }
+
+    // a smaller error keeps more triangles
+    const std::vector<uint32_t> fine = GE::simplifyMesh(indices, vertices, 0, 0.01f);
+    EXPECT_GT(fine.size(), coarse.size());
+
+    // the target count is reached when the error allows it
+    const std::vector<uint32_t> half = GE::simplifyMesh(indices, vertices, indices.size() / 2, 1.0f);
+    EXPECT_LE(half.size(), indices.size() / 2);
+    EXPECT_GE(half.size(), indices.size() / 2 - 12);
+}
+
+TEST(MeshOptimizerTest, cookMeshGeneratesLods)
+{
+    std::vector<GE::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeSphere(64, 32, vertices, indices);
+
+    GE::MeshData meshData = { .name = "sphere" };
+    meshData.geometries.push_back({ .name = "sphere", .vertices = std::span<const GE::Vertex>(vertices), .indices = std::span<const uint32_t>(indices) });
+    const GE::MeshData cooked = GE::cookMesh(meshData, GE::MeshCookOptions{ .vertexFormat = GE::VertexFormat::full, .lodCount = 3, .lodReduction = 0.5f, .lodMaxError = 0.1f });
+
+    const GE::MeshData::Geometry& geometry = cooked.geometries[0];
+    EXPECT_NEAR(geometry.boundingSphere.radius, 1.0f, 0.05f);
+    ASSERT_FALSE(geometry.lods.empty());
+    size_t previousCount = geometry.indexCount();
+    float previousError = 0.0f;
+    for (const GE::MeshData::Lod& lod : geometry.lods)
+    {
+        const std::span<const uint32_t> lodIndices = lod.indices;
+        EXPECT_LT(lodIndices.size(), previousCount);
+        EXPECT_GE(lod.error, previousError);
+        EXPECT_LE(lod.error, 0.1f * geometry.boundingSphere.radius);
+        EXPECT_TRUE(std::ranges::all_of(lodIndices, [&](uint32_t i) { return i < geometry.vertexCount(); }));
+        previousCount = lodIndices.size();
+        previousError = lod.error;
+    }
+    EXPECT_LE(geometry.lods[0].indices.size(), indices.size() / 2);
+
+    const GE::MeshData withoutLods = GE::cookMesh(meshData, GE::MeshCookOptions{ .lodCount = 0 });
+    EXPECT_TRUE(withoutLods.geometries[0].lods.empty());
+}
+
+TEST(MeshOptimizerTest, cookedResourceMesh)
+{
+    const GE::MeshData imported = GE::importMesh(std::filesystem::path(GE_TEST_RESOURCE_DIR) / "shuffled_sphere.obj");
+    ASSERT_EQ(imported.geometries.size(), 1u);
+
+    const GE::MeshCookOptions options = { .vertexFormat = GE::VertexFormat::full };
+    GE::MeshCookOptions unoptimizedOptions = options;
+    unoptimizedOptions.optimize = false;
+
+    const GE::MeshData unoptimized = GE::cookMesh(imported, unoptimizedOptions);
+    const GE::MeshData optimized = GE::cookMesh(imported, options);
+
+    const auto unoptimizedIndices = unoptimized.geometries[0].indices;
+    const auto optimizedIndices = optimized.geometries[0].indices;
+    ASSERT_EQ(optimizedIndices.size(), unoptimizedIndices.size());
+
+    const auto vertexCount = static_cast<uint32_t>(unoptimized.geometries[0].vertexCount());
+    const GE::VertexCacheStatistics before = GE::analyzeVertexCache(unoptimizedIndices, vertexCount);
+    const GE::VertexCacheStatistics after = GE::analyzeVertexCache(optimizedIndices, static_cast<uint32_t>(optimized.geometries[0].vertexCount()));
+    EXPECT_LT(after.acmr, before.acmr * 0.5f);
+    EXPECT_LT(after.atvr, before.atvr);
+}
+
+} // namespace GE_tests
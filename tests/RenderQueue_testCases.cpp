@@ -0,0 +1,105 @@
+/*
+ * ---------------------------------------------------
+ * RenderQueue_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/RenderQueue.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+TEST(RenderQueueTest, sortKeyFieldsOrder)
+{
+    // each field wins over all the less significant ones
+    EXPECT_LT(GE::makeSortKey(0, 65535, 0xFFFFFF, 1e30f), GE::makeSortKey(1, 0, 0, 0.0f));
+    EXPECT_LT(GE::makeSortKey(0, 0, 0xFFFFFF, 1e30f), GE::makeSortKey(0, 1, 0, 0.0f));
+    EXPECT_LT(GE::makeSortKey(0, 0, 0, 1e30f), GE::makeSortKey(0, 0, 1, 0.0f));
+
+    // front to back, the precision is relative to the depth
+    EXPECT_LT(GE::makeSortKey(0, 0, 0, 1.0f), GE::makeSortKey(0, 0, 0, 1.1f));
+    EXPECT_LT(GE::makeSortKey(0, 0, 0, 100.0f), GE::makeSortKey(0, 0, 0, 101.0f));
+    EXPECT_EQ(GE::makeSortKey(0, 0, 0, -5.0f), GE::makeSortKey(0, 0, 0, 0.0f));
+
+    EXPECT_EQ(GE::sortKeyBatch(GE::makeSortKey(3, 4, 5, 1.0f)), GE::sortKeyBatch(GE::makeSortKey(3, 4, 5, 50.0f)));
+    EXPECT_NE(GE::sortKeyBatch(GE::makeSortKey(3, 4, 5, 1.0f)), GE::sortKeyBatch(GE::makeSortKey(3, 4, 6, 1.0f)));
+}
+
+TEST(RenderQueueTest, radixSortMatchesStableSort)
+{
+    std::mt19937_64 random(1);
+    GE::RenderQueue queue;
+    std::vector<GE::RenderQueue::Item> expected;
+    for (int frame = 0; frame < 3; frame++)
+    {
+        queue.clear();
+        expected.clear();
+        // few distinct values in the high bytes, like the pipelines and materials of a frame
+        for (uint32_t i = 0; i < 5000; i++)
+        {
+            const uint64_t key = (frame == 2 ? random() : (random() & 0x0300'0000'FFFF'FFFF));
+            queue.push(key, i);
+            expected.push_back({ .sortKey = key, .draw = i });
+        }
+        queue.push(expected.front().sortKey, 5000); // a duplicated key, keeps the push order
+        expected.push_back({ .sortKey = expected.front().sortKey, .draw = 5000 });
+
+        queue.sort();
+        std::ranges::stable_sort(expected, {}, &GE::RenderQueue::Item::sortKey);
+        ASSERT_EQ(queue.size(), expected.size());
+        for (uint32_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_EQ(queue.items()[i].sortKey, expected[i].sortKey);
+            EXPECT_EQ(queue.items()[i].draw, expected[i].draw);
+        }
+    }
+}
+
+TEST(RenderQueueTest, batchesGroupTheSameGeometry)
+{
+    GE::RenderQueue queue;
+    queue.sort();
+    EXPECT_TRUE(queue.batches().empty());
+
+    // draw index -> pipeline, geometry, depth
+    queue.push(GE::makeSortKey(1, 0, 7, 30.0f), 0);
+    queue.push(GE::makeSortKey(0, 0, 7, 10.0f), 1);
+    queue.push(GE::makeSortKey(1, 0, 7, 5.0f), 2);
+    queue.push(GE::makeSortKey(0, 0, 2, 50.0f), 3);
+    queue.push(GE::makeSortKey(1, 0, 7, 20.0f), 4);
+    queue.push(GE::makeSortKey(0, 0, 7, 1.0f), 5);
+    queue.sort();
+
+    std::vector<uint32_t> draws;
+    for (const GE::RenderQueue::Item& item : queue.items())
+        draws.push_back(item.draw);
+    EXPECT_EQ(draws, (std::vector<uint32_t>{ 3, 5, 1, 2, 4, 0 }));
+
+    ASSERT_EQ(queue.batches().size(), 3u);
+    EXPECT_EQ(queue.batches()[0].firstItem, 0u);
+    EXPECT_EQ(queue.batches()[0].itemCount, 1u);
+    EXPECT_EQ(queue.batches()[1].firstItem, 1u);
+    EXPECT_EQ(queue.batches()[1].itemCount, 2u);
+    EXPECT_EQ(queue.batches()[2].firstItem, 3u);
+    EXPECT_EQ(queue.batches()[2].itemCount, 3u);
+
+    queue.clear();
+    EXPECT_EQ(queue.size(), 0u);
+    EXPECT_TRUE(queue.batches().empty());
+}
+
+} // namespace
+
+} // namespace GE_tests
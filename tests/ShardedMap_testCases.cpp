@@ -0,0 +1,75 @@
+/*
+ * ---------------------------------------------------
+ * ShardedMap_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/ShardedMap.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+TEST(ShardedMapTest, findsTheInsertedValues)
+{
+    GE::ShardedMap<std::string, int> map;
+    EXPECT_EQ(map.find("a"), nullptr);
+
+    auto [value, inserted] = map.tryEmplace("a", 1);
+    ASSERT_TRUE(inserted);
+    EXPECT_EQ(*value, 1);
+
+    auto [sameValue, insertedAgain] = map.tryEmplace("a", 2);
+    EXPECT_FALSE(insertedAgain);
+    EXPECT_EQ(sameValue, value);
+    EXPECT_EQ(*map.find("a"), 1);
+    EXPECT_TRUE(map.contains("a"));
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(ShardedMapTest, concurrentInsertionsOfTheSameKeysInsertEachOnce)
+{
+    constexpr int THREAD_COUNT = 8;
+    constexpr int KEY_COUNT = 2000;
+    GE::ShardedMap<int, int> map;
+    std::atomic<int> insertionCount = 0;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; t++)
+    {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < KEY_COUNT; i++)
+            {
+                const int key = (i * 7 + t * 13) % KEY_COUNT;
+                auto [value, inserted] = map.tryEmplace(key, key * 2);
+                if (inserted)
+                    insertionCount++;
+                EXPECT_EQ(*value, key * 2);
+                EXPECT_EQ(map.find(key), value); // the values are never moved
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(insertionCount.load(), KEY_COUNT);
+    EXPECT_EQ(map.size(), static_cast<size_t>(KEY_COUNT));
+    int sum = 0;
+    map.forEach([&](int key, int value) { sum += value - key; });
+    EXPECT_EQ(sum, KEY_COUNT * (KEY_COUNT - 1) / 2);
+}
+
+} // namespace
+
+} // namespace GE_tests
@@ -0,0 +1,159 @@
+/*
+ * ---------------------------------------------------
+ * TextureCompression_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/TextureCompression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+// smooth gradients with a bit of deterministic noise, like a photographic texture
+std::vector<std::byte> makeImage(uint32_t width, uint32_t height)
+{
+    std::vector<std::byte> pixels(static_cast<size_t>(width) * height * 4);
+    uint32_t seed = 12345;
+    for (uint32_t y = 0; y < height; y++)
+    {
+        for (uint32_t x = 0; x < width; x++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const int noise = static_cast<int>(seed >> 29) - 4;
+            std::byte* pixel = pixels.data() + (static_cast<size_t>(y) * width + x) * 4;
+            pixel[0] = static_cast<std::byte>(std::clamp(static_cast<int>(x * 255 / width) + noise, 0, 255));
+            pixel[1] = static_cast<std::byte>(std::clamp(static_cast<int>(y * 255 / height) + noise, 0, 255));
+            pixel[2] = static_cast<std::byte>(std::clamp(static_cast<int>(128 + 100 * std::sin(x * 0.2f)) + noise, 0, 255));
+            pixel[3] = static_cast<std::byte>((x + y) * 255 / (width + height));
+        }
+    }
+    return pixels;
+}
+
+double channelRmse(const std::vector<std::byte>& lhs, const std::vector<std::byte>& rhs, int channel)
+{
+    double sum = 0.0;
+    for (size_t i = channel; i < lhs.size(); i += 4)
+    {
+        const double difference = static_cast<double>(lhs[i]) - static_cast<double>(rhs[i]);
+        sum += difference * difference;
+    }
+    return std::sqrt(sum / static_cast<double>(lhs.size() / 4));
+}
+
+TEST(TextureCompressionTest, byteSizes)
+{
+    EXPECT_EQ(GE::textureByteSize(GE::TextureFormat::rgba8, 13, 7), 13 * 7 * 4);
+    EXPECT_EQ(GE::textureByteSize(GE::TextureFormat::bc1, 13, 7), 4 * 2 * 8);
+    EXPECT_EQ(GE::textureByteSize(GE::TextureFormat::bc3, 1, 1), 16);
+    EXPECT_EQ(GE::textureByteSize(GE::TextureFormat::bc7, 64, 64), 16 * 16 * 16);
+}
+
+TEST(TextureCompressionTest, roundTripErrors)
+{
+    constexpr uint32_t width = 64;
+    constexpr uint32_t height = 64;
+    const std::vector<std::byte> pixels = makeImage(width, height);
+
+    struct Case
+    {
+        GE::TextureFormat format;
+        std::vector<int> channels;
+        double maxRmse;
+    };
+    const std::vector<Case> cases = {
+        { GE::TextureFormat::rgba8, { 0, 1, 2, 3 }, 0.0 },
+        { GE::TextureFormat::bc1, { 0, 1, 2 }, 6.0 },
+        { GE::TextureFormat::bc3, { 0, 1, 2, 3 }, 6.0 },
+        { GE::TextureFormat::bc5, { 0, 1 }, 2.0 },
+        { GE::TextureFormat::bc7, { 0, 1, 2, 3 }, 6.0 },
+    };
+    for (const Case& testCase : cases)
+    {
+        const std::vector<std::byte> encoded = GE::encodeTexture(testCase.format, pixels, width, height);
+        ASSERT_EQ(encoded.size(), GE::textureByteSize(testCase.format, width, height));
+        const std::vector<std::byte> decoded = GE::decodeTexture(testCase.format, encoded, width, height);
+        ASSERT_EQ(decoded.size(), pixels.size());
+        for (int channel : testCase.channels)
+            EXPECT_LE(channelRmse(pixels, decoded, channel), testCase.maxRmse) << "format " << static_cast<int>(testCase.format) << " channel " << channel;
+    }
+}
+
+TEST(TextureCompressionTest, solidBlocks)
+{
+    std::vector<std::byte> pixels(8 * 8 * 4);
+    for (size_t i = 0; i < pixels.size(); i += 4)
+    {
+        pixels[i + 0] = std::byte{ 255 };
+        pixels[i + 1] = std::byte{ 0 };
+        pixels[i + 2] = std::byte{ 255 };
+        pixels[i + 3] = std::byte{ 255 };
+    }
+    // representable exactly in 565
+    for (GE::TextureFormat format : { GE::TextureFormat::bc1, GE::TextureFormat::bc3 })
+        EXPECT_EQ(GE::decodeTexture(format, GE::encodeTexture(format, pixels, 8, 8), 8, 8), pixels) << static_cast<int>(format);
+
+    // the lowest bit of a BC7 mode 6 endpoint is shared by its channels
+    const std::vector<std::byte> decoded = GE::decodeTexture(GE::TextureFormat::bc7, GE::encodeTexture(GE::TextureFormat::bc7, pixels, 8, 8), 8, 8);
+    for (size_t i = 0; i < pixels.size(); i++)
+        EXPECT_LE(std::abs(static_cast<int>(decoded[i]) - static_cast<int>(pixels[i])), 1);
+}
+
+TEST(TextureCompressionTest, partialBlocksRepeatTheEdges)
+{
+    constexpr uint32_t width = 13;
+    constexpr uint32_t height = 7;
+    constexpr uint32_t paddedWidth = 16;
+    constexpr uint32_t paddedHeight = 8;
+    const std::vector<std::byte> pixels = makeImage(width, height);
+
+    std::vector<std::byte> padded(static_cast<size_t>(paddedWidth) * paddedHeight * 4);
+    for (uint32_t y = 0; y < paddedHeight; y++)
+    {
+        for (uint32_t x = 0; x < paddedWidth; x++)
+        {
+            const size_t source = (static_cast<size_t>(std::min(y, height - 1)) * width + std::min(x, width - 1)) * 4;
+            std::copy_n(pixels.begin() + static_cast<std::ptrdiff_t>(source), 4, padded.begin() + static_cast<std::ptrdiff_t>((static_cast<size_t>(y) * paddedWidth + x) * 4));
+        }
+    }
+
+    for (GE::TextureFormat format : { GE::TextureFormat::bc1, GE::TextureFormat::bc3, GE::TextureFormat::bc5, GE::TextureFormat::bc7 })
+    {
+        EXPECT_EQ(GE::encodeTexture(format, pixels, width, height), GE::encodeTexture(format, padded, paddedWidth, paddedHeight)) << static_cast<int>(format);
+
+        const std::vector<std::byte> decoded = GE::decodeTexture(format, GE::encodeTexture(format, pixels, width, height), width, height);
+        const std::vector<std::byte> decodedPadded = GE::decodeTexture(format, GE::encodeTexture(format, padded, paddedWidth, paddedHeight), paddedWidth, paddedHeight);
+        ASSERT_EQ(decoded.size(), pixels.size());
+        for (uint32_t y = 0; y < height; y++)
+        {
+            EXPECT_TRUE(std::equal(decoded.begin() + static_cast<std::ptrdiff_t>(y * width * 4), decoded.begin() + static_cast<std::ptrdiff_t>((y + 1) * width * 4),
+                                   decodedPadded.begin() + static_cast<std::ptrdiff_t>(y * paddedWidth * 4)));
+        }
+    }
+}
+
+TEST(TextureCompressionTest, unsupportedBc7ModeThrows)
+{
+    std::vector<std::byte> block(16, std::byte{ 0 });
+    block[0] = std::byte{ 1 }; // mode 0
+    EXPECT_THROW(GE::decodeTexture(GE::TextureFormat::bc7, block, 4, 4), std::runtime_error);
+}
+
+} // namespace
+
+} // namespace GE_tests
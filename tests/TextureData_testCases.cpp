@@ -0,0 +1,197 @@
+/*
+ * ---------------------------------------------------
+ * TextureData_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "Game-Engine/TextureData.hpp"
+
+#include <Graphics/Texture.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+class TextureDataTest : public ::testing::Test
+{
+protected:
+    TextureDataTest()
+        : m_directory(std::filesystem::temp_directory_path() / ("GE_TextureDataTest_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name())))
+    {
+        std::filesystem::remove_all(m_directory);
+        std::filesystem::create_directories(m_directory);
+    }
+
+    ~TextureDataTest() override
+    {
+        std::error_code error;
+        std::filesystem::remove_all(m_directory, error);
+    }
+
+    static GE::TextureData makeTextureData(uint32_t width, uint32_t height)
+    {
+        auto pixels = std::make_shared<std::vector<std::byte>>(static_cast<size_t>(width) * height * 4);
+        for (size_t i = 0; i < pixels->size(); i++)
+            (*pixels)[i] = static_cast<std::byte>(i * 7 % 256);
+        return GE::TextureData{
+            .format = GE::TextureFormat::rgba8,
+            .mips = { { .width = width, .height = height, .bytes = *pixels } },
+            .storage = pixels
+        };
+    }
+
+    std::filesystem::path m_directory;
+};
+
+std::filesystem::path dummyTexturePath()
+{
+    return std::filesystem::path(GE_TEST_RESOURCE_DIR) / "dummy_texture.png";
+}
+
+TEST(TextureDataMipTest, mipLevelCount)
+{
+    EXPECT_EQ(GE::mipLevelCount(1, 1), 1u);
+    EXPECT_EQ(GE::mipLevelCount(256, 256), 9u);
+    EXPECT_EQ(GE::mipLevelCount(13, 7), 4u);
+    EXPECT_EQ(GE::mipLevelCount(1, 1024), 11u);
+}
+
+TEST(TextureDataMipTest, downsampleFiltersInLinearSpace)
+{
+    const std::vector<std::byte> pixels = {
+        std::byte{ 0 }, std::byte{ 0 }, std::byte{ 0 }, std::byte{ 0 },
+        std::byte{ 255 }, std::byte{ 255 }, std::byte{ 255 }, std::byte{ 255 },
+    };
+
+    const std::vector<std::byte> linear = GE::downsampleImage(pixels, 2, 1, false);
+    ASSERT_EQ(linear.size(), 4u);
+    EXPECT_EQ(linear[0], std::byte{ 128 });
+    EXPECT_EQ(linear[3], std::byte{ 128 });
+
+    // half the light of a white pixel is not the middle of the sRGB range, alpha is always linear
+    const std::vector<std::byte> srgb = GE::downsampleImage(pixels, 2, 1, true);
+    ASSERT_EQ(srgb.size(), 4u);
+    EXPECT_EQ(srgb[0], std::byte{ 188 });
+    EXPECT_EQ(srgb[3], std::byte{ 128 });
+}
+
+TEST(TextureDataMipTest, downsampleOddSizesKeepsTheLastColumn)
+{
+    std::vector<std::byte> pixels(3 * 1 * 4, std::byte{ 0 });
+    pixels[8] = std::byte{ 255 }; // red channel of the last pixel
+    const std::vector<std::byte> downsampled = GE::downsampleImage(pixels, 3, 1, false);
+    ASSERT_EQ(downsampled.size(), 4u);
+    EXPECT_EQ(downsampled[0], std::byte{ 85 });
+}
+
+TEST_F(TextureDataTest, cookGeneratesTheMipChain)
+{
+    const GE::TextureData cooked = GE::cookTexture(makeTextureData(13, 7), { .format = GE::TextureFormat::bc1 });
+    EXPECT_EQ(cooked.format, GE::TextureFormat::bc1);
+    ASSERT_EQ(cooked.mips.size(), 4u);
+
+    const std::vector<std::pair<uint32_t, uint32_t>> expectedSizes = { { 13, 7 }, { 6, 3 }, { 3, 1 }, { 1, 1 } };
+    for (size_t i = 0; i < cooked.mips.size(); i++)
+    {
+        EXPECT_EQ(cooked.mips[i].width, expectedSizes[i].first);
+        EXPECT_EQ(cooked.mips[i].height, expectedSizes[i].second);
+        EXPECT_EQ(cooked.mips[i].bytes.size(), GE::textureByteSize(GE::TextureFormat::bc1, expectedSizes[i].first, expectedSizes[i].second));
+    }
+
+    EXPECT_EQ(GE::cookTexture(makeTextureData(13, 7), { .mipmaps = false }).mips.size(), 1u);
+    EXPECT_THROW(GE::cookTexture(cooked, {}), std::runtime_error);
+}
+
+// the default cook keeps the pixels, they are uploaded without a lossy block compression round trip
+TEST_F(TextureDataTest, defaultCookIsAnUncompressedMipChain)
+{
+    const GE::TextureData source = makeTextureData(16, 8);
+    const GE::TextureData cooked = GE::cookTexture(source, GE::TextureCookOptions{});
+    EXPECT_EQ(cooked.format, GE::TextureFormat::rgba8);
+    ASSERT_EQ(cooked.mips.size(), GE::mipLevelCount(16, 8));
+    EXPECT_TRUE(std::ranges::equal(cooked.mips.front().bytes, source.mips.front().bytes));
+    for (size_t i = 0; i < cooked.mips.size(); i++)
+        EXPECT_EQ(GE::decodeMip(cooked, i).size(), static_cast<size_t>(cooked.mips[i].width) * cooked.mips[i].height * 4);
+}
+
+TEST_F(TextureDataTest, cookedTextureRoundTrip)
+{
+    const GE::TextureData cooked = GE::cookTexture(makeTextureData(32, 16), { .format = GE::TextureFormat::bc7 });
+    const std::filesystem::path path = m_directory / "texture.getex";
+    GE::writeCookedTexture(path, cooked, 42);
+
+    std::optional<GE::TextureData> read = GE::readCookedTexture(path, 42);
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ(read->format, GE::TextureFormat::bc7);
+    ASSERT_EQ(read->mips.size(), cooked.mips.size());
+    for (size_t i = 0; i < cooked.mips.size(); i++)
+    {
+        EXPECT_EQ(read->mips[i].width, cooked.mips[i].width);
+        EXPECT_EQ(read->mips[i].height, cooked.mips[i].height);
+        EXPECT_TRUE(std::ranges::equal(read->mips[i].bytes, cooked.mips[i].bytes));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(read->mips[i].bytes.data()) % 16, 0u);
+    }
+
+    EXPECT_FALSE(GE::readCookedTexture(path, 43).has_value());
+    EXPECT_FALSE(GE::readCookedTexture(m_directory / "missing.getex", 42).has_value());
+
+    // truncated file
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_FALSE(GE::readCookedTexture(path, 42).has_value());
+}
+
+TEST_F(TextureDataTest, cookedTextureKey)
+{
+    const std::vector<std::byte> content = { std::byte{ 1 }, std::byte{ 2 }, std::byte{ 3 } };
+    const uint64_t key = GE::cookedTextureKey(content, {});
+    EXPECT_EQ(GE::cookedTextureKey(content, {}), key);
+    EXPECT_NE(GE::cookedTextureKey(content, { .format = GE::TextureFormat::bc1 }), key);
+    EXPECT_NE(GE::cookedTextureKey(content, { .mipmaps = false }), key);
+    EXPECT_NE(GE::cookedTextureKey(content, { .srgb = false }), key);
+    EXPECT_NE(GE::cookedTextureKey(std::span(content).first(2), {}), key);
+}
+
+TEST_F(TextureDataTest, loadTextureDataUsesTheCache)
+{
+    const std::filesystem::path source = m_directory / "texture.png";
+    std::filesystem::copy_file(dummyTexturePath(), source);
+    const std::filesystem::path cacheDirectory = m_directory / "cache";
+    const GE::TextureCookOptions options = { .format = GE::TextureFormat::bc3 };
+
+    const GE::TextureData cooked = GE::loadTextureData(source, cacheDirectory, options);
+    ASSERT_FALSE(cooked.mips.empty());
+    ASSERT_EQ(std::ranges::distance(std::filesystem::directory_iterator(cacheDirectory)), 1);
+
+    const GE::TextureData cached = GE::loadTextureData(source, cacheDirectory, options);
+    ASSERT_EQ(cached.mips.size(), cooked.mips.size());
+    EXPECT_TRUE(std::ranges::equal(cached.mips.front().bytes, cooked.mips.front().bytes));
+
+    // a modified source is cooked again under an other key
+    std::ofstream(source, std::ios::app) << "modified";
+    GE::loadTextureData(source, cacheDirectory, options);
+    EXPECT_EQ(std::ranges::distance(std::filesystem::directory_iterator(cacheDirectory)), 2);
+}
+
+} // namespace
+
+} // namespace GE_tests
@@ -0,0 +1,91 @@
+/*
+ * ---------------------------------------------------
+ * UploadArena_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "GraphicsMocks.hpp"
+
+#include "Game-Engine/UploadArena.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+class UploadArenaTest : public ::testing::Test
+{
+protected:
+    UploadArenaTest()
+    {
+        ON_CALL(m_device, newBuffer(testing::_)).WillByDefault([](const gfx::Buffer::Descriptor& desc) {
+            return std::make_unique<MockBuffer>(desc);
+        });
+    }
+
+    testing::NiceMock<MockDevice> m_device;
+};
+
+TEST_F(UploadArenaTest, allocationsAreAlignedRanges)
+{
+    EXPECT_CALL(m_device, newBuffer(testing::_)).Times(1);
+    GE::UploadArena arena(&m_device, gfx::BufferUsage::structuredBuffer, 4096);
+    EXPECT_EQ(arena.buffer(), nullptr);
+
+    const GE::UploadArena::Allocation first = arena.allocate(10);
+    const GE::UploadArena::Allocation second = arena.allocate(48, 48); // the size of an element
+    const GE::UploadArena::Allocation third = arena.allocate(100);
+
+    EXPECT_EQ(first.offset, 0u);
+    EXPECT_EQ(second.offset % 48, 0u);
+    EXPECT_EQ(second.offset % GE::UploadArena::MIN_ALIGNMENT, 0u);
+    EXPECT_GE(second.offset, 10u);
+    EXPECT_GE(third.offset, second.offset + 48);
+    EXPECT_EQ(third.data, arena.buffer()->content<std::byte>() + third.offset);
+    EXPECT_EQ(first.buffer, arena.buffer());
+    EXPECT_EQ(arena.usedBytes(), third.offset + 100);
+    EXPECT_EQ(arena.buffer()->storageMode(), gfx::ResourceStorageMode::hostVisible);
+}
+
+TEST_F(UploadArenaTest, growingKeepsTheContent)
+{
+    EXPECT_CALL(m_device, newBuffer(testing::_)).Times(2);
+    GE::UploadArena arena(&m_device, gfx::BufferUsage::structuredBuffer, 1024);
+
+    const GE::UploadArena::Allocation first = arena.allocate(600);
+    std::memset(first.data, 0xAB, 600);
+    const GE::UploadArena::Allocation second = arena.allocate(600);
+    std::memset(second.data, 0xCD, 600);
+
+    // the first allocation keeps its buffer, the new one holds both
+    EXPECT_NE(first.buffer, second.buffer);
+    EXPECT_EQ(second.buffer, arena.buffer());
+    EXPECT_GE(arena.buffer()->size(), 2048u);
+    EXPECT_EQ(first.buffer->content<std::byte>()[599], std::byte{ 0xAB });
+    EXPECT_EQ(arena.buffer()->content<std::byte>()[first.offset + 599], std::byte{ 0xAB });
+    EXPECT_EQ(arena.buffer()->content<std::byte>()[second.offset], std::byte{ 0xCD });
+
+    // the next frames fit in the grown buffer
+    for (int frame = 0; frame < 3; frame++)
+    {
+        arena.reset();
+        EXPECT_EQ(arena.usedBytes(), 0u);
+        EXPECT_EQ(arena.allocate(600).offset, 0u);
+        EXPECT_EQ(arena.allocate(600).buffer, second.buffer);
+    }
+}
+
+} // namespace
+
+} // namespace GE_tests
@@ -0,0 +1,152 @@
+/*
+ * ---------------------------------------------------
+ * VertexFormat_testCases.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include "Game-Engine/VertexFormat.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace GE_tests
+{
+
+namespace
+{
+
+std::vector<glm::vec3> sphereDirections()
+{
+    std::vector<glm::vec3> directions;
+    for (int i = 0; i <= 64; i++)
+    {
+        const float theta = static_cast<float>(i) / 64.0f * 3.14159265f;
+        for (int j = 0; j < 128; j++)
+        {
+            const float phi = static_cast<float>(j) / 128.0f * 2.0f * 3.14159265f;
+            directions.push_back(glm::vec3(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta)));
+        }
+    }
+    return directions;
+}
+
+TEST(VertexFormatTest, octahedralRoundTripPrecision)
+{
+    float maxAngle = 0.0f;
+    for (const glm::vec3& direction : sphereDirections())
+    {
+        const glm::vec3 decoded = GE::unpackOctahedral(GE::packOctahedral(direction));
+        EXPECT_NEAR(glm::length(decoded), 1.0f, 1e-5f);
+        maxAngle = std::max(maxAngle, std::atan2(glm::length(glm::cross(decoded, direction)), glm::dot(decoded, direction)));
+    }
+    // 16 bits octahedral stays well under a hundredth of a degree
+    EXPECT_LT(maxAngle, 0.01f * 3.14159265f / 180.0f);
+}
+
+TEST(VertexFormatTest, octahedral24RoundTripPrecision)
+{
+    float maxAngle = 0.0f;
+    for (const glm::vec3& direction : sphereDirections())
+    {
+        const uint32_t packed = GE::packOctahedral24(direction);
+        EXPECT_EQ(packed >> 24, 0u);
+        const glm::vec3 decoded = GE::unpackOctahedral24(packed);
+        EXPECT_NEAR(glm::length(decoded), 1.0f, 1e-5f);
+        maxAngle = std::max(maxAngle, std::atan2(glm::length(glm::cross(decoded, direction)), glm::dot(decoded, direction)));
+    }
+    // 24 bits octahedral stays under a tenth of a degree
+    EXPECT_LT(maxAngle, 0.1f * 3.14159265f / 180.0f);
+}
+
+// the words read through the float3 attribute must be normal floats for the 16 bits values which would
+// make a denormal (0) or a NaN (0x7F80 and above) when they are the high half of a word
+TEST(VertexFormatTest, packedWordsAreNormalFloats)
+{
+    const GE::PositionQuantization quantization = { .scale = glm::vec3(1.0f), .offset = glm::vec3(0.0f) };
+    std::vector<uint32_t> values = { 0, 1, 0x7F7F, 0xFFFF };
+    for (uint32_t value = 0x7F80; value <= 0xFFFF; value += 0x3F)
+        values.push_back(value);
+    std::vector<glm::vec3> normals = sphereDirections();
+    normals.push_back(glm::vec3(0.0f));
+    normals.push_back(glm::vec3(-1.0f, 0.0f, 0.0f));
+    normals.push_back(glm::vec3(0.0f, -1.0f, 0.0f));
+    normals.push_back(glm::vec3(0.0f, 0.0f, -1.0f));
+
+    for (size_t i = 0; i < std::max(values.size(), normals.size()); i++)
+    {
+        const glm::vec3 position = glm::vec3(values[i % values.size()], values[(i + 1) % values.size()], values[(i + 2) % values.size()]);
+        const glm::vec3 normal = normals[i % normals.size()];
+        const GE::PackedVertex packed = GE::packVertex(GE::Vertex{ .pos = position, .normal = normal }, quantization);
+        for (uint32_t word : packed.posNormal)
+        {
+            ASSERT_TRUE(std::isnormal(std::bit_cast<float>(word))) << std::hex << word;
+            EXPECT_GT(std::bit_cast<float>(word), 0.0f);
+        }
+
+        // the shader decode of the float3
+        const glm::vec3 bits = glm::vec3(std::bit_cast<float>(packed.posNormal[0]), std::bit_cast<float>(packed.posNormal[1]), std::bit_cast<float>(packed.posNormal[2]));
+        const glm::vec3 decodedPosition = glm::vec3(std::bit_cast<uint32_t>(bits.x) & 0xFFFF, std::bit_cast<uint32_t>(bits.y) & 0xFFFF, std::bit_cast<uint32_t>(bits.z) & 0xFFFF);
+        EXPECT_EQ(decodedPosition, position);
+        const GE::Vertex decoded = GE::unpackVertex(packed, quantization);
+        EXPECT_EQ(decoded.pos, position);
+        if (glm::length(normal) > 0.0f)
+        {
+            EXPECT_GT(glm::dot(decoded.normal, normal), 0.9999f);
+        }
+    }
+}
+
+TEST(VertexFormatTest, positionRoundTripPrecision)
+{
+    std::vector<GE::Vertex> vertices;
+    for (int i = 0; i < 1000; i++)
+    {
+        const float t = static_cast<float>(i) / 999.0f;
+        vertices.push_back(GE::Vertex{ .pos = glm::vec3(-50.0f + 100.0f * t, 2.0f * t * t, 0.5f) });
+    }
+
+    const GE::PositionQuantization quantization = GE::positionQuantization(vertices);
+    EXPECT_EQ(quantization.offset, glm::vec3(-50.0f, 0.0f, 0.5f));
+
+    const glm::vec3 maxError = quantization.scale * 0.5f + glm::vec3(1e-5f);
+    for (const GE::Vertex& vertex : vertices)
+    {
+        const GE::Vertex decoded = GE::unpackVertex(GE::packVertex(vertex, quantization), quantization);
+        EXPECT_LE(std::abs(decoded.pos.x - vertex.pos.x), maxError.x);
+        EXPECT_LE(std::abs(decoded.pos.y - vertex.pos.y), maxError.y);
+        EXPECT_EQ(decoded.pos.z, vertex.pos.z);
+    }
+}
+
+TEST(VertexFormatTest, uvRoundTripPrecision)
+{
+    for (int i = 0; i <= 256; i++)
+    {
+        const glm::vec2 uv = glm::vec2(static_cast<float>(i) / 256.0f, 1.0f - static_cast<float>(i) / 256.0f);
+        const GE::Vertex decoded = GE::unpackVertex(GE::packVertex(GE::Vertex{ .uv = uv }, GE::PositionQuantization{}), GE::PositionQuantization{});
+        // half float has 11 bits of mantissa
+        EXPECT_NEAR(decoded.uv.x, uv.x, 1.0f / 2048.0f);
+        EXPECT_NEAR(decoded.uv.y, uv.y, 1.0f / 2048.0f);
+    }
+}
+
+TEST(VertexFormatTest, vertexLayoutMatchesFormat)
+{
+    EXPECT_EQ(GE::vertexLayout(GE::VertexFormat::full).stride, sizeof(GE::Vertex));
+    EXPECT_EQ(GE::vertexLayout(GE::VertexFormat::packed).stride, sizeof(GE::PackedVertex));
+    EXPECT_EQ(GE::vertexSize(GE::VertexFormat::packed), 20u);
+    EXPECT_LT(2 * GE::vertexSize(GE::VertexFormat::packed), GE::vertexSize(GE::VertexFormat::full));
+}
+
+} // namespace
+
+} // namespace GE_tests
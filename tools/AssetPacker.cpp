@@ -0,0 +1,58 @@
+/*
+ * ---------------------------------------------------
+ * AssetPacker.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ *
+ * Pack the meshes and textures of a resource directory into an asset
+ * archive, to be mounted with AssetManager::mountArchive.
+ *
+ * usage: GE-AssetPacker <resource directory> <archive path> [--no-compression]
+ *
+ */
+
+#include "Game-Engine/AssetArchive.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3 || argc > 4 || (argc == 4 && std::strcmp(argv[3], "--no-compression") != 0))
+    {
+        std::cerr << "usage: " << argv[0] << " <resource directory> <archive path> [--no-compression]\n";
+        return 1;
+    }
+    const std::filesystem::path resourceDirectory = argv[1];
+    const std::filesystem::path archivePath = argv[2];
+    const GE::ArchiveCompression compression = argc == 4 ? GE::ArchiveCompression::none : GE::ArchiveCompression::lz4;
+
+    if (!std::filesystem::is_directory(resourceDirectory))
+    {
+        std::cerr << "resource directory not found: " << resourceDirectory << '\n';
+        return 1;
+    }
+
+    try {
+        const auto start = std::chrono::steady_clock::now();
+        GE::AssetArchiveWriter writer;
+        const std::vector<std::filesystem::path> failedFiles = writer.addDirectory(resourceDirectory, compression);
+        writer.write(archivePath);
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+        for (const std::filesystem::path& failedFile : failedFiles)
+            std::cerr << "failed to cook: " << failedFile.string() << '\n';
+        std::cout << "packed " << writer.entryCount() << " assets into " << archivePath.string()
+                  << " (" << std::filesystem::file_size(archivePath) << " bytes) in " << duration.count() << " s\n";
+        return failedFiles.empty() ? 0 : 2;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}